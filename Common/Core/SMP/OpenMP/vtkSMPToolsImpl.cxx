@@ -0,0 +1,60 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPToolsInternal.h"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+std::atomic<int> vtkSMPNumberOfSpecifiedThreads(0);
+}
+
+void vtk::detail::smp::OpenMP::Initialize(int numThreads)
+{
+  vtkSMPNumberOfSpecifiedThreads = numThreads > 0 ? numThreads : 0;
+}
+
+int vtk::detail::smp::OpenMP::GetEstimatedNumberOfThreads()
+{
+  int numThreads = vtkSMPNumberOfSpecifiedThreads;
+  return numThreads ? numThreads : omp_get_max_threads();
+}
+
+void vtk::detail::smp::OpenMP::For(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor,
+  int maxNumberOfThreads)
+{
+  int numThreads = GetEstimatedNumberOfThreads();
+  if (maxNumberOfThreads > 0 && maxNumberOfThreads < numThreads)
+  {
+    numThreads = maxNumberOfThreads;
+  }
+
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first)/(numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+# pragma omp parallel for schedule(runtime) num_threads(numThreads)
+  for (vtkIdType from = first; from < last; from += grain)
+  {
+    functorExecuter(functor, from, grain, last);
+  }
+}
@@ -0,0 +1,443 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPToolsInternal.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The STDThread back-end executes vtkSMPTools::For on a single persistent
+// pool of std::thread workers. Each worker owns a deque of tasks; a thread
+// that submits a loop pushes helper tasks on its own deque and idle workers
+// steal them from the opposite end of other deques. The threads running a
+// loop, the submitting thread included, take chunks of grain iterations
+// from a shared counter until none is left. A thread waiting for its loop to
+// complete keeps executing pending tasks instead of blocking, so nested
+// calls to For reuse the pool threads and never create new ones.
+//
+// The number of threads of a vtkSMPTools::LocalScope is honored with a
+// budget of helper slots shared by all the loops started in the scope,
+// nested loops included: a helper only joins a loop if it can take a slot in
+// the budget of that loop and of all the enclosing ones.
+
+namespace
+{
+
+using vtk::detail::smp::ExecuteFunctorPtrType;
+
+//--------------------------------------------------------------------------------
+// Number of threads, besides the one that started them, allowed to run the
+// loops of a scope. Budgets live on the stack of the For call that created
+// them, which does not return before all its helpers are done.
+struct vtkSMPBudget
+{
+  std::atomic<int> Slots;
+  int NumberOfThreads;
+  vtkSMPBudget *Parent;
+};
+
+// Take a slot in budget and in all its parents, or none.
+bool vtkSMPAcquireSlot(vtkSMPBudget *budget)
+{
+  for (vtkSMPBudget *level = budget; level; level = level->Parent)
+  {
+    int slots = level->Slots.load();
+    do
+    {
+      if (slots <= 0)
+      {
+        for (vtkSMPBudget *taken = budget; taken != level;
+             taken = taken->Parent)
+        {
+          ++taken->Slots;
+        }
+        return false;
+      }
+    }
+    while (!level->Slots.compare_exchange_weak(slots, slots - 1));
+  }
+  return true;
+}
+
+void vtkSMPReleaseSlot(vtkSMPBudget *budget)
+{
+  for (vtkSMPBudget *level = budget; level; level = level->Parent)
+  {
+    ++level->Slots;
+  }
+}
+
+// Budget of the loop the calling thread is executing a chunk of, if any.
+thread_local vtkSMPBudget *vtkSMPCurrentBudget = NULL;
+
+//--------------------------------------------------------------------------------
+// A parallel for loop submitted to the pool. It lives on the stack of the
+// submitting thread, which does not return before Remaining and
+// PendingHelpers drop to zero.
+struct vtkSMPJob
+{
+  ExecuteFunctorPtrType Executer;
+  void *Functor;
+  vtkIdType Last;
+  vtkIdType Grain;
+  vtkSMPBudget *Budget;
+  std::atomic<vtkIdType> Next;
+  std::atomic<vtkIdType> Remaining;
+  std::atomic<int> PendingHelpers;
+
+  // Execute chunks until there is none left.
+  void Run()
+  {
+    vtkSMPBudget *previousBudget = vtkSMPCurrentBudget;
+    vtkSMPCurrentBudget = this->Budget;
+    for (;;)
+    {
+      vtkIdType from = this->Next.fetch_add(this->Grain);
+      if (from >= this->Last)
+      {
+        break;
+      }
+      this->Executer(this->Functor, from, this->Grain, this->Last);
+      vtkIdType to = from + this->Grain;
+      this->Remaining -= (to < this->Last ? to : this->Last) - from;
+    }
+    vtkSMPCurrentBudget = previousBudget;
+  }
+
+  // Entry point of the helper tasks.
+  void Help()
+  {
+    if (!this->Budget || vtkSMPAcquireSlot(this->Budget))
+    {
+      this->Run();
+      if (this->Budget)
+      {
+        vtkSMPReleaseSlot(this->Budget);
+      }
+    }
+    // The job may be released by its owner as soon as this reaches zero.
+    --this->PendingHelpers;
+  }
+};
+
+//--------------------------------------------------------------------------------
+// Work-stealing deque. The owner pushes and pops at the back (depth first,
+// the helpers of the innermost loop run first) while other threads steal
+// from the front.
+class vtkSMPTaskDeque
+{
+public:
+  void Push(vtkSMPJob *job)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Tasks.push_back(job);
+  }
+
+  vtkSMPJob *Pop()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->Tasks.empty())
+    {
+      return NULL;
+    }
+    vtkSMPJob *job = this->Tasks.back();
+    this->Tasks.pop_back();
+    return job;
+  }
+
+  vtkSMPJob *Steal()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->Tasks.empty())
+    {
+      return NULL;
+    }
+    vtkSMPJob *job = this->Tasks.front();
+    this->Tasks.pop_front();
+    return job;
+  }
+
+private:
+  std::mutex Mutex;
+  std::deque<vtkSMPJob*> Tasks;
+};
+
+class vtkSMPThreadPool;
+
+// Identifies the pool and the deque owned by the calling thread. Threads
+// that do not belong to a pool share deque 0.
+thread_local vtkSMPThreadPool *vtkSMPCurrentPool = NULL;
+thread_local size_t vtkSMPCurrentQueue = 0;
+
+//--------------------------------------------------------------------------------
+// Persistent pool of NumberOfThreads - 1 workers. The thread calling For
+// always participates in the execution, hence the total number of threads
+// executing work is at most NumberOfThreads.
+class vtkSMPThreadPool
+{
+public:
+  explicit vtkSMPThreadPool(int numThreads)
+    : NumberOfThreads(numThreads), PendingTasks(0), Stop(false)
+  {
+    this->Queues.resize(numThreads);
+    for (int i = 0; i < numThreads; ++i)
+    {
+      this->Queues[i] = new vtkSMPTaskDeque;
+    }
+    for (int i = 1; i < numThreads; ++i)
+    {
+      this->Threads.push_back(std::thread(&vtkSMPThreadPool::Run, this, i));
+    }
+  }
+
+  ~vtkSMPThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->WakeMutex);
+      this->Stop = true;
+    }
+    this->WakeCondition.notify_all();
+    for (size_t i = 0; i < this->Threads.size(); ++i)
+    {
+      this->Threads[i].join();
+    }
+    for (size_t i = 0; i < this->Queues.size(); ++i)
+    {
+      delete this->Queues[i];
+    }
+  }
+
+  int GetNumberOfThreads() const
+  {
+    return this->NumberOfThreads;
+  }
+
+  // Run the loop with the calling thread and up to numHelpers other threads
+  // of the pool, within budget if it is not NULL.
+  void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+           ExecuteFunctorPtrType functorExecuter, void *functor,
+           int numHelpers, vtkSMPBudget *budget)
+  {
+    vtkSMPJob job;
+    job.Executer = functorExecuter;
+    job.Functor = functor;
+    job.Last = last;
+    job.Grain = grain;
+    job.Budget = budget;
+    job.Next = first;
+    job.Remaining = last - first;
+    job.PendingHelpers = numHelpers;
+
+    size_t queue = (vtkSMPCurrentPool == this) ? vtkSMPCurrentQueue : 0;
+    for (int i = 0; i < numHelpers; ++i)
+    {
+      this->Push(&job, queue);
+    }
+    job.Run();
+
+    // Help with whatever work is pending until our own job is done and no
+    // helper task refers to it. This is what makes nested For calls safe: a
+    // worker waiting for an inner loop keeps executing tasks instead of
+    // blocking a pool thread.
+    while (job.Remaining.load() > 0 || job.PendingHelpers.load() > 0)
+    {
+      if (!this->RunOneTask(queue))
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+private:
+  void Push(vtkSMPJob *job, size_t queue)
+  {
+    this->Queues[queue]->Push(job);
+    ++this->PendingTasks;
+    {
+      // Synchronize with workers checking the predicate before sleeping
+      std::lock_guard<std::mutex> lock(this->WakeMutex);
+    }
+    this->WakeCondition.notify_one();
+  }
+
+  bool RunOneTask(size_t queue)
+  {
+    vtkSMPJob *job = this->Queues[queue]->Pop();
+    for (size_t i = 1; !job && i < this->Queues.size(); ++i)
+    {
+      job = this->Queues[(queue + i) % this->Queues.size()]->Steal();
+    }
+    if (!job)
+    {
+      return false;
+    }
+    --this->PendingTasks;
+    job->Help();
+    return true;
+  }
+
+  void Run(size_t queue)
+  {
+    vtkSMPCurrentPool = this;
+    vtkSMPCurrentQueue = queue;
+    for (;;)
+    {
+      if (this->RunOneTask(queue))
+      {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(this->WakeMutex);
+      while (!this->Stop && this->PendingTasks.load() <= 0)
+      {
+        this->WakeCondition.wait(lock);
+      }
+      if (this->Stop)
+      {
+        return;
+      }
+    }
+  }
+
+  int NumberOfThreads;
+  std::vector<vtkSMPTaskDeque*> Queues;
+  std::vector<std::thread> Threads;
+  std::atomic<vtkIdType> PendingTasks;
+  std::mutex WakeMutex;
+  std::condition_variable WakeCondition;
+  bool Stop;
+
+  vtkSMPThreadPool(const vtkSMPThreadPool&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMPThreadPool&) VTK_DELETE_FUNCTION;
+};
+
+std::atomic<int> vtkSMPNumberOfSpecifiedThreads(0);
+
+// The pool, created at the first parallel loop. It is only replaced when
+// vtkSMPTools::Initialize() asks for more threads than it has, in which case
+// the previous pool is kept (its workers asleep) until exit for the loops
+// that may still run on it.
+std::mutex vtkSMPPoolMutex;
+vtkSMPThreadPool *vtkSMPPool = NULL;
+std::vector<vtkSMPThreadPool*> vtkSMPRetiredPools;
+
+int vtkSMPGetDefaultNumberOfThreads()
+{
+  int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  return numThreads > 0 ? numThreads : 1;
+}
+
+// Destroys the pools (and joins their threads) at exit.
+struct vtkSMPThreadPoolCleanup
+{
+  ~vtkSMPThreadPoolCleanup()
+  {
+    delete vtkSMPPool;
+    vtkSMPPool = NULL;
+    for (size_t i = 0; i < vtkSMPRetiredPools.size(); ++i)
+    {
+      delete vtkSMPRetiredPools[i];
+    }
+    vtkSMPRetiredPools.clear();
+  }
+} vtkSMPThreadPoolCleanupInstance;
+
+vtkSMPThreadPool& vtkSMPGetThreadPool(int numThreads)
+{
+  std::lock_guard<std::mutex> lock(vtkSMPPoolMutex);
+  if (!vtkSMPPool || vtkSMPPool->GetNumberOfThreads() < numThreads)
+  {
+    if (vtkSMPPool)
+    {
+      vtkSMPRetiredPools.push_back(vtkSMPPool);
+    }
+    vtkSMPPool = new vtkSMPThreadPool(numThreads);
+  }
+  return *vtkSMPPool;
+}
+
+} // end anon namespace
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::STDThread::Initialize(int numThreads)
+{
+  // The pool is created lazily with this many threads.
+  vtkSMPNumberOfSpecifiedThreads = numThreads > 0 ? numThreads : 0;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::STDThread::GetEstimatedNumberOfThreads()
+{
+  int numThreads = vtkSMPNumberOfSpecifiedThreads;
+  return numThreads ? numThreads : vtkSMPGetDefaultNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::STDThread::For(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor,
+  int maxNumberOfThreads)
+{
+  int poolThreads = GetEstimatedNumberOfThreads();
+  int numThreads = poolThreads;
+  if (maxNumberOfThreads > 0 && maxNumberOfThreads < numThreads)
+  {
+    numThreads = maxNumberOfThreads;
+  }
+
+  // Loops nested in a limited one share its budget, and a stricter limit
+  // gets its own budget on top of it.
+  vtkSMPBudget *budget = vtkSMPCurrentBudget;
+  if (budget && budget->NumberOfThreads < numThreads)
+  {
+    numThreads = budget->NumberOfThreads;
+  }
+  vtkSMPBudget scopeBudget;
+  if (numThreads > 1 && numThreads < poolThreads &&
+      (!budget || numThreads < budget->NumberOfThreads))
+  {
+    scopeBudget.Slots = numThreads - 1;
+    scopeBudget.NumberOfThreads = numThreads;
+    scopeBudget.Parent = budget;
+    budget = &scopeBudget;
+  }
+
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first) / (numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  vtkIdType numChunks = (last - first + grain - 1) / grain;
+  int numHelpers = numThreads - 1;
+  if (numChunks - 1 < numHelpers)
+  {
+    numHelpers = static_cast<int>(numChunks - 1);
+  }
+
+  if (numHelpers <= 0)
+  {
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      functorExecuter(functor, from, grain, last);
+    }
+    return;
+  }
+
+  vtkSMPGetThreadPool(poolThreads).For(first, last, grain, functorExecuter,
+    functor, numHelpers, budget);
+}
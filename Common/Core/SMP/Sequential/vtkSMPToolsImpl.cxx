@@ -1,7 +1,7 @@
 /*=========================================================================
 
   Program:   Visualization Toolkit
-  Module:    vtkSMPTools.cxx
+  Module:    vtkSMPToolsImpl.cxx
 
   Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
   All rights reserved.
@@ -13,16 +13,32 @@
 
 =========================================================================*/
 
-#include "vtkSMPTools.h"
+#include "vtkSMPToolsInternal.h"
 
 // Simple implementation that runs everything sequentially.
 
 //--------------------------------------------------------------------------------
-void vtkSMPTools::Initialize(int)
+void vtk::detail::smp::Sequential::Initialize(int)
 {
 }
 
-int vtkSMPTools::GetEstimatedNumberOfThreads()
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::Sequential::GetEstimatedNumberOfThreads()
 {
   return 1;
 }
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::Sequential::For(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor, int)
+{
+  if (grain <= 0)
+  {
+    grain = last - first;
+  }
+
+  for (vtkIdType from = first; from < last; from += grain)
+  {
+    functorExecuter(functor, from, grain, last);
+  }
+}
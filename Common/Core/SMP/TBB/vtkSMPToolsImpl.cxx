@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPToolsInternal.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace
+{
+
+using vtk::detail::smp::ExecuteFunctorPtrType;
+
+std::atomic<int> vtkTBBNumSpecifiedThreads(0);
+
+// Arenas limiting the concurrency of Initialize()'d or scoped calls, one per
+// requested number of threads.
+typedef std::map<int, tbb::task_arena*> vtkSMPTaskArenaMap;
+vtkSMPTaskArenaMap vtkSMPTaskArenas;
+std::mutex vtkSMPTaskArenasMutex;
+
+struct vtkSMPTaskArenaCleanup
+{
+  ~vtkSMPTaskArenaCleanup()
+  {
+    for (vtkSMPTaskArenaMap::iterator it = vtkSMPTaskArenas.begin();
+         it != vtkSMPTaskArenas.end(); ++it)
+    {
+      delete it->second;
+    }
+    vtkSMPTaskArenas.clear();
+  }
+} vtkSMPTaskArenaCleanupInstance;
+
+tbb::task_arena& vtkSMPGetTaskArena(int numThreads)
+{
+  std::lock_guard<std::mutex> lock(vtkSMPTaskArenasMutex);
+  tbb::task_arena *&arena = vtkSMPTaskArenas[numThreads];
+  if (!arena)
+  {
+    arena = new tbb::task_arena(numThreads);
+  }
+  return *arena;
+}
+
+//--------------------------------------------------------------------------------
+class FuncCall
+{
+  ExecuteFunctorPtrType Executer;
+  void *Functor;
+
+public:
+  FuncCall(ExecuteFunctorPtrType executer, void *functor)
+    : Executer(executer), Functor(functor)
+  {
+  }
+
+  void operator() (const tbb::blocked_range<vtkIdType>& r) const
+  {
+    this->Executer(this->Functor, r.begin(), r.end() - r.begin(), r.end());
+  }
+};
+
+//--------------------------------------------------------------------------------
+class ParallelFor
+{
+  vtkIdType First, Last, Grain;
+  FuncCall Call;
+
+public:
+  ParallelFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+              const FuncCall& call)
+    : First(first), Last(last), Grain(grain), Call(call)
+  {
+  }
+
+  void operator() () const
+  {
+    if (this->Grain > 0)
+    {
+      tbb::parallel_for(tbb::blocked_range<vtkIdType>(
+        this->First, this->Last, this->Grain), this->Call);
+    }
+    else
+    {
+      tbb::parallel_for(tbb::blocked_range<vtkIdType>(
+        this->First, this->Last), this->Call);
+    }
+  }
+};
+
+} // end anon namespace
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::TBB::Initialize(int numThreads)
+{
+  // If numThreads <= 0, let TBB do the default thing.
+  vtkTBBNumSpecifiedThreads = numThreads > 0 ? numThreads : 0;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::TBB::GetEstimatedNumberOfThreads()
+{
+  int numThreads = vtkTBBNumSpecifiedThreads;
+  return numThreads ? numThreads : tbb::this_task_arena::max_concurrency();
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::TBB::For(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor,
+  int maxNumberOfThreads)
+{
+  ParallelFor body(first, last, grain, FuncCall(functorExecuter, functor));
+
+  int numThreads = vtkTBBNumSpecifiedThreads;
+  if (maxNumberOfThreads > 0 && (!numThreads || maxNumberOfThreads < numThreads))
+  {
+    numThreads = maxNumberOfThreads;
+  }
+
+  // Nested loops already run inside an arena that is small enough.
+  if (numThreads <= 0 || tbb::this_task_arena::max_concurrency() <= numThreads)
+  {
+    body();
+  }
+  else
+  {
+    vtkSMPGetTaskArena(numThreads).execute(body);
+  }
+}
@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataArrayRange.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkDataArrayRange.h"
+
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
+#include "vtkTestCheck.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+
+// Fill the tuples of a 3 component array with {3 * t, 3 * t + 1, 3 * t + 2}.
+template <typename ArrayT>
+void FillArray(ArrayT *array, vtkIdType numTuples)
+{
+  array->SetNumberOfComponents(3);
+  array->SetNumberOfTuples(numTuples);
+  for (vtkIdType t = 0; t < numTuples; ++t)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      array->SetComponent(t, c, 3 * t + c);
+    }
+  }
+}
+
+template <vtk::ComponentIdType TupleSize, typename ArrayT>
+int TestTupleRange(ArrayT *array)
+{
+  FillArray(array, 10);
+  auto range = vtk::DataArrayTupleRange<TupleSize>(array);
+  vtkTestCheckMacro(range.size() == 10);
+  vtkTestCheckMacro(range.GetTupleSize() == 3);
+  vtkTestCheckMacro(range.end() - range.begin() == 10);
+
+  // Read with nested range-for loops
+  double expected = 0;
+  for (const auto tuple : range)
+  {
+    vtkTestCheckMacro(tuple.size() == 3);
+    for (const double comp : tuple)
+    {
+      vtkTestCheckMacro(comp == expected);
+      ++expected;
+    }
+  }
+
+  // Write through the references
+  for (auto tuple : range)
+  {
+    for (auto&& comp : tuple)
+    {
+      comp = comp * 2;
+    }
+    tuple[1] += 1;
+  }
+  vtkTestCheckMacro(array->GetComponent(4, 0) == 24);
+  vtkTestCheckMacro(array->GetComponent(4, 1) == 27);
+  vtkTestCheckMacro(array->GetComponent(4, 2) == 28);
+
+  // Tuple get/set, assignment and comparison
+  typedef typename decltype(range)::ComponentType ComponentType;
+  ComponentType tuple[3] = { 1, 2, 3 };
+  range[0].SetTuple(tuple);
+  range[1] = range[0];
+  vtkTestCheckMacro(range[1] == range[0]);
+  vtkTestCheckMacro(range[2] != range[0]);
+  range[2].GetTuple(tuple);
+  vtkTestCheckMacro(tuple[0] == 12 && tuple[1] == 15 && tuple[2] == 16);
+  range[3].fill(7);
+  vtkTestCheckMacro(array->GetComponent(3, 2) == 7);
+
+  // Sub range and standard algorithms on tuples
+  auto subRange = vtk::DataArrayTupleRange<TupleSize>(array, 4, 8);
+  vtkTestCheckMacro(subRange.size() == 4);
+  vtkTestCheckMacro((*subRange.begin())[0] == 24);
+  auto found = std::find_if(subRange.cbegin(), subRange.cend(),
+    [](decltype(*subRange.cbegin()) t) { return t[2] == 40; });
+  vtkTestCheckMacro(found - subRange.cbegin() == 2);
+  vtkTestCheckMacro(
+    std::accumulate(subRange[3].cbegin(), subRange[3].cend(), 0.) ==
+    42 + 45 + 46);
+  return 0;
+}
+
+template <vtk::ComponentIdType TupleSize, typename ArrayT>
+int TestValueRange(ArrayT *array)
+{
+  FillArray(array, 10);
+  auto range = vtk::DataArrayValueRange<TupleSize>(array);
+  vtkTestCheckMacro(range.size() == 30);
+
+  double expected = 0;
+  for (const double value : range)
+  {
+    vtkTestCheckMacro(value == expected);
+    ++expected;
+  }
+
+  for (auto&& value : range)
+  {
+    value = value + 1;
+  }
+  vtkTestCheckMacro(array->GetComponent(9, 2) == 30);
+  vtkTestCheckMacro(range[5] == 6);
+
+  auto subRange = vtk::DataArrayValueRange<TupleSize>(array, 4, 11);
+  vtkTestCheckMacro(subRange.size() == 7);
+  vtkTestCheckMacro(*subRange.begin() == 5);
+  vtkTestCheckMacro(subRange.end()[-1] == 11);
+  vtkTestCheckMacro(
+    std::accumulate(subRange.cbegin(), subRange.cend(), 0.) == 56);
+
+  // Random access and reverse iteration
+  auto it = range.end();
+  --it;
+  vtkTestCheckMacro(*it == 30);
+  it -= 4;
+  vtkTestCheckMacro(*it == 26);
+  vtkTestCheckMacro(it - range.begin() == 25);
+  vtkTestCheckMacro(range.begin() < it);
+
+  // The ranges work with vtkSMPTools and the standard algorithms
+  vtkSMPTools::Fill(range.begin(), range.end(), 2);
+  vtkTestCheckMacro(std::count(range.cbegin(), range.cend(), 2) == 30);
+  vtkSMPTools::Transform(range.cbegin(), range.cend(), range.begin(),
+    [](double v) { return v * 3; });
+  vtkTestCheckMacro(
+    vtkSMPTools::Reduce(range.cbegin(), range.cend(), 0.) == 180);
+  return 0;
+}
+
+template <vtk::ComponentIdType TupleSize, typename ArrayT>
+int TestRanges(ArrayT *array)
+{
+  if (TestTupleRange<TupleSize>(array) || TestValueRange<TupleSize>(array))
+  {
+    std::cerr << "Failed with " << array->GetClassName() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestDataArrayRange(int, char*[])
+{
+  vtkNew<vtkFloatArray> aos;
+  vtkNew<vtkIdTypeArray> ids;
+  vtkNew<vtkSOADataArrayTemplate<double> > soa;
+  vtkNew<vtkSOADataArrayTemplate<float> > soaFloat;
+
+  // AOS subclasses use raw pointers
+  static_assert(std::is_same<
+    decltype(vtk::DataArrayValueRange(aos.GetPointer()).begin()),
+    float*>::value, "AOS value iterators are pointers.");
+  static_assert(std::is_same<
+    decltype(vtk::DataArrayTupleRange(ids.GetPointer())[0].begin()),
+    vtkIdType*>::value, "AOS component iterators are pointers.");
+
+  int result = 0;
+  result |= TestRanges<3>(aos.GetPointer());
+  result |= TestRanges<vtk::detail::DynamicTupleSize>(aos.GetPointer());
+  result |= TestRanges<3>(ids.GetPointer());
+  result |= TestRanges<3>(soa.GetPointer());
+  result |= TestRanges<vtk::detail::DynamicTupleSize>(soaFloat.GetPointer());
+
+  // Generic double API
+  vtkDataArray *dataArray = soa.GetPointer();
+  result |= TestRanges<vtk::detail::DynamicTupleSize>(dataArray);
+  dataArray = aos.GetPointer();
+  result |= TestRanges<3>(dataArray);
+
+  return result;
+}
@@ -18,11 +18,82 @@
 #include "vtkObjectFactory.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <functional>
+#include <string>
+#include <thread>
 #include <vector>
 
 static const int Target = 10000;
 
+// Records the settings seen by the threads that run the loop.
+class ScopeFunctor
+{
+public:
+  std::atomic<int> MaxNumberOfThreads;
+  std::atomic<int> WrongBackend;
+
+  ScopeFunctor() : MaxNumberOfThreads(0), WrongBackend(0)
+  {
+  }
+
+  void operator()(vtkIdType, vtkIdType)
+  {
+    int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+    int previous = this->MaxNumberOfThreads;
+    while (numThreads > previous &&
+           !this->MaxNumberOfThreads.compare_exchange_weak(previous,
+                                                           numThreads))
+    {
+    }
+    if (strcmp(vtkSMPTools::GetBackend(), "STDThread") != 0)
+    {
+      this->WrongBackend = 1;
+    }
+  }
+};
+
+// Records the maximum number of threads running the loop, and the loop
+// nested in it, at the same time.
+class ConcurrencyFunctor
+{
+public:
+  std::atomic<int> Active;
+  std::atomic<int> MaxActive;
+  bool Nested;
+
+  ConcurrencyFunctor(bool nested) : Active(0), MaxActive(0), Nested(nested)
+  {
+  }
+
+  void operator()(vtkIdType, vtkIdType)
+  {
+    if (this->Nested)
+    {
+      ConcurrencyFunctor *self = this;
+      vtkSMPTools::For(0, 8, 1, [self](vtkIdType, vtkIdType) { self->Work(); });
+    }
+    else
+    {
+      this->Work();
+    }
+  }
+
+  void Work()
+  {
+    int active = ++this->Active;
+    int previous = this->MaxActive;
+    while (active > previous &&
+           !this->MaxActive.compare_exchange_weak(previous, active))
+    {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    --this->Active;
+  }
+};
+
 class ARangeFunctor
 {
 public:
@@ -91,13 +162,37 @@ public:
 
 };
 
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  NestedFunctor(): Counter(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, 100, 10, inner);
+      int innerTotal = 0;
+      for (vtkSMPThreadLocal<int>::iterator itr = inner.Counter.begin();
+           itr != inner.Counter.end(); ++itr)
+      {
+        innerTotal += *itr;
+      }
+      this->Counter.Local() += innerTotal;
+    }
+  }
+};
+
 // For sorting comparison
 bool myComp (double a, double b) { return (a<b); }
 
-int TestSMP(int, char*[])
+static int DoTestSMP()
 {
-  //vtkSMPTools::Initialize(8);
-
   ARangeFunctor functor1;
 
   vtkSMPTools::For(0, Target, functor1);
@@ -140,6 +235,24 @@ int TestSMP(int, char*[])
     return 1;
   }
 
+  // Nested parallel loops
+  NestedFunctor functor3;
+
+  vtkSMPTools::For(0, 100, 1, functor3);
+
+  total = 0;
+  for (vtkSMPThreadLocal<int>::iterator itr3 = functor3.Counter.begin();
+       itr3 != functor3.Counter.end(); ++itr3)
+  {
+    total += *itr3;
+  }
+
+  if (total != 100 * 100)
+  {
+    cerr << "Error: NestedFunctor did not generate " << 100 * 100 << endl;
+    return 1;
+  }
+
   // Test sorting
   double data0[] = {2,1,0,3,9,6,7,3,8,4,5};
   std::vector<double> myvector (data0, data0+11);
@@ -167,5 +280,170 @@ int TestSMP(int, char*[])
     }
   }
 
+  // Large enough to be sorted in parallel
+  std::vector<int> bigvector(100000);
+  for (size_t i=0; i<bigvector.size(); ++i)
+  {
+    bigvector[i] = static_cast<int>((i * 7919) % 100003);
+  }
+  vtkSMPTools::Sort(bigvector.begin(), bigvector.end());
+  for (size_t i=1; i<bigvector.size(); ++i)
+  {
+    if (bigvector[i-1] > bigvector[i])
+    {
+      cerr << "Error: Bad parallel sort!" << endl;
+      return 1;
+    }
+  }
+
+  // Test the parallel algorithms on sizes that are split in blocks or not
+  const vtkIdType sizes[] = { 0, 1, 11, 100000 };
+  for (int s=0; s<4; ++s)
+  {
+    vtkIdType size = sizes[s];
+    std::vector<vtkIdType> counts(size + 1);
+    std::vector<double> values(size + 1);
+    vtkSMPTools::Fill(counts.begin(), counts.begin() + size, vtkIdType(3));
+    vtkSMPTools::Transform(counts.begin(), counts.begin() + size,
+      values.begin(), [](vtkIdType c) { return 0.5 * c; });
+    vtkSMPTools::Transform(values.begin(), values.begin() + size,
+      counts.begin(), values.begin(),
+      [](double v, vtkIdType c) { return v + c; });
+    if (vtkSMPTools::Reduce(values.begin(), values.begin() + size, 0.0) !=
+        4.5 * size ||
+        vtkSMPTools::Reduce(counts.begin(), counts.begin() + size,
+          vtkIdType(1), [](vtkIdType a, vtkIdType b) { return std::max(a, b); })
+        != (size ? 3 : 1))
+    {
+      cerr << "Error: Bad parallel transform or reduce!" << endl;
+      return 1;
+    }
+
+    std::vector<vtkIdType> inclusive(size);
+    if (vtkSMPTools::InclusiveScan(counts.begin(), counts.begin() + size,
+          inclusive.begin()) != 3 * size)
+    {
+      cerr << "Error: Bad inclusive scan total!" << endl;
+      return 1;
+    }
+    // In place, as used to turn counts into offsets
+    if (vtkSMPTools::ExclusiveScan(counts.begin(), counts.begin() + size,
+          counts.begin(), vtkIdType(10)) != 10 + 3 * size)
+    {
+      cerr << "Error: Bad exclusive scan total!" << endl;
+      return 1;
+    }
+    for (vtkIdType i=0; i<size; ++i)
+    {
+      if (inclusive[i] != 3 * (i + 1) || counts[i] != 10 + 3 * i)
+      {
+        cerr << "Error: Bad parallel scan!" << endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+int TestSMP(int, char*[])
+{
+  const char* backends[] = { "Sequential", "STDThread", "OpenMP", "TBB" };
+  for (int i=0; i<4; ++i)
+  {
+    if (!vtkSMPTools::IsBackendAvailable(backends[i]))
+    {
+      continue;
+    }
+    if (!vtkSMPTools::SetBackend(backends[i]) ||
+        strcmp(vtkSMPTools::GetBackend(), backends[i]) != 0)
+    {
+      cerr << "Error: could not select back-end " << backends[i] << endl;
+      return 1;
+    }
+    if (DoTestSMP())
+    {
+      cerr << "Error: back-end " << backends[i] << " failed" << endl;
+      return 1;
+    }
+
+    // Limit the number of threads for the calling thread only
+    int result = 0;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(2), [&]()
+    {
+      if (vtkSMPTools::GetEstimatedNumberOfThreads() > 2)
+      {
+        cerr << "Error: LocalScope did not limit the number of threads" << endl;
+        result = 1;
+      }
+      result |= DoTestSMP();
+    });
+    if (result)
+    {
+      cerr << "Error: back-end " << backends[i] << " failed in LocalScope" << endl;
+      return 1;
+    }
+  }
+
+  // Switch back-end for the calling thread only
+  vtkSMPTools::SetBackend("Sequential");
+  int result = 0;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(std::string("STDThread")), [&]()
+  {
+    if (vtkSMPTools::IsBackendAvailable("STDThread") &&
+        strcmp(vtkSMPTools::GetBackend(), "STDThread") != 0)
+    {
+      result = 1;
+    }
+  });
+  if (result || strcmp(vtkSMPTools::GetBackend(), "Sequential") != 0)
+  {
+    cerr << "Error: LocalScope did not restore the back-end" << endl;
+    return 1;
+  }
+
+  // The scope also applies to the loops nested in the workers
+  if (vtkSMPTools::IsBackendAvailable("STDThread"))
+  {
+    vtkSMPTools::Initialize(8);
+    ScopeFunctor functor;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(3, "STDThread"), [&]()
+    {
+      vtkSMPTools::For(0, 1000, 1, functor);
+    });
+    if (functor.MaxNumberOfThreads != 3 || functor.WrongBackend)
+    {
+      cerr << "Error: LocalScope was not applied by the workers" << endl;
+      return 1;
+    }
+
+    // Scopes of any size share the pool and never run more threads than
+    // they allow, nested loops included.
+    for (int limit = 1; limit <= 4; ++limit)
+    {
+      for (int nested = 0; nested < 2; ++nested)
+      {
+        ConcurrencyFunctor concurrency(nested == 1);
+        vtkSMPTools::LocalScope(vtkSMPTools::Config(limit, "STDThread"), [&]()
+        {
+          vtkSMPTools::For(0, 64, 1, concurrency);
+        });
+        if (concurrency.MaxActive > limit)
+        {
+          cerr << "Error: " << concurrency.MaxActive << " threads ran in a "
+               << "scope of " << limit << (nested ? " with nested loops" : "")
+               << endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  if (vtkSMPTools::SetBackend("NotABackend"))
+  {
+    cerr << "Error: SetBackend accepted an invalid back-end" << endl;
+    return 1;
+  }
+
   return 0;
 }
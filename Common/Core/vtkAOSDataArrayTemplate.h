@@ -175,6 +175,14 @@ public:
                     int deleteMethod) VTK_OVERRIDE;
   //@}
 
+  /**
+   * Set the function that frees the data held by the array, instead of
+   * the delete method given to SetArray.  This lets the array hold memory
+   * from other allocators, such as memory mapped files.  The data is
+   * copied to memory allocated with malloc() when the array is resized.
+   */
+  void SetArrayFreeFunction(void (*callback)(void*));
+
   // Overridden for optimized implementations:
   void SetTuple(vtkIdType tupleIdx, const float *tuple) VTK_OVERRIDE;
   void SetTuple(vtkIdType tupleIdx, const double *tuple) VTK_OVERRIDE;
@@ -69,6 +69,14 @@ void vtkAOSDataArrayTemplate<ValueTypeT>
   this->DataChanged();
 }
 
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+void vtkAOSDataArrayTemplate<ValueTypeT>
+::SetArrayFreeFunction(void (*callback)(void*))
+{
+  this->Buffer->SetFreeFunction(false, callback);
+}
+
 //-----------------------------------------------------------------------------
 template <class ValueTypeT>
 void vtkAOSDataArrayTemplate<ValueTypeT>
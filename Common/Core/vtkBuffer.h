@@ -53,6 +53,15 @@ public:
   void SetBuffer(ScalarType* array, vtkIdType size, bool save=false,
                  void (*deleteFunction)(void*)=free);
 
+  /**
+   * Set the function that frees the current buffer when this vtkBuffer
+   * object is deleted or resized.  If @a noFreeFunction is true, the
+   * buffer is not freed.  Buffers with a free function other than free()
+   * are copied to new memory when resized.
+   */
+  void SetFreeFunction(bool noFreeFunction,
+                       void (*deleteFunction)(void*)=free);
+
   /**
    * Return the number of elements the current buffer can hold.
    */
@@ -118,6 +127,15 @@ void vtkBuffer<ScalarT>::SetBuffer(
   this->DeleteFunction = deleteFunction;
 }
 
+//------------------------------------------------------------------------------
+template <typename ScalarT>
+void vtkBuffer<ScalarT>::SetFreeFunction(bool noFreeFunction,
+                                         void (*deleteFunction)(void*))
+{
+  this->Save = noFreeFunction;
+  this->DeleteFunction = deleteFunction;
+}
+
 //------------------------------------------------------------------------------
 template <typename ScalarT>
 bool vtkBuffer<ScalarT>::Allocate(vtkIdType size)
@@ -0,0 +1,126 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayMeta.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Type traits and helpers shared by the vtkDataArray ranges, see
+// vtkDataArrayRange.h.
+
+#ifndef vtkDataArrayMeta_h
+#define vtkDataArrayMeta_h
+
+#include "vtkAOSDataArrayTemplate.h"
+#include "vtkDataArray.h"
+
+#include <cassert>
+#include <type_traits>
+
+#ifndef __VTK_WRAP__
+
+namespace vtk
+{
+
+// Types used to index the tuples, components and values of the ranges.
+typedef int ComponentIdType;
+typedef vtkIdType TupleIdType;
+typedef vtkIdType ValueIdType;
+
+namespace detail
+{
+
+// A tuple size of DynamicTupleSize means that the number of components is
+// only known at run-time.
+enum { DynamicTupleSize = 0 };
+
+//------------------------------------------------------------------------------
+// Type used by the range API: double for vtkDataArray, the ValueType of the
+// vtkGenericDataArray subclasses.
+template <typename ArrayType>
+struct GetAPITypeImpl
+{
+  typedef typename ArrayType::ValueType type;
+};
+
+template <>
+struct GetAPITypeImpl<vtkDataArray>
+{
+  typedef double type;
+};
+
+template <typename ArrayType>
+struct GetAPIType
+{
+  typedef typename GetAPITypeImpl<
+    typename std::remove_const<ArrayType>::type>::type type;
+};
+
+//------------------------------------------------------------------------------
+// True for vtkAOSDataArrayTemplate and its subclasses (vtkFloatArray,
+// vtkIdTypeArray, ...), whose values are contiguous in memory.
+template <typename ArrayType, typename Enable = void>
+struct IsAOSDataArray : std::false_type
+{
+};
+
+template <typename ArrayType>
+struct IsAOSDataArray<ArrayType, typename std::enable_if<std::is_base_of<
+  vtkAOSDataArrayTemplate<typename ArrayType::ValueType>,
+  ArrayType>::value>::type> : std::true_type
+{
+};
+
+//------------------------------------------------------------------------------
+// Number of components of the tuples. When TupleSize is not
+// DynamicTupleSize, it is a compile-time constant so that loops over the
+// components of a tuple can be unrolled.
+template <ComponentIdType TupleSize>
+struct GenericTupleSize
+{
+  static_assert(TupleSize > 0, "Invalid tuple size.");
+
+  GenericTupleSize() {}
+
+  template <typename ArrayType>
+  explicit GenericTupleSize(ArrayType *array)
+  {
+    (void)array;
+    assert("Tuple size matches the array." &&
+           (!array || array->GetNumberOfComponents() == TupleSize));
+  }
+
+  ComponentIdType Get() const { return TupleSize; }
+};
+
+template <>
+struct GenericTupleSize<DynamicTupleSize>
+{
+  GenericTupleSize() : Value(0) {}
+
+  template <typename ArrayType>
+  explicit GenericTupleSize(ArrayType *array)
+    : Value(array ? array->GetNumberOfComponents() : 0)
+  {
+  }
+
+  ComponentIdType Get() const { return this->Value; }
+
+private:
+  ComponentIdType Value;
+};
+
+} // end namespace detail
+} // end namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif // vtkDataArrayMeta_h
+// VTK-HeaderTest-Exclude: vtkDataArrayMeta.h
@@ -0,0 +1,174 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayRange.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file vtkDataArrayRange.h
+ * STL-style ranges over the tuples and values of a vtkDataArray.
+ *
+ * vtk::DataArrayTupleRange() and vtk::DataArrayValueRange() return light
+ * objects with random access iterators that can be used in range-for loops
+ * and with the standard algorithms or vtkSMPTools. They are meant to be
+ * used in the workers of vtkArrayDispatch in place of vtkDataArrayAccessor:
+ *
+ * @code
+ * struct Worker
+ * {
+ *   template <typename ArrayT>
+ *   void operator()(ArrayT *points, double &maxNorm)
+ *   {
+ *     // Points have 3 components, known at compile time:
+ *     for (const auto tuple : vtk::DataArrayTupleRange<3>(points))
+ *     {
+ *       double norm = 0.;
+ *       for (const double comp : tuple)
+ *       {
+ *         norm += comp * comp;
+ *       }
+ *       maxNorm = std::max(maxNorm, norm);
+ *     }
+ *   }
+ * };
+ *
+ * // Writing the values, whatever the number of components:
+ * for (auto&& value : vtk::DataArrayValueRange(array))
+ * {
+ *   value *= 2;
+ * }
+ * @endcode
+ *
+ * The tuple range iterates over tuple references, which are themselves
+ * ranges over the components of the tuple. The value range iterates over
+ * all the components of all the tuples, in the order of GetValue().
+ *
+ * The template parameter TupleSize is the number of components of the
+ * array. When it is given, loops over the components of a tuple have a
+ * compile-time trip count. It must match the array (this is asserted in
+ * debug builds). By default, the number of components is read from the
+ * array.
+ *
+ * The implementation depends on the type of the array:
+ * - vtkAOSDataArrayTemplate and its subclasses (vtkFloatArray,
+ *   vtkIdTypeArray...): the value and component iterators are raw pointers
+ *   and the tuple iterators advance a pointer by the tuple size, so that
+ *   loops compile down to pointer arithmetic and can be vectorized.
+ * - other vtkGenericDataArray subclasses, e.g. vtkSOADataArrayTemplate:
+ *   the components are accessed with the inlined GetTypedComponent and
+ *   SetTypedComponent, i.e. directly in the buffer of each component.
+ * - vtkDataArray: the components are accessed with the double API.
+ *
+ * In the last two cases, the references are proxy objects that read or
+ * write the array when converted to or assigned a value. Use `auto&&` (or
+ * `auto`) rather than `auto&` to write through them in range-for loops.
+ *
+ * The ranges, iterators and references do not own or reference count the
+ * array, and are invalidated when it is resized.
+ */
+
+#ifndef vtkDataArrayRange_h
+#define vtkDataArrayRange_h
+
+#include "vtkDataArrayMeta.h"
+#include "vtkDataArrayTupleRange_AOS.h"
+#include "vtkDataArrayTupleRange_Generic.h"
+#include "vtkDataArrayValueRange_AOS.h"
+#include "vtkDataArrayValueRange_Generic.h"
+
+#include <type_traits>
+
+#ifndef __VTK_WRAP__
+
+namespace vtk
+{
+namespace detail
+{
+
+// Ranges over subclasses of vtkAOSDataArrayTemplate use the pointer based
+// implementation.
+template <typename ArrayType, ComponentIdType TupleSize,
+          typename Enable = void>
+struct SelectTupleRange
+{
+  typedef TupleRange<ArrayType, TupleSize> type;
+};
+
+template <typename ArrayType, ComponentIdType TupleSize>
+struct SelectTupleRange<ArrayType, TupleSize,
+  typename std::enable_if<IsAOSDataArray<ArrayType>::value>::type>
+{
+  typedef TupleRange<vtkAOSDataArrayTemplate<typename ArrayType::ValueType>,
+                     TupleSize> type;
+};
+
+template <typename ArrayType, ComponentIdType TupleSize,
+          typename Enable = void>
+struct SelectValueRange
+{
+  typedef ValueRange<ArrayType, TupleSize> type;
+};
+
+template <typename ArrayType, ComponentIdType TupleSize>
+struct SelectValueRange<ArrayType, TupleSize,
+  typename std::enable_if<IsAOSDataArray<ArrayType>::value>::type>
+{
+  typedef ValueRange<vtkAOSDataArrayTemplate<typename ArrayType::ValueType>,
+                     TupleSize> type;
+};
+
+} // end namespace detail
+
+/**
+ * Range over the tuples [start, end) of array. A negative start or end
+ * stands for the first tuple or for the end of the array.
+ */
+template <ComponentIdType TupleSize = detail::DynamicTupleSize,
+          typename ArrayType>
+typename detail::SelectTupleRange<ArrayType, TupleSize>::type
+DataArrayTupleRange(ArrayType *array, TupleIdType start = -1,
+                    TupleIdType end = -1)
+{
+  static_assert(std::is_base_of<vtkDataArray, ArrayType>::value,
+                "Ranges are only available for vtkDataArray subclasses.");
+  assert("Array is not NULL." && array);
+  start = start < 0 ? 0 : start;
+  end = end < 0 ? array->GetNumberOfTuples() : end;
+  return typename detail::SelectTupleRange<ArrayType, TupleSize>::type(
+    array, start, end);
+}
+
+/**
+ * Range over the values [start, end) of array. A negative start or end
+ * stands for the first value or for the end of the array.
+ */
+template <ComponentIdType TupleSize = detail::DynamicTupleSize,
+          typename ArrayType>
+typename detail::SelectValueRange<ArrayType, TupleSize>::type
+DataArrayValueRange(ArrayType *array, ValueIdType start = -1,
+                    ValueIdType end = -1)
+{
+  static_assert(std::is_base_of<vtkDataArray, ArrayType>::value,
+                "Ranges are only available for vtkDataArray subclasses.");
+  assert("Array is not NULL." && array);
+  start = start < 0 ? 0 : start;
+  end = end < 0 ? array->GetNumberOfTuples() *
+                  array->GetNumberOfComponents() : end;
+  return typename detail::SelectValueRange<ArrayType, TupleSize>::type(
+    array, start, end);
+}
+
+} // end namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif // vtkDataArrayRange_h
+// VTK-HeaderTest-Exclude: vtkDataArrayRange.h
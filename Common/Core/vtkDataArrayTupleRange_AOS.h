@@ -0,0 +1,378 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayTupleRange_AOS.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Specialization of the tuple range for vtkAOSDataArrayTemplate, see
+// vtkDataArrayRange.h. The tuples are contiguous so the component iterators
+// are raw pointers and the tuple iterators advance a pointer by the tuple
+// size, which lets the compiler vectorize loops over the range.
+
+#ifndef vtkDataArrayTupleRange_AOS_h
+#define vtkDataArrayTupleRange_AOS_h
+
+#include "vtkAOSDataArrayTemplate.h"
+#include "vtkDataArrayMeta.h"
+#include "vtkDataArrayTupleRange_Generic.h"
+
+#include <algorithm>
+#include <iterator>
+
+#ifndef __VTK_WRAP__
+
+namespace vtk
+{
+namespace detail
+{
+
+//------------------------------------------------------------------------------
+template <typename ValueType, ComponentIdType TupleSize>
+struct ConstTupleReference<vtkAOSDataArrayTemplate<ValueType>, TupleSize>
+{
+  typedef ValueType APIType;
+  typedef const ValueType* const_iterator;
+  typedef const_iterator iterator;
+  typedef ComponentIdType size_type;
+  typedef ValueType value_type;
+
+  ConstTupleReference()
+    : Tuple(NULL)
+  {
+  }
+
+  ConstTupleReference(const ValueType *tuple,
+                      GenericTupleSize<TupleSize> numComps)
+    : Tuple(tuple), NumComps(numComps)
+  {
+  }
+
+  size_type size() const { return this->NumComps.Get(); }
+
+  const_iterator begin() const { return this->Tuple; }
+  const_iterator end() const { return this->Tuple + this->NumComps.Get(); }
+  const_iterator cbegin() const { return this->begin(); }
+  const_iterator cend() const { return this->end(); }
+
+  const ValueType& operator[](size_type i) const { return this->Tuple[i]; }
+
+  void GetTuple(ValueType *tuple) const
+  {
+    std::copy(this->begin(), this->end(), tuple);
+  }
+
+  template <typename OtherTuple>
+  bool operator==(const OtherTuple& other) const
+  {
+    return this->size() == static_cast<size_type>(other.size()) &&
+           std::equal(this->cbegin(), this->cend(), other.cbegin());
+  }
+  template <typename OtherTuple>
+  bool operator!=(const OtherTuple& other) const
+  {
+    return !(*this == other);
+  }
+
+  const ValueType *Tuple;
+  GenericTupleSize<TupleSize> NumComps;
+};
+
+//------------------------------------------------------------------------------
+template <typename ValueType, ComponentIdType TupleSize>
+struct TupleReference<vtkAOSDataArrayTemplate<ValueType>, TupleSize>
+{
+  typedef ValueType APIType;
+  typedef ValueType* iterator;
+  typedef const ValueType* const_iterator;
+  typedef ComponentIdType size_type;
+  typedef ValueType value_type;
+
+  TupleReference()
+    : Tuple(NULL)
+  {
+  }
+
+  TupleReference(ValueType *tuple, GenericTupleSize<TupleSize> numComps)
+    : Tuple(tuple), NumComps(numComps)
+  {
+  }
+
+  TupleReference(const TupleReference&) = default;
+
+  TupleReference& operator=(const TupleReference& other)
+  {
+    std::copy(other.cbegin(), other.cend(), this->begin());
+    return *this;
+  }
+
+  template <typename OtherTuple>
+  TupleReference& operator=(const OtherTuple& other)
+  {
+    assert("Tuples have the same size." &&
+           static_cast<size_type>(other.size()) == this->size());
+    std::copy(other.cbegin(), other.cend(), this->begin());
+    return *this;
+  }
+
+  operator ConstTupleReference<vtkAOSDataArrayTemplate<ValueType>,
+                               TupleSize>() const
+  {
+    return ConstTupleReference<vtkAOSDataArrayTemplate<ValueType>,
+                               TupleSize>(this->Tuple, this->NumComps);
+  }
+
+  size_type size() const { return this->NumComps.Get(); }
+
+  iterator begin() const { return this->Tuple; }
+  iterator end() const { return this->Tuple + this->NumComps.Get(); }
+  const_iterator cbegin() const { return this->Tuple; }
+  const_iterator cend() const { return this->Tuple + this->NumComps.Get(); }
+
+  ValueType& operator[](size_type i) const { return this->Tuple[i]; }
+
+  void GetTuple(ValueType *tuple) const
+  {
+    std::copy(this->cbegin(), this->cend(), tuple);
+  }
+
+  void SetTuple(const ValueType *tuple) const
+  {
+    std::copy(tuple, tuple + this->NumComps.Get(), this->begin());
+  }
+
+  void fill(const ValueType& value) const
+  {
+    std::fill(this->begin(), this->end(), value);
+  }
+
+  template <typename OtherTuple>
+  bool operator==(const OtherTuple& other) const
+  {
+    return this->size() == static_cast<size_type>(other.size()) &&
+           std::equal(this->cbegin(), this->cend(), other.cbegin());
+  }
+  template <typename OtherTuple>
+  bool operator!=(const OtherTuple& other) const
+  {
+    return !(*this == other);
+  }
+
+  friend void swap(TupleReference a, TupleReference b)
+  {
+    std::swap_ranges(a.begin(), a.end(), b.begin());
+  }
+
+  ValueType *Tuple;
+  GenericTupleSize<TupleSize> NumComps;
+};
+
+//------------------------------------------------------------------------------
+// ReferenceType is one of the two tuple references above, PointerType the
+// matching (const) ValueType pointer.
+template <typename ValueType, ComponentIdType TupleSize,
+          typename ReferenceType>
+struct TupleIterator<vtkAOSDataArrayTemplate<ValueType>, TupleSize,
+                     ReferenceType>
+{
+  typedef typename std::conditional<
+    std::is_same<ReferenceType, TupleReference<
+      vtkAOSDataArrayTemplate<ValueType>, TupleSize> >::value,
+    ValueType*, const ValueType*>::type PointerType;
+
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef ReferenceType value_type;
+  typedef TupleIdType difference_type;
+  typedef void pointer;
+  typedef ReferenceType reference;
+
+  TupleIterator()
+    : Tuple(NULL)
+  {
+  }
+
+  TupleIterator(PointerType tuple, GenericTupleSize<TupleSize> numComps)
+    : Tuple(tuple), NumComps(numComps)
+  {
+  }
+
+  reference operator*() const
+  {
+    return reference(this->Tuple, this->NumComps);
+  }
+  reference operator[](difference_type i) const
+  {
+    return reference(this->Tuple + i * this->NumComps.Get(), this->NumComps);
+  }
+
+  TupleIterator& operator++()
+  {
+    this->Tuple += this->NumComps.Get();
+    return *this;
+  }
+  TupleIterator operator++(int)
+  {
+    TupleIterator tmp(*this);
+    ++*this;
+    return tmp;
+  }
+  TupleIterator& operator--()
+  {
+    this->Tuple -= this->NumComps.Get();
+    return *this;
+  }
+  TupleIterator operator--(int)
+  {
+    TupleIterator tmp(*this);
+    --*this;
+    return tmp;
+  }
+  TupleIterator& operator+=(difference_type n)
+  {
+    this->Tuple += n * this->NumComps.Get();
+    return *this;
+  }
+  TupleIterator& operator-=(difference_type n)
+  {
+    this->Tuple -= n * this->NumComps.Get();
+    return *this;
+  }
+  friend TupleIterator operator+(TupleIterator it, difference_type n)
+  {
+    return it += n;
+  }
+  friend TupleIterator operator+(difference_type n, TupleIterator it)
+  {
+    return it += n;
+  }
+  friend TupleIterator operator-(TupleIterator it, difference_type n)
+  {
+    return it -= n;
+  }
+  friend difference_type operator-(const TupleIterator& a,
+                                   const TupleIterator& b)
+  {
+    return static_cast<difference_type>((a.Tuple - b.Tuple) /
+                                        a.NumComps.Get());
+  }
+
+  friend bool operator==(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.Tuple == b.Tuple;
+  }
+  friend bool operator!=(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.Tuple != b.Tuple;
+  }
+  friend bool operator<(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.Tuple < b.Tuple;
+  }
+  friend bool operator>(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.Tuple > b.Tuple;
+  }
+  friend bool operator<=(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.Tuple <= b.Tuple;
+  }
+  friend bool operator>=(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.Tuple >= b.Tuple;
+  }
+
+  PointerType Tuple;
+  GenericTupleSize<TupleSize> NumComps;
+};
+
+//------------------------------------------------------------------------------
+template <typename ValueType, ComponentIdType TupleSize>
+struct TupleRange<vtkAOSDataArrayTemplate<ValueType>, TupleSize>
+{
+  typedef vtkAOSDataArrayTemplate<ValueType> ArrayType;
+  typedef ValueType ComponentType;
+  typedef TupleReference<ArrayType, TupleSize> TupleReferenceType;
+  typedef ConstTupleReference<ArrayType, TupleSize> ConstTupleReferenceType;
+  typedef TupleIterator<ArrayType, TupleSize, TupleReferenceType>
+    TupleIteratorType;
+  typedef TupleIterator<ArrayType, TupleSize, ConstTupleReferenceType>
+    ConstTupleIteratorType;
+  typedef ValueType* ComponentIteratorType;
+  typedef const ValueType* ConstComponentIteratorType;
+  typedef ValueType& ComponentReferenceType;
+  typedef const ValueType& ConstComponentReferenceType;
+
+  typedef TupleIdType size_type;
+  typedef TupleIteratorType iterator;
+  typedef ConstTupleIteratorType const_iterator;
+  typedef TupleReferenceType reference;
+  typedef ConstTupleReferenceType const_reference;
+
+  TupleRange()
+    : Array(NULL), BeginTuple(0), EndTuple(0), Begin(NULL), End(NULL)
+  {
+  }
+
+  TupleRange(ArrayType *array, TupleIdType beginTuple, TupleIdType endTuple)
+    : Array(array), NumComps(array), BeginTuple(beginTuple),
+      EndTuple(endTuple),
+      Begin(array->GetPointer(beginTuple * this->NumComps.Get())),
+      End(array->GetPointer(endTuple * this->NumComps.Get()))
+  {
+    assert("Valid tuple range." && beginTuple >= 0 && beginTuple <= endTuple &&
+           endTuple <= array->GetNumberOfTuples());
+  }
+
+  ArrayType* GetArray() const { return this->Array; }
+  ComponentIdType GetTupleSize() const { return this->NumComps.Get(); }
+  TupleIdType GetBeginTupleId() const { return this->BeginTuple; }
+  TupleIdType GetEndTupleId() const { return this->EndTuple; }
+
+  size_type size() const { return this->EndTuple - this->BeginTuple; }
+
+  iterator begin() { return iterator(this->Begin, this->NumComps); }
+  iterator end() { return iterator(this->End, this->NumComps); }
+  const_iterator begin() const { return this->cbegin(); }
+  const_iterator end() const { return this->cend(); }
+  const_iterator cbegin() const
+  {
+    return const_iterator(this->Begin, this->NumComps);
+  }
+  const_iterator cend() const
+  {
+    return const_iterator(this->End, this->NumComps);
+  }
+
+  reference operator[](size_type i)
+  {
+    return reference(this->Begin + i * this->NumComps.Get(), this->NumComps);
+  }
+  const_reference operator[](size_type i) const
+  {
+    return const_reference(this->Begin + i * this->NumComps.Get(),
+                           this->NumComps);
+  }
+
+private:
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  TupleIdType BeginTuple;
+  TupleIdType EndTuple;
+  ValueType *Begin;
+  ValueType *End;
+};
+
+} // end namespace detail
+} // end namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif // vtkDataArrayTupleRange_AOS_h
+// VTK-HeaderTest-Exclude: vtkDataArrayTupleRange_AOS.h
@@ -0,0 +1,618 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayTupleRange_Generic.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Generic implementation of the tuple range, see vtkDataArrayRange.h. The
+// components are accessed through vtkDataArrayAccessor, i.e. with the
+// inlined GetTypedComponent/SetTypedComponent of vtkGenericDataArray
+// subclasses (e.g. the per-component buffers of vtkSOADataArrayTemplate), or
+// with the double API of vtkDataArray. The references are proxy objects.
+
+#ifndef vtkDataArrayTupleRange_Generic_h
+#define vtkDataArrayTupleRange_Generic_h
+
+#include "vtkDataArrayAccessor.h"
+#include "vtkDataArrayMeta.h"
+
+#include <algorithm>
+#include <iterator>
+
+#ifndef __VTK_WRAP__
+
+namespace vtk
+{
+namespace detail
+{
+
+//------------------------------------------------------------------------------
+// Read-only reference to a component of a tuple.
+template <typename ArrayType, ComponentIdType TupleSize>
+struct ConstComponentReference
+{
+  typedef typename GetAPIType<ArrayType>::type APIType;
+
+  ConstComponentReference()
+    : Array(NULL), TupleId(0), ComponentId(0)
+  {
+  }
+
+  ConstComponentReference(ArrayType *array, TupleIdType tupleId,
+                          ComponentIdType compId)
+    : Array(array), TupleId(tupleId), ComponentId(compId)
+  {
+  }
+
+  operator APIType() const
+  {
+    return vtkDataArrayAccessor<ArrayType>(this->Array).Get(
+      this->TupleId, this->ComponentId);
+  }
+
+  ArrayType *Array;
+  TupleIdType TupleId;
+  ComponentIdType ComponentId;
+};
+
+//------------------------------------------------------------------------------
+// Reference to a component of a tuple. Like the reference of
+// std::vector<bool>, assigning to it writes the array.
+template <typename ArrayType, ComponentIdType TupleSize>
+struct ComponentReference
+{
+  typedef typename GetAPIType<ArrayType>::type APIType;
+
+  ComponentReference()
+    : Array(NULL), TupleId(0), ComponentId(0)
+  {
+  }
+
+  ComponentReference(ArrayType *array, TupleIdType tupleId,
+                     ComponentIdType compId)
+    : Array(array), TupleId(tupleId), ComponentId(compId)
+  {
+  }
+
+  ComponentReference(const ComponentReference&) = default;
+
+  ComponentReference& operator=(const ComponentReference& other)
+  {
+    return *this = static_cast<APIType>(other);
+  }
+
+  ComponentReference& operator=(APIType value)
+  {
+    vtkDataArrayAccessor<ArrayType>(this->Array).Set(
+      this->TupleId, this->ComponentId, value);
+    return *this;
+  }
+
+  operator APIType() const
+  {
+    return vtkDataArrayAccessor<ArrayType>(this->Array).Get(
+      this->TupleId, this->ComponentId);
+  }
+
+  ComponentReference& operator+=(APIType value)
+  {
+    return *this = static_cast<APIType>(*this) + value;
+  }
+  ComponentReference& operator-=(APIType value)
+  {
+    return *this = static_cast<APIType>(*this) - value;
+  }
+  ComponentReference& operator*=(APIType value)
+  {
+    return *this = static_cast<APIType>(*this) * value;
+  }
+  ComponentReference& operator/=(APIType value)
+  {
+    return *this = static_cast<APIType>(*this) / value;
+  }
+
+  friend void swap(ComponentReference a, ComponentReference b)
+  {
+    APIType tmp = a;
+    a = static_cast<APIType>(b);
+    b = tmp;
+  }
+
+  ArrayType *Array;
+  TupleIdType TupleId;
+  ComponentIdType ComponentId;
+};
+
+//------------------------------------------------------------------------------
+// Random access iterator over the components of a tuple. ReferenceType is
+// one of the two component references above.
+template <typename ArrayType, ComponentIdType TupleSize,
+          typename ReferenceType>
+struct ComponentIterator
+{
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef typename GetAPIType<ArrayType>::type value_type;
+  typedef ComponentIdType difference_type;
+  typedef void pointer;
+  typedef ReferenceType reference;
+
+  ComponentIterator()
+    : Array(NULL), TupleId(0), ComponentId(0)
+  {
+  }
+
+  ComponentIterator(ArrayType *array, TupleIdType tupleId,
+                    ComponentIdType compId)
+    : Array(array), TupleId(tupleId), ComponentId(compId)
+  {
+  }
+
+  reference operator*() const
+  {
+    return reference(this->Array, this->TupleId, this->ComponentId);
+  }
+  reference operator[](difference_type i) const
+  {
+    return reference(this->Array, this->TupleId, this->ComponentId + i);
+  }
+
+  ComponentIterator& operator++() { ++this->ComponentId; return *this; }
+  ComponentIterator operator++(int)
+  {
+    ComponentIterator tmp(*this);
+    ++this->ComponentId;
+    return tmp;
+  }
+  ComponentIterator& operator--() { --this->ComponentId; return *this; }
+  ComponentIterator operator--(int)
+  {
+    ComponentIterator tmp(*this);
+    --this->ComponentId;
+    return tmp;
+  }
+  ComponentIterator& operator+=(difference_type n)
+  {
+    this->ComponentId += n;
+    return *this;
+  }
+  ComponentIterator& operator-=(difference_type n)
+  {
+    this->ComponentId -= n;
+    return *this;
+  }
+  friend ComponentIterator operator+(ComponentIterator it, difference_type n)
+  {
+    return it += n;
+  }
+  friend ComponentIterator operator+(difference_type n, ComponentIterator it)
+  {
+    return it += n;
+  }
+  friend ComponentIterator operator-(ComponentIterator it, difference_type n)
+  {
+    return it -= n;
+  }
+  friend difference_type operator-(const ComponentIterator& a,
+                                   const ComponentIterator& b)
+  {
+    return a.ComponentId - b.ComponentId;
+  }
+
+  friend bool operator==(const ComponentIterator& a, const ComponentIterator& b)
+  {
+    return a.Array == b.Array && a.TupleId == b.TupleId &&
+           a.ComponentId == b.ComponentId;
+  }
+  friend bool operator!=(const ComponentIterator& a, const ComponentIterator& b)
+  {
+    return !(a == b);
+  }
+  friend bool operator<(const ComponentIterator& a, const ComponentIterator& b)
+  {
+    return a.ComponentId < b.ComponentId;
+  }
+  friend bool operator>(const ComponentIterator& a, const ComponentIterator& b)
+  {
+    return b < a;
+  }
+  friend bool operator<=(const ComponentIterator& a, const ComponentIterator& b)
+  {
+    return !(b < a);
+  }
+  friend bool operator>=(const ComponentIterator& a, const ComponentIterator& b)
+  {
+    return !(a < b);
+  }
+
+  ArrayType *Array;
+  TupleIdType TupleId;
+  ComponentIdType ComponentId;
+};
+
+//------------------------------------------------------------------------------
+// Read-only reference to a tuple, usable as a range of components.
+template <typename ArrayType, ComponentIdType TupleSize>
+struct ConstTupleReference
+{
+  typedef typename GetAPIType<ArrayType>::type APIType;
+  typedef ComponentIterator<ArrayType, TupleSize,
+    ConstComponentReference<ArrayType, TupleSize> > const_iterator;
+  typedef const_iterator iterator;
+  typedef ComponentIdType size_type;
+  typedef APIType value_type;
+
+  ConstTupleReference()
+    : Array(NULL), TupleId(0)
+  {
+  }
+
+  ConstTupleReference(ArrayType *array, GenericTupleSize<TupleSize> numComps,
+                      TupleIdType tupleId)
+    : Array(array), NumComps(numComps), TupleId(tupleId)
+  {
+  }
+
+  size_type size() const { return this->NumComps.Get(); }
+
+  const_iterator begin() const { return this->cbegin(); }
+  const_iterator end() const { return this->cend(); }
+  const_iterator cbegin() const
+  {
+    return const_iterator(this->Array, this->TupleId, 0);
+  }
+  const_iterator cend() const
+  {
+    return const_iterator(this->Array, this->TupleId, this->NumComps.Get());
+  }
+
+  APIType operator[](size_type i) const
+  {
+    return vtkDataArrayAccessor<ArrayType>(this->Array).Get(this->TupleId, i);
+  }
+
+  void GetTuple(APIType *tuple) const
+  {
+    vtkDataArrayAccessor<ArrayType> accessor(this->Array);
+    for (ComponentIdType c = 0; c < this->NumComps.Get(); ++c)
+    {
+      tuple[c] = accessor.Get(this->TupleId, c);
+    }
+  }
+
+  // Element-wise comparison with any tuple.
+  template <typename OtherTuple>
+  bool operator==(const OtherTuple& other) const
+  {
+    return this->size() == static_cast<size_type>(other.size()) &&
+           std::equal(this->cbegin(), this->cend(), other.cbegin());
+  }
+  template <typename OtherTuple>
+  bool operator!=(const OtherTuple& other) const
+  {
+    return !(*this == other);
+  }
+
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  TupleIdType TupleId;
+};
+
+//------------------------------------------------------------------------------
+// Reference to a tuple, usable as a range of components. Assigning a tuple
+// to it copies the components.
+template <typename ArrayType, ComponentIdType TupleSize>
+struct TupleReference
+{
+  typedef typename GetAPIType<ArrayType>::type APIType;
+  typedef ComponentIterator<ArrayType, TupleSize,
+    ComponentReference<ArrayType, TupleSize> > iterator;
+  typedef ComponentIterator<ArrayType, TupleSize,
+    ConstComponentReference<ArrayType, TupleSize> > const_iterator;
+  typedef ComponentIdType size_type;
+  typedef APIType value_type;
+
+  TupleReference()
+    : Array(NULL), TupleId(0)
+  {
+  }
+
+  TupleReference(ArrayType *array, GenericTupleSize<TupleSize> numComps,
+                 TupleIdType tupleId)
+    : Array(array), NumComps(numComps), TupleId(tupleId)
+  {
+  }
+
+  TupleReference(const TupleReference&) = default;
+
+  TupleReference& operator=(const TupleReference& other)
+  {
+    std::copy(other.cbegin(), other.cend(), this->begin());
+    return *this;
+  }
+
+  // Copy the components of any tuple of the same size.
+  template <typename OtherTuple>
+  TupleReference& operator=(const OtherTuple& other)
+  {
+    assert("Tuples have the same size." &&
+           static_cast<size_type>(other.size()) == this->size());
+    std::copy(other.cbegin(), other.cend(), this->begin());
+    return *this;
+  }
+
+  operator ConstTupleReference<ArrayType, TupleSize>() const
+  {
+    return ConstTupleReference<ArrayType, TupleSize>(
+      this->Array, this->NumComps, this->TupleId);
+  }
+
+  size_type size() const { return this->NumComps.Get(); }
+
+  iterator begin() const
+  {
+    return iterator(this->Array, this->TupleId, 0);
+  }
+  iterator end() const
+  {
+    return iterator(this->Array, this->TupleId, this->NumComps.Get());
+  }
+  const_iterator cbegin() const
+  {
+    return const_iterator(this->Array, this->TupleId, 0);
+  }
+  const_iterator cend() const
+  {
+    return const_iterator(this->Array, this->TupleId, this->NumComps.Get());
+  }
+
+  ComponentReference<ArrayType, TupleSize> operator[](size_type i) const
+  {
+    return ComponentReference<ArrayType, TupleSize>(
+      this->Array, this->TupleId, i);
+  }
+
+  void GetTuple(APIType *tuple) const
+  {
+    vtkDataArrayAccessor<ArrayType> accessor(this->Array);
+    for (ComponentIdType c = 0; c < this->NumComps.Get(); ++c)
+    {
+      tuple[c] = accessor.Get(this->TupleId, c);
+    }
+  }
+
+  void SetTuple(const APIType *tuple) const
+  {
+    vtkDataArrayAccessor<ArrayType> accessor(this->Array);
+    for (ComponentIdType c = 0; c < this->NumComps.Get(); ++c)
+    {
+      accessor.Set(this->TupleId, c, tuple[c]);
+    }
+  }
+
+  void fill(const APIType& value) const
+  {
+    std::fill(this->begin(), this->end(), value);
+  }
+
+  template <typename OtherTuple>
+  bool operator==(const OtherTuple& other) const
+  {
+    return this->size() == static_cast<size_type>(other.size()) &&
+           std::equal(this->cbegin(), this->cend(), other.cbegin());
+  }
+  template <typename OtherTuple>
+  bool operator!=(const OtherTuple& other) const
+  {
+    return !(*this == other);
+  }
+
+  friend void swap(TupleReference a, TupleReference b)
+  {
+    std::swap_ranges(a.begin(), a.end(), b.begin());
+  }
+
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  TupleIdType TupleId;
+};
+
+//------------------------------------------------------------------------------
+// Random access iterator over the tuples of an array. ReferenceType is one
+// of the two tuple references above.
+template <typename ArrayType, ComponentIdType TupleSize,
+          typename ReferenceType>
+struct TupleIterator
+{
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef ReferenceType value_type;
+  typedef TupleIdType difference_type;
+  typedef void pointer;
+  typedef ReferenceType reference;
+
+  TupleIterator()
+    : Array(NULL), TupleId(0)
+  {
+  }
+
+  TupleIterator(ArrayType *array, GenericTupleSize<TupleSize> numComps,
+                TupleIdType tupleId)
+    : Array(array), NumComps(numComps), TupleId(tupleId)
+  {
+  }
+
+  reference operator*() const
+  {
+    return reference(this->Array, this->NumComps, this->TupleId);
+  }
+  reference operator[](difference_type i) const
+  {
+    return reference(this->Array, this->NumComps, this->TupleId + i);
+  }
+
+  TupleIterator& operator++() { ++this->TupleId; return *this; }
+  TupleIterator operator++(int)
+  {
+    TupleIterator tmp(*this);
+    ++this->TupleId;
+    return tmp;
+  }
+  TupleIterator& operator--() { --this->TupleId; return *this; }
+  TupleIterator operator--(int)
+  {
+    TupleIterator tmp(*this);
+    --this->TupleId;
+    return tmp;
+  }
+  TupleIterator& operator+=(difference_type n)
+  {
+    this->TupleId += n;
+    return *this;
+  }
+  TupleIterator& operator-=(difference_type n)
+  {
+    this->TupleId -= n;
+    return *this;
+  }
+  friend TupleIterator operator+(TupleIterator it, difference_type n)
+  {
+    return it += n;
+  }
+  friend TupleIterator operator+(difference_type n, TupleIterator it)
+  {
+    return it += n;
+  }
+  friend TupleIterator operator-(TupleIterator it, difference_type n)
+  {
+    return it -= n;
+  }
+  friend difference_type operator-(const TupleIterator& a,
+                                   const TupleIterator& b)
+  {
+    return a.TupleId - b.TupleId;
+  }
+
+  friend bool operator==(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.Array == b.Array && a.TupleId == b.TupleId;
+  }
+  friend bool operator!=(const TupleIterator& a, const TupleIterator& b)
+  {
+    return !(a == b);
+  }
+  friend bool operator<(const TupleIterator& a, const TupleIterator& b)
+  {
+    return a.TupleId < b.TupleId;
+  }
+  friend bool operator>(const TupleIterator& a, const TupleIterator& b)
+  {
+    return b < a;
+  }
+  friend bool operator<=(const TupleIterator& a, const TupleIterator& b)
+  {
+    return !(b < a);
+  }
+  friend bool operator>=(const TupleIterator& a, const TupleIterator& b)
+  {
+    return !(a < b);
+  }
+
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  TupleIdType TupleId;
+};
+
+//------------------------------------------------------------------------------
+// Range over the tuples [BeginTuple, EndTuple) of an array.
+template <typename ArrayType, ComponentIdType TupleSize>
+struct TupleRange
+{
+  typedef typename GetAPIType<ArrayType>::type ComponentType;
+  typedef TupleReference<ArrayType, TupleSize> TupleReferenceType;
+  typedef ConstTupleReference<ArrayType, TupleSize> ConstTupleReferenceType;
+  typedef TupleIterator<ArrayType, TupleSize, TupleReferenceType>
+    TupleIteratorType;
+  typedef TupleIterator<ArrayType, TupleSize, ConstTupleReferenceType>
+    ConstTupleIteratorType;
+  typedef typename TupleReferenceType::iterator ComponentIteratorType;
+  typedef typename TupleReferenceType::const_iterator
+    ConstComponentIteratorType;
+  typedef ComponentReference<ArrayType, TupleSize> ComponentReferenceType;
+  typedef ConstComponentReference<ArrayType, TupleSize>
+    ConstComponentReferenceType;
+
+  typedef TupleIdType size_type;
+  typedef TupleIteratorType iterator;
+  typedef ConstTupleIteratorType const_iterator;
+  typedef TupleReferenceType reference;
+  typedef ConstTupleReferenceType const_reference;
+
+  TupleRange()
+    : Array(NULL), BeginTuple(0), EndTuple(0)
+  {
+  }
+
+  TupleRange(ArrayType *array, TupleIdType beginTuple, TupleIdType endTuple)
+    : Array(array), NumComps(array), BeginTuple(beginTuple),
+      EndTuple(endTuple)
+  {
+    assert("Valid tuple range." && beginTuple >= 0 && beginTuple <= endTuple &&
+           endTuple <= array->GetNumberOfTuples());
+  }
+
+  ArrayType* GetArray() const { return this->Array; }
+  ComponentIdType GetTupleSize() const { return this->NumComps.Get(); }
+  TupleIdType GetBeginTupleId() const { return this->BeginTuple; }
+  TupleIdType GetEndTupleId() const { return this->EndTuple; }
+
+  size_type size() const { return this->EndTuple - this->BeginTuple; }
+
+  iterator begin()
+  {
+    return iterator(this->Array, this->NumComps, this->BeginTuple);
+  }
+  iterator end()
+  {
+    return iterator(this->Array, this->NumComps, this->EndTuple);
+  }
+  const_iterator begin() const { return this->cbegin(); }
+  const_iterator end() const { return this->cend(); }
+  const_iterator cbegin() const
+  {
+    return const_iterator(this->Array, this->NumComps, this->BeginTuple);
+  }
+  const_iterator cend() const
+  {
+    return const_iterator(this->Array, this->NumComps, this->EndTuple);
+  }
+
+  reference operator[](size_type i)
+  {
+    return reference(this->Array, this->NumComps, this->BeginTuple + i);
+  }
+  const_reference operator[](size_type i) const
+  {
+    return const_reference(this->Array, this->NumComps, this->BeginTuple + i);
+  }
+
+private:
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  TupleIdType BeginTuple;
+  TupleIdType EndTuple;
+};
+
+} // end namespace detail
+} // end namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif // vtkDataArrayTupleRange_Generic_h
+// VTK-HeaderTest-Exclude: vtkDataArrayTupleRange_Generic.h
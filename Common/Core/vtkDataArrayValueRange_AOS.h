@@ -0,0 +1,97 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayValueRange_AOS.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Specialization of the value range for vtkAOSDataArrayTemplate, see
+// vtkDataArrayRange.h. The iterators are raw pointers.
+
+#ifndef vtkDataArrayValueRange_AOS_h
+#define vtkDataArrayValueRange_AOS_h
+
+#include "vtkAOSDataArrayTemplate.h"
+#include "vtkDataArrayMeta.h"
+#include "vtkDataArrayValueRange_Generic.h"
+
+#ifndef __VTK_WRAP__
+
+namespace vtk
+{
+namespace detail
+{
+
+//------------------------------------------------------------------------------
+template <typename ValueTypeT, ComponentIdType TupleSize>
+struct ValueRange<vtkAOSDataArrayTemplate<ValueTypeT>, TupleSize>
+{
+  typedef vtkAOSDataArrayTemplate<ValueTypeT> ArrayType;
+  typedef ValueTypeT ValueType;
+  typedef ValueType& ReferenceType;
+  typedef const ValueType& ConstReferenceType;
+  typedef ValueType* IteratorType;
+  typedef const ValueType* ConstIteratorType;
+
+  typedef ValueIdType size_type;
+  typedef ValueType value_type;
+  typedef IteratorType iterator;
+  typedef ConstIteratorType const_iterator;
+  typedef ReferenceType reference;
+  typedef ConstReferenceType const_reference;
+
+  ValueRange()
+    : Array(NULL), BeginValue(0), EndValue(0), Begin(NULL), End(NULL)
+  {
+  }
+
+  ValueRange(ArrayType *array, ValueIdType beginValue, ValueIdType endValue)
+    : Array(array), NumComps(array), BeginValue(beginValue),
+      EndValue(endValue), Begin(array->GetPointer(beginValue)),
+      End(array->GetPointer(endValue))
+  {
+    assert("Valid value range." && beginValue >= 0 &&
+           beginValue <= endValue &&
+           endValue <= array->GetNumberOfTuples() * this->NumComps.Get());
+  }
+
+  ArrayType* GetArray() const { return this->Array; }
+  ComponentIdType GetTupleSize() const { return this->NumComps.Get(); }
+  ValueIdType GetBeginValueId() const { return this->BeginValue; }
+  ValueIdType GetEndValueId() const { return this->EndValue; }
+
+  size_type size() const { return this->EndValue - this->BeginValue; }
+
+  iterator begin() { return this->Begin; }
+  iterator end() { return this->End; }
+  const_iterator begin() const { return this->Begin; }
+  const_iterator end() const { return this->End; }
+  const_iterator cbegin() const { return this->Begin; }
+  const_iterator cend() const { return this->End; }
+
+  reference operator[](size_type i) { return this->Begin[i]; }
+  const_reference operator[](size_type i) const { return this->Begin[i]; }
+
+private:
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  ValueIdType BeginValue;
+  ValueIdType EndValue;
+  ValueType *Begin;
+  ValueType *End;
+};
+
+} // end namespace detail
+} // end namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif // vtkDataArrayValueRange_AOS_h
+// VTK-HeaderTest-Exclude: vtkDataArrayValueRange_AOS.h
@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayValueRange_Generic.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Generic implementation of the value range, see vtkDataArrayRange.h. The
+// iterators keep track of the tuple and component of the current value so
+// that walking the range does not need any division, and the references
+// are the component references of the tuple range.
+
+#ifndef vtkDataArrayValueRange_Generic_h
+#define vtkDataArrayValueRange_Generic_h
+
+#include "vtkDataArrayMeta.h"
+#include "vtkDataArrayTupleRange_Generic.h"
+
+#include <iterator>
+
+#ifndef __VTK_WRAP__
+
+namespace vtk
+{
+namespace detail
+{
+
+//------------------------------------------------------------------------------
+// Random access iterator over the values of an array. ReferenceType is
+// ComponentReference or ConstComponentReference.
+template <typename ArrayType, ComponentIdType TupleSize,
+          typename ReferenceType>
+struct ValueIterator
+{
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef typename GetAPIType<ArrayType>::type value_type;
+  typedef ValueIdType difference_type;
+  typedef void pointer;
+  typedef ReferenceType reference;
+
+  ValueIterator()
+    : Array(NULL), TupleId(0), ComponentId(0)
+  {
+  }
+
+  ValueIterator(ArrayType *array, GenericTupleSize<TupleSize> numComps,
+                ValueIdType valueId)
+    : Array(array), NumComps(numComps)
+  {
+    this->SetValueId(valueId);
+  }
+
+  ValueIdType GetValueId() const
+  {
+    return this->TupleId * this->NumComps.Get() + this->ComponentId;
+  }
+
+  void SetValueId(ValueIdType valueId)
+  {
+    const ComponentIdType numComps = this->NumComps.Get();
+    this->TupleId = numComps > 0 ? valueId / numComps : 0;
+    this->ComponentId = static_cast<ComponentIdType>(
+      valueId - this->TupleId * numComps);
+  }
+
+  reference operator*() const
+  {
+    return reference(this->Array, this->TupleId, this->ComponentId);
+  }
+  reference operator[](difference_type i) const
+  {
+    ValueIterator it(*this);
+    it += i;
+    return *it;
+  }
+
+  ValueIterator& operator++()
+  {
+    if (++this->ComponentId == this->NumComps.Get())
+    {
+      this->ComponentId = 0;
+      ++this->TupleId;
+    }
+    return *this;
+  }
+  ValueIterator operator++(int)
+  {
+    ValueIterator tmp(*this);
+    ++*this;
+    return tmp;
+  }
+  ValueIterator& operator--()
+  {
+    if (this->ComponentId-- == 0)
+    {
+      this->ComponentId = this->NumComps.Get() - 1;
+      --this->TupleId;
+    }
+    return *this;
+  }
+  ValueIterator operator--(int)
+  {
+    ValueIterator tmp(*this);
+    --*this;
+    return tmp;
+  }
+  ValueIterator& operator+=(difference_type n)
+  {
+    this->SetValueId(this->GetValueId() + n);
+    return *this;
+  }
+  ValueIterator& operator-=(difference_type n)
+  {
+    this->SetValueId(this->GetValueId() - n);
+    return *this;
+  }
+  friend ValueIterator operator+(ValueIterator it, difference_type n)
+  {
+    return it += n;
+  }
+  friend ValueIterator operator+(difference_type n, ValueIterator it)
+  {
+    return it += n;
+  }
+  friend ValueIterator operator-(ValueIterator it, difference_type n)
+  {
+    return it -= n;
+  }
+  friend difference_type operator-(const ValueIterator& a,
+                                   const ValueIterator& b)
+  {
+    return a.GetValueId() - b.GetValueId();
+  }
+
+  friend bool operator==(const ValueIterator& a, const ValueIterator& b)
+  {
+    return a.Array == b.Array && a.TupleId == b.TupleId &&
+           a.ComponentId == b.ComponentId;
+  }
+  friend bool operator!=(const ValueIterator& a, const ValueIterator& b)
+  {
+    return !(a == b);
+  }
+  friend bool operator<(const ValueIterator& a, const ValueIterator& b)
+  {
+    return a.TupleId < b.TupleId ||
+           (a.TupleId == b.TupleId && a.ComponentId < b.ComponentId);
+  }
+  friend bool operator>(const ValueIterator& a, const ValueIterator& b)
+  {
+    return b < a;
+  }
+  friend bool operator<=(const ValueIterator& a, const ValueIterator& b)
+  {
+    return !(b < a);
+  }
+  friend bool operator>=(const ValueIterator& a, const ValueIterator& b)
+  {
+    return !(a < b);
+  }
+
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  TupleIdType TupleId;
+  ComponentIdType ComponentId;
+};
+
+//------------------------------------------------------------------------------
+// Range over the values [BeginValue, EndValue) of an array, in the order of
+// GetValue(): all the components of the first tuple, then of the second...
+template <typename ArrayType, ComponentIdType TupleSize>
+struct ValueRange
+{
+  typedef typename GetAPIType<ArrayType>::type ValueType;
+  typedef ComponentReference<ArrayType, TupleSize> ReferenceType;
+  typedef ConstComponentReference<ArrayType, TupleSize> ConstReferenceType;
+  typedef ValueIterator<ArrayType, TupleSize, ReferenceType> IteratorType;
+  typedef ValueIterator<ArrayType, TupleSize, ConstReferenceType>
+    ConstIteratorType;
+
+  typedef ValueIdType size_type;
+  typedef ValueType value_type;
+  typedef IteratorType iterator;
+  typedef ConstIteratorType const_iterator;
+  typedef ReferenceType reference;
+  typedef ConstReferenceType const_reference;
+
+  ValueRange()
+    : Array(NULL), BeginValue(0), EndValue(0)
+  {
+  }
+
+  ValueRange(ArrayType *array, ValueIdType beginValue, ValueIdType endValue)
+    : Array(array), NumComps(array), BeginValue(beginValue),
+      EndValue(endValue)
+  {
+    assert("Valid value range." && beginValue >= 0 &&
+           beginValue <= endValue &&
+           endValue <= array->GetNumberOfTuples() * this->NumComps.Get());
+  }
+
+  ArrayType* GetArray() const { return this->Array; }
+  ComponentIdType GetTupleSize() const { return this->NumComps.Get(); }
+  ValueIdType GetBeginValueId() const { return this->BeginValue; }
+  ValueIdType GetEndValueId() const { return this->EndValue; }
+
+  size_type size() const { return this->EndValue - this->BeginValue; }
+
+  iterator begin()
+  {
+    return iterator(this->Array, this->NumComps, this->BeginValue);
+  }
+  iterator end()
+  {
+    return iterator(this->Array, this->NumComps, this->EndValue);
+  }
+  const_iterator begin() const { return this->cbegin(); }
+  const_iterator end() const { return this->cend(); }
+  const_iterator cbegin() const
+  {
+    return const_iterator(this->Array, this->NumComps, this->BeginValue);
+  }
+  const_iterator cend() const
+  {
+    return const_iterator(this->Array, this->NumComps, this->EndValue);
+  }
+
+  reference operator[](size_type i)
+  {
+    return this->begin()[i];
+  }
+  const_reference operator[](size_type i) const
+  {
+    return this->cbegin()[i];
+  }
+
+private:
+  ArrayType *Array;
+  GenericTupleSize<TupleSize> NumComps;
+  ValueIdType BeginValue;
+  ValueIdType EndValue;
+};
+
+} // end namespace detail
+} // end namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif // vtkDataArrayValueRange_Generic_h
+// VTK-HeaderTest-Exclude: vtkDataArrayValueRange_Generic.h
@@ -15,17 +15,18 @@
 
 #include "vtkSMPThreadLocalImpl.h"
 
-#include <omp.h>
-
 #include <algorithm>
 
+namespace vtk
+{
 namespace detail
 {
+namespace smp
+{
 
 static ThreadIdType GetThreadId()
 {
-  static int threadPrivateData;
-#pragma omp threadprivate(threadPrivateData)
+  static thread_local char threadPrivateData;
   return &threadPrivateData;
 }
 
@@ -49,60 +50,9 @@ inline HashType GetHash(ThreadIdType id)
 }
 
 
-class LockGuard
-{
-public:
-  LockGuard(omp_lock_t &lock, bool wait) : Lock(lock), Status(0)
-  {
-    if (wait)
-    {
-      omp_set_lock(&this->Lock);
-      this->Status = 1;
-    }
-    else
-    {
-      this->Status = omp_test_lock(&this->Lock);
-    }
-  }
-
-  bool Success() const
-  {
-    return this->Status != 0;
-  }
-
-  void Release()
-  {
-    if (this->Status)
-    {
-      omp_unset_lock(&this->Lock);
-      this->Status = 0;
-    }
-  }
-
-  ~LockGuard()
-  {
-    this->Release();
-  }
-
-private:
-  // not copyable
-  LockGuard(const LockGuard&);
-  void operator=(const LockGuard&);
-
-  omp_lock_t &Lock;
-  int Status;
-};
-
-
 Slot::Slot()
   : ThreadId(0), Storage(0)
 {
-  omp_init_lock(&this->ModifyLock);
-}
-
-Slot::~Slot()
-{
-  omp_destroy_lock(&this->ModifyLock);
 }
 
 
@@ -130,7 +80,7 @@ static Slot* LookupSlot(HashTableArray *array, ThreadIdType threadId,
   size_t mask = array->Size - 1u;
   Slot *slot = NULL;
 
-  // since load factor is maintained bellow 0.5, this loop should hit an
+  // since load factor is maintained below 0.5, this loop should hit an
   // empty slot if the queried slot does not exist in this array
   for (size_t idx = hash & mask; ; idx = (idx + 1) & mask) // linear probing
   {
@@ -167,8 +117,8 @@ static Slot* AcquireSlot(HashTableArray *array, ThreadIdType threadId,
     if (!slotThreadId) // unused?
     {
       // empty slot means threadId does not exist, try to acquire the slot
-      LockGuard lguard(slot->ModifyLock, false); // try to get exclusive access
-      if (lguard.Success())
+      std::unique_lock<std::mutex> lguard(slot->ModifyLock, std::try_to_lock);
+      if (lguard.owns_lock())
       {
         size_t size = ++array->NumberOfEntries; // atomic
         if ((size * 2) > array->Size) // load factor is above threshold
@@ -255,7 +205,7 @@ StoragePointerType& ThreadSpecific::GetStorage()
     slot = AcquireSlot(array, threadId, hash, firstAccess);
     if (!slot) // not enough room, resize
     {
-#     pragma omp critical (HashTableResize)
+      std::lock_guard<std::mutex> lguard(this->ResizeLock);
       if (this->Root == array)
       {
         HashTableArray *newArray = new HashTableArray(array->SizeLg + 1);
@@ -271,4 +221,6 @@ StoragePointerType& ThreadSpecific::GetStorage()
   return slot->Storage;
 }
 
+} // smp
 } // detail
+} // vtk
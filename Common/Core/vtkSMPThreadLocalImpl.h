@@ -28,6 +28,11 @@
 // faster lookup next time. The ThreadSpecific::GetStorage() function is thread
 // safe and only blocks when a new array needs to be allocated, which should be
 // rare.
+//
+// The Thread Id is the address of a C++11 thread_local variable. This does
+// not depend on the threading library that created the thread, so the same
+// storage is shared by all vtkSMPTools back-ends, including when the back-end
+// is changed at run-time.
 
 #ifndef vtkSMPThreadLocalImpl_h
 #define vtkSMPThreadLocalImpl_h
@@ -37,11 +42,14 @@
 #include "vtkConfigure.h"
 #include "vtkSystemIncludes.h"
 
-#include <omp.h>
-
+#include <mutex> // For std::mutex
 
+namespace vtk
+{
 namespace detail
 {
+namespace smp
+{
 
 typedef void* ThreadIdType;
 typedef vtkTypeUInt32 HashType;
@@ -51,11 +59,10 @@ typedef void* StoragePointerType;
 struct Slot
 {
   vtkAtomic<ThreadIdType> ThreadId;
-  omp_lock_t ModifyLock;
+  std::mutex ModifyLock;
   StoragePointerType Storage;
 
   Slot();
-  ~Slot();
 
 private:
   // not copyable
@@ -93,6 +100,7 @@ public:
 private:
   vtkAtomic<HashTableArray*> Root;
   vtkAtomic<size_t> Count;
+  std::mutex ResizeLock;
 
   friend class ThreadSpecificStorageIterator;
 };
@@ -182,7 +190,9 @@ private:
   size_t CurrentSlot;
 };
 
-} // detail;
+} // smp
+} // detail
+} // vtk
 
 #endif
 // VTK-HeaderTest-Exclude: vtkSMPThreadLocalImpl.h
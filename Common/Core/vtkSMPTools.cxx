@@ -0,0 +1,312 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+using namespace vtk::detail::smp;
+
+namespace
+{
+
+const char *vtkSMPBackendNames[NumberOfBackends] =
+  { "Sequential", "STDThread", "OpenMP", "TBB" };
+
+//--------------------------------------------------------------------------------
+bool vtkSMPIsBackendAvailable(int backend)
+{
+  switch (backend)
+  {
+    case SequentialBackend:
+      return true;
+#ifdef VTK_SMP_ENABLE_STDTHREAD
+    case STDThreadBackend:
+      return true;
+#endif
+#ifdef VTK_SMP_ENABLE_OPENMP
+    case OpenMPBackend:
+      return true;
+#endif
+#ifdef VTK_SMP_ENABLE_TBB
+    case TBBBackend:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+//--------------------------------------------------------------------------------
+// Returns -1 if the name does not match an available back-end.
+int vtkSMPGetBackendFromName(const char *name)
+{
+  if (!name)
+  {
+    return -1;
+  }
+  for (int i = 0; i < NumberOfBackends; ++i)
+  {
+    if (strcmp(name, vtkSMPBackendNames[i]) == 0)
+    {
+      return vtkSMPIsBackendAvailable(i) ? i : -1;
+    }
+  }
+  return -1;
+}
+
+//--------------------------------------------------------------------------------
+// Back-end used by all threads that are not inside a vtkSMPTools::LocalScope.
+// It is initialized from the VTK_SMP_BACKEND_IN_USE environment variable,
+// falling back to the configure time VTK_SMP_IMPLEMENTATION_TYPE.
+int vtkSMPGetDefaultBackend()
+{
+  int backend = vtkSMPGetBackendFromName(getenv("VTK_SMP_BACKEND_IN_USE"));
+  if (backend < 0)
+  {
+    backend = vtkSMPGetBackendFromName(VTK_SMP_BACKEND);
+  }
+  return backend < 0 ? SequentialBackend : backend;
+}
+
+std::atomic<int> vtkSMPGlobalBackend(vtkSMPGetDefaultBackend());
+
+// Per thread overrides installed by vtkSMPToolsScope. -1 and 0 mean unset.
+thread_local int vtkSMPLocalBackend = -1;
+thread_local int vtkSMPLocalMaxNumberOfThreads = 0;
+
+std::once_flag vtkSMPInitializeFromEnvironmentFlag;
+
+//--------------------------------------------------------------------------------
+void vtkSMPSetNumberOfThreads(int numThreads)
+{
+  Sequential::Initialize(numThreads);
+#ifdef VTK_SMP_ENABLE_STDTHREAD
+  STDThread::Initialize(numThreads);
+#endif
+#ifdef VTK_SMP_ENABLE_OPENMP
+  OpenMP::Initialize(numThreads);
+#endif
+#ifdef VTK_SMP_ENABLE_TBB
+  TBB::Initialize(numThreads);
+#endif
+}
+
+//--------------------------------------------------------------------------------
+// Honor VTK_SMP_MAX_THREADS before the first parallel operation, unless
+// vtkSMPTools::Initialize() was called explicitly.
+void vtkSMPInitializeFromEnvironment()
+{
+  std::call_once(vtkSMPInitializeFromEnvironmentFlag, []()
+  {
+    const char *maxThreads = getenv("VTK_SMP_MAX_THREADS");
+    int numThreads = maxThreads ? atoi(maxThreads) : 0;
+    if (numThreads > 0)
+    {
+      vtkSMPSetNumberOfThreads(numThreads);
+    }
+  });
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPGetBackendInUse()
+{
+  return vtkSMPLocalBackend >= 0 ? vtkSMPLocalBackend :
+         vtkSMPGlobalBackend.load();
+}
+
+//--------------------------------------------------------------------------------
+// The overrides of a LocalScope are thread_local, so a functor run by the
+// workers of a back-end is wrapped to install the overrides of the thread
+// that started the loop, which nested loops then honor.
+struct vtkSMPScopedFunctor
+{
+  ExecuteFunctorPtrType Executer;
+  void *Functor;
+  int Backend;
+  int MaxNumberOfThreads;
+};
+
+void vtkSMPExecuteScopedFunctor(void *functor, vtkIdType from,
+                                vtkIdType grain, vtkIdType last)
+{
+  const vtkSMPScopedFunctor &scoped =
+    *static_cast<vtkSMPScopedFunctor*>(functor);
+  int previousBackend = vtkSMPLocalBackend;
+  int previousMaxNumberOfThreads = vtkSMPLocalMaxNumberOfThreads;
+  vtkSMPLocalBackend = scoped.Backend;
+  vtkSMPLocalMaxNumberOfThreads = scoped.MaxNumberOfThreads;
+  scoped.Executer(scoped.Functor, from, grain, last);
+  vtkSMPLocalBackend = previousBackend;
+  vtkSMPLocalMaxNumberOfThreads = previousMaxNumberOfThreads;
+}
+
+} // end anon namespace
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+  vtkSMPInitializeFromEnvironment();
+  if (numThreads > 0)
+  {
+    vtkSMPSetNumberOfThreads(numThreads);
+  }
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  return vtk::detail::smp::GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::SetBackend(const char *backend)
+{
+  int type = vtkSMPGetBackendFromName(backend);
+  if (type < 0)
+  {
+    return false;
+  }
+  vtkSMPGlobalBackend = type;
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+const char *vtkSMPTools::GetBackend()
+{
+  return vtkSMPBackendNames[vtkSMPGetBackendInUse()];
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::IsBackendAvailable(const char *backend)
+{
+  return vtkSMPGetBackendFromName(backend) >= 0;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  vtkSMPInitializeFromEnvironment();
+
+  int numThreads = 1;
+  switch (vtkSMPGetBackendInUse())
+  {
+#ifdef VTK_SMP_ENABLE_STDTHREAD
+    case STDThreadBackend:
+      numThreads = STDThread::GetEstimatedNumberOfThreads();
+      break;
+#endif
+#ifdef VTK_SMP_ENABLE_OPENMP
+    case OpenMPBackend:
+      numThreads = OpenMP::GetEstimatedNumberOfThreads();
+      break;
+#endif
+#ifdef VTK_SMP_ENABLE_TBB
+    case TBBBackend:
+      numThreads = TBB::GetEstimatedNumberOfThreads();
+      break;
+#endif
+    default:
+      numThreads = Sequential::GetEstimatedNumberOfThreads();
+      break;
+  }
+
+  int maxThreads = vtkSMPLocalMaxNumberOfThreads;
+  return (maxThreads > 0 && maxThreads < numThreads) ? maxThreads : numThreads;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetBackendInUse()
+{
+  return vtkSMPGetBackendInUse();
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_Dispatch(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  vtkSMPInitializeFromEnvironment();
+
+  int maxThreads = vtkSMPLocalMaxNumberOfThreads;
+  vtkSMPScopedFunctor scoped;
+  if (vtkSMPLocalBackend >= 0 || maxThreads > 0)
+  {
+    scoped.Executer = functorExecuter;
+    scoped.Functor = functor;
+    scoped.Backend = vtkSMPLocalBackend;
+    scoped.MaxNumberOfThreads = maxThreads;
+    functorExecuter = vtkSMPExecuteScopedFunctor;
+    functor = &scoped;
+  }
+
+  switch (vtkSMPGetBackendInUse())
+  {
+#ifdef VTK_SMP_ENABLE_STDTHREAD
+    case STDThreadBackend:
+      STDThread::For(first, last, grain, functorExecuter, functor, maxThreads);
+      break;
+#endif
+#ifdef VTK_SMP_ENABLE_OPENMP
+    case OpenMPBackend:
+      OpenMP::For(first, last, grain, functorExecuter, functor, maxThreads);
+      break;
+#endif
+#ifdef VTK_SMP_ENABLE_TBB
+    case TBBBackend:
+      TBB::For(first, last, grain, functorExecuter, functor, maxThreads);
+      break;
+#endif
+    default:
+      Sequential::For(first, last, grain, functorExecuter, functor, maxThreads);
+      break;
+  }
+}
+
+//--------------------------------------------------------------------------------
+vtk::detail::smp::vtkSMPToolsScope::vtkSMPToolsScope(int maxNumberOfThreads,
+                                                     const char *backend)
+  : PreviousMaxNumberOfThreads(vtkSMPLocalMaxNumberOfThreads),
+    PreviousBackend(vtkSMPLocalBackend)
+{
+  if (maxNumberOfThreads > 0)
+  {
+    vtkSMPLocalMaxNumberOfThreads = maxNumberOfThreads;
+  }
+  if (backend && *backend)
+  {
+    int type = vtkSMPGetBackendFromName(backend);
+    if (type >= 0)
+    {
+      vtkSMPLocalBackend = type;
+    }
+    else
+    {
+      vtkGenericWarningMacro(<< "vtkSMPTools back-end " << backend
+                             << " is not available, keeping "
+                             << vtkSMPTools::GetBackend() << ".");
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------
+vtk::detail::smp::vtkSMPToolsScope::~vtkSMPToolsScope()
+{
+  vtkSMPLocalMaxNumberOfThreads = this->PreviousMaxNumberOfThreads;
+  vtkSMPLocalBackend = this->PreviousBackend;
+}
@@ -19,8 +19,18 @@
  * vtkSMPTools provides a set of utility functions that can
  * be used to parallelize parts of VTK code using multiple threads.
  * There are several back-end implementations of parallel functionality
- * (currently Sequential, TBB and X-Kaapi) that actual execution is
- * delegated to.
+ * (currently Sequential, STDThread, OpenMP and TBB) that actual execution is
+ * delegated to. The STDThread back-end has no external dependency: it
+ * runs on a persistent pool of std::thread workers with work-stealing
+ * task deques and supports nested calls to For().
+ *
+ * All the back-ends enabled at configure time (VTK_SMP_ENABLE_STDTHREAD,
+ * VTK_SMP_ENABLE_OPENMP, VTK_SMP_ENABLE_TBB) are compiled in. The one in
+ * use defaults to VTK_SMP_IMPLEMENTATION_TYPE, can be overridden with the
+ * VTK_SMP_BACKEND_IN_USE environment variable and changed at run-time with
+ * SetBackend(). The VTK_SMP_MAX_THREADS environment variable has the same
+ * effect as calling Initialize(). LocalScope() runs code with a different
+ * back-end or a lower maximum number of threads for the calling thread only.
 */
 
 #ifndef vtkSMPTools_h
@@ -32,6 +42,15 @@
 #include "vtkSMPThreadLocal.h" // For Initialized
 #include "vtkSMPToolsInternal.h"
 
+#include <algorithm> // For std::sort
+#include <iterator> // For std::iterator_traits
+#include <string> // For Config
+#include <vector> // For Reduce and the scans
+
+#ifdef VTK_SMP_ENABLE_TBB
+#include <tbb/parallel_sort.h> // For Sort
+#endif
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -129,6 +148,220 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+struct vtkSMPTools_Less
+{
+  template <typename T>
+  bool operator()(const T& a, const T& b) const
+  {
+    return a < b;
+  }
+};
+
+// Sort consecutive blocks of Width elements.
+template <typename RandomAccessIterator, typename Compare>
+struct vtkSMPTools_SortBlocks
+{
+  RandomAccessIterator Begin;
+  vtkIdType Size, Width;
+  Compare Comp;
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      vtkIdType lo = block * this->Width;
+      vtkIdType hi = std::min(lo + this->Width, this->Size);
+      std::sort(this->Begin + lo, this->Begin + hi, this->Comp);
+    }
+  }
+};
+
+// Merge pairs of consecutive sorted blocks of Width elements.
+template <typename RandomAccessIterator, typename Compare>
+struct vtkSMPTools_MergeBlocks
+{
+  RandomAccessIterator Begin;
+  vtkIdType Size, Width;
+  Compare Comp;
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    for (vtkIdType pair = first; pair < last; ++pair)
+    {
+      vtkIdType lo = pair * 2 * this->Width;
+      vtkIdType mid = std::min(lo + this->Width, this->Size);
+      vtkIdType hi = std::min(lo + 2 * this->Width, this->Size);
+      std::inplace_merge(this->Begin + lo, this->Begin + mid,
+                         this->Begin + hi, this->Comp);
+    }
+  }
+};
+
+// Apply Op to each element of [In, In + size) and store the result in Out.
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+struct vtkSMPTools_UnaryTransform
+{
+  InputIt In;
+  OutputIt Out;
+  UnaryOp Op;
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    InputIt in = this->In + first;
+    OutputIt out = this->Out + first;
+    for (vtkIdType i = first; i < last; ++i, ++in, ++out)
+    {
+      *out = this->Op(*in);
+    }
+  }
+};
+
+// Apply Op to each pair of elements of In1 and In2 and store the result in
+// Out.
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+          typename BinaryOp>
+struct vtkSMPTools_BinaryTransform
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  BinaryOp Op;
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    InputIt1 in1 = this->In1 + first;
+    InputIt2 in2 = this->In2 + first;
+    OutputIt out = this->Out + first;
+    for (vtkIdType i = first; i < last; ++i, ++in1, ++in2, ++out)
+    {
+      *out = this->Op(*in1, *in2);
+    }
+  }
+};
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_Fill
+{
+  Iterator Begin;
+  const T& Value;
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    std::fill(this->Begin + first, this->Begin + last, this->Value);
+  }
+};
+
+// Reduce, and the first pass of the scans, work on a fixed number of blocks
+// of consecutive elements so that the result does not depend on how the
+// back-end schedules the work, even for operations that are only
+// associative (e.g. floating point sums).
+struct vtkSMPTools_Blocks
+{
+  vtkIdType Size, Width, Number;
+  vtkSMPTools_Blocks(vtkIdType size)
+    : Size(size), Width(size), Number(size > 0 ? 1 : 0)
+  {
+    // Small ranges are not worth the overhead of a second pass.
+    const vtkIdType minWidth = 1024;
+    vtkIdType maxBlocks = 4 * vtk::detail::smp::GetNumberOfThreads();
+    if (maxBlocks > 4 && size >= 2 * minWidth)
+    {
+      this->Number = std::min(maxBlocks, size / minWidth);
+      this->Width = (size + this->Number - 1) / this->Number;
+      this->Number = (size + this->Width - 1) / this->Width;
+    }
+  }
+  vtkIdType Begin(vtkIdType block) const
+  {
+    return block * this->Width;
+  }
+  vtkIdType End(vtkIdType block) const
+  {
+    return std::min((block + 1) * this->Width, this->Size);
+  }
+};
+
+// Reduce each block of [Begin, Begin + Blocks.Size) into Partials[block].
+template <typename InputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_ReduceBlocks
+{
+  InputIt Begin;
+  const vtkSMPTools_Blocks& Blocks;
+  T* Partials;
+  BinaryOp Op;
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      InputIt it = this->Begin + this->Blocks.Begin(block);
+      InputIt end = this->Begin + this->Blocks.End(block);
+      T value = *it;
+      for (++it; it != end; ++it)
+      {
+        value = this->Op(value, *it);
+      }
+      this->Partials[block] = value;
+    }
+  }
+};
+
+// Scan each block of [In, In + Blocks.Size) into Out, starting from
+// Offsets[block]. When FirstOffset is false, the inclusive scan of the first
+// block starts from its first element instead. In and Out may be the same
+// range. With a single block, the reduction of the whole range is stored in
+// Total.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp,
+          bool Inclusive>
+struct vtkSMPTools_ScanBlocks
+{
+  InputIt In;
+  OutputIt Out;
+  const vtkSMPTools_Blocks& Blocks;
+  const T* Offsets;
+  bool FirstOffset;
+  BinaryOp Op;
+  T* Total;
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      vtkIdType begin = this->Blocks.Begin(block);
+      vtkIdType end = this->Blocks.End(block);
+      InputIt in = this->In + begin;
+      OutputIt out = this->Out + begin;
+      T value = this->Offsets[block];
+      if (Inclusive && block == 0 && !this->FirstOffset)
+      {
+        value = *in;
+        *out = value;
+        ++begin, ++in, ++out;
+      }
+      for (vtkIdType i = begin; i < end; ++i, ++in, ++out)
+      {
+        if (Inclusive)
+        {
+          value = this->Op(value, *in);
+          *out = value;
+        }
+        else
+        {
+          T next = this->Op(value, *in);
+          *out = value;
+          value = next;
+        }
+      }
+      if (this->Blocks.Number == 1)
+      {
+        *this->Total = value;
+      }
+    }
+  }
+};
+
+struct vtkSMPTools_Plus
+{
+  template <typename T, typename U>
+  auto operator()(const T& a, const U& b) const -> decltype(a + b)
+  {
+    return a + b;
+  }
+};
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -139,6 +372,63 @@ class VTKCOMMONCORE_EXPORT vtkSMPTools
 {
 public:
 
+  /**
+   * Settings applied by LocalScope(). A non-positive MaxNumberOfThreads or
+   * an empty Backend leave the corresponding setting unchanged.
+   */
+  struct Config
+  {
+    int MaxNumberOfThreads;
+    std::string Backend;
+
+    Config() : MaxNumberOfThreads(0) {}
+    explicit Config(int maxNumberOfThreads)
+      : MaxNumberOfThreads(maxNumberOfThreads) {}
+    explicit Config(const std::string& backend)
+      : MaxNumberOfThreads(0), Backend(backend) {}
+    Config(int maxNumberOfThreads, const std::string& backend)
+      : MaxNumberOfThreads(maxNumberOfThreads), Backend(backend) {}
+  };
+
+  /**
+   * Run lambda (any callable taking no argument) with the settings of
+   * config. The settings only affect the parallel operations started by the
+   * calling thread, including the loops nested in them that run on worker
+   * threads, and are restored when lambda returns, so that e.g. one
+   * pipeline can be limited to a few threads on a shared node while others
+   * keep using the whole machine:
+   * \code
+   * vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { filter->Update(); });
+   * \endcode
+   */
+  template <typename T>
+  static void LocalScope(Config const& config, T&& lambda)
+  {
+    vtk::detail::smp::vtkSMPToolsScope scope(
+      config.MaxNumberOfThreads, config.Backend.c_str());
+    lambda();
+  }
+
+  /**
+   * Select the back-end used by all threads outside of a LocalScope().
+   * Valid names are "Sequential", "STDThread", "OpenMP" and "TBB". Returns
+   * false, leaving the back-end unchanged, if backend was not enabled at
+   * configure time. Must not be called while a parallel operation is
+   * running.
+   */
+  static bool SetBackend(const char *backend);
+
+  /**
+   * Name of the back-end used by the calling thread.
+   */
+  static const char *GetBackend();
+
+  /**
+   * Returns true if backend was compiled in and can be used with
+   * SetBackend() and LocalScope().
+   */
+  static bool IsBackendAvailable(const char *backend);
+
   //@{
   /**
    * Execute a for operation in parallel. First and last
@@ -209,11 +499,9 @@ public:
    * Initialize the underlying libraries for execution. This is
    * not required as it is automatically called before the first
    * execution of any parallel code. However, it can be used to
-   * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
-   * it before any other parallel operation.
-   * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
-   * the number of threads used in the thread pool.
+   * control the maximum number of threads used by all the back-ends
+   * that support it (currently STDThread, OpenMP and TBB). Make sure to
+   * call it before any other parallel operation.
    */
   static void Initialize(int numThreads=0);
 
@@ -221,34 +509,260 @@ public:
    * Get the estimated number of threads being used by the backend.
    * This should be used as just an estimate since the number of threads may
    * vary dynamically and a particular task may not be executed on all the
-   * available threads.
+   * available threads. The limit of the current LocalScope() is taken into
+   * account.
    */
   static int GetEstimatedNumberOfThreads();
 
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB.
+   * std::sort(). The TBB back-end uses tbb::parallel_sort(). With the other
+   * back-ends, blocks of the range are sorted in parallel with std::sort()
+   * and then merged pairwise, also in parallel.
    */
   template<typename RandomAccessIterator>
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end);
+    vtkSMPTools::Sort(begin, end, vtk::detail::smp::vtkSMPTools_Less());
   }
 
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB. This version of Sort() takes a
-   * comparison class.
+   * std::sort(). See above. This version of Sort() takes a comparison class.
    */
   template<typename RandomAccessIterator, typename Compare>
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end,
       Compare comp)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
+#ifdef VTK_SMP_ENABLE_TBB
+    if (vtk::detail::smp::GetBackendInUse() == vtk::detail::smp::TBBBackend)
+    {
+      tbb::parallel_sort(begin, end, comp);
+      return;
+    }
+#endif
+    vtkIdType size = static_cast<vtkIdType>(end - begin);
+    vtkIdType numBlocks = 2 * vtk::detail::smp::GetNumberOfThreads();
+    if (numBlocks <= 2 || size < 4096)
+    {
+      std::sort(begin, end, comp);
+      return;
+    }
+
+    vtkIdType width = (size + numBlocks - 1) / numBlocks;
+    numBlocks = (size + width - 1) / width;
+    vtk::detail::smp::vtkSMPTools_SortBlocks<RandomAccessIterator, Compare>
+      sorter = { begin, size, width, comp };
+    vtkSMPTools::For(0, numBlocks, 1, sorter);
+
+    for (; width < size; width *= 2)
+    {
+      vtkIdType numPairs = (size + 2 * width - 1) / (2 * width);
+      vtk::detail::smp::vtkSMPTools_MergeBlocks<RandomAccessIterator, Compare>
+        merger = { begin, size, width, comp };
+      vtkSMPTools::For(0, numPairs, 1, merger);
+    }
   }
 
+  /**
+   * A parallel drop in replacement for std::transform(). op is applied to
+   * each element of [inBegin, inEnd) and the result is stored in the range
+   * starting at outBegin, which may be the input range. The iterators must
+   * be random access (e.g. raw pointers). op may be called concurrently and
+   * in any order.
+   */
+  template <typename InputIt, typename OutputIt, typename UnaryOp>
+  static void Transform(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+    UnaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_UnaryTransform<InputIt, OutputIt, UnaryOp>
+      transform = { inBegin, outBegin, op };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(inEnd - inBegin), transform);
+  }
+
+  /**
+   * A parallel drop in replacement for the binary version of
+   * std::transform(). op is applied to each pair of elements of
+   * [inBegin1, inEnd1) and of the range starting at inBegin2, and the result
+   * is stored in the range starting at outBegin.
+   */
+  template <typename InputIt1, typename InputIt2, typename OutputIt,
+            typename BinaryOp>
+  static void Transform(InputIt1 inBegin1, InputIt1 inEnd1, InputIt2 inBegin2,
+    OutputIt outBegin, BinaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_BinaryTransform<InputIt1, InputIt2,
+      OutputIt, BinaryOp> transform = { inBegin1, inBegin2, outBegin, op };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(inEnd1 - inBegin1), transform);
+  }
+
+  /**
+   * A parallel drop in replacement for std::fill().
+   */
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_Fill<Iterator, T> fill = { begin, value };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(end - begin), fill);
+  }
+
+  /**
+   * A parallel replacement for std::accumulate(). Returns the reduction of
+   * init and of the elements of [begin, end) with op, which must be
+   * associative but does not have to be commutative. The range is split in
+   * a number of blocks that only depends on its size and on the number of
+   * threads, so that repeated calls return the same result, including for
+   * floating point sums.
+   */
+  template <typename InputIt, typename T, typename BinaryOp>
+  static T Reduce(InputIt begin, InputIt end, T init, BinaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_Blocks blocks(
+      static_cast<vtkIdType>(end - begin));
+    if (blocks.Number <= 1)
+    {
+      for (; begin != end; ++begin)
+      {
+        init = op(init, *begin);
+      }
+      return init;
+    }
+
+    std::vector<T> partials(blocks.Number);
+    vtk::detail::smp::vtkSMPTools_ReduceBlocks<InputIt, T, BinaryOp>
+      reducer = { begin, blocks, &partials[0], op };
+    vtkSMPTools::For(0, blocks.Number, 1, reducer);
+    for (vtkIdType block = 0; block < blocks.Number; ++block)
+    {
+      init = op(init, partials[block]);
+    }
+    return init;
+  }
+
+  /**
+   * Sum of init and of the elements of [begin, end). See Reduce().
+   */
+  template <typename InputIt, typename T>
+  static T Reduce(InputIt begin, InputIt end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init,
+      vtk::detail::smp::vtkSMPTools_Plus());
+  }
+
+  /**
+   * A parallel replacement for std::inclusive_scan(): the i-th output is the
+   * reduction with op of the elements 0 to i of [begin, end). The output
+   * range starting at out may be the input range and op must be
+   * associative. Returns the reduction of all the elements (the last
+   * output), which is T() for an empty range.
+   */
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  static typename std::iterator_traits<InputIt>::value_type InclusiveScan(
+    InputIt begin, InputIt end, OutputIt out, BinaryOp op)
+  {
+    return vtkSMPTools::Scan<true>(begin, end, out,
+      static_cast<typename std::iterator_traits<InputIt>::value_type*>(NULL),
+      op);
+  }
+
+  /**
+   * Parallel inclusive prefix sum of [begin, end). See InclusiveScan().
+   */
+  template <typename InputIt, typename OutputIt>
+  static typename std::iterator_traits<InputIt>::value_type InclusiveScan(
+    InputIt begin, InputIt end, OutputIt out)
+  {
+    return vtkSMPTools::InclusiveScan(begin, end, out,
+      vtk::detail::smp::vtkSMPTools_Plus());
+  }
+
+  /**
+   * A parallel replacement for std::exclusive_scan(): the i-th output is the
+   * reduction with op of init and of the elements 0 to i-1 of [begin, end).
+   * The output range starting at out may be the input range and op must be
+   * associative. Returns the reduction of init and of all the elements,
+   * i.e. the value that would follow the last output. This is what the
+   * "count then write" algorithms need: turn per-item counts into offsets
+   * in place, and allocate the output with the returned total.
+   * \code
+   * vtkIdType numOutputs = vtkSMPTools::ExclusiveScan(
+   *   counts, counts + numItems, counts, vtkIdType(0));
+   * \endcode
+   */
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static T ExclusiveScan(InputIt begin, InputIt end, OutputIt out, T init,
+    BinaryOp op)
+  {
+    return vtkSMPTools::Scan<false>(begin, end, out, &init, op);
+  }
+
+  /**
+   * Parallel exclusive prefix sum of [begin, end) starting at init. See
+   * ExclusiveScan().
+   */
+  template <typename InputIt, typename OutputIt, typename T>
+  static T ExclusiveScan(InputIt begin, InputIt end, OutputIt out, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(begin, end, out, init,
+      vtk::detail::smp::vtkSMPTools_Plus());
+  }
+
+private:
+  // Two pass scan: the blocks are reduced in parallel, the value each block
+  // starts from is computed sequentially, and the blocks are then scanned
+  // in parallel. init may be NULL for inclusive scans only.
+  template <bool Inclusive, typename InputIt, typename OutputIt, typename T,
+            typename BinaryOp>
+  static T Scan(InputIt begin, InputIt end, OutputIt out, const T* init,
+    BinaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_Blocks blocks(
+      static_cast<vtkIdType>(end - begin));
+    if (blocks.Number == 0)
+    {
+      return init ? *init : T();
+    }
+
+    std::vector<T> offsets(blocks.Number, init ? *init : T());
+    T total = offsets[0];
+    if (blocks.Number > 1)
+    {
+      vtk::detail::smp::vtkSMPTools_ReduceBlocks<InputIt, T, BinaryOp>
+        reducer = { begin, blocks, &offsets[0], op };
+      vtkSMPTools::For(0, blocks.Number, 1, reducer);
+
+      vtkIdType block = 0;
+      if (init)
+      {
+        total = *init;
+      }
+      else
+      {
+        total = offsets[0];
+        ++block;
+      }
+      for (; block < blocks.Number; ++block)
+      {
+        T partial = offsets[block];
+        offsets[block] = total;
+        total = op(total, partial);
+      }
+    }
+
+    vtk::detail::smp::vtkSMPTools_ScanBlocks<InputIt, OutputIt, T, BinaryOp,
+      Inclusive> scanner = { begin, out, blocks, &offsets[0], init != NULL,
+      op, &total };
+    if (blocks.Number > 1)
+    {
+      vtkSMPTools::For(0, blocks.Number, 1, scanner);
+    }
+    else
+    {
+      // Small range: the total is only known once the block is scanned.
+      scanner(0, 1);
+    }
+    return total;
+  }
 };
 
 #endif
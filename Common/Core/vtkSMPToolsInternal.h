@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// All the vtkSMPTools back-ends enabled at configure time (Sequential,
+// STDThread, OpenMP and TBB) are compiled into vtkCommonCore. The functor
+// passed to vtkSMPTools::For is type-erased into an ExecuteFunctorPtrType
+// and a void pointer, and handed to the back-end in use, which can be
+// changed at run-time with vtkSMPTools::SetBackend() or the
+// VTK_SMP_BACKEND_IN_USE environment variable.
+
+#ifndef vtkSMPToolsInternal_h
+#define vtkSMPToolsInternal_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkSystemIncludes.h"
+
+#ifndef __VTK_WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+typedef void (*ExecuteFunctorPtrType)(void *, vtkIdType, vtkIdType, vtkIdType);
+
+enum BackendType
+{
+  SequentialBackend = 0,
+  STDThreadBackend,
+  OpenMPBackend,
+  TBBBackend,
+  NumberOfBackends
+};
+
+/**
+ * Number of threads the calling thread would use for a parallel operation,
+ * taking the back-end in use and the current vtkSMPTools::LocalScope into
+ * account.
+ */
+int VTKCOMMONCORE_EXPORT GetNumberOfThreads();
+
+/**
+ * Back-end (a BackendType) used by the calling thread, taking the current
+ * vtkSMPTools::LocalScope into account.
+ */
+int VTKCOMMONCORE_EXPORT GetBackendInUse();
+
+/**
+ * Execute the type-erased functor with the back-end in use.
+ */
+void VTKCOMMONCORE_EXPORT vtkSMPTools_Impl_For_Dispatch(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor);
+
+/**
+ * Overrides the back-end and/or the maximum number of threads used by the
+ * calling thread for the lifetime of the object. A non-positive
+ * maxNumberOfThreads or an empty or NULL backend leave the corresponding
+ * setting unchanged. See vtkSMPTools::LocalScope.
+ */
+class VTKCOMMONCORE_EXPORT vtkSMPToolsScope
+{
+public:
+  vtkSMPToolsScope(int maxNumberOfThreads, const char *backend);
+  ~vtkSMPToolsScope();
+
+private:
+  int PreviousMaxNumberOfThreads;
+  int PreviousBackend;
+
+  vtkSMPToolsScope(const vtkSMPToolsScope&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMPToolsScope&) VTK_DELETE_FUNCTION;
+};
+
+// Entry points implemented by each back-end in SMP/<Backend>. A
+// maxNumberOfThreads of 0 means no limit.
+#define VTK_SMP_DECLARE_BACKEND(name)                                       \
+  namespace name                                                            \
+  {                                                                         \
+  void Initialize(int numThreads);                                          \
+  int GetEstimatedNumberOfThreads();                                        \
+  void For(vtkIdType first, vtkIdType last, vtkIdType grain,                \
+    ExecuteFunctorPtrType functorExecuter, void *functor,                   \
+    int maxNumberOfThreads);                                                \
+  }
+
+VTK_SMP_DECLARE_BACKEND(Sequential)
+VTK_SMP_DECLARE_BACKEND(STDThread)
+VTK_SMP_DECLARE_BACKEND(OpenMP)
+VTK_SMP_DECLARE_BACKEND(TBB)
+
+#undef VTK_SMP_DECLARE_BACKEND
+
+template <typename FunctorInternal>
+void ExecuteFunctor(void *functor, vtkIdType from, vtkIdType grain,
+                    vtkIdType last)
+{
+  vtkIdType to = from + grain;
+  if (to > last)
+  {
+    to = last;
+  }
+
+  FunctorInternal &fi = *reinterpret_cast<FunctorInternal*>(functor);
+  fi.Execute(from, to);
+}
+
+template <typename FunctorInternal>
+static void vtkSMPTools_Impl_For(vtkIdType first, vtkIdType last,
+                                 vtkIdType grain, FunctorInternal& fi)
+{
+  vtkIdType n = last - first;
+  if (n <= 0)
+  {
+    return;
+  }
+
+  if (grain >= n)
+  {
+    fi.Execute(first, last);
+  }
+  else
+  {
+    vtkSMPTools_Impl_For_Dispatch(first, last, grain,
+                                  ExecuteFunctor<FunctorInternal>, &fi);
+  }
+}
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsInternal.h
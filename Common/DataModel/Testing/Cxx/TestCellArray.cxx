@@ -0,0 +1,305 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the offsets and connectivity storage of vtkCellArray and the legacy
+// API on top of it.
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestCheck.h"
+#include "vtkTypeInt32Array.h"
+
+#include <atomic>
+
+namespace
+{
+
+// Cell i has i % 4 + 1 points: i, i + 1, ...
+void InsertCells(vtkCellArray *ca, vtkIdType numCells)
+{
+  vtkIdType pts[4];
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    vtkIdType npts = i % 4 + 1;
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      pts[j] = i + j;
+    }
+    ca->InsertNextCell(npts, pts);
+  }
+}
+
+int CheckCells(vtkCellArray *ca, vtkIdType numCells)
+{
+  vtkTestCheckMacro(ca->GetNumberOfCells() == numCells);
+  vtkNew<vtkIdList> ptIds;
+  vtkIdType npts;
+  const vtkIdType *pts;
+
+  // Random access
+  for (vtkIdType i = numCells - 1; i >= 0; --i)
+  {
+    ca->GetCellAtId(i, npts, pts, ptIds.GetPointer());
+    vtkTestCheckMacro(npts == i % 4 + 1);
+    vtkTestCheckMacro(ca->GetCellSize(i) == npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      vtkTestCheckMacro(pts[j] == i + j);
+    }
+  }
+
+  // Legacy traversal and locations
+  vtkIdType *legacyPts;
+  vtkIdType cellId = 0;
+  vtkIdType loc = 0;
+  ca->InitTraversal();
+  while (ca->GetNextCell(npts, legacyPts))
+  {
+    vtkTestCheckMacro(npts == cellId % 4 + 1 && legacyPts[0] == cellId);
+    vtkTestCheckMacro(ca->GetTraversalLocation(npts) == loc);
+    ca->GetCell(loc, npts, legacyPts);
+    vtkTestCheckMacro(npts == cellId % 4 + 1 &&
+      legacyPts[npts - 1] == cellId + npts - 1);
+    loc += npts + 1;
+    ++cellId;
+  }
+  vtkTestCheckMacro(cellId == numCells);
+  vtkTestCheckMacro(ca->GetNumberOfConnectivityEntries() == loc);
+  vtkTestCheckMacro(ca->GetMaxCellSize() == (numCells < 4 ? numCells : 4));
+  return 0;
+}
+
+// Fill the cells of InsertCells() in parallel: count, scan, then write.
+struct FillCells
+{
+  vtkIdType *Offsets;
+  vtkTypeInt32 *Offsets32;
+  vtkTypeInt32 *Connectivity;
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkTypeInt32 offset = static_cast<vtkTypeInt32>(this->Offsets[i]);
+      this->Offsets32[i] = offset;
+      for (vtkIdType j = 0; j < i % 4 + 1; ++j)
+      {
+        this->Connectivity[offset + j] = static_cast<vtkTypeInt32>(i + j);
+      }
+    }
+  }
+};
+
+// Read triangles through the legacy API, as several threads may do.
+struct ReadTriangles
+{
+  vtkCellArray *Cells;
+  std::atomic<int> *Errors;
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType npts;
+      vtkIdType *pts;
+      this->Cells->GetCell(4 * i, npts, pts);
+      if (npts != 3 || pts[0] != i || pts[1] != i + 1 || pts[2] != i + 2)
+      {
+        ++*this->Errors;
+      }
+    }
+  }
+};
+
+} // end anon namespace
+
+int TestCellArray(int, char*[])
+{
+  const vtkIdType numCells = 1000;
+
+  // Legacy storage, converted to each storage and back
+  vtkNew<vtkCellArray> ca;
+  InsertCells(ca.GetPointer(), numCells);
+  vtkTestCheckMacro(ca->IsStorageLegacy());
+  vtkTestCheckMacro(CheckCells(ca.GetPointer(), numCells) == 0);
+  vtkIdType legacySize = ca->GetNumberOfConnectivityEntries();
+
+  ca->UseOffsetsStorage(false);
+  vtkTestCheckMacro(ca->GetStorageType() ==
+    vtkCellArray::OFFSETS_64BIT_STORAGE);
+  vtkTestCheckMacro(ca->GetOffsetsArray()->GetNumberOfTuples() == numCells + 1);
+  vtkTestCheckMacro(ca->GetConnectivityArray()->GetNumberOfTuples() ==
+    legacySize - numCells);
+  vtkTestCheckMacro(CheckCells(ca.GetPointer(), numCells) == 0);
+
+  ca->UseOffsetsStorage();
+  vtkTestCheckMacro(ca->IsStorage32Bit());
+  vtkTestCheckMacro(ca->GetConnectivityArray()->IsA("vtkTypeInt32Array"));
+  vtkTestCheckMacro(CheckCells(ca.GetPointer(), numCells) == 0);
+
+  // Legacy array built on demand
+  vtkIdTypeArray *legacy = ca->GetData();
+  vtkTestCheckMacro(ca->IsStorageLegacy());
+  vtkTestCheckMacro(legacy->GetNumberOfTuples() == legacySize);
+  vtkTestCheckMacro(legacy->GetValue(0) == 1 && legacy->GetValue(2) == 2);
+  vtkTestCheckMacro(CheckCells(ca.GetPointer(), numCells) == 0);
+
+  // Insertion, in place modifications and DeepCopy with offsets storage
+  vtkNew<vtkCellArray> ca32;
+  ca32->UseOffsetsStorage();
+  vtkTestCheckMacro(ca32->IsStorage32Bit());
+  InsertCells(ca32.GetPointer(), numCells - 1);
+  ca32->InsertNextCell(4);
+  ca32->InsertCellPoint(numCells - 1);
+  ca32->InsertCellPoint(numCells);
+  ca32->InsertCellPoint(numCells + 1);
+  ca32->InsertCellPoint(numCells + 2);
+  ca32->UpdateCellCount(4);
+  vtkTestCheckMacro(CheckCells(ca32.GetPointer(), numCells) == 0);
+
+  vtkIdType loc = ca32->GetInsertLocation(4);
+  ca32->ReverseCell(loc);
+  vtkNew<vtkIdList> ptIds;
+  ca32->GetCellAtId(numCells - 1, ptIds.GetPointer());
+  vtkTestCheckMacro(ptIds->GetId(0) == numCells + 2 &&
+    ptIds->GetId(3) == numCells - 1);
+  ca32->ReverseCell(loc);
+
+  // The point ids of a cell stay valid while the next cells are read
+  vtkIdType npts1, npts2;
+  vtkIdType *pts1, *pts2;
+  ca32->InitTraversal();
+  ca32->GetNextCell(npts1, pts1);
+  ca32->GetNextCell(npts2, pts2);
+  ca32->GetCell(loc, npts2, pts2);
+  vtkTestCheckMacro(npts1 == 1 && pts1[0] == 0);
+  vtkTestCheckMacro(npts2 == 4 && pts2[0] == numCells - 1 &&
+    pts2[3] == numCells + 2);
+
+  vtkNew<vtkCellArray> copy;
+  copy->DeepCopy(ca32.GetPointer());
+  vtkTestCheckMacro(copy->IsStorage32Bit());
+  vtkTestCheckMacro(CheckCells(copy.GetPointer(), numCells) == 0);
+
+  // Ids that do not fit in 32 bits switch to 64 bit storage
+  vtkIdType bigIds[2] = { 0, VTK_INT_MAX };
+  bigIds[1] += 10;
+  if (sizeof(vtkIdType) == 8)
+  {
+    ca32->InsertNextCell(2, bigIds);
+    vtkTestCheckMacro(ca32->GetStorageType() ==
+      vtkCellArray::OFFSETS_64BIT_STORAGE);
+    vtkIdType npts;
+    const vtkIdType *pts;
+    ca32->GetCellAtId(numCells, npts, pts, ptIds.GetPointer());
+    vtkTestCheckMacro(npts == 2 && pts[1] == bigIds[1]);
+    vtkTestCheckMacro(!ca32->CanConvertTo32BitStorage());
+  }
+
+  // Parallel fill: count, exclusive scan and write
+  vtkNew<vtkIdTypeArray> counts;
+  counts->SetNumberOfValues(numCells + 1);
+  vtkIdType *offsets = counts->GetPointer(0);
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    offsets[i] = i % 4 + 1;
+  }
+  vtkIdType connectivitySize =
+    vtkSMPTools::ExclusiveScan(offsets, offsets + numCells, offsets,
+                               vtkIdType(0));
+  offsets[numCells] = connectivitySize;
+
+  vtkNew<vtkTypeInt32Array> offsets32;
+  vtkNew<vtkTypeInt32Array> connectivity32;
+  offsets32->SetNumberOfValues(numCells + 1);
+  offsets32->SetValue(numCells, static_cast<vtkTypeInt32>(connectivitySize));
+  connectivity32->SetNumberOfValues(connectivitySize);
+  FillCells filler =
+    { offsets, offsets32->GetPointer(0), connectivity32->GetPointer(0) };
+  vtkSMPTools::For(0, numCells, filler);
+
+  vtkNew<vtkCellArray> filled;
+  filled->SetData(offsets32.GetPointer(), connectivity32.GetPointer());
+  vtkTestCheckMacro(CheckCells(filled.GetPointer(), numCells) == 0);
+  vtkTestCheckMacro(filled->GetActualMemorySize() < ca->GetActualMemorySize());
+
+  // Reset keeps the storage
+  filled->Reset();
+  vtkTestCheckMacro(filled->IsStorage32Bit() &&
+    filled->GetNumberOfCells() == 0);
+  InsertCells(filled.GetPointer(), 10);
+  vtkTestCheckMacro(CheckCells(filled.GetPointer(), 10) == 0);
+
+  // Concurrent reads with 32 bit storage
+  vtkNew<vtkCellArray> triangles;
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    vtkIdType triangle[3] = { i, i + 1, i + 2 };
+    triangles->InsertNextCell(3, triangle);
+  }
+  triangles->UseOffsetsStorage();
+  std::atomic<int> errors(0);
+  ReadTriangles reader = { triangles.GetPointer(), &errors };
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4, "STDThread"), [&]()
+  {
+    vtkSMPTools::For(0, numCells, 10, reader);
+  });
+  vtkTestCheckMacro(errors == 0);
+  vtkTestCheckMacro(triangles->IsStorage32Bit());
+
+  // Reading the cells of a poly data does not change their storage
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numCells + 3);
+  vtkNew<vtkCellArray> verts;
+  vtkIdType vert = 2;
+  verts->InsertNextCell(1, &vert);
+  vtkNew<vtkCellArray> polys;
+  vtkIdType quad[4];
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    // Alternate triangles and quads
+    for (vtkIdType j = 0; j < 4; ++j)
+    {
+      quad[j] = i + j;
+    }
+    polys->InsertNextCell(3 + i % 2, quad);
+  }
+  polys->UseOffsetsStorage();
+  vtkNew<vtkPolyData> pd;
+  pd->SetPoints(points.GetPointer());
+  pd->SetVerts(verts.GetPointer());
+  pd->SetPolys(polys.GetPointer());
+  pd->BuildLinks();
+  vtkTestCheckMacro(pd->GetCellType(0) == VTK_VERTEX);
+  vtkTestCheckMacro(pd->GetCellType(1) == VTK_TRIANGLE);
+  vtkTestCheckMacro(pd->GetCellType(2) == VTK_QUAD);
+  vtkTestCheckMacro(pd->GetCell(numCells)->GetNumberOfPoints() == 4);
+  pd->GetCellPoints(numCells, ptIds.GetPointer());
+  vtkTestCheckMacro(ptIds->GetId(3) == numCells + 2);
+  pd->GetPointCells(numCells + 2, ptIds.GetPointer());
+  vtkTestCheckMacro(ptIds->GetNumberOfIds() == 1 &&
+    ptIds->GetId(0) == numCells);
+  vtkTestCheckMacro(polys->IsStorage32Bit() && verts->IsStorageLegacy());
+
+  // Cells changed in place through the poly data
+  pd->ReplaceCellPoint(numCells, numCells + 2, 0);
+  pd->GetCellPoints(numCells, ptIds.GetPointer());
+  vtkTestCheckMacro(ptIds->GetId(3) == 0 && ptIds->GetId(2) == numCells + 1);
+  vtkTestCheckMacro(polys->IsStorage32Bit());
+
+  return 0;
+}
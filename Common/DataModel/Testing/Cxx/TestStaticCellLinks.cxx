@@ -22,6 +22,29 @@
 #include "vtkSphere.h"
 #include "vtkSphereSource.h"
 #include "vtkTimerLog.h"
+#include "vtkCellArray.h"
+
+#include <algorithm>
+#include <set>
+
+namespace
+{
+
+// Records the id type and the number of cells using the first point.
+struct LinksWorker
+{
+  size_t IdSize;
+  vtkIdType NumCells;
+
+  template <typename TIds>
+  void operator()(vtkStaticCellLinksTemplate<TIds> &links)
+  {
+    this->IdSize = sizeof(TIds);
+    this->NumCells = links.GetNumberOfCells(0);
+  }
+};
+
+}
 
 // Test the building of static cell links in both unstructured and structured
 // grids.
@@ -191,5 +214,60 @@ int TestStaticCellLinks( int, char *[] )
     return EXIT_FAILURE;
   }
 
+  //----------------------------------------------------------------------------
+  // Offsets storage: the links are built in parallel and sorted, and match
+  // the links built serially from the legacy storage.
+  vtkStaticCellLinksTemplate<vtkIdType> legacyLinks;
+  legacyLinks.BuildLinks(pdata);
+
+  pdata->GetPolys()->UseOffsetsStorage();
+  vtkStaticCellLinksTemplate<int> threadedLinks;
+  threadedLinks.BuildLinks(pdata);
+  vtkStaticCellLinksTemplate<int> serialLinks;
+  serialLinks.SetSequentialProcessing(true);
+  serialLinks.BuildLinks(pdata);
+  if ( !pdata->GetPolys()->IsStorage32Bit() )
+  {
+    cout << "Building links converted the cell array\n";
+    return EXIT_FAILURE;
+  }
+
+  for (vtkIdType ptId=0; ptId < pdata->GetNumberOfPoints(); ++ptId)
+  {
+    numCells = threadedLinks.GetNumberOfCells(ptId);
+    cells = threadedLinks.GetCells(ptId);
+    const int *serialCells = serialLinks.GetCells(ptId);
+    std::set<vtkIdType> legacyCells(legacyLinks.GetCells(ptId),
+      legacyLinks.GetCells(ptId) + legacyLinks.GetNumberOfCells(ptId));
+    if ( numCells != legacyLinks.GetNumberOfCells(ptId) ||
+         numCells != serialLinks.GetNumberOfCells(ptId) ||
+         !std::is_sorted(cells, cells + numCells) ||
+         !std::equal(cells, cells + numCells, serialCells) ||
+         !std::equal(cells, cells + numCells, legacyCells.begin()) )
+    {
+      cout << "Offsets storage: wrong links for point " << ptId << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The int links take half the memory of vtkIdType links
+  if ( sizeof(vtkIdType) == 8 &&
+       2 * threadedLinks.GetActualMemorySize() >
+       legacyLinks.GetActualMemorySize() + 1 )
+  {
+    cout << "Offsets storage: int links are too large\n";
+    return EXIT_FAILURE;
+  }
+
+  // Automatic selection of the id type
+  LinksWorker worker;
+  vtkStaticCellLinksDispatch::Execute(pdata, worker);
+  if ( worker.IdSize != sizeof(int) || worker.NumCells != 12 ||
+       vtkStaticCellLinksDispatch::UseLargeIds(pdata) )
+  {
+    cout << "Dispatch: wrong id type or links\n";
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -14,9 +14,114 @@
 =========================================================================*/
 #include "vtkCellArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSimpleCriticalSection.h"
+
+#include <limits>
 
 vtkStandardNewMacro(vtkCellArray);
 
+namespace
+{
+
+// Fill the offsets and connectivity arrays from a legacy cell array.
+template <typename ArrayT>
+void vtkCellArrayLegacyToOffsets(vtkIdTypeArray *legacy, vtkIdType numCells,
+                                 ArrayT *offsets, ArrayT *connectivity)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  vtkIdType size = legacy->GetMaxId() + 1;
+  offsets->SetNumberOfValues(numCells + 1);
+  connectivity->SetNumberOfValues(size - numCells);
+  const vtkIdType *in = legacy->GetPointer(0);
+  ValueType *offset = offsets->GetPointer(0);
+  ValueType *out = connectivity->GetPointer(0);
+  vtkIdType numIds = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    offset[cellId] = static_cast<ValueType>(numIds);
+    vtkIdType npts = *in++;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      out[numIds++] = static_cast<ValueType>(*in++);
+    }
+  }
+  offset[numCells] = static_cast<ValueType>(numIds);
+}
+
+// Fill a legacy cell array from the offsets and connectivity arrays.
+template <typename ArrayT>
+void vtkCellArrayOffsetsToLegacy(ArrayT *offsets, ArrayT *connectivity,
+                                 vtkIdType numCells, vtkIdTypeArray *legacy)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  legacy->SetNumberOfValues(connectivity->GetNumberOfValues() + numCells);
+  const ValueType *offset = offsets->GetPointer(0);
+  const ValueType *in = connectivity->GetPointer(0);
+  vtkIdType *out = legacy->GetPointer(0);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    *out++ = offset[cellId + 1] - offset[cellId];
+    out = std::copy(in + offset[cellId], in + offset[cellId + 1], out);
+  }
+}
+
+// Copy the values of an array to an array of another type.
+template <typename SourceT, typename DestT>
+void vtkCellArrayCopyValues(SourceT *source, DestT *dest)
+{
+  typedef typename DestT::ValueType ValueType;
+  vtkIdType numValues = source->GetNumberOfValues();
+  dest->SetNumberOfValues(numValues);
+  const typename SourceT::ValueType *in = source->GetPointer(0);
+  ValueType *out = dest->GetPointer(0);
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    out[i] = static_cast<ValueType>(in[i]);
+  }
+}
+
+// Cell whose legacy location (offset + cellId) is loc. When the cells before
+// it have the size of the first cell, as in meshes of a single cell type, the
+// location gives the cell id directly: the binary search is only needed
+// otherwise.
+template <typename ArrayT>
+vtkIdType vtkCellArrayCellIdFromLocation(ArrayT *offsets, vtkIdType numCells,
+                                         vtkIdType loc)
+{
+  if (numCells > 0)
+  {
+    vtkIdType guess = loc / (offsets->GetValue(1) + 1);
+    if (guess < numCells && offsets->GetValue(guess) + guess == loc)
+    {
+      return guess;
+    }
+  }
+
+  vtkIdType lo = 0;
+  vtkIdType hi = numCells;
+  while (lo < hi)
+  {
+    vtkIdType mid = lo + (hi - lo) / 2;
+    if (offsets->GetValue(mid) + mid < loc)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+inline bool vtkCellArrayFitsIn32Bit(vtkIdType id)
+{
+  return id >= std::numeric_limits<vtkTypeInt32>::min() &&
+         id <= std::numeric_limits<vtkTypeInt32>::max();
+}
+
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 vtkCellArray::vtkCellArray()
 {
@@ -24,6 +129,15 @@ vtkCellArray::vtkCellArray()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+
+  this->Storage = LEGACY_STORAGE;
+  this->Offsets64 = NULL;
+  this->Connectivity64 = NULL;
+  this->Offsets32 = NULL;
+  this->Connectivity32 = NULL;
+  this->TraversalCellId = 0;
+  this->Connectivity32Ids = NULL;
+  this->Connectivity32IdsLock = new vtkSimpleCriticalSection;
 }
 
 //----------------------------------------------------------------------------
@@ -35,25 +149,117 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     return;
   }
 
+  this->ReleaseOffsetsStorage();
   this->Ia->DeepCopy(ca->Ia);
+  if (ca->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    vtkIdTypeArray *offsets = vtkIdTypeArray::New();
+    vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+    offsets->DeepCopy(ca->Offsets64);
+    connectivity->DeepCopy(ca->Connectivity64);
+    this->SetData(offsets, connectivity);
+    offsets->Delete();
+    connectivity->Delete();
+  }
+  else if (ca->Storage == OFFSETS_32BIT_STORAGE)
+  {
+    vtkTypeInt32Array *offsets = vtkTypeInt32Array::New();
+    vtkTypeInt32Array *connectivity = vtkTypeInt32Array::New();
+    offsets->DeepCopy(ca->Offsets32);
+    connectivity->DeepCopy(ca->Connectivity32);
+    this->SetData(offsets, connectivity);
+    offsets->Delete();
+    connectivity->Delete();
+  }
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
   this->TraversalLocation = ca->TraversalLocation;
+  this->TraversalCellId = ca->TraversalCellId;
 }
 
 //----------------------------------------------------------------------------
 vtkCellArray::~vtkCellArray()
 {
+  this->ReleaseOffsetsStorage();
   this->Ia->Delete();
+  delete this->Connectivity32IdsLock;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::Allocate(const vtkIdType sz, const int ext)
+{
+  switch (this->Storage)
+  {
+    case OFFSETS_64BIT_STORAGE:
+      return this->Connectivity64->Allocate(sz, ext);
+    case OFFSETS_32BIT_STORAGE:
+      return this->Connectivity32->Allocate(sz, ext);
+    default:
+      return this->Ia->Allocate(sz, ext);
+  }
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::Initialize()
 {
   this->Ia->Initialize();
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    this->Offsets64->Initialize();
+    this->Offsets64->InsertNextValue(0);
+    this->Connectivity64->Initialize();
+  }
+  else if (this->Storage == OFFSETS_32BIT_STORAGE)
+  {
+    this->ReleaseConnectivity32Ids();
+    this->Offsets32->Initialize();
+    this->Offsets32->InsertNextValue(0);
+    this->Connectivity32->Initialize();
+  }
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetSize()
+{
+  switch (this->Storage)
+  {
+    case OFFSETS_64BIT_STORAGE:
+      return this->Offsets64->GetSize() + this->Connectivity64->GetSize();
+    case OFFSETS_32BIT_STORAGE:
+      return this->Offsets32->GetSize() + this->Connectivity32->GetSize();
+    default:
+      return this->Ia->GetSize();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  this->Ia->Squeeze();
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    this->Offsets64->Squeeze();
+    this->Connectivity64->Squeeze();
+  }
+  else if (this->Storage == OFFSETS_32BIT_STORAGE)
+  {
+    this->Offsets32->Squeeze();
+    this->Connectivity32->Squeeze();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetTraversalLocation(vtkIdType loc)
+{
+  this->TraversalLocation = loc;
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->TraversalCellId = this->GetCellIdFromLocation(loc);
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -63,6 +269,15 @@ int vtkCellArray::GetMaxCellSize()
 {
   int i, npts=0, maxSize=0;
 
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    for (vtkIdType cellId = 0; cellId < this->NumberOfCells; ++cellId)
+    {
+      maxSize = std::max(maxSize, static_cast<int>(this->GetCellSize(cellId)));
+    }
+    return maxSize;
+  }
+
   for (i=0; i<this->Ia->GetMaxId(); i+=(npts+1))
   {
     if ( (npts=this->Ia->GetValue(i)) > maxSize )
@@ -79,6 +294,7 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 {
   if ( cells && cells != this->Ia )
   {
+    this->ReleaseOffsetsStorage();
     this->Modified();
     this->Ia->Delete();
     this->Ia = cells;
@@ -93,7 +309,18 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    size += this->Offsets64->GetActualMemorySize() +
+            this->Connectivity64->GetActualMemorySize();
+  }
+  else if (this->Storage == OFFSETS_32BIT_STORAGE)
+  {
+    size += this->Offsets32->GetActualMemorySize() +
+            this->Connectivity32->GetActualMemorySize();
+  }
+  return size;
 }
 
 //----------------------------------------------------------------------------
@@ -115,8 +342,14 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
 {
-  vtkIdType npts = this->Ia->GetValue(loc++);
-  vtkIdType *ppts = this->Ia->GetPointer(loc);
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    // Copies the point ids straight into pts.
+    this->GetCellAtId(this->GetCellIdFromLocation(loc), pts);
+    return;
+  }
+  vtkIdType npts, *ppts;
+  this->GetCell(loc, npts, ppts);
   pts->SetNumberOfIds(npts);
   for (vtkIdType i = 0; i < npts; i++)
   {
@@ -132,4 +365,465 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Storage: "
+     << (this->Storage == OFFSETS_64BIT_STORAGE ? "Offsets 64 bit" :
+         this->Storage == OFFSETS_32BIT_STORAGE ? "Offsets 32 bit" : "Legacy")
+     << endl;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::CanConvertTo32BitStorage()
+{
+  vtkIdType numIds =
+    this->GetNumberOfConnectivityEntries() - this->NumberOfCells;
+  if (!vtkCellArrayFitsIn32Bit(numIds))
+  {
+    return false;
+  }
+  switch (this->Storage)
+  {
+    case OFFSETS_32BIT_STORAGE:
+      return true;
+    case OFFSETS_64BIT_STORAGE:
+    {
+      const vtkIdType *ids = this->Connectivity64->GetPointer(0);
+      for (vtkIdType i = 0; i < numIds; ++i)
+      {
+        if (!vtkCellArrayFitsIn32Bit(ids[i]))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+    {
+      const vtkIdType *ids = this->Ia->GetPointer(0);
+      const vtkIdType *end = ids + this->Ia->GetMaxId() + 1;
+      while (ids < end)
+      {
+        vtkIdType npts = *ids++;
+        for (vtkIdType i = 0; i < npts; ++i, ++ids)
+        {
+          if (!vtkCellArrayFitsIn32Bit(*ids))
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::UseOffsetsStorage(bool allow32Bit)
+{
+  bool use32Bit = allow32Bit && this->CanConvertTo32BitStorage();
+  int storage = use32Bit ? OFFSETS_32BIT_STORAGE : OFFSETS_64BIT_STORAGE;
+  if (storage == this->Storage)
+  {
+    return;
+  }
+
+  vtkIdType numCells = this->NumberOfCells;
+  vtkIdType insertLocation = this->InsertLocation;
+  vtkIdType traversalLocation = this->TraversalLocation;
+  if (use32Bit)
+  {
+    vtkTypeInt32Array *offsets = vtkTypeInt32Array::New();
+    vtkTypeInt32Array *connectivity = vtkTypeInt32Array::New();
+    if (this->Storage == LEGACY_STORAGE)
+    {
+      vtkCellArrayLegacyToOffsets(this->Ia, numCells, offsets, connectivity);
+    }
+    else
+    {
+      vtkCellArrayCopyValues(this->Offsets64, offsets);
+      vtkCellArrayCopyValues(this->Connectivity64, connectivity);
+    }
+    this->SetData(offsets, connectivity);
+    offsets->Delete();
+    connectivity->Delete();
+  }
+  else
+  {
+    vtkIdTypeArray *offsets = vtkIdTypeArray::New();
+    vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+    if (this->Storage == LEGACY_STORAGE)
+    {
+      vtkCellArrayLegacyToOffsets(this->Ia, numCells, offsets, connectivity);
+    }
+    else
+    {
+      vtkCellArrayCopyValues(this->Offsets32, offsets);
+      vtkCellArrayCopyValues(this->Connectivity32, connectivity);
+    }
+    this->SetData(offsets, connectivity);
+    offsets->Delete();
+    connectivity->Delete();
+  }
+
+  // The cells are unchanged: keep the legacy locations.
+  this->InsertLocation = insertLocation;
+  this->SetTraversalLocation(traversalLocation);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::UseLegacyStorage()
+{
+  if (this->Storage == LEGACY_STORAGE)
+  {
+    return;
+  }
+
+  vtkDebugMacro(<< "Converting " << this->NumberOfCells
+                << " cells to the legacy storage");
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    vtkCellArrayOffsetsToLegacy(this->Offsets64, this->Connectivity64,
+                                this->NumberOfCells, this->Ia);
+  }
+  else
+  {
+    vtkCellArrayOffsetsToLegacy(this->Offsets32, this->Connectivity32,
+                                this->NumberOfCells, this->Ia);
+  }
+  this->ReleaseOffsetsStorage();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseOffsetsStorage()
+{
+  if (this->Storage == LEGACY_STORAGE)
+  {
+    return;
+  }
+  if (this->Offsets64)
+  {
+    this->Offsets64->UnRegister(this);
+    this->Connectivity64->UnRegister(this);
+    this->Offsets64 = NULL;
+    this->Connectivity64 = NULL;
+  }
+  if (this->Offsets32)
+  {
+    this->ReleaseConnectivity32Ids();
+    this->Offsets32->UnRegister(this);
+    this->Connectivity32->UnRegister(this);
+    this->Offsets32 = NULL;
+    this->Connectivity32 = NULL;
+  }
+  this->Storage = LEGACY_STORAGE;
+  this->TraversalCellId = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkIdTypeArray *offsets,
+                           vtkIdTypeArray *connectivity)
+{
+  if (!offsets || !connectivity || offsets->GetNumberOfValues() < 1)
+  {
+    vtkErrorMacro("The offsets array must contain at least one value.");
+    return;
+  }
+
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->ReleaseOffsetsStorage();
+  this->Ia->Initialize();
+  this->Offsets64 = offsets;
+  this->Connectivity64 = connectivity;
+  this->Storage = OFFSETS_64BIT_STORAGE;
+
+  this->NumberOfCells = offsets->GetNumberOfValues() - 1;
+  this->InsertLocation = connectivity->GetNumberOfValues() +
+                         this->NumberOfCells;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkTypeInt32Array *offsets,
+                           vtkTypeInt32Array *connectivity)
+{
+  if (!offsets || !connectivity || offsets->GetNumberOfValues() < 1)
+  {
+    vtkErrorMacro("The offsets array must contain at least one value.");
+    return;
+  }
+
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->ReleaseOffsetsStorage();
+  this->Ia->Initialize();
+  this->Offsets32 = offsets;
+  this->Connectivity32 = connectivity;
+  this->Storage = OFFSETS_32BIT_STORAGE;
+
+  this->NumberOfCells = offsets->GetNumberOfValues() - 1;
+  this->InsertLocation = connectivity->GetNumberOfValues() +
+                         this->NumberOfCells;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkCellArray::GetOffsetsArray()
+{
+  switch (this->Storage)
+  {
+    case OFFSETS_64BIT_STORAGE:
+      return this->Offsets64;
+    case OFFSETS_32BIT_STORAGE:
+      return this->Offsets32;
+    default:
+      return NULL;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkCellArray::GetConnectivityArray()
+{
+  switch (this->Storage)
+  {
+    case OFFSETS_64BIT_STORAGE:
+      return this->Connectivity64;
+    case OFFSETS_32BIT_STORAGE:
+      return this->Connectivity32;
+    default:
+      return NULL;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId)
+{
+  switch (this->Storage)
+  {
+    case OFFSETS_64BIT_STORAGE:
+      return this->Offsets64->GetValue(cellId + 1) -
+             this->Offsets64->GetValue(cellId);
+    case OFFSETS_32BIT_STORAGE:
+      return this->Offsets32->GetValue(cellId + 1) -
+             this->Offsets32->GetValue(cellId);
+    default:
+    {
+      vtkIdType npts;
+      const vtkIdType *pts;
+      this->GetLegacyCellAtId(cellId, npts, pts);
+      return npts;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *pts)
+{
+  vtkIdType npts;
+  const vtkIdType *ppts;
+  this->GetCellAtId(cellId, npts, ppts, pts);
+  if (ppts != pts->GetPointer(0))
+  {
+    pts->SetNumberOfIds(npts);
+    std::copy(ppts, ppts + npts, pts->GetPointer(0));
+  }
+}
+
+//----------------------------------------------------------------------------
+// The legacy storage has no random access: walk the cells.
+void vtkCellArray::GetLegacyCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                     const vtkIdType* &pts)
+{
+  const vtkIdType *ids = this->Ia->GetPointer(0);
+  for (vtkIdType i = 0; i < cellId; ++i)
+  {
+    ids += *ids + 1;
+  }
+  npts = *ids;
+  pts = ids + 1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellInOffsets(vtkIdType npts,
+                                                const vtkIdType* pts)
+{
+  vtkIdType numIds = this->InsertLocation - this->NumberOfCells;
+  if (this->Storage == OFFSETS_32BIT_STORAGE)
+  {
+    bool fits = vtkCellArrayFitsIn32Bit(numIds + npts);
+    for (vtkIdType i = 0; fits && i < npts; ++i)
+    {
+      fits = vtkCellArrayFitsIn32Bit(pts[i]);
+    }
+    if (!fits)
+    {
+      this->UseOffsetsStorage(false);
+    }
+  }
+
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    vtkIdType *ptr = this->Connectivity64->WritePointer(numIds, npts);
+    std::copy(pts, pts + npts, ptr);
+    this->Offsets64->InsertNextValue(numIds + npts);
+  }
+  else
+  {
+    this->ReleaseConnectivity32Ids();
+    vtkTypeInt32 *ptr = this->Connectivity32->WritePointer(numIds, npts);
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      ptr[i] = static_cast<vtkTypeInt32>(pts[i]);
+    }
+    this->Offsets32->InsertNextValue(static_cast<vtkTypeInt32>(numIds + npts));
+  }
+
+  this->NumberOfCells++;
+  this->InsertLocation += npts + 1;
+
+  return this->NumberOfCells - 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::InsertCellPointInOffsets(vtkIdType id)
+{
+  vtkIdType numIds = this->InsertLocation - this->NumberOfCells;
+  if (this->Storage == OFFSETS_32BIT_STORAGE &&
+      !(vtkCellArrayFitsIn32Bit(id) && vtkCellArrayFitsIn32Bit(numIds + 1)))
+  {
+    this->UseOffsetsStorage(false);
+  }
+
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    this->Connectivity64->InsertNextValue(id);
+    this->Offsets64->SetValue(this->NumberOfCells, numIds + 1);
+  }
+  else
+  {
+    this->ReleaseConnectivity32Ids();
+    this->Connectivity32->InsertNextValue(static_cast<vtkTypeInt32>(id));
+    this->Offsets32->SetValue(this->NumberOfCells,
+                              static_cast<vtkTypeInt32>(numIds + 1));
+  }
+  this->InsertLocation++;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::GetNextCellFromOffsets(vtkIdType& npts, vtkIdType* &pts)
+{
+  if (this->TraversalCellId < this->NumberOfCells)
+  {
+    pts = this->GetCellPointsFromOffsets(this->TraversalCellId++, npts);
+    this->TraversalLocation += npts + 1;
+    return 1;
+  }
+  npts = 0;
+  pts = 0;
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellIdFromLocation(vtkIdType loc)
+{
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    return vtkCellArrayCellIdFromLocation(this->Offsets64,
+                                          this->NumberOfCells, loc);
+  }
+  return vtkCellArrayCellIdFromLocation(this->Offsets32,
+                                        this->NumberOfCells, loc);
+}
+
+//----------------------------------------------------------------------------
+// With 32 bit storage, the point ids point into the vtkIdType copy of the
+// connectivity, so that they stay valid while other cells are read.
+vtkIdType* vtkCellArray::GetCellPointsFromOffsets(vtkIdType cellId,
+                                                  vtkIdType &npts)
+{
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    vtkIdType begin = this->Offsets64->GetValue(cellId);
+    npts = this->Offsets64->GetValue(cellId + 1) - begin;
+    return this->Connectivity64->GetPointer(begin);
+  }
+
+  vtkTypeInt32 begin = this->Offsets32->GetValue(cellId);
+  npts = this->Offsets32->GetValue(cellId + 1) - begin;
+  return this->GetConnectivity32Ids()->GetPointer(begin);
+}
+
+//----------------------------------------------------------------------------
+// Built once, under the lock, by the first of possibly concurrent readers.
+vtkIdTypeArray* vtkCellArray::GetConnectivity32Ids()
+{
+  vtkIdTypeArray *ids = this->Connectivity32Ids;
+  if (!ids)
+  {
+    this->Connectivity32IdsLock->Lock();
+    ids = this->Connectivity32Ids;
+    if (!ids)
+    {
+      ids = vtkIdTypeArray::New();
+      vtkCellArrayCopyValues(this->Connectivity32, ids);
+      this->Connectivity32Ids = ids;
+    }
+    this->Connectivity32IdsLock->Unlock();
+  }
+  return ids;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseConnectivity32Ids()
+{
+  vtkIdTypeArray *ids = this->Connectivity32Ids;
+  if (ids)
+  {
+    this->Connectivity32Ids = NULL;
+    ids->Delete();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetCellPointsInOffsets(vtkIdType cellId,
+                                          const vtkIdType *pts)
+{
+  if (this->Storage == OFFSETS_64BIT_STORAGE)
+  {
+    vtkIdType begin = this->Offsets64->GetValue(cellId);
+    vtkIdType end = this->Offsets64->GetValue(cellId + 1);
+    vtkIdType *ptr = this->Connectivity64->GetPointer(begin);
+    if (ptr != pts)
+    {
+      std::copy(pts, pts + (end - begin), ptr);
+    }
+    return;
+  }
+
+  vtkIdType begin = this->Offsets32->GetValue(cellId);
+  vtkIdType end = this->Offsets32->GetValue(cellId + 1);
+  bool fits = true;
+  for (vtkIdType i = 0; fits && i < end - begin; ++i)
+  {
+    fits = vtkCellArrayFitsIn32Bit(pts[i]);
+  }
+  if (!fits)
+  {
+    this->UseOffsetsStorage(false);
+    this->SetCellPointsInOffsets(cellId, pts);
+    return;
+  }
+  vtkTypeInt32 *ptr = this->Connectivity32->GetPointer(begin);
+  for (vtkIdType i = 0; i < end - begin; ++i)
+  {
+    ptr[i] = static_cast<vtkTypeInt32>(pts[i]);
+  }
+  vtkIdTypeArray *ids = this->Connectivity32Ids;
+  if (ids && ids->GetPointer(begin) != pts)
+  {
+    std::copy(pts, pts + (end - begin), ids->GetPointer(begin));
+  }
 }
@@ -28,6 +28,24 @@
  * using the vtkCellTypes and vtkCellLinks objects to extend the definition of
  * the data structure.
  *
+ * Alternatively, the cells can be stored as two arrays (see
+ * UseOffsetsStorage()): a connectivity array with the point ids of all the
+ * cells, and an offsets array of NumberOfCells + 1 values where cell i uses
+ * the point ids [offsets[i], offsets[i+1]) of the connectivity array. This
+ * storage gives O(1) random access with GetCellAtId(), which is safe to call
+ * from several threads, and can be filled in parallel with SetData(). When
+ * the point ids and the connectivity size allow it, both arrays use 32 bit
+ * ids, which halves the memory of small meshes. The legacy API keeps
+ * working with this storage: locations are still the offsets into the
+ * equivalent legacy array, and GetData(), GetPointer(), WritePointer() and
+ * SetCells() switch back to the legacy storage. With 32 bit ids, the first
+ * GetCell() or GetNextCell() call builds a vtkIdType copy of the
+ * connectivity which the returned point ids point into, so that they stay
+ * valid while other cells are read, until the cells are modified. These
+ * point ids are read only: use ReplaceCell() to change a cell. Finding a
+ * cell from its location is O(1) when the cells have the same size, and
+ * O(log(NumberOfCells)) otherwise.
+ *
  * @sa
  * vtkCellTypes vtkCellLinks
 */
@@ -39,7 +57,13 @@
 #include "vtkObject.h"
 
 #include "vtkIdTypeArray.h" // Needed for inline methods
+#include "vtkTypeInt32Array.h" // Needed for inline methods
 #include "vtkCell.h" // Needed for inline methods
+#include "vtkAtomic.h" // For Connectivity32Ids
+
+#include <algorithm> // Needed for inline methods
+
+class vtkSimpleCriticalSection;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
@@ -55,8 +79,7 @@ public:
   /**
    * Allocate memory and set the size to extend by.
    */
-  int Allocate(const vtkIdType sz, const int ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+  int Allocate(const vtkIdType sz, const int ext=1000);
 
   /**
    * Free any memory and reset to an empty state.
@@ -93,13 +116,16 @@ public:
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  InitTraversal() initializes the traversal of the list of cells.
    */
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal()
+    {this->TraversalLocation=0; this->TraversalCellId=0;};
 
   /**
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  GetNextCell() gets the next cell in the list. If end of list
    * is encountered, 0 is returned. A value of 1 is returned whenever
-   * npts and pts have been updated without error.
+   * npts and pts have been updated without error. With 32 bit storage, pts
+   * points to a read only copy of the point ids that is only valid until
+   * the next call from the same thread (see the class description).
    */
   int GetNextCell(vtkIdType& npts, vtkIdType* &pts);
 
@@ -113,20 +139,25 @@ public:
   /**
    * Get the size of the allocated connectivity array.
    */
-  vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+  vtkIdType GetSize();
 
   /**
    * Get the total number of entries (i.e., data values) in the connectivity
    * array. This may be much less than the allocated size (i.e., return value
-   * from GetSize().)
+   * from GetSize().) This is the size of the legacy array, i.e. it counts
+   * the number of points of each cell, whatever the storage.
    */
   vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+  {
+    return this->Storage == LEGACY_STORAGE ? this->Ia->GetMaxId() + 1 :
+                                             this->InsertLocation;
+  }
 
   /**
    * Internal method used to retrieve a cell given an offset into
-   * the internal array.
+   * the internal array. With 32 bit storage, pts points to a read only copy
+   * of the point ids that is only valid until the next call from the same
+   * thread (see the class description).
    */
   void GetCell(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts);
 
@@ -185,8 +216,7 @@ public:
    */
   vtkIdType GetTraversalLocation()
     {return this->TraversalLocation;}
-  void SetTraversalLocation(vtkIdType loc)
-    {this->TraversalLocation = loc;}
+  void SetTraversalLocation(vtkIdType loc);
 
   /**
    * Computes the current traversal location within the internal array. Used
@@ -216,15 +246,15 @@ public:
   int GetMaxCellSize();
 
   /**
-   * Get pointer to array of cell data.
+   * Get pointer to array of cell data. Switches to the legacy storage.
    */
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+    {this->UseLegacyStorage(); return this->Ia->GetPointer(0);}
 
   /**
    * Get pointer to data array for purpose of direct writes of data. Size is the
    * total storage consumed by the cell array. ncells is the number of cells
-   * represented in the array.
+   * represented in the array. Switches to the legacy storage.
    */
   vtkIdType *WritePointer(const vtkIdType ncells, const vtkIdType size);
 
@@ -235,7 +265,7 @@ public:
    * referring these cells becomes invalid (for example, if BuildCells() has
    * been called see vtkPolyData).  The traversal location is reset to the
    * beginning of the list; the insertion location is set to the end of the
-   * list.
+   * list. Switches to the legacy storage.
    */
   void SetCells(vtkIdType ncells, vtkIdTypeArray *cells);
 
@@ -245,10 +275,11 @@ public:
   void DeepCopy(vtkCellArray *ca);
 
   /**
-   * Return the underlying data as a data array.
+   * Return the underlying data as a data array. Switches to the legacy
+   * storage.
    */
   vtkIdTypeArray* GetData()
-    {return this->Ia;}
+    {this->UseLegacyStorage(); return this->Ia;}
 
   /**
    * Reuse list. Reset to initial condition.
@@ -258,8 +289,7 @@ public:
   /**
    * Reclaim any extra memory.
    */
-  void Squeeze()
-    {this->Ia->Squeeze();}
+  void Squeeze();
 
   /**
    * Return the memory in kibibytes (1024 bytes) consumed by this cell array. Used to
@@ -271,6 +301,93 @@ public:
    */
   unsigned long GetActualMemorySize();
 
+  /**
+   * Storage of the cells, see the class description.
+   */
+  enum StorageTypes
+  {
+    LEGACY_STORAGE = 0,
+    OFFSETS_64BIT_STORAGE,
+    OFFSETS_32BIT_STORAGE
+  };
+
+  //@{
+  /**
+   * Get the current storage.
+   */
+  int GetStorageType()
+    {return this->Storage;}
+  bool IsStorageLegacy()
+    {return this->Storage == LEGACY_STORAGE;}
+  bool IsStorage32Bit()
+    {return this->Storage == OFFSETS_32BIT_STORAGE;}
+  //@}
+
+  /**
+   * Convert the cells to the offsets and connectivity storage. If allow32Bit
+   * is true and CanConvertTo32BitStorage(), 32 bit ids are used. Cells
+   * inserted later with ids or a connectivity size that do not fit in 32
+   * bits switch the storage to 64 bit ids.
+   */
+  void UseOffsetsStorage(bool allow32Bit = true);
+
+  /**
+   * Convert the cells back to the legacy (npts, id0, id1, ...) storage. Does
+   * nothing if the storage is already legacy.
+   */
+  void UseLegacyStorage();
+
+  /**
+   * Returns true if all the point ids and the connectivity size fit in 32
+   * bits.
+   */
+  bool CanConvertTo32BitStorage();
+
+  //@{
+  /**
+   * Use the given arrays as offsets and connectivity storage (see the class
+   * description), without copying them. offsets must have one value more
+   * than the number of cells, the first one being 0. This allows filling
+   * the cells in parallel, e.g. by computing the size of each cell in
+   * offsets, turning them into offsets in place with
+   * vtkSMPTools::ExclusiveScan() and then writing the point ids of each
+   * cell at its offset.
+   */
+  void SetData(vtkIdTypeArray *offsets, vtkIdTypeArray *connectivity);
+  void SetData(vtkTypeInt32Array *offsets, vtkTypeInt32Array *connectivity);
+  //@}
+
+  //@{
+  /**
+   * Return the offsets and connectivity arrays of the offsets storage
+   * (vtkIdTypeArray or vtkTypeInt32Array), or NULL with the legacy storage.
+   */
+  vtkDataArray* GetOffsetsArray();
+  vtkDataArray* GetConnectivityArray();
+  //@}
+
+  /**
+   * Return the number of points of the cell cellId. O(1) with the offsets
+   * storage, linear in cellId with the legacy storage.
+   */
+  vtkIdType GetCellSize(vtkIdType cellId);
+
+  /**
+   * Random access to the cell cellId: npts is set to its number of points
+   * and pts to its point ids, either in place or, with 32 bit storage,
+   * copied into ptIds. This method does not modify the cell array and can
+   * be called from several threads, each with its own ptIds. O(1) with the
+   * offsets storage, linear in cellId with the legacy storage.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, const vtkIdType* &pts,
+                   vtkIdList *ptIds);
+
+  /**
+   * Random access to the cell cellId, whose point ids are copied into pts.
+   * Same as above.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdList *pts);
+
 protected:
   vtkCellArray();
   ~vtkCellArray() VTK_OVERRIDE;
@@ -280,6 +397,32 @@ protected:
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  // Offsets storage: only the arrays of the current storage are not NULL.
+  int Storage;
+  vtkIdTypeArray *Offsets64;
+  vtkIdTypeArray *Connectivity64;
+  vtkTypeInt32Array *Offsets32;
+  vtkTypeInt32Array *Connectivity32;
+  vtkIdType TraversalCellId;
+
+  // vtkIdType copy of Connectivity32 for the methods returning point ids,
+  // built on their first call and released when the cells are modified.
+  vtkAtomic<vtkIdTypeArray*> Connectivity32Ids;
+  vtkSimpleCriticalSection *Connectivity32IdsLock;
+
+  // Legacy API with the offsets storage.
+  vtkIdType InsertNextCellInOffsets(vtkIdType npts, const vtkIdType* pts);
+  void InsertCellPointInOffsets(vtkIdType id);
+  int GetNextCellFromOffsets(vtkIdType& npts, vtkIdType* &pts);
+  vtkIdType GetCellIdFromLocation(vtkIdType loc);
+  vtkIdType* GetCellPointsFromOffsets(vtkIdType cellId, vtkIdType &npts);
+  void SetCellPointsInOffsets(vtkIdType cellId, const vtkIdType *pts);
+  void GetLegacyCellAtId(vtkIdType cellId, vtkIdType &npts,
+                         const vtkIdType* &pts);
+  void ReleaseOffsetsStorage();
+  vtkIdTypeArray* GetConnectivity32Ids();
+  void ReleaseConnectivity32Ids();
+
 private:
   vtkCellArray(const vtkCellArray&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCellArray&) VTK_DELETE_FUNCTION;
@@ -290,6 +433,11 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    return this->InsertNextCellInOffsets(npts, pts);
+  }
+
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
 
@@ -307,6 +455,12 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    // The points are appended by InsertCellPoint().
+    return this->InsertNextCellInOffsets(0, NULL);
+  }
+
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -316,13 +470,23 @@ inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    this->InsertCellPointInOffsets(id);
+    return;
+  }
+
   this->Ia->InsertValue(this->InsertLocation++, id);
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
-  this->Ia->SetValue(this->InsertLocation-npts-1, npts);
+  // The offsets storage does not store the number of points of the cells.
+  if (this->Storage == vtkCellArray::LEGACY_STORAGE)
+  {
+    this->Ia->SetValue(this->InsertLocation-npts-1, npts);
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -344,12 +508,31 @@ inline void vtkCellArray::Reset()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
   this->Ia->Reset();
+  if (this->Storage == vtkCellArray::OFFSETS_64BIT_STORAGE)
+  {
+    this->Offsets64->Reset();
+    this->Offsets64->InsertNextValue(0);
+    this->Connectivity64->Reset();
+  }
+  else if (this->Storage == vtkCellArray::OFFSETS_32BIT_STORAGE)
+  {
+    this->ReleaseConnectivity32Ids();
+    this->Offsets32->Reset();
+    this->Offsets32->InsertNextValue(0);
+    this->Connectivity32->Reset();
+  }
 }
 
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    return this->GetNextCellFromOffsets(npts, pts);
+  }
+
   if ( this->Ia->GetMaxId() >= 0 &&
        this->TraversalLocation <= this->Ia->GetMaxId() )
   {
@@ -367,6 +550,13 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    pts = this->GetCellPointsFromOffsets(this->GetCellIdFromLocation(loc),
+                                         npts);
+    return;
+  }
+
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
@@ -374,6 +564,16 @@ inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
 //----------------------------------------------------------------------------
 inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    vtkIdType cellId = this->GetCellIdFromLocation(loc);
+    vtkIdType npts;
+    vtkIdType *pts = this->GetCellPointsFromOffsets(cellId, npts);
+    std::reverse(pts, pts + npts);
+    this->SetCellPointsInOffsets(cellId, pts);
+    return;
+  }
+
   int i;
   vtkIdType tmp;
   vtkIdType npts=this->Ia->GetValue(loc);
@@ -390,6 +590,12 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
                                       const vtkIdType *pts)
 {
+  if (this->Storage != vtkCellArray::LEGACY_STORAGE)
+  {
+    this->SetCellPointsInOffsets(this->GetCellIdFromLocation(loc), pts);
+    return;
+  }
+
   vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
   for (int i=0; i < npts; i++)
   {
@@ -401,10 +607,41 @@ inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
 inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
                                              const vtkIdType size)
 {
+  this->ReleaseOffsetsStorage();
   this->NumberOfCells = ncells;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
   return this->Ia->WritePointer(0,size);
 }
 
+//----------------------------------------------------------------------------
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      const vtkIdType* &pts,
+                                      vtkIdList *ptIds)
+{
+  switch (this->Storage)
+  {
+    case vtkCellArray::OFFSETS_64BIT_STORAGE:
+    {
+      vtkIdType begin = this->Offsets64->GetValue(cellId);
+      npts = this->Offsets64->GetValue(cellId + 1) - begin;
+      pts = this->Connectivity64->GetPointer(begin);
+      break;
+    }
+    case vtkCellArray::OFFSETS_32BIT_STORAGE:
+    {
+      vtkTypeInt32 begin = this->Offsets32->GetValue(cellId);
+      npts = this->Offsets32->GetValue(cellId + 1) - begin;
+      const vtkTypeInt32 *cellPts = this->Connectivity32->GetPointer(begin);
+      ptIds->SetNumberOfIds(npts);
+      vtkIdType *ids = ptIds->GetPointer(0);
+      std::copy(cellPts, cellPts + npts, ids);
+      pts = ids;
+      break;
+    }
+    default:
+      this->GetLegacyCellAtId(cellId, npts, pts);
+      break;
+  }
+}
 #endif
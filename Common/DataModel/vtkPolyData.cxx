@@ -918,6 +918,34 @@ void vtkPolyData::DeleteCells()
   }
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+// Sizes of the cells of a cell array in order, read in place with the legacy
+// storage and from the offsets otherwise, without converting the storage.
+class vtkPolyDataCellSizes
+{
+public:
+  vtkPolyDataCellSizes(vtkCellArray *cells)
+    : Cells(cells),
+      Legacy(cells->IsStorageLegacy() ? cells->GetPointer() : NULL)
+  {
+  }
+
+  // Number of points of the cell cellId, at location loc.
+  vtkIdType GetCellSize(vtkIdType cellId, vtkIdType loc)
+  {
+    return this->Legacy ? this->Legacy[loc] : this->Cells->GetCellSize(cellId);
+  }
+
+private:
+  vtkCellArray *Cells;
+  const vtkIdType *Legacy;
+};
+
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 // Create data structure that allows random access of cells.
 void vtkPolyData::BuildCells()
@@ -947,103 +975,68 @@ void vtkPolyData::BuildCells()
   vtkIntArray *locs = vtkIntArray::New();
   int *pLocs = locs->WritePointer(0, nCells);
 
-  // record locations and type of each cell.
+  // record locations and type of each cell. The cell arrays are read with
+  // vtkPolyDataCellSizes so that the offsets storage is not converted.
   // verts
   vtkIdType numCellPts;
-  vtkIdType nextCellPts;
-  if (nVerts)
-  {
-    vtkIdType *pVerts = vertCells->GetData()->GetPointer(0);
-    numCellPts = pVerts[0];
-    nextCellPts = numCellPts + 1;
-    pLocs[0] = 0;
-    pTypes[0] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
-    for (vtkIdType i = 1; i < nVerts; ++i)
-    {
-      numCellPts = pVerts[nextCellPts];
-      pLocs[i] = nextCellPts;
-      pTypes[i] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
-      nextCellPts += numCellPts + 1;
-    }
-    pLocs += nVerts;
-    pTypes += nVerts;
+  vtkIdType nextCellPts = 0;
+  vtkPolyDataCellSizes vertSizes(vertCells);
+  for (vtkIdType i = 0; i < nVerts; ++i)
+  {
+    numCellPts = vertSizes.GetCellSize(i, nextCellPts);
+    pLocs[i] = nextCellPts;
+    pTypes[i] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
+    nextCellPts += numCellPts + 1;
   }
+  pLocs += nVerts;
+  pTypes += nVerts;
 
   // lines
-  if (nLines)
+  nextCellPts = 0;
+  vtkPolyDataCellSizes lineSizes(lineCells);
+  for (vtkIdType i = 0; i < nLines; ++i)
   {
-    vtkIdType *pLines = lineCells->GetData()->GetPointer(0);
-    numCellPts = pLines[0];
-    pLocs[0] = 0;
-    pTypes[0] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
+    numCellPts = lineSizes.GetCellSize(i, nextCellPts);
+    pLocs[i] = nextCellPts;
+    pTypes[i] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
     if (numCellPts == 1)
     {
-      vtkWarningMacro("Building VTK_LINE 0 with only one point, but VTK_LINE "
-      "needs at least two points. Check the input.");
+      vtkWarningMacro("Building VTK_LINE " << i <<" with only one point, but "
+      "VTK_LINE needs at least two points. Check the input.");
     }
-    nextCellPts = numCellPts + 1;
-    for (vtkIdType i = 1; i < nLines; ++i)
-    {
-      numCellPts = pLines[nextCellPts];
-      pLocs[i] = nextCellPts;
-      pTypes[i] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
-      if (numCellPts == 1)
-      {
-        vtkWarningMacro("Building VTK_LINE " << i <<" with only one point, but "
-        "VTK_LINE needs at least two points. Check the input.");
-      }
-      nextCellPts += numCellPts + 1;
-    }
-    pLocs += nLines;
-    pTypes += nLines;
+    nextCellPts += numCellPts + 1;
   }
+  pLocs += nLines;
+  pTypes += nLines;
 
   // polys
-  if (nPolys)
+  nextCellPts = 0;
+  vtkPolyDataCellSizes polySizes(polyCells);
+  for (vtkIdType i = 0; i < nPolys; ++i)
   {
-    vtkIdType *pPolys = polyCells->GetData()->GetPointer(0);
-    numCellPts = pPolys[0];
-    pLocs[0] = 0;
+    numCellPts = polySizes.GetCellSize(i, nextCellPts);
+    pLocs[i] = nextCellPts;
     if (numCellPts < 3)
     {
-      vtkWarningMacro("Building VTK_TRIANGLE 0 with less than three points, but"
-      " VTK_TRIANGLE needs at least three points. Check the input.");
+      vtkWarningMacro("Building VTK_TRIANGLE "<< i << " with less than three "
+      "points, but VTK_TRIANGLE needs at least three points. "
+      "Check the input.");
     }
-    pTypes[0] = numCellPts == 3 ? VTK_TRIANGLE :
+    pTypes[i] = numCellPts == 3 ? VTK_TRIANGLE :
       numCellPts == 4 ? VTK_QUAD : VTK_POLYGON;
-    nextCellPts = numCellPts + 1;
-    for (vtkIdType i = 1; i < nPolys; ++i)
-    {
-      numCellPts = pPolys[nextCellPts];
-      pLocs[i] = nextCellPts;
-      if (numCellPts < 3)
-      {
-        vtkWarningMacro("Building VTK_TRIANGLE "<< i << " with less than three "
-        "points, but VTK_TRIANGLE needs at least three points. "
-        "Check the input.");
-      }
-      pTypes[i] = numCellPts == 3 ? VTK_TRIANGLE :
-        numCellPts == 4 ? VTK_QUAD : VTK_POLYGON;
-      nextCellPts += numCellPts + 1;
-    }
-    pLocs += nPolys;
-    pTypes += nPolys;
+    nextCellPts += numCellPts + 1;
   }
+  pLocs += nPolys;
+  pTypes += nPolys;
 
   // strips
-  if (nStrips)
-  {
-    std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
-    vtkIdType *pStrips = stripCells->GetData()->GetPointer(0);
-    numCellPts = pStrips[0];
-    pLocs[0] = 0;
-    nextCellPts = numCellPts + 1;
-    for (vtkIdType i = 1; i < nStrips; ++i)
-    {
-      numCellPts = pStrips[nextCellPts];
-      pLocs[i] = nextCellPts;
-      nextCellPts += numCellPts + 1;
-    }
+  std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
+  nextCellPts = 0;
+  vtkPolyDataCellSizes stripSizes(stripCells);
+  for (vtkIdType i = 0; i < nStrips; ++i)
+  {
+    pLocs[i] = nextCellPts;
+    nextCellPts += stripSizes.GetCellSize(i, nextCellPts) + 1;
   }
 
   // set up the cell types data structure
@@ -1108,6 +1101,30 @@ void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
     this->BuildCells();
   }
 
+  // The offsets storage is read without going through the shared buffer of
+  // the legacy API, so that concurrent reads are safe.
+  vtkCellArray *cells = NULL;
+  switch (this->Cells->GetCellType(cellId))
+  {
+    case VTK_VERTEX: case VTK_POLY_VERTEX:
+      cells = this->Verts;
+      break;
+    case VTK_LINE: case VTK_POLY_LINE:
+      cells = this->Lines;
+      break;
+    case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
+      cells = this->Polys;
+      break;
+    case VTK_TRIANGLE_STRIP:
+      cells = this->Strips;
+      break;
+  }
+  if (cells && !cells->IsStorageLegacy())
+  {
+    cells->GetCell(this->Cells->GetCellLocation(cellId), ptIds);
+    return;
+  }
+
   this->vtkPolyData::GetCellPoints(cellId, npts, pts);
   ptIds->InsertId (npts-1,pts[npts-1]);
   for (i=0; i<npts-1; i++)
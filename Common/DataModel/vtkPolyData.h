@@ -299,7 +299,9 @@ public:
    * Get a pointer to a list of point ids defining cell. More efficient
    * because pointer points directly to cell array internals and this
    * is not a virtual call. However, this requires that cells have been
-   * built (with BuildCells()). The cell type is returned.
+   * built (with BuildCells()). The cell type is returned. With a cell array
+   * in 32 bit offsets storage, pts is a read only copy (see
+   * vtkCellArray): use ReplaceCell() to change the cell.
    */
   unsigned char GetCellPoints(vtkIdType cellId,
       vtkIdType& npts, vtkIdType* &pts);
@@ -668,7 +670,9 @@ inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
   {
     if ( verts[i] == oldPtId )
     {
-      verts[i] = newPtId; // this is very nasty! direct write!
+      // verts may be a copy of the point ids: write them back to the cells.
+      verts[i] = newPtId;
+      this->ReplaceCell(cellId, static_cast<int>(nverts), verts);
       return;
     }
   }
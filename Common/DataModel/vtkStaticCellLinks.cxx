@@ -33,4 +33,7 @@ vtkStaticCellLinks::~vtkStaticCellLinks()
 void vtkStaticCellLinks::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Sequential Processing: "
+     << (this->GetSequentialProcessing() ? "On\n" : "Off\n");
 }
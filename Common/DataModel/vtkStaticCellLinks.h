@@ -34,7 +34,8 @@
  * instantiating vtkStaticCellLinksTemplate with a vtkIdType template
  * parameter. Note that for best performance, the vtkStaticCellLinksTemplate
  * class may be used directly, instantiating it with the appropriate id
- * type. This class is also wrappable and can be used from an interpreted
+ * type, or through vtkStaticCellLinksDispatch which selects int ids when
+ * the dataset allows it. This class is also wrappable and can be used from an interpreted
  * language such as Python.
  *
  * @sa
@@ -95,6 +96,24 @@ public:
   void Initialize()
     {this->Impl->Initialize();}
 
+  //@{
+  /**
+   * Force the links to be built serially. By default, the links of
+   * polydata and unstructured grids whose cell arrays use the offsets
+   * storage are built in parallel.
+   */
+  void SetSequentialProcessing(bool seq)
+    {this->Impl->SetSequentialProcessing(seq);}
+  bool GetSequentialProcessing()
+    {return this->Impl->GetSequentialProcessing();}
+  //@}
+
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by the links.
+   */
+  unsigned long GetActualMemorySize()
+    {return this->Impl->GetActualMemorySize();}
+
 protected:
   vtkStaticCellLinks();
   ~vtkStaticCellLinks() VTK_OVERRIDE;
@@ -20,13 +20,81 @@
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------
+// Note: this class is a faster version of vtkCellLinks. Cell arrays in the
+// legacy storage are processed serially, as their cells can only be
+// traversed in order. Cell arrays in offsets storage are processed in
+// parallel: atomics count the number of cells using each point, a parallel
+// prefix sum of the counts gives the offsets, and each thread then inserts
+// its cells at the position reserved by an atomic cursor for each point.
+
 //----------------------------------------------------------------------------
-// Note: this class is a faster, serial version of vtkCellLinks. Future work
-// to parallelize this class is possible. This includes:
-// = using a parallel prefix sum operation
-// = using atomics to update counts (i.e., number of cells using a point)
+// Functors for the threaded construction. TConn is the type of the offsets
+// and connectivity of the cell array.
+template <typename TIds, typename TConn>
+struct vtkStaticCellLinksCountUses
+{
+  const TConn *Connectivity;
+  std::atomic<TIds> *Counts;
+
+  void operator()(vtkIdType idx, vtkIdType endIdx) const
+  {
+    for ( ; idx < endIdx; ++idx )
+    {
+      this->Counts[this->Connectivity[idx]].fetch_add(
+        1, std::memory_order_relaxed);
+    }
+  }
+};
+
+template <typename TIds, typename TConn>
+struct vtkStaticCellLinksInsertLinks
+{
+  const TConn *CellOffsets;
+  const TConn *Connectivity;
+  const TIds *Offsets;
+  std::atomic<TIds> *Cursors;
+  TIds *Links;
+  vtkIdType CellIdOffset;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId) const
+  {
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      const TConn *pt = this->Connectivity + this->CellOffsets[cellId];
+      const TConn *endPt = this->Connectivity + this->CellOffsets[cellId+1];
+      for ( ; pt < endPt; ++pt )
+      {
+        TIds pos = this->Cursors[*pt].fetch_add(1, std::memory_order_relaxed);
+        this->Links[this->Offsets[*pt] + pos] =
+          static_cast<TIds>(this->CellIdOffset + cellId);
+      }
+    }
+  }
+};
+
+// The order of insertion depends on the scheduling of the threads.
+template <typename TIds>
+struct vtkStaticCellLinksSortLinks
+{
+  const TIds *Offsets;
+  TIds *Links;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      std::sort(this->Links + this->Offsets[ptId],
+                this->Links + this->Offsets[ptId+1]);
+    }
+  }
+};
 
 //----------------------------------------------------------------------------
 // Clean up any previously allocated memory
@@ -43,6 +111,23 @@ Initialize()
     delete [] this->Offsets;
     this->Offsets = NULL;
   }
+  this->LinksSize = this->NumPts = this->NumCells = 0;
+}
+
+//----------------------------------------------------------------------------
+template <typename TIds> unsigned long vtkStaticCellLinksTemplate<TIds>::
+GetActualMemorySize()
+{
+  double size = 0.0;
+  if ( this->Links )
+  {
+    size += static_cast<double>(this->LinksSize + 1) * sizeof(TIds);
+  }
+  if ( this->Offsets )
+  {
+    size += static_cast<double>(this->NumPts + 1) * sizeof(TIds);
+  }
+  return static_cast<unsigned long>(ceil(size / 1024.0)); // kibibytes
 }
 
 //----------------------------------------------------------------------------
@@ -65,6 +150,7 @@ BuildLinks(vtkDataSet *ds)
   // Any other type of dataset. Generally this is not called as datasets have
   // their own, more efficient ways of getting similar information.
   // Make sure that we clear out previous allocation.
+  this->Initialize();
   this->NumCells = ds->GetNumberOfCells();
   this->NumPts = ds->GetNumberOfPoints();
 
@@ -124,11 +210,17 @@ template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkUnstructuredGrid *ugrid)
 {
   // Basic information about the grid
+  this->Initialize();
   this->NumCells = ugrid->GetNumberOfCells();
   this->NumPts = ugrid->GetNumberOfPoints();
 
   // We're going to get into the guts of the class
   vtkCellArray *cellArray = ugrid->GetCells();
+  if ( cellArray == NULL || !cellArray->IsStorageLegacy() )
+  {
+    this->BuildLinksFromOffsets(&cellArray, cellArray ? 1 : 0);
+    return;
+  }
   const vtkIdType *cells = cellArray->GetPointer();
 
   // I love this trick: the size of the Links array is equal to
@@ -187,6 +279,7 @@ template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkPolyData *pd)
 {
   // Basic information about the grid
+  this->Initialize();
   this->NumCells = pd->GetNumberOfCells();
   this->NumPts = pd->GetNumberOfPoints();
 
@@ -194,6 +287,7 @@ BuildLinks(vtkPolyData *pd)
   vtkIdType numCells[4];
   vtkIdType sizes[4];
   int i, j;
+  bool legacy = false;
 
   cellArrays[0] = pd->GetVerts();
   cellArrays[1] = pd->GetLines();
@@ -206,6 +300,7 @@ BuildLinks(vtkPolyData *pd)
     {
       numCells[i] = cellArrays[i]->GetNumberOfCells();
       sizes[i] = cellArrays[i]->GetNumberOfConnectivityEntries() - numCells[i];
+      legacy |= (numCells[i] > 0 && cellArrays[i]->IsStorageLegacy());
     }
     else
     {
@@ -214,6 +309,12 @@ BuildLinks(vtkPolyData *pd)
     }
   }//for the four polydata arrays
 
+  if ( !legacy )
+  {
+    this->BuildLinksFromOffsets(cellArrays, 4);
+    return;
+  }
+
   // Allocate
   this->LinksSize = sizes[0] + sizes[1] + sizes[2] + sizes[3];
   this->Links = new TIds[this->LinksSize+1];
@@ -222,24 +323,39 @@ BuildLinks(vtkPolyData *pd)
   this->Offsets[this->NumPts] = this->LinksSize;
   std::fill_n(this->Offsets, this->NumPts, 0);
 
-  // Now create the links.
+  // Now create the links. The arrays in offsets storage mixed with legacy
+  // ones are read cell by cell, so that their storage is not converted.
   vtkIdType npts, cellId, CellId, ptId;
-  const vtkIdType *cell;
+  const vtkIdType *cell, *pts;
+  vtkIdList *cellPts = vtkIdList::New();
 
   // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
+  for ( j=0; j < 4; ++j )
   {
+    if ( numCells[j] == 0 )
+    {
+      continue;
+    }
     // Count number of point uses
-    cell = cellArrays[j]->GetPointer();
+    cell = cellArrays[j]->IsStorageLegacy() ? cellArrays[j]->GetPointer() :
+                                              NULL;
     for ( cellId=0; cellId < numCells[j]; ++cellId )
     {
-      npts = *cell++;
+      if ( cell )
+      {
+        npts = *cell++;
+        pts = cell;
+        cell += npts;
+      }
+      else
+      {
+        cellArrays[j]->GetCellAtId(cellId, npts, pts, cellPts);
+      }
       for (i=0; i<npts; ++i)
       {
-        this->Offsets[CellId+(*cell++)]++;
+        this->Offsets[pts[i]]++;
       }
     }
-    CellId += numCells[j];
   } //for each of the four polydata cell arrays
 
   // Perform prefix sum
@@ -255,19 +371,193 @@ BuildLinks(vtkPolyData *pd)
   // points to the beginning of each cell run.
   for ( CellId=0, j=0; j < 4; ++j )
   {
-    cell = cellArrays[j]->GetPointer();
+    if ( numCells[j] == 0 )
+    {
+      continue;
+    }
+    cell = cellArrays[j]->IsStorageLegacy() ? cellArrays[j]->GetPointer() :
+                                              NULL;
     for ( cellId=0; cellId < numCells[j]; ++cellId )
     {
-      npts = *cell++;
+      if ( cell )
+      {
+        npts = *cell++;
+        pts = cell;
+        cell += npts;
+      }
+      else
+      {
+        cellArrays[j]->GetCellAtId(cellId, npts, pts, cellPts);
+      }
       for (i=0; i<npts; ++i)
       {
-        this->Offsets[*cell]--;
-        this->Links[this->Offsets[*cell++]] = CellId+cellId;
+        this->Offsets[pts[i]]--;
+        this->Links[this->Offsets[pts[i]]] = CellId+cellId;
       }
     }
     CellId += numCells[j];
   }//for each of the four polydata arrays
   this->Offsets[this->NumPts] = this->LinksSize;
+
+  cellPts->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Build the links of cell arrays in offsets storage. The links are built in
+// parallel: see the note at the top of this file.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+BuildLinksFromOffsets(vtkCellArray **cellArrays, int numArrays)
+{
+  vtkSMPTools::Config config;
+  if ( this->SequentialProcessing )
+  {
+    config.Backend = "Sequential";
+  }
+
+  vtkSMPTools::LocalScope(config, [&]()
+  {
+    // Count number of point uses
+    std::atomic<TIds> *counts = new std::atomic<TIds>[this->NumPts];
+    vtkSMPTools::Fill(counts, counts + this->NumPts, static_cast<TIds>(0));
+    for (int i=0; i < numArrays; ++i)
+    {
+      if ( cellArrays[i] == NULL || cellArrays[i]->GetNumberOfCells() == 0 )
+      {
+        continue;
+      }
+      if ( cellArrays[i]->IsStorage32Bit() )
+      {
+        this->CountUses<vtkTypeInt32>(cellArrays[i], counts);
+      }
+      else
+      {
+        this->CountUses<vtkIdType>(cellArrays[i], counts);
+      }
+    }
+
+    // Perform prefix sum
+    this->Offsets = new TIds[this->NumPts+1];
+    this->LinksSize = vtkSMPTools::ExclusiveScan(
+      counts, counts + this->NumPts, this->Offsets, static_cast<TIds>(0));
+    this->Offsets[this->NumPts] = this->LinksSize;
+    this->Links = new TIds[this->LinksSize+1];
+    this->Links[this->LinksSize] = this->NumPts;
+
+    // Now build the links. The counts are reused as cursors into the run of
+    // each point.
+    vtkSMPTools::Fill(counts, counts + this->NumPts, static_cast<TIds>(0));
+    vtkIdType cellIdOffset = 0;
+    for (int i=0; i < numArrays; ++i)
+    {
+      if ( cellArrays[i] == NULL || cellArrays[i]->GetNumberOfCells() == 0 )
+      {
+        continue;
+      }
+      if ( cellArrays[i]->IsStorage32Bit() )
+      {
+        this->InsertLinks<vtkTypeInt32>(cellArrays[i], cellIdOffset, counts);
+      }
+      else
+      {
+        this->InsertLinks<vtkIdType>(cellArrays[i], cellIdOffset, counts);
+      }
+      cellIdOffset += cellArrays[i]->GetNumberOfCells();
+    }
+    delete [] counts;
+
+    // A serial insertion visits the cells in order, and leaves the links
+    // sorted.
+    if ( !this->SequentialProcessing )
+    {
+      vtkStaticCellLinksSortLinks<TIds> sorter = { this->Offsets, this->Links };
+      vtkSMPTools::For(0, this->NumPts, sorter);
+    }
+  });
+}
+
+//----------------------------------------------------------------------------
+template <typename TIds> template <typename TConn>
+void vtkStaticCellLinksTemplate<TIds>::
+CountUses(vtkCellArray *cellArray, std::atomic<TIds> *counts)
+{
+  vtkStaticCellLinksCountUses<TIds,TConn> counter;
+  counter.Connectivity = static_cast<const TConn*>(
+    cellArray->GetConnectivityArray()->GetVoidPointer(0));
+  counter.Counts = counts;
+  vtkSMPTools::For(0, cellArray->GetConnectivityArray()->GetNumberOfTuples(),
+                   counter);
+}
+
+//----------------------------------------------------------------------------
+template <typename TIds> template <typename TConn>
+void vtkStaticCellLinksTemplate<TIds>::
+InsertLinks(vtkCellArray *cellArray, vtkIdType cellIdOffset,
+            std::atomic<TIds> *cursors)
+{
+  vtkStaticCellLinksInsertLinks<TIds,TConn> inserter;
+  inserter.CellOffsets = static_cast<const TConn*>(
+    cellArray->GetOffsetsArray()->GetVoidPointer(0));
+  inserter.Connectivity = static_cast<const TConn*>(
+    cellArray->GetConnectivityArray()->GetVoidPointer(0));
+  inserter.Offsets = this->Offsets;
+  inserter.Cursors = cursors;
+  inserter.Links = this->Links;
+  inserter.CellIdOffset = cellIdOffset;
+  vtkSMPTools::For(0, cellArray->GetNumberOfCells(), inserter);
+}
+
+//----------------------------------------------------------------------------
+inline bool vtkStaticCellLinksDispatch::UseLargeIds(vtkDataSet *ds)
+{
+  vtkIdType numCells = ds->GetNumberOfCells();
+  vtkIdType linksSize;
+  if ( ds->GetDataObjectType() == VTK_POLY_DATA )
+  {
+    vtkPolyData *pd = static_cast<vtkPolyData*>(ds);
+    vtkCellArray *cellArrays[4] =
+      { pd->GetVerts(), pd->GetLines(), pd->GetPolys(), pd->GetStrips() };
+    linksSize = 0;
+    for (int i=0; i < 4; ++i)
+    {
+      if ( cellArrays[i] != NULL )
+      {
+        linksSize += cellArrays[i]->GetNumberOfConnectivityEntries();
+      }
+    }
+  }
+  else if ( ds->GetDataObjectType() == VTK_UNSTRUCTURED_GRID &&
+            static_cast<vtkUnstructuredGrid*>(ds)->GetCells() != NULL )
+  {
+    linksSize = static_cast<vtkUnstructuredGrid*>(ds)->GetCells()->
+      GetNumberOfConnectivityEntries();
+  }
+  else
+  {
+    linksSize = numCells * ds->GetMaxCellSize();
+  }
+  return ( ds->GetNumberOfPoints() >= VTK_INT_MAX ||
+           numCells >= VTK_INT_MAX || linksSize >= VTK_INT_MAX );
+}
+
+//----------------------------------------------------------------------------
+template <typename Worker>
+void vtkStaticCellLinksDispatch::
+Execute(vtkDataSet *ds, Worker &worker, bool sequential)
+{
+  if ( vtkStaticCellLinksDispatch::UseLargeIds(ds) )
+  {
+    vtkStaticCellLinksTemplate<vtkIdType> links;
+    links.SetSequentialProcessing(sequential);
+    links.BuildLinks(ds);
+    worker(links);
+  }
+  else
+  {
+    vtkStaticCellLinksTemplate<int> links;
+    links.SetSequentialProcessing(sequential);
+    links.BuildLinks(ds);
+    worker(links);
+  }
 }
 
 #endif
@@ -620,9 +620,9 @@ public:
   {
       // Place each point in a bucket
       //
-      vtkPointSet *ps=static_cast<vtkPointSet *>(this->DataSet);
+      vtkPointSet *ps=vtkPointSet::SafeDownCast(this->DataSet);
       int mapped=0;
-      if ( ps )
+      if ( ps && ps->GetPoints() )
       {//map points array: explicit points representation
         int dataType = ps->GetPoints()->GetDataType();
         void *pts = ps->GetPoints()->GetVoidPointer(0);
@@ -1671,4 +1671,6 @@ void vtkStaticPointLocator::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Divisions: (" << this->Divisions[0] << ", "
      << this->Divisions[1] << ", " << this->Divisions[2] << ")\n";
+
+  os << indent << "Large Ids: " << (this->LargeIds ? "On\n" : "Off\n");
 }
@@ -809,12 +809,20 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   cell->SetCellType(cellType);
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  if (this->Connectivity->IsStorageLegacy())
+  {
+    loc = this->Locations->GetValue(cellId);
+    this->Connectivity->GetCell(loc,numPts,pts);
 
-  cell->PointIds->SetNumberOfIds(numPts);
+    cell->PointIds->SetNumberOfIds(numPts);
 
-  std::copy(pts, pts + numPts, cell->PointIds->GetPointer(0));
+    std::copy(pts, pts + numPts, cell->PointIds->GetPointer(0));
+  }
+  else
+  {
+    // Random access that is safe to use from several threads.
+    this->Connectivity->GetCellAtId(cellId, cell->PointIds);
+  }
   this->Points->GetPoints(cell->PointIds, cell->Points);
 
   // Explicit face representation
@@ -972,7 +980,8 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
     }
 
     // insert cell location
-    this->Locations->InsertNextValue(this->Connectivity->GetData()->GetMaxId()+1);
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetNumberOfConnectivityEntries());
     // insert face location
     this->FaceLocations->InsertNextValue(this->Faces->GetMaxId()+1);
     // insert cell connectivity and faces stream
@@ -1308,6 +1317,12 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
   vtkIdType i, loc;
   vtkIdType *pts, numPts;
 
+  if (!this->Connectivity->IsStorageLegacy())
+  {
+    this->Connectivity->GetCellAtId(cellId, ptIds);
+    return;
+  }
+
   loc = this->Locations->GetValue(cellId);
   this->Connectivity->GetCell(loc,numPts,pts);
   ptIds->SetNumberOfIds(numPts);
@@ -86,6 +86,7 @@ public:
   {
     vtkIdType i = static_cast<vtkIdType>(
       static_cast<double>(this->Dim) * (value - this->SMin) / this->Range);
+    i = ( i < 0 ? 0 : (i >= this->Dim ? this->Dim-1 : i));
 
     rMin[0] = 0; //xmin on rectangle left boundary
     rMin[1] = i; //ymin on rectangle bottom
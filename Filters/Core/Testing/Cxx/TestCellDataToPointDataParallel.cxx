@@ -0,0 +1,236 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellDataToPointDataParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the parallel paths of vtkCellDataToPointData average the
+// cells around each point like GetPointCells() and InterpolateTuple(), for
+// structured datasets, polydata and unstructured grids, whatever the
+// number of threads.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestCheck.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+// A vector, an integer and a string array on the cells of ds.
+void AddCellArrays(vtkDataSet *ds)
+{
+  vtkIdType numCells = ds->GetNumberOfCells();
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numCells);
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  ints->SetNumberOfTuples(numCells);
+  vtkNew<vtkStringArray> strings;
+  strings->SetName("Strings");
+  strings->SetNumberOfTuples(numCells);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      vectors->SetComponent(cellId, c, std::sin(0.37 * cellId + c));
+    }
+    ints->SetValue(cellId, static_cast<int>((cellId * 7919) % 101) - 50);
+    strings->SetValue(cellId, cellId % 2 ? "odd" : "even");
+  }
+  ds->GetCellData()->AddArray(vectors.GetPointer());
+  ds->GetCellData()->AddArray(ints.GetPointer());
+  ds->GetCellData()->AddArray(strings.GetPointer());
+}
+
+// Run the filter on input with the given number of threads.
+vtkSmartPointer<vtkDataSet> Run(vtkDataSet *input, int numThreads)
+{
+  vtkNew<vtkCellDataToPointData> c2p;
+  c2p->SetInputData(input);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(numThreads),
+                          [&]() { c2p->Update(); });
+  return c2p->GetOutput();
+}
+
+// Check the point data of output against the average of the cells given
+// by GetPointCells(). The links may list the cells in another order, which
+// changes the roundoff.
+int CheckAverages(vtkDataSet *input, vtkDataSet *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkDataArray *vectors = output->GetPointData()->GetArray("Vectors");
+  vtkDataArray *ints = output->GetPointData()->GetArray("Ints");
+  vtkAbstractArray *strings =
+    output->GetPointData()->GetAbstractArray("Strings");
+  vtkTestCheckMacro(vectors && vectors->GetNumberOfTuples() == numPts);
+  vtkTestCheckMacro(ints && ints->GetNumberOfTuples() == numPts &&
+    ints->IsA("vtkIntArray"));
+  vtkTestCheckMacro(!output->GetCellData()->GetArray("Vectors"));
+  if (!vtkUnstructuredGrid::SafeDownCast(input))
+  {
+    vtkTestCheckMacro(strings && strings->GetNumberOfTuples() == numPts);
+  }
+
+  vtkDataArray *inVectors = input->GetCellData()->GetArray("Vectors");
+  vtkDataArray *inInts = input->GetCellData()->GetArray("Ints");
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    input->GetPointCells(ptId, cellIds.GetPointer());
+    vtkIdType numCells = cellIds->GetNumberOfIds();
+    vtkTestCheckMacro(numCells > 0);
+    double weight = 1.0 / numCells;
+    for (int c = 0; c < 3; ++c)
+    {
+      double val = 0.0;
+      for (vtkIdType i = 0; i < numCells; ++i)
+      {
+        val += weight * inVectors->GetComponent(cellIds->GetId(i), c);
+      }
+      vtkTestCheckMacro(
+        std::fabs(vectors->GetComponent(ptId, c) - val) < 1e-12);
+    }
+    double val = 0.0;
+    for (vtkIdType i = 0; i < numCells; ++i)
+    {
+      val += weight * inInts->GetComponent(cellIds->GetId(i), 0);
+    }
+    vtkTestCheckMacro(std::fabs(ints->GetComponent(ptId, 0) - val) <=
+      0.5 + 1e-12);
+  }
+  return 0;
+}
+
+// Check that two outputs have the same point data.
+int SameOutput(vtkDataSet *a, vtkDataSet *b)
+{
+  const char *names[2] = { "Vectors", "Ints" };
+  for (int n = 0; n < 2; ++n)
+  {
+    vtkDataArray *arrayA = a->GetPointData()->GetArray(names[n]);
+    vtkDataArray *arrayB = b->GetPointData()->GetArray(names[n]);
+    vtkTestCheckMacro(arrayA && arrayB);
+    vtkTestCheckMacro(arrayA->GetNumberOfTuples() ==
+      arrayB->GetNumberOfTuples());
+    for (vtkIdType t = 0; t < arrayA->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < arrayA->GetNumberOfComponents(); ++c)
+      {
+        vtkTestCheckMacro(arrayA->GetComponent(t, c) ==
+          arrayB->GetComponent(t, c));
+      }
+    }
+  }
+  return 0;
+}
+
+int TestDataSet(vtkDataSet *input)
+{
+  AddCellArrays(input);
+  vtkSmartPointer<vtkDataSet> serial = Run(input, 1);
+  vtkTestCheckMacro(CheckAverages(input, serial) == 0);
+  vtkTestCheckMacro(SameOutput(serial, Run(input, 4)) == 0);
+  return 0;
+}
+
+} // end anon namespace
+
+int TestCellDataToPointDataParallel(int, char*[])
+{
+  const int dims[3] = { 9, 7, 5 };
+
+  // Structured datasets, in 3D and 2D
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(dims[0], dims[1], dims[2]);
+  vtkTestCheckMacro(TestDataSet(image.GetPointer()) == 0);
+
+  vtkNew<vtkImageData> slice;
+  slice->SetExtent(0, dims[0] - 1, 2, 2, 0, dims[2] - 1);
+  vtkTestCheckMacro(TestDataSet(slice.GetPointer()) == 0);
+
+  vtkNew<vtkRectilinearGrid> rGrid;
+  rGrid->SetDimensions(dims[0], dims[1], dims[2]);
+  vtkNew<vtkDoubleArray> coords[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < dims[i]; ++j)
+    {
+      coords[i]->InsertNextValue(j * j);
+    }
+  }
+  rGrid->SetXCoordinates(coords[0].GetPointer());
+  rGrid->SetYCoordinates(coords[1].GetPointer());
+  rGrid->SetZCoordinates(coords[2].GetPointer());
+  vtkTestCheckMacro(TestDataSet(rGrid.GetPointer()) == 0);
+
+  vtkNew<vtkStructuredGrid> sGrid;
+  sGrid->SetDimensions(dims[0], dims[1], dims[2]);
+  vtkNew<vtkPoints> points;
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    points->InsertNextPoint(image->GetPoint(ptId));
+  }
+  sGrid->SetPoints(points.GetPointer());
+  vtkTestCheckMacro(TestDataSet(sGrid.GetPointer()) == 0);
+
+  // Unstructured grid with the cells of the image
+  vtkNew<vtkImageData> image2;
+  image2->SetDimensions(dims[0], dims[1], dims[2]);
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputData(image2.GetPointer());
+  append->Update();
+  vtkUnstructuredGrid *ugrid = append->GetOutput();
+  vtkTestCheckMacro(ugrid->GetNumberOfCells() == image2->GetNumberOfCells());
+  vtkTestCheckMacro(TestDataSet(ugrid) == 0);
+
+  // Polydata with vertices, lines and triangles
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  for (vtkIdType i = 0; i + 2 < points->GetNumberOfPoints(); ++i)
+  {
+    vtkIdType pts[3] = { i, i + 1, i + 2 };
+    polys->InsertNextCell(3, pts);
+    if (i % 5 == 0)
+    {
+      lines->InsertNextCell(2, pts);
+      verts->InsertNextCell(1, pts + 2);
+    }
+  }
+  polyData->SetVerts(verts.GetPointer());
+  polyData->SetLines(lines.GetPointer());
+  polyData->SetPolys(polys.GetPointer());
+  vtkTestCheckMacro(TestDataSet(polyData.GetPointer()) == 0);
+
+  return 0;
+}
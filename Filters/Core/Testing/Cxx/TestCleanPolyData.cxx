@@ -14,9 +14,16 @@
 =========================================================================*/
 
 #include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkCleanPolyData.h>
+#include <vtkIdList.h>
+#include <vtkIntArray.h>
 #include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
+#include <vtkTestCheck.h>
 
 namespace
 {
@@ -83,6 +90,170 @@ int CleanPolyData(int dataType, int outputPointsPrecision)
 
   return points->GetDataType();
 }
+
+// A grid of quads that do not share their points, with unused points and
+// degenerate verts, lines, polys and strips. The point and cell data hold
+// the ids.
+void MakeMesh(int n, int dataType, vtkPolyData *mesh)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+  vtkNew<vtkIntArray> pointIds;
+  pointIds->SetName("PointIds");
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+
+  struct Inserter
+  {
+    vtkPoints *Points;
+    vtkIntArray *Ids;
+    vtkIdType operator()(int i, int j)
+    {
+      vtkIdType id = this->Points->InsertNextPoint(i, j, (i * j) % 3);
+      this->Ids->InsertNextValue(static_cast<int>(id));
+      return id;
+    }
+  } insert = { points.GetPointer(), pointIds.GetPointer() };
+
+  for (int i = 0; i < n; ++i)
+  {
+    vtkIdType pts[4];
+    pts[0] = insert(i, i);
+    pts[1] = insert(i, i + 1);
+    verts->InsertNextCell(2, pts);
+    pts[0] = insert(i, 0);
+    pts[1] = insert(i, 0);
+    pts[2] = insert(i + 1, 0);
+    lines->InsertNextCell(3, pts);
+    pts[1] = insert(i, n);
+    lines->InsertNextCell(2, pts + (i % 2));
+
+    for (int j = 0; j < n; ++j)
+    {
+      if ((i + j) % 5 == 0)
+      {
+        insert(j, i);
+      }
+      pts[0] = insert(i, j);
+      pts[1] = insert(i + 1, j);
+      pts[2] = (i * j) % 7 == 1 ? insert(i + 1, j) : insert(i + 1, j + 1);
+      pts[3] = (i * j) % 11 == 2 ? insert(i, j) : insert(i, j + 1);
+      if ((i + 2 * j) % 13 == 3)
+      {
+        pts[2] = insert(i, j);
+      }
+      polys->InsertNextCell(4, pts);
+    }
+
+    strips->InsertNextCell(2 * n + 2);
+    for (int j = 0; j <= n; ++j)
+    {
+      strips->InsertCellPoint(i % 3 == 2 ? insert(i, i) : insert(j, i));
+      strips->InsertCellPoint(i % 3 == 2 ? insert(i, i) : insert(j, i + 1));
+    }
+  }
+
+  mesh->SetPoints(points.GetPointer());
+  mesh->SetVerts(verts.GetPointer());
+  mesh->SetLines(lines.GetPointer());
+  mesh->SetPolys(polys.GetPointer());
+  mesh->SetStrips(strips.GetPointer());
+  mesh->GetPointData()->AddArray(pointIds.GetPointer());
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < mesh->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+  }
+  mesh->GetCellData()->AddArray(cellIds.GetPointer());
+}
+
+// Check that two outputs are identical.
+int SameOutput(vtkPolyData *a, vtkPolyData *b)
+{
+  vtkTestCheckMacro(a->GetNumberOfPoints() == b->GetNumberOfPoints());
+  vtkTestCheckMacro(a->GetNumberOfVerts() == b->GetNumberOfVerts());
+  vtkTestCheckMacro(a->GetNumberOfLines() == b->GetNumberOfLines());
+  vtkTestCheckMacro(a->GetNumberOfPolys() == b->GetNumberOfPolys());
+  vtkTestCheckMacro(a->GetNumberOfStrips() == b->GetNumberOfStrips());
+  vtkDataArray *pointIdsA = a->GetPointData()->GetArray("PointIds");
+  vtkDataArray *pointIdsB = b->GetPointData()->GetArray("PointIds");
+  double x[3], y[3];
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    a->GetPoint(ptId, x);
+    b->GetPoint(ptId, y);
+    vtkTestCheckMacro(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+    vtkTestCheckMacro(pointIdsA->GetTuple1(ptId) == pointIdsB->GetTuple1(ptId));
+  }
+  vtkDataArray *cellIdsA = a->GetCellData()->GetArray("CellIds");
+  vtkDataArray *cellIdsB = b->GetCellData()->GetArray("CellIds");
+  vtkTestCheckMacro(cellIdsA->GetNumberOfTuples() == a->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    vtkTestCheckMacro(cellIdsA->GetTuple1(cellId) ==
+      cellIdsB->GetTuple1(cellId));
+  }
+  vtkCellArray *cellsA[4] =
+    { a->GetVerts(), a->GetLines(), a->GetPolys(), a->GetStrips() };
+  vtkCellArray *cellsB[4] =
+    { b->GetVerts(), b->GetLines(), b->GetPolys(), b->GetStrips() };
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  for (int type = 0; type < 4; ++type)
+  {
+    cellsA[type]->InitTraversal();
+    cellsB[type]->InitTraversal();
+    while (cellsA[type]->GetNextCell(ptsA.GetPointer()))
+    {
+      vtkTestCheckMacro(cellsB[type]->GetNextCell(ptsB.GetPointer()));
+      vtkTestCheckMacro(ptsA->GetNumberOfIds() == ptsB->GetNumberOfIds());
+      for (vtkIdType i = 0; i < ptsA->GetNumberOfIds(); ++i)
+      {
+        vtkTestCheckMacro(ptsA->GetId(i) == ptsB->GetId(i));
+      }
+    }
+  }
+  return 0;
+}
+
+// Points of an integer type are merged by the serial path, which is the
+// reference for the parallel path on the same mesh with float points.
+int TestParallelClean(int pointMerging, int convert)
+{
+  const int n = 20;
+  vtkNew<vtkPolyData> serialInput;
+  MakeMesh(n, VTK_INT, serialInput.GetPointer());
+  vtkNew<vtkPolyData> parallelInput;
+  MakeMesh(n, VTK_FLOAT, parallelInput.GetPointer());
+
+  vtkNew<vtkCleanPolyData> clean;
+  clean->SetPointMerging(pointMerging);
+  clean->SetConvertLinesToPoints(convert);
+  clean->SetConvertPolysToLines(convert);
+  clean->SetConvertStripsToPolys(convert);
+  clean->SetInputData(serialInput.GetPointer());
+  clean->Update();
+  vtkNew<vtkPolyData> serial;
+  serial->DeepCopy(clean->GetOutput());
+  vtkTestCheckMacro(serial->GetNumberOfPoints() <
+    serialInput->GetNumberOfPoints());
+
+  clean->SetInputData(parallelInput.GetPointer());
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { clean->Update(); });
+  vtkTestCheckMacro(SameOutput(serial.GetPointer(), clean->GetOutput()) == 0);
+  vtkTestCheckMacro(!clean->GetOutput()->GetPolys()->IsStorage32Bit());
+
+  // The storage of the input cells does not matter
+  parallelInput->GetPolys()->UseOffsetsStorage();
+  parallelInput->GetStrips()->UseOffsetsStorage(false);
+  clean->Modified();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]() { clean->Update(); });
+  vtkTestCheckMacro(SameOutput(serial.GetPointer(), clean->GetOutput()) == 0);
+  return 0;
+}
 }
 
 int TestCleanPolyData(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
@@ -129,5 +300,18 @@ int TestCleanPolyData(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
     return EXIT_FAILURE;
   }
 
+  // Let the local scopes of the parallel tests use 4 threads
+  vtkSMPTools::Initialize(4);
+  for (int pointMerging = 0; pointMerging < 2; ++pointMerging)
+  {
+    for (int convert = 0; convert < 2; ++convert)
+    {
+      if (TestParallelClean(pointMerging, convert))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
   return EXIT_SUCCESS;
 }
@@ -22,7 +22,19 @@
 #include "vtkDataSetTriangleFilter.h"
 #include "vtkPointDataToCellData.h"
 #include "vtkImageDataToPointSet.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkSMPTools.h"
+#include "vtkSpanSpace.h"
+#include "vtkMergePoints.h"
+#include "vtkIdList.h"
+#include <algorithm>
 #include <cassert>
+#include <map>
+#include <set>
+#include <vector>
 
 bool TestStructured(int type)
 {
@@ -103,6 +115,156 @@ bool TestUnstructured()
   return true;
 }
 
+// The cells of a polydata with the point ids mapped through pointMap, each
+// cell starting at its smallest id so that the orientation is kept, with
+// the cell data.
+typedef std::multiset<std::pair<std::vector<vtkIdType>, double> > CellSet;
+CellSet GetCellSet(vtkPolyData* output, const std::vector<vtkIdType>& pointMap)
+{
+  CellSet cells;
+  vtkDataArray* array = output->GetCellData()->GetArray("RTData");
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); cellId++)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    std::vector<vtkIdType> ids;
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); i++)
+    {
+      ids.push_back(pointMap[ptIds->GetId(i)]);
+    }
+    std::rotate(ids.begin(), std::min_element(ids.begin(), ids.end()),
+                ids.end());
+    cells.insert(std::make_pair(ids, array->GetComponent(cellId, 0)));
+  }
+  return cells;
+}
+
+// Same points with the same point data, and same cells with the same cell
+// data, in any order.
+bool SameCut(vtkPolyData* output, vtkPolyData* expected)
+{
+  vtkIdType numPts = output->GetNumberOfPoints();
+  if (numPts != expected->GetNumberOfPoints() ||
+      output->GetNumberOfCells() != expected->GetNumberOfCells() ||
+      output->CheckAttributes())
+  {
+    return false;
+  }
+
+  std::map<std::vector<double>, vtkIdType> expectedIds;
+  for (vtkIdType i = 0; i < numPts; i++)
+  {
+    double* x = expected->GetPoint(i);
+    expectedIds[std::vector<double>(x, x + 3)] = i;
+  }
+  std::vector<vtkIdType> pointMap(numPts);
+  std::vector<vtkIdType> identity(numPts);
+  vtkPointData* outPD = output->GetPointData();
+  vtkPointData* expectedPD = expected->GetPointData();
+  for (vtkIdType i = 0; i < numPts; i++)
+  {
+    double* x = output->GetPoint(i);
+    std::map<std::vector<double>, vtkIdType>::iterator it =
+      expectedIds.find(std::vector<double>(x, x + 3));
+    if (it == expectedIds.end())
+    {
+      return false;
+    }
+    pointMap[i] = it->second;
+    identity[i] = i;
+    for (int a = 0; a < outPD->GetNumberOfArrays(); a++)
+    {
+      vtkDataArray* array = outPD->GetArray(a);
+      vtkDataArray* expectedArray = array->GetName() ?
+        expectedPD->GetArray(array->GetName()) : expectedPD->GetArray(a);
+      if (!expectedArray ||
+          array->GetComponent(i, 0) != expectedArray->GetComponent(it->second, 0))
+      {
+        return false;
+      }
+    }
+  }
+
+  return GetCellSet(output, pointMap) == GetCellSet(expected, identity);
+}
+
+// Tetrahedra are cut in parallel when sorting by value and no locator is
+// set. Setting one uses the serial path, which gives the reference.
+bool TestUnstructuredParallel()
+{
+  // Let the local scopes below use 4 threads whatever the machine.
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkRTAnalyticSource> imageSource = vtkSmartPointer<vtkRTAnalyticSource>::New();
+  imageSource->SetWholeExtent(-10,10,-10,10,-10,10);
+
+  vtkSmartPointer<vtkPointDataToCellData> dataFilter = vtkSmartPointer<vtkPointDataToCellData>::New();
+  dataFilter->SetInputConnection(imageSource->GetOutputPort());
+  dataFilter->PassPointDataOn();
+
+  vtkSmartPointer<vtkDataSetTriangleFilter> tetraFilter = vtkSmartPointer<vtkDataSetTriangleFilter>::New();
+  tetraFilter->SetInputConnection(dataFilter->GetOutputPort());
+
+  vtkSmartPointer<vtkPlane> p3d = vtkSmartPointer<vtkPlane>::New();
+  p3d->SetOrigin(0.5,0.5,0.5);
+  p3d->SetNormal(1,1,1);
+
+  vtkSmartPointer<vtkCutter> serial = vtkSmartPointer<vtkCutter>::New();
+  serial->SetCutFunction(p3d);
+  serial->SetInputConnection(tetraFilter->GetOutputPort());
+  serial->SetLocator(vtkSmartPointer<vtkMergePoints>::New());
+  serial->GenerateCutScalarsOn();
+  serial->SetValue(0, -3.);
+  serial->SetValue(1, 4.);
+
+  vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+  cutter->SetCutFunction(p3d);
+  cutter->SetInputConnection(tetraFilter->GetOutputPort());
+  cutter->GenerateCutScalarsOn();
+  cutter->SetValue(0, -3.);
+  cutter->SetValue(1, 4.);
+
+  for (int useScalarTree = 0; useScalarTree < 2; useScalarTree++)
+  {
+    cutter->SetUseScalarTree(useScalarTree);
+    for (int triangles = 0; triangles < 2; triangles++)
+    {
+      serial->SetGenerateTriangles(triangles);
+      serial->Update();
+      cutter->SetGenerateTriangles(triangles);
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { cutter->Update(); });
+      vtkPolyData* output = cutter->GetOutput();
+      if (output->GetNumberOfPolys() == 0 ||
+          !SameCut(output, serial->GetOutput()) ||
+          !output->GetPointData()->GetScalars())
+      {
+        return false;
+      }
+    }
+  }
+  if (!vtkSpanSpace::SafeDownCast(cutter->GetScalarTree()))
+  {
+    return false;
+  }
+
+  // Sweep a single value, the cut scalars and the tree are reused.
+  for (int i = 0; i < 4; i++)
+  {
+    double value = -10. + 6. * i;
+    serial->SetValue(0, value);
+    serial->SetNumberOfContours(1);
+    serial->Update();
+    cutter->SetValue(0, value);
+    cutter->SetNumberOfContours(1);
+    cutter->Update();
+    if (!SameCut(cutter->GetOutput(), serial->GetOutput()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 int TestCutter(int, char *[])
 {
   for(int type=0; type<2; type++)
@@ -120,5 +282,11 @@ int TestCutter(int, char *[])
     return EXIT_FAILURE;
   }
 
+  if(!TestUnstructuredParallel())
+  {
+    cerr<<"Cutting Unstructured in parallel failed"<<endl;
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,235 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the parallel glyphing of vtkGlyph3D gives the points,
+// attributes and cells of the serial one, whatever the number of threads.
+// A glyph with mixed cells is glyphed serially.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkTestCheck.h"
+#include "vtkTransform.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Points on a spiral with scalars, vectors, a string array and ghost
+// points.
+void MakeInput(vtkIdType numPts, vtkPolyData *input)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkStringArray> labels;
+  labels->SetName("Labels");
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double t = 0.1 * i;
+    points->InsertNextPoint(std::cos(t), std::sin(t), 0.01 * i);
+    scalars->InsertNextValue(0.5 + 0.5 * std::sin(3.0 * t));
+    vectors->InsertNextTuple3(std::sin(t), i % 7 ? std::cos(2.0 * t) : 0.0,
+                              i % 7 ? 0.3 : 0.0);
+    labels->InsertNextValue(i % 2 ? "odd" : "even");
+    ghosts->InsertNextValue(i % 11 == 5 ?
+      vtkDataSetAttributes::DUPLICATEPOINT : 0);
+  }
+  input->SetPoints(points.GetPointer());
+  input->GetPointData()->SetScalars(scalars.GetPointer());
+  input->GetPointData()->SetVectors(vectors.GetPointer());
+  input->GetPointData()->AddArray(labels.GetPointer());
+  input->GetPointData()->AddArray(ghosts.GetPointer());
+}
+
+// A square of two triangles with normals and texture coordinates, and
+// optionally a vertex.
+void MakeGlyph(bool withVertex, vtkPolyData *glyph)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> normals;
+  normals->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> tcoords;
+  tcoords->SetNumberOfComponents(2);
+  for (int i = 0; i < 4; ++i)
+  {
+    double x = i % 3 ? 1.0 : 0.0;
+    double y = i / 2 ? 1.0 : 0.0;
+    points->InsertNextPoint(x, y, 0.2 * x * y);
+    normals->InsertNextTuple3(0.1 * x, 0.2 * y, 1.0);
+    tcoords->InsertNextTuple2(x, y);
+  }
+  vtkNew<vtkCellArray> polys;
+  vtkIdType triangles[2][3] = { { 0, 1, 2 }, { 0, 2, 3 } };
+  polys->InsertNextCell(3, triangles[0]);
+  polys->InsertNextCell(3, triangles[1]);
+  glyph->SetPoints(points.GetPointer());
+  glyph->SetPolys(polys.GetPointer());
+  if (withVertex)
+  {
+    vtkNew<vtkCellArray> verts;
+    vtkIdType vertex = 3;
+    verts->InsertNextCell(1, &vertex);
+    glyph->SetVerts(verts.GetPointer());
+  }
+  glyph->GetPointData()->SetNormals(normals.GetPointer());
+  glyph->GetPointData()->SetTCoords(tcoords.GetPointer());
+}
+
+// Check that the point data arrays of a and b are identical.
+int SamePointData(vtkPolyData *a, vtkPolyData *b)
+{
+  vtkPointData *pdA = a->GetPointData();
+  vtkPointData *pdB = b->GetPointData();
+  vtkTestCheckMacro(pdA->GetNumberOfArrays() == pdB->GetNumberOfArrays());
+  for (int i = 0; i < pdA->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray *arrayA = pdA->GetAbstractArray(i);
+    vtkAbstractArray *arrayB = pdB->GetAbstractArray(arrayA->GetName());
+    vtkTestCheckMacro(arrayB && arrayB->GetDataType() == arrayA->GetDataType());
+    vtkTestCheckMacro(arrayA->GetNumberOfTuples() == a->GetNumberOfPoints());
+    vtkTestCheckMacro(arrayB->GetNumberOfTuples() == a->GetNumberOfPoints());
+    vtkIdType numValues =
+      arrayA->GetNumberOfTuples() * arrayA->GetNumberOfComponents();
+    for (vtkIdType j = 0; j < numValues; ++j)
+    {
+      vtkTestCheckMacro(arrayA->GetVariantValue(j) ==
+        arrayB->GetVariantValue(j));
+    }
+  }
+  vtkTestCheckMacro(pdA->GetScalars() && pdB->GetScalars());
+  vtkTestCheckMacro(!strcmp(pdA->GetScalars()->GetName(),
+    pdB->GetScalars()->GetName()));
+  return 0;
+}
+
+// Check that a and b have the same points, point data and polygons.
+int SameOutput(vtkPolyData *a, vtkPolyData *b)
+{
+  vtkTestCheckMacro(a->GetNumberOfPoints() == b->GetNumberOfPoints());
+  vtkTestCheckMacro(a->GetNumberOfPolys() == b->GetNumberOfPolys());
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    vtkTestCheckMacro(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+  }
+  vtkTestCheckMacro(SamePointData(a, b) == 0);
+
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  vtkIdType npts, *pts;
+  vtkCellArray *polysA = a->GetPolys();
+  vtkCellArray *polysB = b->GetPolys();
+  polysA->InitTraversal();
+  polysB->InitTraversal();
+  while (polysA->GetNextCell(ptsA.GetPointer()))
+  {
+    vtkTestCheckMacro(polysB->GetNextCell(npts, pts));
+    vtkTestCheckMacro(npts == ptsA->GetNumberOfIds());
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      vtkTestCheckMacro(pts[i] == ptsA->GetId(i));
+    }
+  }
+  return 0;
+}
+
+// Glyph input with glyph with the given number of threads.
+vtkSmartPointer<vtkPolyData> Run(vtkGlyph3D *glypher, vtkPolyData *glyph,
+                                 int numThreads)
+{
+  glypher->SetSourceData(glyph);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(numThreads),
+                          [&]() { glypher->Update(); });
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(glypher->GetOutput());
+  return output;
+}
+
+} // end anon namespace
+
+int TestGlyph3DParallel(int, char*[])
+{
+  const vtkIdType numPts = 500;
+  vtkNew<vtkPolyData> input;
+  MakeInput(numPts, input.GetPointer());
+  vtkNew<vtkPolyData> glyph;
+  MakeGlyph(false, glyph.GetPointer());
+  vtkNew<vtkPolyData> mixedGlyph;
+  MakeGlyph(true, mixedGlyph.GetPointer());
+  vtkNew<vtkTransform> sourceTransform;
+  sourceTransform->RotateZ(30.0);
+  sourceTransform->Translate(-0.5, -0.5, 0.0);
+
+  vtkNew<vtkGlyph3D> glypher;
+  glypher->SetInputData(input.GetPointer());
+  glypher->GeneratePointIdsOn();
+  glypher->FillCellDataOn();
+  glypher->SetScaleFactor(0.1);
+
+  // Combinations of scaling, coloring and orientation modes
+  const int scaleModes[3] = { VTK_SCALE_BY_SCALAR, VTK_SCALE_BY_VECTOR,
+                              VTK_SCALE_BY_VECTORCOMPONENTS };
+  const int colorModes[3] = { VTK_COLOR_BY_SCALE, VTK_COLOR_BY_SCALAR,
+                              VTK_COLOR_BY_VECTOR };
+  for (int mode = 0; mode < 3; ++mode)
+  {
+    glypher->SetScaleMode(scaleModes[mode]);
+    glypher->SetColorMode(colorModes[mode]);
+    glypher->SetClamping(mode == 1);
+    glypher->SetSourceTransform(mode == 2 ? sourceTransform.GetPointer()
+                                          : NULL);
+
+    vtkSmartPointer<vtkPolyData> serial =
+      Run(glypher.GetPointer(), mixedGlyph.GetPointer(), 1);
+    vtkSmartPointer<vtkPolyData> parallel =
+      Run(glypher.GetPointer(), glyph.GetPointer(), 1);
+    vtkIdType numGlyphs = numPts - numPts / 11;
+    vtkTestCheckMacro(parallel->GetNumberOfPoints() == 4 * numGlyphs);
+    vtkTestCheckMacro(parallel->GetNumberOfCells() == 2 * numGlyphs);
+    vtkTestCheckMacro(serial->GetNumberOfCells() == 3 * numGlyphs);
+    vtkTestCheckMacro(parallel->GetPolys()->GetStorageType() ==
+                      vtkCellArray::OFFSETS_64BIT_STORAGE);
+    vtkTestCheckMacro(parallel->GetCellData()->GetAbstractArray("Labels")->
+      GetNumberOfTuples() == 2 * numGlyphs);
+    vtkTestCheckMacro(parallel->GetPointData()->GetNormals() &&
+      parallel->GetPointData()->GetTCoords() &&
+      parallel->GetPointData()->GetVectors());
+    vtkTestCheckMacro(SameOutput(serial, parallel) == 0);
+
+    vtkTestCheckMacro(SameOutput(parallel,
+      Run(glypher.GetPointer(), glyph.GetPointer(), 4)) == 0);
+  }
+
+  return 0;
+}
@@ -0,0 +1,220 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the splitting, ordering and point normals of vtkPolyDataNormals on
+// a triangulated cube, and that the output does not depend on the number
+// of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkPolygon.h"
+#include "vtkSMPTools.h"
+#include "vtkTestCheck.h"
+
+#include <cmath>
+#include <map>
+
+namespace
+{
+
+// The surface of the unit cube, with n x n quads split in two triangles
+// on each face. Some triangles are inverted. The point data holds the id
+// of the points.
+void MakeCube(int n, vtkPolyData *cube)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> triangles;
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  std::map<int, vtkIdType> pointIds;
+
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (int side = 0; side <= n; side += n)
+    {
+      vtkIdType quad[4];
+      for (int i = 0; i < n; ++i)
+      {
+        for (int j = 0; j < n; ++j)
+        {
+          static const int corners[4][2] = { {0,0}, {1,0}, {1,1}, {0,1} };
+          for (int c = 0; c < 4; ++c)
+          {
+            int ijk[3];
+            ijk[axis] = side;
+            ijk[(axis + 1) % 3] = i + corners[c][0];
+            ijk[(axis + 2) % 3] = j + corners[c][1];
+            int key = (ijk[0] * (n + 1) + ijk[1]) * (n + 1) + ijk[2];
+            std::map<int, vtkIdType>::iterator it = pointIds.find(key);
+            if (it == pointIds.end())
+            {
+              vtkIdType id = points->InsertNextPoint(
+                static_cast<double>(ijk[0]) / n,
+                static_cast<double>(ijk[1]) / n,
+                static_cast<double>(ijk[2]) / n);
+              ids->InsertNextValue(static_cast<int>(id));
+              it = pointIds.insert(std::make_pair(key, id)).first;
+            }
+            quad[c] = it->second;
+          }
+          vtkIdType tri[2][3] = { { quad[0], quad[1], quad[2] },
+                                  { quad[0], quad[2], quad[3] } };
+          if ((i + 2 * j + axis) % 3 == 0)
+          {
+            std::swap(tri[1][0], tri[1][1]);
+          }
+          triangles->InsertNextCell(3, tri[0]);
+          triangles->InsertNextCell(3, tri[1]);
+        }
+      }
+    }
+  }
+  cube->SetPoints(points.GetPointer());
+  cube->SetPolys(triangles.GetPointer());
+  cube->GetPointData()->AddArray(ids.GetPointer());
+}
+
+// Check that the output of the filter on the cube has outward cell
+// normals, which are the normals of their points when splitting.
+int CheckCube(vtkPolyData *output, vtkIdType numInPts, bool splitting)
+{
+  vtkDataArray *normals = output->GetPointData()->GetNormals();
+  vtkDataArray *ids = output->GetPointData()->GetArray("Ids");
+  vtkTestCheckMacro(normals && ids);
+
+  vtkIdType npts, *pts;
+  double n[3], x[3], center[3], p[3];
+  vtkCellArray *polys = output->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); )
+  {
+    vtkPolygon::ComputeNormal(output->GetPoints(), npts, pts, n);
+    center[0] = center[1] = center[2] = 0.0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      output->GetPoint(pts[i], x);
+      for (int c = 0; c < 3; ++c)
+      {
+        center[c] += x[c] / npts - 0.5 / npts;
+      }
+    }
+    vtkTestCheckMacro(
+      n[0] * center[0] + n[1] * center[1] + n[2] * center[2] > 0.0);
+
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      normals->GetTuple(pts[i], p);
+      double dot = n[0] * p[0] + n[1] * p[1] + n[2] * p[2];
+      vtkTestCheckMacro(splitting ? std::fabs(dot - 1.0) < 1e-6 : dot > 0.0);
+    }
+  }
+
+  // The split points copy the attributes of the points they duplicate
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    vtkIdType inPtId = static_cast<vtkIdType>(ids->GetTuple1(ptId));
+    vtkTestCheckMacro(ptId < numInPts ? inPtId == ptId : inPtId < numInPts);
+    output->GetPoint(ptId, x);
+    output->GetPoint(inPtId, p);
+    vtkTestCheckMacro(x[0] == p[0] && x[1] == p[1] && x[2] == p[2]);
+  }
+  return 0;
+}
+
+// Check that two outputs are identical.
+int SameOutput(vtkPolyData *a, vtkPolyData *b)
+{
+  vtkTestCheckMacro(a->GetNumberOfPoints() == b->GetNumberOfPoints());
+  vtkTestCheckMacro(a->GetNumberOfPolys() == b->GetNumberOfPolys());
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    a->GetCellPoints(cellId, ptsA.GetPointer());
+    b->GetCellPoints(cellId, ptsB.GetPointer());
+    vtkTestCheckMacro(ptsA->GetNumberOfIds() == ptsB->GetNumberOfIds());
+    for (vtkIdType i = 0; i < ptsA->GetNumberOfIds(); ++i)
+    {
+      vtkTestCheckMacro(ptsA->GetId(i) == ptsB->GetId(i));
+    }
+  }
+  vtkDataArray *normalsA = a->GetPointData()->GetNormals();
+  vtkDataArray *normalsB = b->GetPointData()->GetNormals();
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      vtkTestCheckMacro(normalsA->GetComponent(ptId, c) ==
+        normalsB->GetComponent(ptId, c));
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestPolyDataNormals(int, char*[])
+{
+  const int n = 10;
+  vtkNew<vtkPolyData> cube;
+  MakeCube(n, cube.GetPointer());
+  vtkIdType numPts = cube->GetNumberOfPoints();
+  vtkTestCheckMacro(numPts == 6 * n * n + 2);
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(cube.GetPointer());
+  normals->AutoOrientNormalsOn();
+  normals->ComputeCellNormalsOn();
+
+  // Splitting duplicates the points of the edges once, the corners twice
+  vtkNew<vtkPolyData> serial;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]() { normals->Update(); });
+  serial->DeepCopy(normals->GetOutput());
+  vtkTestCheckMacro(serial->GetNumberOfPoints() ==
+    numPts + 12 * (n - 1) + 8 * 2);
+  vtkTestCheckMacro(serial->GetCellData()->GetNormals()->GetNumberOfTuples() ==
+    cube->GetNumberOfPolys());
+  vtkTestCheckMacro(CheckCube(serial.GetPointer(), numPts, true) == 0);
+
+  normals->Modified();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { normals->Update(); });
+  vtkTestCheckMacro(SameOutput(serial.GetPointer(), normals->GetOutput()) == 0);
+
+  // Without splitting, the normals of the edges are averaged
+  normals->SplittingOff();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { normals->Update(); });
+  vtkTestCheckMacro(normals->GetOutput()->GetNumberOfPoints() == numPts);
+  vtkTestCheckMacro(CheckCube(normals->GetOutput(), numPts, false) == 0);
+
+  // Without ordering, the normals of the inverted triangles are inverted
+  normals->AutoOrientNormalsOff();
+  normals->ConsistencyOff();
+  normals->SplittingOn();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]() { normals->Update(); });
+  serial->DeepCopy(normals->GetOutput());
+  vtkTestCheckMacro(serial->GetNumberOfPoints() >
+    numPts + 12 * (n - 1) + 8 * 2);
+  normals->Modified();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { normals->Update(); });
+  vtkTestCheckMacro(SameOutput(serial.GetPointer(), normals->GetOutput()) == 0);
+
+  return 0;
+}
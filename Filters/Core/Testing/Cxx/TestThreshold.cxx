@@ -19,8 +19,206 @@
 #include "vtkDataObject.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkImageData.h"
+#include "vtkUniformGrid.h"
+#include "vtkCellArray.h"
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkIdList.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkSMPTools.h"
+
+namespace
+{
+
+// Check the output of thresholding image by upper with all scalars: its
+// cells are the cells of image whose points are all above upper, and the
+// points and attributes of the output match the input.
+int CheckUpperThreshold(vtkImageData *image, vtkUnstructuredGrid *output,
+                        double upper)
+{
+  vtkDataArray *scalars = image->GetPointData()->GetArray("RTData");
+  vtkDataArray *outScalars = output->GetPointData()->GetArray("RTData");
+  vtkDataArray *outCellScalars = output->GetCellData()->GetArray("RTData");
+  if (!outScalars || !outCellScalars)
+  {
+    cerr << "Missing attributes" << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkIdList> cellPts;
+  vtkIdType numCells = 0;
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    image->GetCellPoints(cellId, cellPts.GetPointer());
+    bool keep = true;
+    for (vtkIdType i = 0; keep && i < cellPts->GetNumberOfIds(); ++i)
+    {
+      keep = scalars->GetTuple1(cellPts->GetId(i)) >= upper;
+    }
+    numCells += keep ? 1 : 0;
+  }
+  if (output->GetNumberOfCells() != numCells || numCells == 0)
+  {
+    cerr << "Expected " << numCells << " cells, got "
+         << output->GetNumberOfCells() << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The points are numbered in the order in which the cells first use them
+  vtkIdType numUsedPts = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    output->GetCellPoints(cellId, cellPts.GetPointer());
+    for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+    {
+      if (cellPts->GetId(i) > numUsedPts)
+      {
+        cerr << "Point " << cellPts->GetId(i) << " used before point "
+             << numUsedPts << endl;
+        return EXIT_FAILURE;
+      }
+      numUsedPts += cellPts->GetId(i) == numUsedPts ? 1 : 0;
+    }
+  }
+  if (numUsedPts != output->GetNumberOfPoints())
+  {
+    cerr << "Unused output points" << endl;
+    return EXIT_FAILURE;
+  }
+
+  double x[3];
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    output->GetPoint(ptId, x);
+    vtkIdType inPtId = image->FindPoint(x);
+    if (inPtId < 0 ||
+        outScalars->GetTuple1(ptId) != scalars->GetTuple1(inPtId))
+    {
+      cerr << "Wrong point or point data at " << ptId << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The cell data is the mean of the point data
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    output->GetCellPoints(cellId, cellPts.GetPointer());
+    if (output->GetCellType(cellId) != VTK_VOXEL ||
+        cellPts->GetNumberOfIds() != 8)
+    {
+      cerr << "Wrong cell " << cellId << endl;
+      return EXIT_FAILURE;
+    }
+    double mean = 0.;
+    for (vtkIdType i = 0; i < 8; ++i)
+    {
+      double s = outScalars->GetTuple1(cellPts->GetId(i));
+      if (s < upper)
+      {
+        cerr << "Wrong connectivity for cell " << cellId << endl;
+        return EXIT_FAILURE;
+      }
+      mean += s / 8.;
+    }
+    if (fabs(mean - outCellScalars->GetTuple1(cellId)) > 1e-3)
+    {
+      cerr << "Wrong cell data for cell " << cellId << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int TestParallelThreshold()
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-20, 20, -20, 20, -20, 20);
+  vtkNew<vtkPointDataToCellData> p2c;
+  p2c->SetInputConnection(source->GetOutputPort());
+  p2c->PassPointDataOn();
+  p2c->Update();
+  vtkImageData *image = vtkImageData::SafeDownCast(p2c->GetOutput());
+
+  const double upper = 150.;
+  vtkNew<vtkThreshold> filter;
+  filter->SetInputData(image);
+  filter->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "RTData");
+  filter->ThresholdByUpper(upper);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4, "STDThread"),
+                          [&]() { filter->Update(); });
+  if (CheckUpperThreshold(image, filter->GetOutput(), upper))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Thresholding the unstructured output again keeps all its cells, and
+  // a higher threshold on the cell data keeps part of them.
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->DeepCopy(filter->GetOutput());
+  vtkNew<vtkThreshold> filter2;
+  filter2->SetInputData(grid.GetPointer());
+  filter2->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "RTData");
+  filter2->ThresholdByUpper(upper);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4, "STDThread"),
+                          [&]() { filter2->Update(); });
+  if (CheckUpperThreshold(image, filter2->GetOutput(), upper) ||
+      filter2->GetOutput()->GetNumberOfPoints() != grid->GetNumberOfPoints())
+  {
+    return EXIT_FAILURE;
+  }
+
+  filter2->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, "RTData");
+  filter2->ThresholdByUpper(upper + 50.);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4, "STDThread"),
+                          [&]() { filter2->Update(); });
+  vtkUnstructuredGrid *output = filter2->GetOutput();
+  vtkDataArray *cellScalars = grid->GetCellData()->GetArray("RTData");
+  vtkIdType numCells = 0;
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    numCells += cellScalars->GetTuple1(cellId) >= upper + 50. ? 1 : 0;
+  }
+  vtkDataArray *outCellScalars = output->GetCellData()->GetArray("RTData");
+  if (output->GetNumberOfCells() != numCells || numCells == 0 ||
+      outCellScalars->GetRange()[0] < upper + 50.)
+  {
+    cerr << "Wrong cell data threshold" << endl;
+    return EXIT_FAILURE;
+  }
+  if (output->GetCells()->IsStorage32Bit())
+  {
+    cerr << "Unexpected 32 bit cell storage" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Blanked cells are not extracted.
+  vtkNew<vtkUniformGrid> uniform;
+  uniform->ShallowCopy(image);
+  vtkIdType numVisible = uniform->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numVisible; cellId += 3)
+  {
+    uniform->BlankCell(cellId);
+  }
+  numVisible -= (numVisible + 2) / 3;
+  filter->SetInputData(uniform.GetPointer());
+  filter->ThresholdByUpper(VTK_DOUBLE_MIN);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4, "STDThread"),
+                          [&]() { filter->Update(); });
+  if (filter->GetOutput()->GetNumberOfCells() != numVisible)
+  {
+    cerr << "Blanked cells were extracted" << endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // end anon namespace
+
 int TestThreshold(int, char *[])
 {
   //---------------------------------------------------
@@ -64,5 +262,5 @@ int TestThreshold(int, char *[])
     return EXIT_FAILURE;
   }
 
-  return EXIT_SUCCESS;
+  return TestParallelThreshold();
 }
@@ -14,22 +14,28 @@
 =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStructuredGrid.h"
-#include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
 
-#include <algorithm>
-#include <functional>
+#include <vector>
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
@@ -88,7 +94,7 @@ int vtkCellDataToPointData::RequestData(
   {
     this->interpolatePointDataWithMask(sGrid, output);
   }
-  else
+  else if (!this->interpolatePointDataInParallel(input, output))
   {
     this->interpolatePointData(input, output);
   }
@@ -112,52 +118,204 @@ void vtkCellDataToPointData::PrintSelf(ostream& os, vtkIndent indent)
 }
 
 //----------------------------------------------------------------------------
-// Helper template function that implement the major part of the algorighm
-// which will be expanded by the vtkTemplateMacro. The template function is
-// provided so that coverage test can cover this function.
 namespace
 {
-  template <typename T>
-  void __spread (vtkUnstructuredGrid* const src, vtkUnsignedIntArray* const num,
-             vtkDataArray* const srcarray, vtkDataArray* const dstarray,
-             vtkIdType ncells, vtkIdType npoints, vtkIdType ncomps)
+
+// The cells using a point of a structured dataset, in the order of
+// vtkStructuredData::GetPointCells().
+struct StructuredCells
+{
+  typedef vtkIdType IdType;
+  int Dims[3];
+
+  vtkIdType GetCells(vtkIdType ptId, const vtkIdType *&cells,
+                     vtkIdType buffer[8]) const
+  {
+    static const int offsets[8][3] = {
+      {-1,0,0}, {-1,-1,0}, {-1,-1,-1}, {-1,0,-1},
+      {0,0,0}, {0,-1,0}, {0,-1,-1}, {0,0,-1} };
+
+    const vtkIdType ptLoc[3] = {
+      ptId % this->Dims[0],
+      (ptId / this->Dims[0]) % this->Dims[1],
+      ptId / (static_cast<vtkIdType>(this->Dims[0]) * this->Dims[1]) };
+    vtkIdType cellDims[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      cellDims[i] = this->Dims[i] > 1 ? this->Dims[i] - 1 : 1;
+    }
+
+    vtkIdType numCells = 0;
+    for (int j = 0; j < 8; ++j)
+    {
+      vtkIdType cellLoc[3];
+      bool valid = true;
+      for (int i = 0; i < 3 && valid; ++i)
+      {
+        cellLoc[i] = ptLoc[i] + offsets[j][i];
+        valid = cellLoc[i] >= 0 && cellLoc[i] < cellDims[i];
+      }
+      if (valid)
+      {
+        buffer[numCells++] = cellLoc[0] + cellDims[0] *
+          (cellLoc[1] + cellDims[1] * cellLoc[2]);
+      }
+    }
+    cells = buffer;
+    return numCells;
+  }
+};
+
+// The cells using a point of an unstructured dataset, given by its links.
+template <typename TIds>
+struct LinkedCells
+{
+  typedef TIds IdType;
+  vtkStaticCellLinksTemplate<TIds> *Links;
+
+  vtkIdType GetCells(vtkIdType ptId, const TIds *&cells, TIds *) const
   {
-    T const* const srcptr = static_cast<T const*>(srcarray->GetVoidPointer(0));
-    T      * const dstptr = static_cast<T      *>(dstarray->GetVoidPointer(0));
+    cells = this->Links->GetCells(ptId);
+    return static_cast<vtkIdType>(this->Links->GetNumberOfCells(ptId));
+  }
+};
+
+// Average the cell values around each point, with the weights and
+// rounding of vtkDataArray::InterpolateTuple().
+template <typename TCells>
+struct AverageWorker
+{
+  const TCells &Cells;
+  vtkIdType NumberOfPoints;
 
-    // zero initialization
-    std::fill_n(dstptr, npoints*ncomps, T(0));
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT *srcArray, DstArrayT *dstArray) const
+  {
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType DstType;
+    const int numComps = srcArray->GetNumberOfComponents();
+    const TCells &cellsOfPoints = this->Cells;
 
-    // accumulate
-    T const* srcbeg = srcptr;
-    vtkNew<vtkIdList> pids;
-    for (vtkIdType cid = 0; cid < ncells; ++cid, srcbeg += ncomps)
+    vtkSMPTools::For(0, this->NumberOfPoints,
+      [&](vtkIdType begin, vtkIdType end)
     {
-      src->GetCellPoints(cid, pids.GetPointer());
-      for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+      vtkDataArrayAccessor<SrcArrayT> src(srcArray);
+      vtkDataArrayAccessor<DstArrayT> dst(dstArray);
+      typename TCells::IdType buffer[8];
+      const typename TCells::IdType *cells;
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
       {
-        T* const dstbeg = dstptr + pids->GetId(i)*ncomps;
-        // accumulate cell data to point data <==> point_data += cell_data
-        std::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,std::plus<T>());
+        vtkIdType numCells = cellsOfPoints.GetCells(ptId, cells, buffer);
+        double weight = numCells > 0 ? 1.0 / numCells : 0.0;
+        for (int c = 0; c < numComps; ++c)
+        {
+          double val = 0.0;
+          for (vtkIdType i = 0; i < numCells; ++i)
+          {
+            val += weight * static_cast<double>(src.Get(cells[i], c));
+          }
+          DstType valT;
+          vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+          dst.Set(ptId, c, valT);
+        }
       }
+    });
+  }
+};
+
+// Interpolate the fields of cfl from the cell data to the point data.
+// The data arrays are averaged in parallel, the other arrays (and the bit
+// arrays, whose tuples share bytes) serially with InterpolateTuple().
+template <typename TCells>
+void InterpolateFields(vtkAlgorithm *self,
+                       vtkDataSetAttributes::FieldList &cfl,
+                       vtkCellData *inCD, vtkPointData *outPD,
+                       vtkIdType numPts, const TCells &cellsOfPoints)
+{
+  for (int fid = 0, nfields = cfl.GetNumberOfFields(); fid < nfields; ++fid)
+  {
+    // update progress and check for an abort request.
+    self->UpdateProgress((fid+1.)/nfields);
+    if (self->GetAbortExecute())
+    {
+      break;
+    }
+
+    // indices into the field arrays associated with the cell and the point
+    // respectively
+    int const dstid = cfl.GetFieldIndex(fid);
+    int const srcid = cfl.GetDSAIndex(0,fid);
+    if  (srcid < 0 || dstid < 0)
+    {
+      continue;
     }
 
-    // average
-    T* dstbeg = dstptr;
-    for (vtkIdType pid = 0; pid < npoints; ++pid, dstbeg += ncomps)
+    vtkAbstractArray *srcArray = inCD->GetAbstractArray(srcid);
+    vtkAbstractArray *dstArray = outPD->GetAbstractArray(dstid);
+    dstArray->SetNumberOfTuples(numPts);
+
+    vtkDataArray *srcDA = vtkArrayDownCast<vtkDataArray>(srcArray);
+    vtkDataArray *dstDA = vtkArrayDownCast<vtkDataArray>(dstArray);
+    if (srcDA && dstDA && srcDA->GetDataType() != VTK_BIT &&
+        dstDA->GetDataType() != VTK_BIT)
     {
-      // guard against divide by zero
-      if (unsigned int const denum = num->GetValue(pid))
+      AverageWorker<TCells> worker = { cellsOfPoints, numPts };
+      if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(
+             srcDA, dstDA, worker))
       {
-        // divide point data by the number of cells using it <==>
-        // point_data /= denum
-        std::transform(dstbeg, dstbeg+ncomps, dstbeg,
-          std::bind2nd(std::divides<T>(), denum));
+        worker(srcDA, dstDA);
+      }
+      continue;
+    }
+
+    vtkNew<vtkIdList> cellIds;
+    std::vector<double> weights;
+    typename TCells::IdType buffer[8];
+    const typename TCells::IdType *cells;
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+      vtkIdType numCells = cellsOfPoints.GetCells(ptId, cells, buffer);
+      if (numCells > 0)
+      {
+        cellIds->SetNumberOfIds(numCells);
+        for (vtkIdType i = 0; i < numCells; ++i)
+        {
+          cellIds->SetId(i, static_cast<vtkIdType>(cells[i]));
+        }
+        weights.assign(numCells, 1.0 / numCells);
+        dstArray->InterpolateTuple(ptId, cellIds.GetPointer(), srcArray,
+                                   &weights[0]);
+      }
+      else if (dstDA)
+      {
+        for (int c = 0; c < dstDA->GetNumberOfComponents(); ++c)
+        {
+          dstDA->SetComponent(ptId, c, 0.0);
+        }
       }
     }
   }
 }
 
+// Interpolate the fields with the links of a polydata or unstructured grid.
+struct LinksWorker
+{
+  vtkAlgorithm *Self;
+  vtkDataSetAttributes::FieldList *Fields;
+  vtkCellData *InCD;
+  vtkPointData *OutPD;
+  vtkIdType NumberOfPoints;
+
+  template <typename TIds>
+  void operator()(vtkStaticCellLinksTemplate<TIds> &links)
+  {
+    LinkedCells<TIds> cells = { &links };
+    InterpolateFields(this->Self, *this->Fields, this->InCD, this->OutPD,
+                      this->NumberOfPoints, cells);
+  }
+};
+
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 int vtkCellDataToPointData::RequestDataForUnstructuredGrid
   (vtkInformation*,
@@ -177,23 +335,6 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
     return 1;
   }
 
-  // count the number of cells associated with each point
-  vtkSmartPointer<vtkUnsignedIntArray> num
-    = vtkSmartPointer<vtkUnsignedIntArray>::New();
-  num->SetNumberOfComponents(1);
-  num->SetNumberOfTuples(npoints);
-  std::fill_n(num->GetPointer(0), npoints, 0u);
-  vtkNew<vtkIdList> pids;
-  for (vtkIdType cid = 0; cid < ncells; ++cid)
-  {
-    src->GetCellPoints(cid, pids.GetPointer());
-    for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-    {
-      vtkIdType const pid = pids->GetId(i);
-      num->SetValue(pid, num->GetValue(pid)+1);
-    }
-  }
-
   // First, copy the input to the output as a starting point
   dst->CopyStructure(src);
   vtkPointData* const opd = dst->GetPointData();
@@ -223,43 +364,8 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
   cfl.InitializeFieldList(clean);
   opd->InterpolateAllocate(cfl, npoints, npoints);
 
-  for (int fid = 0, nfields = cfl.GetNumberOfFields(); fid < nfields; ++fid)
-  {
-    // update progress and check for an abort request.
-    this->UpdateProgress((fid+1.)/nfields);
-    if (this->GetAbortExecute())
-    {
-      break;
-    }
-
-    // indices into the field arrays associated with the cell and the point
-    // respectively
-    int const dstid = cfl.GetFieldIndex(fid);
-    int const srcid = cfl.GetDSAIndex(0,fid);
-    if  (srcid < 0 || dstid < 0)
-    {
-      continue;
-    }
-
-    vtkCellData * const srccelldata  = clean;
-    vtkPointData* const dstpointdata = dst->GetPointData();
-
-    if (!srccelldata || !dstpointdata)
-    {
-      continue;
-    }
-
-    vtkDataArray* const srcarray = srccelldata ->GetArray(srcid);
-    vtkDataArray* const dstarray = dstpointdata->GetArray(dstid);
-    dstarray->SetNumberOfTuples(npoints);
-
-    vtkIdType const ncomps = srcarray->GetNumberOfComponents();
-    switch (srcarray->GetDataType())
-    {
-      vtkTemplateMacro
-        (__spread<VTK_TT>(src,num,srcarray,dstarray,ncells,npoints,ncomps));
-    }
-  }
+  LinksWorker worker = { this, &cfl, clean, opd, npoints };
+  vtkStaticCellLinksDispatch::Execute(src, worker);
 
   if (!this->PassCellData)
   {
@@ -314,6 +420,54 @@ void vtkCellDataToPointData::interpolatePointData(vtkDataSet *input,
   }
 }
 
+//----------------------------------------------------------------------------
+int vtkCellDataToPointData::interpolatePointDataInParallel(vtkDataSet *input,
+                                                           vtkDataSet *output)
+{
+  StructuredCells structuredCells;
+  vtkPolyData *polyData = vtkPolyData::SafeDownCast(input);
+  if (vtkImageData *image = vtkImageData::SafeDownCast(input))
+  {
+    image->GetDimensions(structuredCells.Dims);
+  }
+  else if (vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(input))
+  {
+    rGrid->GetDimensions(structuredCells.Dims);
+  }
+  else if (vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input))
+  {
+    sGrid->GetDimensions(structuredCells.Dims);
+  }
+  else if (!polyData)
+  {
+    return 0;
+  }
+  if (!polyData && (structuredCells.Dims[0] < 1 ||
+      structuredCells.Dims[1] < 1 || structuredCells.Dims[2] < 1))
+  {
+    return 0;
+  }
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkCellData *inCD = input->GetCellData();
+  vtkPointData *outPD = output->GetPointData();
+  vtkDataSetAttributes::FieldList cfl(1);
+  cfl.InitializeFieldList(inCD);
+  outPD->InterpolateAllocate(cfl, numPts, numPts);
+
+  if (polyData)
+  {
+    LinksWorker worker = { this, &cfl, inCD, outPD, numPts };
+    vtkStaticCellLinksDispatch::Execute(polyData, worker);
+  }
+  else
+  {
+    InterpolateFields(this, cfl, inCD, outPD, numPts, structuredCells);
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
 void vtkCellDataToPointData::interpolatePointDataWithMask(
     vtkStructuredGrid *input, vtkDataSet *output)
 {
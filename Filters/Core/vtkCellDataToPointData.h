@@ -22,6 +22,12 @@
  * values of all cells using a particular point. Optionally, the input cell
  * data can be passed through to the output as well.
  *
+ * The averages are computed in parallel with vtkSMPTools. The cells using
+ * each point are given by index arithmetic for vtkImageData,
+ * vtkRectilinearGrid and vtkStructuredGrid without blanking, and by
+ * vtkStaticCellLinks for vtkPolyData and vtkUnstructuredGrid. Other
+ * datasets use GetPointCells() serially.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -72,6 +78,10 @@ protected:
 
   void interpolatePointData(vtkDataSet *input, vtkDataSet *output);
 
+  // Same as above, in parallel. Return 0 if the input is not a structured
+  // dataset or a polydata.
+  int interpolatePointDataInParallel(vtkDataSet *input, vtkDataSet *output);
+
   // Same as above, but with special handling for masked cells in input.
   void interpolatePointDataWithMask(vtkStructuredGrid *input,
                                     vtkDataSet *output);
@@ -16,17 +16,188 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
+namespace
+{
+
+// The verts, lines, polys and strips of the input, numbered in this order
+// as in the serial traversal, in the 64 bit offsets storage for random
+// access (arrays in another storage are converted in a copy).
+struct vtkCleanPolyDataCells
+{
+  vtkSmartPointer<vtkCellArray> Cells[4];
+  const vtkIdType *Offsets[4];
+  const vtkIdType *Connectivity[4];
+  vtkIdType CellBase[5];
+  vtkIdType ConnectivityBase[5];
+
+  void Initialize(vtkPolyData *input)
+  {
+    vtkCellArray *cells[4] =
+      { input->GetVerts(), input->GetLines(), input->GetPolys(),
+        input->GetStrips() };
+    this->CellBase[0] = this->ConnectivityBase[0] = 0;
+    for (int type = 0; type < 4; ++type)
+    {
+      vtkIdType numCells = cells[type]->GetNumberOfCells();
+      this->Cells[type] = cells[type];
+      this->Offsets[type] = this->Connectivity[type] = NULL;
+      if (numCells > 0)
+      {
+        if (cells[type]->GetStorageType() !=
+            vtkCellArray::OFFSETS_64BIT_STORAGE)
+        {
+          this->Cells[type] = vtkSmartPointer<vtkCellArray>::New();
+          this->Cells[type]->DeepCopy(cells[type]);
+          this->Cells[type]->UseOffsetsStorage(false);
+        }
+        this->Offsets[type] = static_cast<vtkIdTypeArray*>(
+          this->Cells[type]->GetOffsetsArray())->GetPointer(0);
+        this->Connectivity[type] = static_cast<vtkIdTypeArray*>(
+          this->Cells[type]->GetConnectivityArray())->GetPointer(0);
+      }
+      this->CellBase[type + 1] = this->CellBase[type] + numCells;
+      this->ConnectivityBase[type + 1] = this->ConnectivityBase[type] +
+        (numCells > 0 ? this->Offsets[type][numCells] : 0);
+    }
+  }
+
+  // Return the type (0 to 3 for verts to strips) of a cell, its points and
+  // the position of its first point in the concatenated connectivity.
+  int GetCell(vtkIdType cellId, vtkIdType &npts, const vtkIdType* &pts,
+              vtkIdType &position) const
+  {
+    int type = 3;
+    while (cellId < this->CellBase[type])
+    {
+      --type;
+    }
+    vtkIdType id = cellId - this->CellBase[type];
+    const vtkIdType *offsets = this->Offsets[type];
+    npts = offsets[id + 1] - offsets[id];
+    pts = this->Connectivity[type] + offsets[id];
+    position = this->ConnectivityBase[type] + offsets[id];
+    return type;
+  }
+};
+
+// A used point and the bin of its mapped coordinates.
+struct vtkCleanPolyDataBinnedPoint
+{
+  vtkIdType Bin;
+  vtkIdType PtId;
+
+  bool operator<(const vtkCleanPolyDataBinnedPoint &other) const
+  {
+    return this->Bin < other.Bin ||
+      (this->Bin == other.Bin && this->PtId < other.PtId);
+  }
+};
+
+// Rewrite a cell with the output point ids and return the output type of
+// the cell (-1 if it is removed), following the rules of the serial path.
+struct vtkCleanPolyDataUpdateCell
+{
+  const vtkIdType *PointMap;
+  int Convert[4]; // indexed by the type of the cells to convert
+
+  int operator()(int type, vtkIdType npts, const vtkIdType *pts,
+                 vtkIdType *newPts, vtkIdType &numNewPts) const
+  {
+    numNewPts = 0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      vtkIdType ptId = this->PointMap[pts[i]];
+      if (type == 0 || i == 0 || ptId != newPts[numNewPts - 1])
+      {
+        newPts[numNewPts++] = ptId;
+      }
+    }
+    if (type == 2 && numNewPts > 2 && newPts[0] == newPts[numNewPts - 1])
+    {
+      numNewPts--;
+    }
+    for (int newType = type; newType > 0; --newType)
+    {
+      if (numNewPts > newType || !this->Convert[newType])
+      {
+        return newType;
+      }
+    }
+    return numNewPts > 0 ? 0 : -1;
+  }
+};
+
+// Write the cells of the input that become cells of the given type. Ids[i]
+// and Offsets[i] are the index and the connectivity offset of input cell i
+// in the output cells.
+void vtkCleanPolyDataWriteCells(const vtkCleanPolyDataCells &cells,
+                                const vtkCleanPolyDataUpdateCell &update,
+                                int type, const signed char *types,
+                                const vtkIdType *ids, const vtkIdType *offsets,
+                                vtkIdType numNewCells, vtkIdType connSize,
+                                vtkIdType *cellMap, vtkCellArray *newCells)
+{
+  vtkNew<vtkIdTypeArray> newOffsets;
+  vtkNew<vtkIdTypeArray> newConnectivity;
+  newOffsets->SetNumberOfValues(numNewCells + 1);
+  newOffsets->SetValue(numNewCells, connSize);
+  newConnectivity->SetNumberOfValues(connSize);
+  vtkIdType *offsetsPtr = newOffsets->GetPointer(0);
+  vtkIdType *connPtr = newConnectivity->GetPointer(0);
+
+  vtkSMPThreadLocal<std::vector<vtkIdType> > localPts;
+  vtkSMPTools::For(cells.CellBase[type], cells.CellBase[4],
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      std::vector<vtkIdType> &newPts = localPts.Local();
+      vtkIdType npts, position, numNewPts;
+      const vtkIdType *pts;
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (types[cellId] != type)
+        {
+          continue;
+        }
+        int inType = cells.GetCell(cellId, npts, pts, position);
+        newPts.resize(npts > 0 ? npts : 1);
+        update(inType, npts, pts, &newPts[0], numNewPts);
+        offsetsPtr[ids[cellId]] = offsets[cellId];
+        std::copy(newPts.begin(), newPts.begin() + numNewPts,
+                  connPtr + offsets[cellId]);
+        cellMap[ids[cellId]] = cellId;
+      }
+    });
+  newCells->SetData(newOffsets.GetPointer(), newConnectivity.GetPointer());
+}
+
+} // end anon namespace
+
 //---------------------------------------------------------------------------
 // Specify a spatial locator for speeding the search process. By
 // default an instance of vtkPointLocator is used.
@@ -158,6 +329,22 @@ int vtkCleanPolyData::RequestData(
     newPts->SetDataType(VTK_DOUBLE);
   }
 
+  // Exact merging, or no merging at all, runs in parallel
+  double tol = this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+    this->Tolerance * input->GetLength();
+  if ((newPts->GetDataType() == VTK_FLOAT ||
+       newPts->GetDataType() == VTK_DOUBLE) &&
+      this->CanOperateOnPointsInParallel() &&
+      (!this->PointMerging ||
+       (tol == 0.0 &&
+        (this->Locator == NULL || this->Locator->IsA("vtkMergePoints")))))
+  {
+    delete [] updatedPts;
+    this->CleanInParallel(input, newPts, output);
+    newPts->Delete();
+    return 1;
+  }
+
   newPts->Allocate(numPts);
 
   // we'll be needing these
@@ -594,6 +781,413 @@ int vtkCleanPolyData::RequestData(
   return 1;
 }
 
+//--------------------------------------------------------------------------
+// Subclasses may override OperateOnPoint() with code that is not thread safe.
+bool vtkCleanPolyData::CanOperateOnPointsInParallel()
+{
+  return strcmp(this->GetClassName(), "vtkCleanPolyData") == 0;
+}
+
+//--------------------------------------------------------------------------
+// The output point ids are given in the order of the first use of the
+// points (or of the first use of a group of coincident points) in the
+// serial traversal of the cells, and the attributes of a group come from the
+// point used first: this is the numbering of the serial path.
+void vtkCleanPolyData::CleanInParallel(vtkPolyData *input, vtkPoints *newPts,
+                                       vtkPolyData *output)
+{
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkCleanPolyDataCells cells;
+  cells.Initialize(input);
+  vtkIdType numCells = cells.CellBase[4];
+  vtkIdType connSize = cells.ConnectivityBase[4];
+
+  // Position of the first use of each point in the connectivity, or
+  // connSize if the point is not used.
+  std::atomic<vtkIdType> *firstUse = new std::atomic<vtkIdType>[numPts];
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      firstUse[ptId].store(connSize, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType npts, position;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      cells.GetCell(cellId, npts, pts, position);
+      for (vtkIdType i = 0; i < npts; ++i, ++position)
+      {
+        std::atomic<vtkIdType> &use = firstUse[pts[i]];
+        vtkIdType current = use.load(std::memory_order_relaxed);
+        while (position < current &&
+               !use.compare_exchange_weak(current, position))
+        {
+        }
+      }
+    }
+  });
+  this->UpdateProgress(0.2);
+
+  // Mapped coordinates of the used points, rounded to the type of the output
+  // points as they are compared by vtkMergePoints.
+  bool isFloat = newPts->GetDataType() == VTK_FLOAT;
+  std::vector<double> newX(3 * numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      if (firstUse[ptId] < connSize)
+      {
+        double *newx = &newX[3 * ptId];
+        inPts->GetPoint(ptId, x);
+        this->OperateOnPoint(x, newx);
+        if (isFloat)
+        {
+          for (int c = 0; c < 3; ++c)
+          {
+            newx[c] = static_cast<float>(newx[c]);
+          }
+        }
+      }
+    }
+  });
+
+  // Each used point is mapped to the point of its group of coincident points
+  // that is used first, the representative of the group.
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  if (!this->PointMerging)
+  {
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        if (firstUse[ptId] < connSize)
+        {
+          pointMap[ptId] = ptId;
+        }
+      }
+    });
+  }
+  else
+  {
+    // Sort the points into bins of a regular grid over the mapped bounds,
+    // with a few points per bin. The unused points come last.
+    double bounds[6], mappedBounds[6];
+    input->GetBounds(bounds);
+    this->OperateOnBounds(bounds, mappedBounds);
+    double lengths[3];
+    double volume = 1.0;
+    int dimension = 0;
+    for (int c = 0; c < 3; ++c)
+    {
+      lengths[c] = mappedBounds[2 * c + 1] - mappedBounds[2 * c];
+      if (lengths[c] > 0.0)
+      {
+        volume *= lengths[c];
+        ++dimension;
+      }
+    }
+    double numBinsTarget = std::max(1.0, numPts / 4.0);
+    double binSize = dimension > 0 ?
+      std::pow(volume / numBinsTarget, 1.0 / dimension) : 1.0;
+    vtkIdType divs[3];
+    double factors[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      divs[c] = 1;
+      if (lengths[c] > 0.0)
+      {
+        divs[c] = static_cast<vtkIdType>(
+          std::min(std::max(lengths[c] / binSize, 1.0), numBinsTarget));
+      }
+      factors[c] = lengths[c] > 0.0 ? divs[c] / lengths[c] : 0.0;
+    }
+    vtkIdType numBins = divs[0] * divs[1] * divs[2];
+
+    std::vector<vtkCleanPolyDataBinnedPoint> binned(numPts);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        binned[ptId].PtId = ptId;
+        binned[ptId].Bin = numBins;
+        if (firstUse[ptId] < connSize)
+        {
+          const double *x = &newX[3 * ptId];
+          vtkIdType ijk[3];
+          for (int c = 0; c < 3; ++c)
+          {
+            // Points outside of the bounds, and NaNs, are clamped
+            double t = (x[c] - mappedBounds[2 * c]) * factors[c];
+            ijk[c] = t > 0.0 ?
+              (t < divs[c] ? static_cast<vtkIdType>(t) : divs[c] - 1) : 0;
+          }
+          binned[ptId].Bin = ijk[0] + divs[0] * (ijk[1] + divs[1] * ijk[2]);
+        }
+      }
+    });
+    vtkSMPTools::Sort(binned.begin(), binned.end());
+    vtkCleanPolyDataBinnedPoint last = { numBins, 0 };
+    vtkIdType numUsedPts = static_cast<vtkIdType>(
+      std::lower_bound(binned.begin(), binned.end(), last) - binned.begin());
+
+    // Merge the coincident points of each bin. A range of the sorted points
+    // processes the bins that start in it.
+    auto hasNoNaN = [&](const vtkCleanPolyDataBinnedPoint &p)
+    {
+      const double *x = &newX[3 * p.PtId];
+      return !vtkMath::IsNan(x[0]) && !vtkMath::IsNan(x[1]) &&
+             !vtkMath::IsNan(x[2]);
+    };
+    auto coincident = [&](const vtkCleanPolyDataBinnedPoint &a,
+                          const vtkCleanPolyDataBinnedPoint &b)
+    {
+      const double *x = &newX[3 * a.PtId];
+      const double *y = &newX[3 * b.PtId];
+      return x[0] == y[0] && x[1] == y[1] && x[2] == y[2];
+    };
+    auto coordinatesLess = [&](const vtkCleanPolyDataBinnedPoint &a,
+                               const vtkCleanPolyDataBinnedPoint &b)
+    {
+      const double *x = &newX[3 * a.PtId];
+      const double *y = &newX[3 * b.PtId];
+      for (int c = 0; c < 3; ++c)
+      {
+        if (x[c] != y[c])
+        {
+          return x[c] < y[c];
+        }
+      }
+      return firstUse[a.PtId] < firstUse[b.PtId];
+    };
+    vtkSMPThreadLocal<std::vector<vtkCleanPolyDataBinnedPoint> > localBins;
+    vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      std::vector<vtkCleanPolyDataBinnedPoint> &bin = localBins.Local();
+      vtkIdType i = begin;
+      while (i < end && i > 0 && binned[i].Bin == binned[i - 1].Bin)
+      {
+        ++i;
+      }
+      while (i < end)
+      {
+        vtkIdType binEnd = i + 1;
+        while (binEnd < numUsedPts && binned[binEnd].Bin == binned[i].Bin)
+        {
+          ++binEnd;
+        }
+        // Sorting a copy of the bin by coordinates, then by first use,
+        // makes each group of coincident points a run that starts with its
+        // representative. Points with NaN coordinates are never merged.
+        bin.assign(binned.begin() + i, binned.begin() + binEnd);
+        std::vector<vtkCleanPolyDataBinnedPoint>::iterator last =
+          std::partition(bin.begin(), bin.end(), hasNoNaN);
+        for (std::vector<vtkCleanPolyDataBinnedPoint>::iterator p = last;
+             p != bin.end(); ++p)
+        {
+          pointMap[p->PtId] = p->PtId;
+        }
+        std::sort(bin.begin(), last, coordinatesLess);
+        vtkIdType representative = -1;
+        for (std::vector<vtkCleanPolyDataBinnedPoint>::iterator p =
+               bin.begin(); p != last; ++p)
+        {
+          if (p == bin.begin() || !coincident(*(p - 1), *p))
+          {
+            representative = p->PtId;
+          }
+          pointMap[p->PtId] = representative;
+        }
+        i = binEnd;
+      }
+    });
+  }
+  this->UpdateProgress(0.4);
+
+  // The output ids of the representatives are the ranks of their first use
+  std::vector<vtkIdType> newIds(connSize, 0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      if (pointMap[ptId] == ptId)
+      {
+        newIds[firstUse[ptId]] = 1;
+      }
+    }
+  });
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    newIds.begin(), newIds.end(), newIds.begin(), vtkIdType(0));
+
+  vtkNew<vtkIdList> inPtIds;
+  vtkNew<vtkIdList> outPtIds;
+  inPtIds->SetNumberOfIds(numNewPts);
+  outPtIds->SetNumberOfIds(numNewPts);
+  vtkIdType *pointSources = inPtIds->GetPointer(0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      vtkIdType representative = pointMap[ptId];
+      if (representative >= 0)
+      {
+        vtkIdType newId = newIds[firstUse[representative]];
+        if (representative == ptId)
+        {
+          pointSources[newId] = ptId;
+        }
+        pointMap[ptId] = newId;
+      }
+    }
+  });
+  delete [] firstUse;
+  std::vector<vtkIdType>().swap(newIds);
+
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkSMPTools::For(0, numNewPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType newId = begin; newId < end; ++newId)
+    {
+      const double *x = &newX[3 * pointSources[newId]];
+      if (isFloat)
+      {
+        float *newx = static_cast<vtkFloatArray*>(newPts->GetData())->
+          GetPointer(3 * newId);
+        newx[0] = static_cast<float>(x[0]);
+        newx[1] = static_cast<float>(x[1]);
+        newx[2] = static_cast<float>(x[2]);
+      }
+      else
+      {
+        double *newx = static_cast<vtkDoubleArray*>(newPts->GetData())->
+          GetPointer(3 * newId);
+        newx[0] = x[0];
+        newx[1] = x[1];
+        newx[2] = x[2];
+      }
+      outPtIds->SetId(newId, newId);
+    }
+  });
+  std::vector<double>().swap(newX);
+  vtkPointData *outputPD = output->GetPointData();
+  outputPD->CopyAllocate(input->GetPointData(), numNewPts);
+  outputPD->CopyData(input->GetPointData(), inPtIds.GetPointer(),
+                     outPtIds.GetPointer());
+  this->UpdateProgress(0.6);
+
+  // Output type and number of points of each cell
+  vtkCleanPolyDataUpdateCell update;
+  update.PointMap = &pointMap[0];
+  update.Convert[0] = 0;
+  update.Convert[1] = this->ConvertLinesToPoints;
+  update.Convert[2] = this->ConvertPolysToLines;
+  update.Convert[3] = this->ConvertStripsToPolys;
+  std::vector<signed char> types(numCells);
+  std::vector<vtkIdType> sizes(numCells);
+  vtkSMPThreadLocal<std::vector<vtkIdType> > localPts;
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    std::vector<vtkIdType> &newPtIds = localPts.Local();
+    vtkIdType npts, position;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      int type = cells.GetCell(cellId, npts, pts, position);
+      newPtIds.resize(npts > 0 ? npts : 1);
+      types[cellId] = static_cast<signed char>(
+        update(type, npts, pts, &newPtIds[0], sizes[cellId]));
+    }
+  });
+
+  // The output cells of each type are numbered in the order of the input
+  // cells, and their cell data are ordered verts, lines, polys, strips.
+  std::vector<vtkIdType> ids(numCells);
+  std::vector<vtkIdType> offsets(numCells);
+  std::vector<vtkIdType> cellMap(numCells);
+  vtkCellArray *newCells[4] = { NULL, NULL, NULL, NULL };
+  vtkIdType numNewCells = 0;
+  for (int type = 0; type < 4; ++type)
+  {
+    // Only the cells of this type or above can become cells of this type
+    vtkIdType begin = cells.CellBase[type];
+    vtkSMPTools::For(begin, numCells, [&](vtkIdType b, vtkIdType e)
+    {
+      for (vtkIdType cellId = b; cellId < e; ++cellId)
+      {
+        bool keep = types[cellId] == type;
+        ids[cellId] = keep ? 1 : 0;
+        offsets[cellId] = keep ? sizes[cellId] : 0;
+      }
+    });
+    vtkIdType numTypeCells = vtkSMPTools::ExclusiveScan(
+      ids.begin() + begin, ids.end(), ids.begin() + begin, vtkIdType(0));
+    vtkIdType typeConnSize = vtkSMPTools::ExclusiveScan(
+      offsets.begin() + begin, offsets.end(), offsets.begin() + begin,
+      vtkIdType(0));
+    if (numTypeCells == 0 && cells.CellBase[type + 1] == begin)
+    {
+      continue;
+    }
+
+    newCells[type] = vtkCellArray::New();
+    vtkCleanPolyDataWriteCells(
+      cells, update, type, types.data(), ids.data(), offsets.data(),
+      numTypeCells, typeConnSize, cellMap.data() + numNewCells,
+      newCells[type]);
+    numNewCells += numTypeCells;
+  }
+  this->UpdateProgress(0.8);
+
+  vtkNew<vtkIdList> inCellIds;
+  vtkNew<vtkIdList> outCellIds;
+  inCellIds->SetNumberOfIds(numNewCells);
+  outCellIds->SetNumberOfIds(numNewCells);
+  std::copy(cellMap.begin(), cellMap.begin() + numNewCells,
+            inCellIds->GetPointer(0));
+  for (vtkIdType cellId = 0; cellId < numNewCells; ++cellId)
+  {
+    outCellIds->SetId(cellId, cellId);
+  }
+  vtkCellData *outputCD = output->GetCellData();
+  outputCD->CopyAllocate(input->GetCellData(), numNewCells);
+  outputCD->CopyData(input->GetCellData(), inCellIds.GetPointer(),
+                     outCellIds.GetPointer());
+
+  vtkDebugMacro(<<"Removed " << numPts - numNewPts << " points and "
+                << numCells - numNewCells << " cells");
+
+  output->SetPoints(newPts);
+  if (newCells[0])
+  {
+    output->SetVerts(newCells[0]);
+  }
+  if (newCells[1])
+  {
+    output->SetLines(newCells[1]);
+  }
+  if (newCells[2])
+  {
+    output->SetPolys(newCells[2]);
+  }
+  if (newCells[3])
+  {
+    output->SetStrips(newCells[3]);
+  }
+  for (int type = 0; type < 4; ++type)
+  {
+    if (newCells[type])
+    {
+      newCells[type]->Delete();
+    }
+  }
+}
+
 //--------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
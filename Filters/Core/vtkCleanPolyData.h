@@ -46,6 +46,16 @@
  * will not be used, and points that are not used by any cells will be
  * eliminated, but never merged.
  *
+ * When merging is off, or when the tolerance is 0.0 and the locator is
+ * NULL or a vtkMergePoints, the filter runs in parallel with vtkSMPTools
+ * (subclasses only do so if CanOperateOnPointsInParallel() is true):
+ * the points are sorted into bins, the coincident points of each bin are
+ * merged concurrently and the cells are rewritten in parallel. The output
+ * is identical to the one of the serial exact merging (the locator is not
+ * used then). Merging with a tolerance is inherently sequential, since the
+ * result depends on the order in which points are inserted, and remains
+ * serial.
+ *
  * @warning
  * Merging points can alter topology, including introducing non-manifold
  * forms. The tolerance should be chosen carefully to avoid these problems.
@@ -69,6 +79,7 @@
 #include "vtkPolyDataAlgorithm.h"
 
 class vtkIncrementalPointLocator;
+class vtkPoints;
 
 class VTKFILTERSCORE_EXPORT vtkCleanPolyData : public vtkPolyDataAlgorithm
 {
@@ -169,7 +180,9 @@ public:
   vtkMTimeType GetMTime() VTK_OVERRIDE;
 
   /**
-   * Perform operation on a point
+   * Perform operation on a point. When the filter runs in parallel (see
+   * CanOperateOnPointsInParallel()), this is called concurrently from
+   * several threads.
    */
   virtual void OperateOnPoint(double in[3], double out[3]);
 
@@ -205,6 +218,22 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
 
+  /**
+   * Merge the points exactly, or only remove unused points if PointMerging
+   * is off, and rewrite the cells in parallel. newPts is empty, with the
+   * data type of the output points (float or double).
+   */
+  void CleanInParallel(vtkPolyData *input, vtkPoints *newPts,
+                       vtkPolyData *output);
+
+  /**
+   * Return true if OperateOnPoint() and OperateOnBounds() may be called
+   * from several threads, which the parallel path requires. This is only
+   * true for vtkCleanPolyData itself: subclasses overriding them with
+   * thread safe code can override this method to return true.
+   */
+  virtual bool CanOperateOnPointsInParallel();
+
   int   PointMerging;
   double Tolerance;
   double AbsoluteTolerance;
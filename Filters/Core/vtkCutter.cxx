@@ -38,12 +38,19 @@
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkScalarTree.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPMergePoints.h"
+#include "vtkSMPMergePolyDataHelper.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSpanSpace.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
-#include "vtkUnstructuredGridBase.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkTimerLog.h"
@@ -52,10 +59,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
-vtkCxxSetObjectMacro(vtkCutter,Locator,vtkIncrementalPointLocator)
+vtkCxxSetObjectMacro(vtkCutter,ScalarTree,vtkScalarTree)
 
 //----------------------------------------------------------------------------
 // Construct with user-specified implicit function; initial value of 0.0; and
@@ -67,8 +75,11 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->CutFunction = cf;
   this->GenerateCutScalars = 0;
   this->Locator = NULL;
+  this->LocatorIsDefault = false;
   this->GenerateTriangles = 1;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->UseScalarTree = 0;
+  this->ScalarTree = NULL;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
@@ -82,6 +93,7 @@ vtkCutter::~vtkCutter()
   this->ContourValues->Delete();
   this->SetCutFunction(NULL);
   this->SetLocator(NULL);
+  this->SetScalarTree(NULL);
 
   this->SynchronizedTemplates3D->Delete();
   this->SynchronizedTemplatesCutter3D->Delete();
@@ -703,16 +715,421 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+//----------------------------------------------------------------------------
+// Threaded cutting of unstructured grids, see ParallelUnstructuredGridCutter.
+namespace
+{
+
+// Output of the cells processed by one thread, with the offsets of the
+// cells that vtkSMPMergePolyDataHelper needs to merge the outputs.
+struct vtkCutterLocalData
+{
+  vtkPolyData *Output;
+  vtkSMPMergePoints *Locator;
+  vtkIdList *VertOffsets;
+  vtkIdList *LineOffsets;
+  vtkIdList *PolyOffsets;
+  vtkContourHelper *Helper;
+  vtkGenericCell *Cell;
+  vtkDoubleArray *CellScalars;
+  vtkIdList *CellPointIds;
+
+  vtkCutterLocalData() : Output(NULL)
+  {
+  }
+};
+
+// Cuts a range of cell ids or, when a scalar tree is given, a range of
+// batches of candidate cells for the value being traversed.
+class vtkCutterFunctor
+{
+public:
+  vtkUnstructuredGrid *Input;
+  vtkDoubleArray *CutScalars;
+  vtkPointData *InPD;
+  vtkScalarTree *ScalarTree;
+  const double *Values;
+  int NumValues;
+  const unsigned char *CellTypeDimensions;
+  int PointsType;
+  bool GenerateTriangles;
+  vtkIdType EstimatedSize;
+  double Bounds[6];
+
+  vtkSMPThreadLocal<vtkCutterLocalData> LocalData;
+
+  vtkCutterFunctor(vtkUnstructuredGrid *input, vtkDoubleArray *cutScalars,
+                   vtkPointData *inPD, const unsigned char *cellTypeDimensions,
+                   int pointsType, bool generateTriangles) :
+    Input(input), CutScalars(cutScalars), InPD(inPD), ScalarTree(NULL),
+    Values(NULL), NumValues(0), CellTypeDimensions(cellTypeDimensions),
+    PointsType(pointsType), GenerateTriangles(generateTriangles)
+  {
+    this->EstimatedSize = static_cast<vtkIdType>(
+      pow(static_cast<double>(input->GetNumberOfCells()),.75));
+    this->EstimatedSize = this->EstimatedSize / 1024 * 1024;
+    if (this->EstimatedSize < 1024)
+    {
+      this->EstimatedSize = 1024;
+    }
+    // Computed once here, GetBounds() is not safe to call from the threads.
+    input->GetBounds(this->Bounds);
+  }
+
+  ~vtkCutterFunctor()
+  {
+    vtkSMPThreadLocal<vtkCutterLocalData>::iterator iter =
+      this->LocalData.begin();
+    for (; iter != this->LocalData.end(); ++iter)
+    {
+      delete iter->Helper;
+      iter->Output->Delete();
+      iter->Locator->Delete();
+      iter->VertOffsets->Delete();
+      iter->LineOffsets->Delete();
+      iter->PolyOffsets->Delete();
+      iter->Cell->Delete();
+      iter->CellScalars->Delete();
+      iter->CellPointIds->Delete();
+    }
+  }
+
+  void Initialize()
+  {
+    // With a scalar tree, vtkSMPTools::For() is invoked once per contour
+    // value and the outputs of the threads accumulate.
+    vtkCutterLocalData &local = this->LocalData.Local();
+    if (local.Output)
+    {
+      return;
+    }
+    vtkIdType size = this->EstimatedSize;
+
+    local.Output = vtkPolyData::New();
+    vtkNew<vtkPoints> newPts;
+    newPts->SetDataType(this->PointsType);
+    newPts->Allocate(size, size / 2);
+    local.Output->SetPoints(newPts.GetPointer());
+
+    // All the locators must share the same binning to be merged.
+    local.Locator = vtkSMPMergePoints::New();
+    local.Locator->InitPointInsertion(newPts.GetPointer(),
+                                      this->Bounds,
+                                      this->Input->GetNumberOfPoints());
+
+    vtkNew<vtkCellArray> newVerts;
+    newVerts->Allocate(size, size / 2);
+    local.Output->SetVerts(newVerts.GetPointer());
+    vtkNew<vtkCellArray> newLines;
+    newLines->Allocate(size, size / 2);
+    local.Output->SetLines(newLines.GetPointer());
+    vtkNew<vtkCellArray> newPolys;
+    newPolys->Allocate(size, size / 2);
+    local.Output->SetPolys(newPolys.GetPointer());
+
+    local.VertOffsets = vtkIdList::New();
+    local.VertOffsets->Allocate(size);
+    local.LineOffsets = vtkIdList::New();
+    local.LineOffsets->Allocate(size);
+    local.PolyOffsets = vtkIdList::New();
+    local.PolyOffsets->Allocate(size);
+
+    vtkPointData *outPD = local.Output->GetPointData();
+    vtkCellData *outCD = local.Output->GetCellData();
+    vtkCellData *inCD = this->Input->GetCellData();
+    outPD->InterpolateAllocate(this->InPD, size, size / 2);
+    outCD->CopyAllocate(inCD, size, size / 2);
+    local.Helper = new vtkContourHelper(local.Locator, newVerts.GetPointer(),
+      newLines.GetPointer(), newPolys.GetPointer(), this->InPD, inCD, outPD,
+      outCD, size, this->GenerateTriangles);
+
+    local.Cell = vtkGenericCell::New();
+    local.CellScalars = vtkDoubleArray::New();
+    local.CellScalars->Allocate(VTK_CELL_SIZE);
+    local.CellPointIds = vtkIdList::New();
+  }
+
+  // Cut the cell with the values that are in the range of its scalars.
+  void CutCell(vtkCutterLocalData &local, vtkIdType cellId)
+  {
+    if (this->CellTypeDimensions[this->Input->GetCellType(cellId)] == 0)
+    {
+      return; // Points cannot be cut.
+    }
+
+    vtkIdList *pointIds = local.CellPointIds;
+    this->Input->GetCellPoints(cellId, pointIds);
+    vtkIdType numCellPts = pointIds->GetNumberOfIds();
+    const vtkIdType *ptIds = pointIds->GetPointer(0);
+    const double *scalars = this->CutScalars->GetPointer(0);
+    double range[2];
+    range[0] = range[1] = scalars[ptIds[0]];
+    for (vtkIdType i = 1; i < numCellPts; ++i)
+    {
+      range[0] = std::min(range[0], scalars[ptIds[i]]);
+      range[1] = std::max(range[1], scalars[ptIds[i]]);
+    }
+
+    bool cellFetched = false;
+    vtkCellArray *verts = local.Output->GetVerts();
+    vtkCellArray *lines = local.Output->GetLines();
+    vtkCellArray *polys = local.Output->GetPolys();
+    for (int i = 0; i < this->NumValues; ++i)
+    {
+      double value = this->Values[i];
+      if (value < range[0] || value > range[1])
+      {
+        continue;
+      }
+      if (!cellFetched)
+      {
+        this->Input->GetCell(cellId, local.Cell);
+        local.CellScalars->SetNumberOfTuples(numCellPts);
+        this->CutScalars->GetTuples(pointIds, local.CellScalars);
+        cellFetched = true;
+      }
+
+      vtkIdType vertSize = verts->GetNumberOfConnectivityEntries();
+      vtkIdType lineSize = lines->GetNumberOfConnectivityEntries();
+      vtkIdType polySize = polys->GetNumberOfConnectivityEntries();
+      local.Helper->Contour(local.Cell, value, local.CellScalars, cellId);
+      // Each offset gives the start of one or more cells, so that the
+      // cell arrays of the threads can be merged in parallel.
+      if (verts->GetNumberOfConnectivityEntries() > vertSize)
+      {
+        local.VertOffsets->InsertNextId(vertSize);
+      }
+      if (lines->GetNumberOfConnectivityEntries() > lineSize)
+      {
+        local.LineOffsets->InsertNextId(lineSize);
+      }
+      if (polys->GetNumberOfConnectivityEntries() > polySize)
+      {
+        local.PolyOffsets->InsertNextId(polySize);
+      }
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkCutterLocalData &local = this->LocalData.Local();
+    if (!this->ScalarTree)
+    {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->CutCell(local, cellId);
+      }
+      return;
+    }
+
+    for (vtkIdType batchNum = begin; batchNum < end; ++batchNum)
+    {
+      vtkIdType numCells;
+      const vtkIdType *cellIds =
+        this->ScalarTree->GetCellBatch(batchNum, numCells);
+      for (vtkIdType i = 0; i < numCells; ++i)
+      {
+        this->CutCell(local, cellIds[i]);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+// The threaded cutter merges the outputs of the threads cell type by cell
+// type, so that the cell data is only consistent when all the cells are cut
+// into the same type. It merges points with its own vtkSMPMergePoints, so
+// a locator set by the user is only honored by the serial path.
+bool vtkCutter::CanCutInParallel(vtkUnstructuredGrid *input)
+{
+  if (this->SortBy != VTK_SORT_BY_VALUE ||
+      (this->Locator && !this->LocatorIsDefault) ||
+      !input->GetPoints() || !input->GetCellTypesArray())
+  {
+    return false;
+  }
+
+  unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+  const unsigned char *types = input->GetCellTypesArray()->GetPointer(0);
+  vtkIdType numCells = input->GetNumberOfCells();
+  int dimension = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (types[cellId] >= VTK_NUMBER_OF_CELL_TYPES)
+    {
+      return false; // Reported by the serial path.
+    }
+    int cellDimension = cellTypeDimensions[types[cellId]];
+    if (cellDimension == 0)
+    {
+      continue;
+    }
+    if (dimension != 0 && cellDimension != dimension)
+    {
+      return false;
+    }
+    dimension = cellDimension;
+  }
+  return dimension != 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCutter::ParallelUnstructuredGridCutter(vtkUnstructuredGrid *input,
+                                               vtkPolyData *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  int numContours = this->ContourValues->GetNumberOfContours();
+  double *values = this->ContourValues->GetValues();
+
+  // The scalar tree keeps the cut scalars it was built with: reuse them as
+  // long as neither the input nor the cut function changed.
+  vtkSmartPointer<vtkDoubleArray> cutScalars;
+  if ( this->UseScalarTree )
+  {
+    if ( this->ScalarTree == NULL )
+    {
+      this->ScalarTree = vtkSpanSpace::New();
+      this->ScalarTree->Register(this);
+      this->ScalarTree->Delete();
+    }
+    vtkDoubleArray *treeScalars =
+      vtkDoubleArray::SafeDownCast(this->ScalarTree->GetScalars());
+    vtkMTimeType treeTime = this->ScalarTree->GetMTime();
+    if ( treeScalars && this->ScalarTree->GetDataSet() == input &&
+         treeScalars->GetNumberOfTuples() == numPts &&
+         treeTime > input->GetMTime() &&
+         treeTime > this->CutFunction->GetMTime() &&
+         treeTime > this->Superclass::GetMTime() )
+    {
+      cutScalars = treeScalars;
+    }
+  }
+  if ( !cutScalars )
+  {
+    // vtkPlane evaluates the points with vtkSMPTools.
+    cutScalars = vtkSmartPointer<vtkDoubleArray>::New();
+    cutScalars->SetNumberOfTuples(numPts);
+    this->CutFunction->EvaluateFunction(input->GetPoints()->GetData(),
+                                        cutScalars);
+    if ( this->UseScalarTree )
+    {
+      this->ScalarTree->SetDataSet(input);
+      this->ScalarTree->SetScalars(cutScalars);
+    }
+  }
+
+  // Interpolate data along edge. If generating cut scalars, do necessary setup
+  vtkSmartPointer<vtkPointData> inPD = input->GetPointData();
+  if ( this->GenerateCutScalars )
+  {
+    inPD = vtkSmartPointer<vtkPointData>::New();
+    inPD->ShallowCopy(input->GetPointData());//copies original attributes
+    inPD->SetScalars(cutScalars);
+  }
+
+  // set precision for the points in the output
+  int pointsType = input->GetPoints()->GetDataType();
+  if ( this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION )
+  {
+    pointsType = VTK_FLOAT;
+  }
+  else if ( this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION )
+  {
+    pointsType = VTK_DOUBLE;
+  }
+
+  unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+  vtkCutterFunctor functor(input, cutScalars, inPD, cellTypeDimensions,
+                           pointsType, this->GenerateTriangles != 0);
+
+  // The scalar tree cannot be built over constant scalars.
+  double range[2];
+  cutScalars->GetRange(range);
+  if ( this->UseScalarTree && range[0] < range[1] )
+  {
+    functor.ScalarTree = this->ScalarTree;
+    functor.NumValues = 1;
+    for (int i = 0; i < numContours; ++i)
+    {
+      if ( values[i] < range[0] || values[i] > range[1] )
+      {
+        continue;
+      }
+      this->ScalarTree->InitTraversal(values[i]);
+      vtkIdType numBatches = this->ScalarTree->GetNumberOfCellBatches();
+      if ( numBatches > 0 )
+      {
+        functor.Values = values + i;
+        vtkSMPTools::For(0, numBatches, functor);
+      }
+      this->UpdateProgress(static_cast<double>(i + 1) / numContours);
+    }
+  }
+  else
+  {
+    functor.Values = values;
+    functor.NumValues = numContours;
+    vtkSMPTools::For(0, input->GetNumberOfCells(), functor);
+  }
+
+  std::vector<vtkSMPMergePolyDataHelper::InputData> mpData;
+  vtkSMPThreadLocal<vtkCutterLocalData>::iterator iter =
+    functor.LocalData.begin();
+  for (; iter != functor.LocalData.end(); ++iter)
+  {
+    mpData.push_back(vtkSMPMergePolyDataHelper::InputData(iter->Output,
+      iter->Locator, iter->VertOffsets, iter->LineOffsets, iter->PolyOffsets));
+  }
+  if ( mpData.empty() )
+  {
+    return;
+  }
+
+  vtkPolyData *merged = vtkSMPMergePolyDataHelper::MergePolyData(mpData);
+  output->SetPoints(merged->GetPoints());
+  if ( merged->GetVerts() && merged->GetVerts()->GetNumberOfCells() )
+  {
+    output->SetVerts(merged->GetVerts());
+  }
+  if ( merged->GetLines() && merged->GetLines()->GetNumberOfCells() )
+  {
+    output->SetLines(merged->GetLines());
+  }
+  if ( merged->GetPolys() && merged->GetPolys()->GetNumberOfCells() )
+  {
+    output->SetPolys(merged->GetPolys());
+  }
+  output->GetPointData()->ShallowCopy(merged->GetPointData());
+  output->GetCellData()->ShallowCopy(merged->GetCellData());
+  merged->Delete();
+  output->Squeeze();
+}
+
 //----------------------------------------------------------------------------
 void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 {
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (grid && this->CanCutInParallel(grid))
+  {
+    vtkDebugMacro(<< "Cutting unstructured grid in parallel");
+    this->ParallelUnstructuredGridCutter(grid, output);
+    return;
+  }
+
   vtkIdType i;
   int iter;
   vtkDoubleArray *cellScalars;
   vtkCellArray *newVerts, *newLines, *newPolys;
   vtkPoints *newPoints;
   vtkDoubleArray *cutScalars;
-  double value;
   vtkIdType estimatedSize, numCells=input->GetNumberOfCells();
   vtkIdType numPts=input->GetNumberOfPoints();
   vtkIdType numCellPts;
@@ -863,13 +1280,8 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
           cellIter->GetCell(cell.GetPointer());
           cellIds = cell->GetPointIds();
           cutScalars->GetTuples(cellIds,cellScalars);
-          // Loop over all contour values.
-          for (iter=0; iter < numContours && !abortExecute; iter++)
-          {
-            value = this->ContourValues->GetValue(iter);
-            helper.Contour(cell.GetPointer(), value, cellScalars,
-                           cellIter->GetCellId());
-          }
+          helper.Contour(cell.GetPointer(), val, cellScalars,
+                         cellIter->GetCellId());
         }
 
       } // for all cells
@@ -1017,6 +1429,26 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 //----------------------------------------------------------------------------
 // Specify a spatial locator for merging points. By default,
 // an instance of vtkMergePoints is used.
+void vtkCutter::SetLocator(vtkIncrementalPointLocator *locator)
+{
+  if ( this->Locator == locator )
+  {
+    return;
+  }
+  if ( this->Locator )
+  {
+    this->Locator->UnRegister(this);
+  }
+  this->Locator = locator;
+  if ( this->Locator )
+  {
+    this->Locator->Register(this);
+  }
+  this->LocatorIsDefault = false;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
 void vtkCutter::CreateDefaultLocator()
 {
   if ( this->Locator == NULL )
@@ -1024,6 +1456,7 @@ void vtkCutter::CreateDefaultLocator()
     this->Locator = vtkMergePoints::New();
     this->Locator->Register(this);
     this->Locator->Delete();
+    this->LocatorIsDefault = true;
   }
 }
 
@@ -1069,4 +1502,15 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Use Scalar Tree: "
+     << (this->UseScalarTree ? "On\n" : "Off\n");
+  if ( this->ScalarTree )
+  {
+    os << indent << "Scalar Tree: " << this->ScalarTree << "\n";
+  }
+  else
+  {
+    os << indent << "Scalar Tree: (none)\n";
+  }
 }
@@ -38,6 +38,16 @@
  * By default, if an implicit function is set it is used to clip the data
  * set, otherwise the dataset scalars are used to perform the clipping.
  *
+ * Unstructured grids are cut in parallel with vtkSMPTools when the output
+ * does not depend on the order in which cells are processed: the cells
+ * (0D cells aside) all have the same dimension, the polygons are sorted
+ * by value and no locator was set with SetLocator(). Each thread cuts
+ * its cells into its own vtkPolyData and the pieces are merged with
+ * vtkSMPMergePoints. The order of the output cells then varies with the
+ * number of threads. Cells that cannot be cut by a value can also be
+ * skipped with a scalar tree (see UseScalarTree), which pays off when
+ * sweeping the contour values through a fixed cut function.
+ *
  * @sa
  * vtkImplicitFunction vtkClipPolyData
 */
@@ -59,6 +69,8 @@ class vtkSynchronizedTemplates3D;
 class vtkSynchronizedTemplatesCutter3D;
 class vtkGridSynchronizedTemplates3D;
 class vtkRectilinearSynchronizedTemplates;
+class vtkScalarTree;
+class vtkUnstructuredGrid;
 
 class VTKFILTERSCORE_EXPORT vtkCutter : public vtkPolyDataAlgorithm
 {
@@ -175,6 +187,27 @@ public:
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
   //@}
 
+  //@{
+  /**
+   * Enable the use of a scalar tree to skip the cells of unstructured grids
+   * that the cut surfaces do not cross. The tree is built over the values of
+   * the cut function, and is only rebuilt when the input or the cut function
+   * change, so that changing the contour values is cheap. Off by default.
+   */
+  vtkSetMacro(UseScalarTree,int);
+  vtkGetMacro(UseScalarTree,int);
+  vtkBooleanMacro(UseScalarTree,int);
+  //@}
+
+  //@{
+  /**
+   * Specify the instance of vtkScalarTree to use. If not specified
+   * and UseScalarTree is enabled, then a vtkSpanSpace will be used.
+   */
+  void SetScalarTree(vtkScalarTree *sTree);
+  vtkGetObjectMacro(ScalarTree,vtkScalarTree);
+  //@}
+
   //@{
   /**
    * Set the sorting order for the generated polydata. There are two
@@ -231,6 +264,9 @@ protected:
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
   int FillInputPortInformation(int port, vtkInformation *info) VTK_OVERRIDE;
   void UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
+  bool CanCutInParallel(vtkUnstructuredGrid *input);
+  void ParallelUnstructuredGridCutter(vtkUnstructuredGrid *input,
+                                      vtkPolyData *output);
   void DataSetCutter(vtkDataSet *input, vtkPolyData *output);
   void StructuredPointsCutter(vtkDataSet *, vtkPolyData *,
                               vtkInformation *, vtkInformationVector **,
@@ -246,10 +282,13 @@ protected:
   vtkRectilinearSynchronizedTemplates *RectilinearSynchronizedTemplates;
 
   vtkIncrementalPointLocator *Locator;
+  bool LocatorIsDefault; // Locator was made by CreateDefaultLocator()
   int SortBy;
   vtkContourValues *ContourValues;
   int GenerateCutScalars;
   int OutputPointsPrecision;
+  int UseScalarTree;
+  vtkScalarTree *ScalarTree;
 private:
   vtkCutter(const vtkCutter&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCutter&) VTK_DELETE_FUNCTION;
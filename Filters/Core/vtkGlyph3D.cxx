@@ -14,8 +14,11 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -26,6 +29,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +38,8 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -328,6 +335,22 @@ bool vtkGlyph3D::Execute(
     }
   }
 
+  // A single glyph is copied in parallel, unless its cells are mixed
+  vtkDataArray *array3D = NULL;
+  if ( haveVectors )
+  {
+    array3D = this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
+  }
+  if ( this->IndexMode == VTK_INDEXING_OFF &&
+       (!array3D || array3D->GetNumberOfComponents() <= 3) &&
+       this->ExecuteInParallel(input, source, output, inSScalars, array3D,
+                               inCScalars, inGhostLevels) )
+  {
+    pts->Delete();
+    trans->Delete();
+    return true;
+  }
+
   srcPointIdList->SetNumberOfIds(numSourcePts);
   dstPointIdList->SetNumberOfIds(numSourcePts);
   srcCellIdList->SetNumberOfIds(numSourceCells);
@@ -732,6 +755,519 @@ bool vtkGlyph3D::Execute(
   return true;
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+// Pair the arrays of outAttr, allocated with CopyAllocate() from inAttr,
+// with the arrays of inAttr for the parallel copies of vtkArrayListTemplate.
+// Return false if some arrays cannot be copied through raw pointers.
+bool PairArrays(vtkIdType numOut, vtkDataSetAttributes *inAttr,
+                vtkDataSetAttributes *outAttr, ArrayList &arrays)
+{
+  for (int i = 0; i < outAttr->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array = outAttr->GetArray(i);
+    if (!array || !array->GetName() || !array->HasStandardMemoryLayout())
+    {
+      return false;
+    }
+  }
+  arrays.AddArrays(numOut, inAttr, outAttr, 0.0, false);
+  return true;
+}
+
+// Copy the tuple of each glyphed input point to the glyphSize tuples of its
+// glyph serially with CopyData(), when PairArrays() fails.
+void CopyGlyphTuples(vtkDataSetAttributes *inAttr,
+                     vtkDataSetAttributes *outAttr,
+                     const std::vector<vtkIdType> &glyphIds,
+                     vtkIdType glyphSize)
+{
+  vtkIdType numPts = static_cast<vtkIdType>(glyphIds.size()) - 1;
+  vtkIdType numOut = glyphIds[numPts] * glyphSize;
+  vtkNew<vtkIdList> fromIds;
+  vtkNew<vtkIdList> toIds;
+  fromIds->SetNumberOfIds(numOut);
+  toIds->SetNumberOfIds(numOut);
+  for (vtkIdType inPtId = 0; inPtId < numPts; ++inPtId)
+  {
+    if (glyphIds[inPtId] != glyphIds[inPtId + 1])
+    {
+      for (vtkIdType i = 0; i < glyphSize; ++i)
+      {
+        vtkIdType outId = glyphIds[inPtId] * glyphSize + i;
+        fromIds->SetId(outId, inPtId);
+        toIds->SetId(outId, outId);
+      }
+    }
+  }
+  outAttr->CopyData(inAttr, fromIds.GetPointer(), toIds.GetPointer());
+}
+
+// Copy the cells of the glyph, given by glyphOffsets and glyphConn, once
+// per glyph.
+void WriteGlyphCells(const std::vector<vtkIdType> &glyphOffsets,
+                     const std::vector<vtkIdType> &glyphConn,
+                     vtkIdType numGlyphs, vtkIdType numGlyphPts,
+                     vtkCellArray *cells)
+{
+  vtkIdType numGlyphCells = static_cast<vtkIdType>(glyphOffsets.size()) - 1;
+  vtkIdType glyphConnSize = static_cast<vtkIdType>(glyphConn.size());
+
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> connectivity;
+  offsets->SetNumberOfValues(numGlyphs * numGlyphCells + 1);
+  offsets->SetValue(numGlyphs * numGlyphCells, numGlyphs * glyphConnSize);
+  connectivity->SetNumberOfValues(numGlyphs * glyphConnSize);
+  vtkIdType *offsetsPtr = offsets->GetPointer(0);
+  vtkIdType *connPtr = connectivity->GetPointer(0);
+
+  vtkSMPTools::For(0, numGlyphs, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType glyphId = begin; glyphId < end; ++glyphId)
+    {
+      vtkIdType *glyphOffsetsPtr = offsetsPtr + glyphId * numGlyphCells;
+      for (vtkIdType i = 0; i < numGlyphCells; ++i)
+      {
+        glyphOffsetsPtr[i] = glyphOffsets[i] + glyphId * glyphConnSize;
+      }
+      vtkIdType *glyphConnPtr = connPtr + glyphId * glyphConnSize;
+      for (vtkIdType i = 0; i < glyphConnSize; ++i)
+      {
+        glyphConnPtr[i] = glyphConn[i] + glyphId * numGlyphPts;
+      }
+    }
+  });
+  cells->SetData(offsets.GetPointer(), connectivity.GetPointer());
+}
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+bool vtkGlyph3D::ExecuteInParallel(vtkDataSet *input, vtkPolyData *source,
+                                   vtkPolyData *output,
+                                   vtkDataArray *inSScalars,
+                                   vtkDataArray *array3D,
+                                   vtkDataArray *inCScalars,
+                                   unsigned char *inGhostLevels)
+{
+  // The cells of the glyph must all be in one of the cell arrays, so that
+  // their order in the output is the one of the serial InsertNextCell().
+  vtkCellArray *sourceCells[4] = { source->GetVerts(), source->GetLines(),
+                                   source->GetPolys(), source->GetStrips() };
+  int cellsKind = -1;
+  for (int kind = 0; kind < 4; ++kind)
+  {
+    if (sourceCells[kind] && sourceCells[kind]->GetNumberOfCells() > 0)
+    {
+      if (cellsKind >= 0)
+      {
+        return false;
+      }
+      cellsKind = kind;
+    }
+  }
+
+  vtkDebugMacro(<<"Generating glyphs in parallel");
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPoints *sourcePts = source->GetPoints();
+  vtkIdType numSourcePts = sourcePts->GetNumberOfPoints();
+  vtkIdType numSourceCells = source->GetNumberOfCells();
+  vtkDataArray *sourceNormals = source->GetPointData()->GetNormals();
+  vtkDataArray *sourceTCoords = source->GetPointData()->GetTCoords();
+  vtkPointData *pd = input->GetPointData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+  vtkUniformGrid *inputUG = vtkUniformGrid::SafeDownCast(input);
+  double den = this->Range[1] - this->Range[0];
+  if ( den == 0.0 )
+  {
+    den = 1.0;
+  }
+
+  // Prebuild the glyph: its points after the source transform, normals,
+  // texture coordinates and cells.
+  vtkNew<vtkPoints> glyphPts;
+  glyphPts->SetDataTypeToDouble();
+  if (this->SourceTransform)
+  {
+    this->SourceTransform->TransformPoints(sourcePts, glyphPts.GetPointer());
+  }
+  else
+  {
+    glyphPts->SetNumberOfPoints(numSourcePts);
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      glyphPts->SetPoint(i, sourcePts->GetPoint(i));
+    }
+  }
+  const double *glyphPoints =
+    vtkArrayDownCast<vtkDoubleArray>(glyphPts->GetData())->GetPointer(0);
+
+  std::vector<double> glyphNormals;
+  if (sourceNormals)
+  {
+    glyphNormals.resize(3 * numSourcePts);
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      sourceNormals->GetTuple(i, &glyphNormals[3 * i]);
+    }
+  }
+
+  int numTCoordComps = sourceTCoords ?
+    sourceTCoords->GetNumberOfComponents() : 0;
+  std::vector<float> glyphTCoords(numTCoordComps * numSourcePts);
+  for (vtkIdType i = 0; i < numSourcePts * numTCoordComps; ++i)
+  {
+    glyphTCoords[i] = static_cast<float>(
+      sourceTCoords->GetComponent(i / numTCoordComps, i % numTCoordComps));
+  }
+
+  std::vector<vtkIdType> glyphOffsets(1, 0);
+  std::vector<vtkIdType> glyphConn;
+  if (cellsKind >= 0)
+  {
+    vtkIdType npts, *cellPts;
+    vtkCellArray *cells = sourceCells[cellsKind];
+    for (cells->InitTraversal(); cells->GetNextCell(npts, cellPts); )
+    {
+      glyphConn.insert(glyphConn.end(), cellPts, cellPts + npts);
+      glyphOffsets.push_back(static_cast<vtkIdType>(glyphConn.size()));
+    }
+  }
+
+  // Number the glyphs, skipping the ghost and blanked points. This is
+  // serial because IsPointVisible() may be overridden.
+  std::vector<vtkIdType> glyphIds(numPts + 1, 0);
+  for (vtkIdType inPtId = 0; inPtId < numPts; ++inPtId)
+  {
+    glyphIds[inPtId] =
+      !(inGhostLevels &&
+        inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT) &&
+      !(inputUG && !inputUG->IsPointVisible(inPtId)) &&
+      this->IsPointVisible(input, inPtId);
+  }
+  vtkIdType numGlyphs = vtkSMPTools::ExclusiveScan(
+    glyphIds.begin(), glyphIds.begin() + numPts, glyphIds.begin(),
+    vtkIdType(0));
+  glyphIds[numPts] = numGlyphs;
+  vtkIdType numNewPts = numGlyphs * numSourcePts;
+  this->UpdateProgress(0.1);
+
+  // Allocate the output arrays to their final size
+  vtkNew<vtkPoints> newPts;
+  newPts->SetNumberOfPoints(numNewPts);
+  float *newPtsPtr =
+    vtkArrayDownCast<vtkFloatArray>(newPts->GetData())->GetPointer(0);
+
+  ArrayList pointArrays;
+  ArrayList cellArrays;
+  bool pairedPoints = PairArrays(numNewPts, pd, outputPD, pointArrays);
+  bool pairedCells = !this->FillCellData ||
+    PairArrays(numGlyphs * numSourceCells, pd, outputCD, cellArrays);
+
+  vtkIdType *pointIdsPtr = NULL;
+  if ( this->GeneratePointIds )
+  {
+    vtkNew<vtkIdTypeArray> pointIds;
+    pointIds->SetName(this->PointIdsName);
+    pointIds->SetNumberOfValues(numNewPts);
+    pointIdsPtr = pointIds->GetPointer(0);
+    outputPD->AddArray(pointIds.GetPointer());
+  }
+
+  vtkSmartPointer<vtkDataArray> newScalars;
+  float *newScalarsPtr = NULL;
+  if ( this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars )
+  {
+    newScalars.TakeReference(inCScalars->NewInstance());
+    newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
+    newScalars->SetNumberOfTuples(numNewPts);
+    newScalars->SetName(inCScalars->GetName());
+  }
+  else if ( (this->ColorMode == VTK_COLOR_BY_SCALE && inSScalars) ||
+            (this->ColorMode == VTK_COLOR_BY_VECTOR && array3D) )
+  {
+    vtkFloatArray *floatScalars = vtkFloatArray::New();
+    floatScalars->SetNumberOfValues(numNewPts);
+    newScalarsPtr = floatScalars->GetPointer(0);
+    newScalars.TakeReference(floatScalars);
+    if (this->ColorMode == VTK_COLOR_BY_VECTOR)
+    {
+      newScalars->SetName("VectorMagnitude");
+    }
+    else
+    {
+      newScalars->SetName(this->ScaleMode == VTK_SCALE_BY_SCALAR ?
+                          inSScalars->GetName() : "GlyphScale");
+    }
+  }
+
+  vtkNew<vtkFloatArray> newVectors;
+  newVectors->SetNumberOfComponents(3);
+  newVectors->SetNumberOfTuples(array3D ? numNewPts : 0);
+  newVectors->SetName("GlyphVector");
+  float *newVectorsPtr = newVectors->GetPointer(0);
+
+  vtkNew<vtkFloatArray> newNormals;
+  newNormals->SetNumberOfComponents(3);
+  newNormals->SetNumberOfTuples(sourceNormals ? numNewPts : 0);
+  newNormals->SetName("Normals");
+  float *newNormalsPtr = newNormals->GetPointer(0);
+
+  vtkNew<vtkFloatArray> newTCoords;
+  newTCoords->SetNumberOfComponents(numTCoordComps ? numTCoordComps : 1);
+  newTCoords->SetNumberOfTuples(sourceTCoords ? numNewPts : 0);
+  newTCoords->SetName("TCoords");
+  float *newTCoordsPtr = newTCoords->GetPointer(0);
+
+  // Transform the glyph and copy the attributes for each input point, with
+  // the same arithmetic as the serial loop and vtkLinearTransform.
+  vtkSMPThreadLocalObject<vtkTransform> threadTransforms;
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkTransform *trans = threadTransforms.Local();
+    double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0;
+    double normalMatrix[4][4];
+    for (vtkIdType inPtId = begin; inPtId < end; ++inPtId)
+    {
+      if (glyphIds[inPtId] == glyphIds[inPtId + 1])
+      {
+        continue;
+      }
+      vtkIdType ptIncr = glyphIds[inPtId] * numSourcePts;
+      vtkIdType cellIncr = glyphIds[inPtId] * numSourceCells;
+
+      double scalex = 1.0, scaley = 1.0, scalez = 1.0;
+      if ( inSScalars )
+      {
+        s = inSScalars->GetComponent(inPtId, 0);
+        if ( this->ScaleMode == VTK_SCALE_BY_SCALAR ||
+             this->ScaleMode == VTK_DATA_SCALING_OFF )
+        {
+          scalex = scaley = scalez = s;
+        }
+      }
+
+      if ( array3D )
+      {
+        v[0] = v[1] = v[2] = 0.0;
+        array3D->GetTuple(inPtId, v);
+        vMag = vtkMath::Norm(v);
+        if ( this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
+        {
+          scalex = v[0];
+          scaley = v[1];
+          scalez = v[2];
+        }
+        else if ( this->ScaleMode == VTK_SCALE_BY_VECTOR )
+        {
+          scalex = scaley = scalez = vMag;
+        }
+      }
+
+      if ( this->Clamping )
+      {
+        scalex = (scalex < this->Range[0] ? this->Range[0] :
+                  (scalex > this->Range[1] ? this->Range[1] : scalex));
+        scalex = (scalex - this->Range[0]) / den;
+        scaley = (scaley < this->Range[0] ? this->Range[0] :
+                  (scaley > this->Range[1] ? this->Range[1] : scaley));
+        scaley = (scaley - this->Range[0]) / den;
+        scalez = (scalez < this->Range[0] ? this->Range[0] :
+                  (scalez > this->Range[1] ? this->Range[1] : scalez));
+        scalez = (scalez - this->Range[0]) / den;
+      }
+
+      trans->Identity();
+      input->GetPoint(inPtId, x);
+      trans->Translate(x[0], x[1], x[2]);
+
+      if ( array3D )
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          for (int c = 0; c < 3; ++c)
+          {
+            newVectorsPtr[3 * (ptIncr + i) + c] = static_cast<float>(v[c]);
+          }
+        }
+        if (this->Orient && (vMag > 0.0))
+        {
+          if ( v[1] == 0.0 && v[2] == 0.0 )
+          {
+            if (v[0] < 0)
+            {
+              trans->RotateWXYZ(180.0,0,1,0);
+            }
+          }
+          else
+          {
+            vNew[0] = (v[0]+vMag) / 2.0;
+            vNew[1] = v[1] / 2.0;
+            vNew[2] = v[2] / 2.0;
+            trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+          }
+        }
+      }
+
+      if ( numTCoordComps )
+      {
+        std::copy(glyphTCoords.begin(), glyphTCoords.end(),
+                  newTCoordsPtr + numTCoordComps * ptIncr);
+      }
+
+      if ( newScalarsPtr )
+      {
+        float value = static_cast<float>(
+          this->ColorMode == VTK_COLOR_BY_VECTOR ? vMag : scalex);
+        std::fill_n(newScalarsPtr + ptIncr, numSourcePts, value);
+      }
+      else if ( newScalars )
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          newScalars->SetTuple(ptIncr + i, inPtId, inCScalars);
+        }
+      }
+
+      if ( this->Scaling )
+      {
+        if ( this->ScaleMode == VTK_DATA_SCALING_OFF )
+        {
+          scalex = scaley = scalez = this->ScaleFactor;
+        }
+        else
+        {
+          scalex *= this->ScaleFactor;
+          scaley *= this->ScaleFactor;
+          scalez *= this->ScaleFactor;
+        }
+
+        if ( scalex == 0.0 )
+        {
+          scalex = 1.0e-10;
+        }
+        if ( scaley == 0.0 )
+        {
+          scaley = 1.0e-10;
+        }
+        if ( scalez == 0.0 )
+        {
+          scalez = 1.0e-10;
+        }
+        trans->Scale(scalex,scaley,scalez);
+      }
+
+      double (*matrix)[4] = trans->GetMatrix()->Element;
+      for (vtkIdType i = 0; i < numSourcePts; ++i)
+      {
+        const double *in = glyphPoints + 3 * i;
+        float *out = newPtsPtr + 3 * (ptIncr + i);
+        for (int c = 0; c < 3; ++c)
+        {
+          out[c] = static_cast<float>(matrix[c][0]*in[0] + matrix[c][1]*in[1] +
+                                      matrix[c][2]*in[2] + matrix[c][3]);
+        }
+      }
+
+      if ( sourceNormals )
+      {
+        // to transform the normal, multiply by the transposed inverse matrix
+        vtkMatrix4x4::DeepCopy(*normalMatrix, trans->GetMatrix());
+        vtkMatrix4x4::Invert(*normalMatrix, *normalMatrix);
+        vtkMatrix4x4::Transpose(*normalMatrix, *normalMatrix);
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          const double *in = &glyphNormals[3 * i];
+          float *out = newNormalsPtr + 3 * (ptIncr + i);
+          for (int c = 0; c < 3; ++c)
+          {
+            out[c] = static_cast<float>(normalMatrix[c][0]*in[0] +
+                                        normalMatrix[c][1]*in[1] +
+                                        normalMatrix[c][2]*in[2]);
+          }
+          vtkMath::Normalize(out);
+        }
+      }
+
+      for (vtkIdType i = 0; pairedPoints && i < numSourcePts; ++i)
+      {
+        pointArrays.Copy(inPtId, ptIncr + i);
+      }
+      for (vtkIdType i = 0;
+           this->FillCellData && pairedCells && i < numSourceCells; ++i)
+      {
+        cellArrays.Copy(inPtId, cellIncr + i);
+      }
+      if ( pointIdsPtr )
+      {
+        std::fill_n(pointIdsPtr + ptIncr, numSourcePts, inPtId);
+      }
+    }
+  });
+  this->UpdateProgress(0.8);
+
+  if ( !pairedPoints )
+  {
+    CopyGlyphTuples(pd, outputPD, glyphIds, numSourcePts);
+  }
+  if ( !pairedCells )
+  {
+    CopyGlyphTuples(pd, outputCD, glyphIds, numSourceCells);
+  }
+
+  // Cells
+  if ( cellsKind >= 0 )
+  {
+    vtkNew<vtkCellArray> newCells;
+    WriteGlyphCells(glyphOffsets, glyphConn, numGlyphs, numSourcePts,
+                    newCells.GetPointer());
+    switch (cellsKind)
+    {
+      case 0:
+        output->SetVerts(newCells.GetPointer());
+        break;
+      case 1:
+        output->SetLines(newCells.GetPointer());
+        break;
+      case 2:
+        output->SetPolys(newCells.GetPointer());
+        break;
+      default:
+        output->SetStrips(newCells.GetPointer());
+        break;
+    }
+  }
+
+  output->SetPoints(newPts.GetPointer());
+
+  if (newScalars)
+  {
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+  }
+  if (array3D)
+  {
+    outputPD->SetVectors(newVectors.GetPointer());
+  }
+  if (sourceNormals)
+  {
+    outputPD->SetNormals(newNormals.GetPointer());
+  }
+  if (sourceTCoords)
+  {
+    outputPD->SetTCoords(newTCoords.GetPointer());
+  }
+
+  output->Squeeze();
+  this->UpdateProgress(1.0);
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // Specify a source object at a specified table location.
 void vtkGlyph3D::SetSourceConnection(int id, vtkAlgorithmOutput* algOutput)
@@ -34,6 +34,14 @@
  * you'll have to decide whether to index into it with scalar value or with
  * vector magnitude.
  *
+ * With a single glyph whose cells are all of the same kind (vertices,
+ * lines, polygons or strips), the glyphs are generated in parallel with
+ * vtkSMPTools: the points are numbered with a prefix sum over the
+ * glyphed input points, then the transformed geometry and the copied
+ * attributes are written directly into the output arrays. The output is
+ * the same as the serial one, except that the cells use the offsets
+ * storage of vtkCellArray.
+ *
  * @warning
  * The scaling of the glyphs is controlled by the ScaleFactor ivar multiplied
  * by the scalar value at each point (if VTK_SCALE_BY_SCALAR is set), or
@@ -334,6 +342,17 @@ protected:
                        vtkDataArray *inVectors);
   //@}
 
+  /**
+   * Parallel version of the glyphing loop of Execute() for a single
+   * source. array3D is the array of vectors or normals used to orient and
+   * scale the glyphs, or NULL. Return false, without modifying the output,
+   * if the cells of the source are not all of the same kind.
+   */
+  bool ExecuteInParallel(vtkDataSet *input, vtkPolyData *source,
+                         vtkPolyData *output, vtkDataArray *inSScalars,
+                         vtkDataArray *array3D, vtkDataArray *inCScalars,
+                         unsigned char *inGhostLevels);
+
   vtkPolyData **Source; // Geometry to copy to each point
   int Scaling; // Determine whether scaling of geometry is performed
   int ScaleMode; // Scale by scalar value or vector magnitude
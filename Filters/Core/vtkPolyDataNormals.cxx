@@ -17,6 +17,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -26,9 +27,14 @@
 #include "vtkPolygon.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLinksTemplate.h"
 
 #include "vtkNew.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
 // Construct with feature angle=30, splitting and consistency turned on,
@@ -49,7 +55,6 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   this->Wave = 0;
   this->Wave2 = 0;
   this->CellIds = 0;
-  this->Map = 0;
   this->OldMesh = 0;
   this->NewMesh = 0;
   this->Visited = 0;
@@ -60,6 +65,334 @@ vtkPolyDataNormals::vtkPolyDataNormals()
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
+namespace
+{
+
+// Polygons in the offsets storage: polygon i uses the point ids
+// [Connectivity + Offsets[i], Connectivity + Offsets[i+1]).
+struct vtkPolyDataNormalsPolys
+{
+  const vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+
+  vtkIdType GetCellPoints(vtkIdType cellId, vtkIdType* &pts) const
+  {
+    pts = this->Connectivity + this->Offsets[cellId];
+    return this->Offsets[cellId + 1] - this->Offsets[cellId];
+  }
+};
+
+// A point of the connectivity that is replaced by a split point: the
+// connectivity entry, the original point and the region of the cell.
+struct vtkPolyDataNormalsSplit
+{
+  vtkIdType Entry;
+  vtkIdType PtId;
+  int Region;
+};
+
+// Splits the mesh along sharp edges. For each point, the cells using it
+// are grouped into regions of cells connected by edges that are not sharp.
+// The cells of region r > 0 use a new point, numbered after the points of
+// the previous regions and of the previous points. This is the same
+// numbering as a serial traversal of the points, so that the output does
+// not depend on the number of threads.
+struct vtkPolyDataNormalsSplitWorker
+{
+  vtkPolyDataNormalsPolys Polys;
+  const float *PolyNormals;
+  double CosAngle;
+  vtkIdType NumPts;
+
+  // Point id -> first split point, then the map of the split points into
+  // the input points.
+  std::vector<vtkIdType> FirstSplitPoint;
+  std::vector<vtkIdType> Map;
+
+  template <typename TIds>
+  struct MarkRegions
+  {
+    vtkPolyDataNormalsSplitWorker *Worker;
+    vtkStaticCellLinksTemplate<TIds> *Links;
+    vtkSMPThreadLocal<std::vector<int> > Regions;
+    vtkSMPThreadLocal<std::vector<vtkPolyDataNormalsSplit> > Splits;
+
+    void Initialize()
+    {
+    }
+
+    // Return the index in the links of ptId of the single cell other than
+    // cellId that uses the edge (ptId, nei), or -1.
+    int GetEdgeNeighbor(vtkIdType ptId, vtkIdType nei, vtkIdType cellId)
+    {
+      const TIds *cells = this->Links->GetCells(ptId);
+      const TIds *neiCells = this->Links->GetCells(nei);
+      int ncells = static_cast<int>(this->Links->GetNumberOfCells(ptId));
+      int nneiCells = static_cast<int>(this->Links->GetNumberOfCells(nei));
+      int neighbor = -1;
+      int numNeighbors = 0;
+      // Both lists are sorted
+      for (int i = 0, j = 0; i < ncells && j < nneiCells; )
+      {
+        if (cells[i] < neiCells[j])
+        {
+          ++i;
+        }
+        else if (neiCells[j] < cells[i])
+        {
+          ++j;
+        }
+        else
+        {
+          if (cells[i] != cellId)
+          {
+            neighbor = i;
+            ++numNeighbors;
+          }
+          ++i;
+        }
+      }
+      return numNeighbors == 1 ? neighbor : -1;
+    }
+
+    // Return the point following (or preceding) ptId in the cell, the one
+    // that is not nei.
+    static vtkIdType GetOtherEdgePoint(vtkIdType npts, const vtkIdType *pts,
+                                       vtkIdType ptId, vtkIdType nei)
+    {
+      vtkIdType spot;
+      for (spot = 0; spot < npts; ++spot)
+      {
+        if (pts[spot] == ptId)
+        {
+          break;
+        }
+      }
+      if (spot == 0)
+      {
+        return pts[spot+1] != nei ? pts[spot+1] : pts[npts-1];
+      }
+      else if (spot == npts - 1)
+      {
+        return pts[spot-1] != nei ? pts[spot-1] : pts[0];
+      }
+      return pts[spot+1] != nei ? pts[spot+1] : pts[spot-1];
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      std::vector<int> &regions = this->Regions.Local();
+      std::vector<vtkPolyDataNormalsSplit> &splits = this->Splits.Local();
+      const vtkPolyDataNormalsPolys &polys = this->Worker->Polys;
+      const float *normals = this->Worker->PolyNormals;
+      vtkIdType npts, *pts;
+
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Worker->FirstSplitPoint[ptId] = 0;
+        int ncells = static_cast<int>(this->Links->GetNumberOfCells(ptId));
+        if (ncells <= 1)
+        {
+          continue;
+        }
+        const TIds *cells = this->Links->GetCells(ptId);
+        regions.assign(ncells, -1);
+
+        int numRegions = 0;
+        for (int j = 0; j < ncells; ++j)
+        {
+          if (regions[j] >= 0)
+          {
+            continue;
+          }
+          // Grow the region from the seed cell across its two edges using
+          // ptId, until a sharp edge, a boundary or a visited cell.
+          regions[j] = numRegions;
+          npts = polys.GetCellPoints(cells[j], pts);
+          vtkIdType spot;
+          for (spot = 0; spot < npts; ++spot)
+          {
+            if (pts[spot] == ptId)
+            {
+              break;
+            }
+          }
+          vtkIdType neiPt[2];
+          if (spot == 0)
+          {
+            neiPt[0] = pts[spot+1];
+            neiPt[1] = pts[npts-1];
+          }
+          else if (spot == npts - 1)
+          {
+            neiPt[0] = pts[spot-1];
+            neiPt[1] = pts[0];
+          }
+          else
+          {
+            neiPt[0] = pts[spot+1];
+            neiPt[1] = pts[spot-1];
+          }
+
+          for (int i = 0; i < 2; ++i)
+          {
+            int cell = j;
+            vtkIdType nei = neiPt[i];
+            while (cell >= 0)
+            {
+              int neiCell = this->GetEdgeNeighbor(ptId, nei, cells[cell]);
+              if (neiCell >= 0 && regions[neiCell] < 0)
+              {
+                const float *n0 = normals + 3 * cells[cell];
+                const float *n1 = normals + 3 * cells[neiCell];
+                double dot = static_cast<double>(n0[0]) * n1[0] +
+                  static_cast<double>(n0[1]) * n1[1] +
+                  static_cast<double>(n0[2]) * n1[2];
+                if (dot > this->Worker->CosAngle)
+                {
+                  regions[neiCell] = numRegions;
+                  cell = neiCell;
+                  npts = polys.GetCellPoints(cells[cell], pts);
+                  nei = GetOtherEdgePoint(npts, pts, ptId, nei);
+                }
+                else
+                {
+                  cell = -1; // separated by a sharp edge
+                }
+              }
+              else
+              {
+                cell = -1; // boundary, non-manifold or visited neighbor
+              }
+            }
+          }
+          ++numRegions;
+        }
+
+        // The cells not in the first region use a split point
+        this->Worker->FirstSplitPoint[ptId] = numRegions - 1;
+        for (int j = 0; numRegions > 1 && j < ncells; ++j)
+        {
+          if (regions[j] > 0)
+          {
+            npts = polys.GetCellPoints(cells[j], pts);
+            for (vtkIdType i = 0; i < npts; ++i)
+            {
+              if (pts[i] == ptId)
+              {
+                vtkPolyDataNormalsSplit split =
+                  { pts + i - polys.Connectivity, ptId, regions[j] };
+                splits.push_back(split);
+                break;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    void Reduce()
+    {
+    }
+  };
+
+  template <typename TIds>
+  void operator()(vtkStaticCellLinksTemplate<TIds> &links)
+  {
+    this->FirstSplitPoint.resize(this->NumPts);
+    MarkRegions<TIds> marker;
+    marker.Worker = this;
+    marker.Links = &links;
+    vtkSMPTools::For(0, this->NumPts, marker);
+
+    // Number the split points
+    vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+      this->FirstSplitPoint.begin(), this->FirstSplitPoint.end(),
+      this->FirstSplitPoint.begin(), this->NumPts);
+    this->Map.resize(numNewPts);
+    std::vector<vtkIdType> &map = this->Map;
+    const std::vector<vtkIdType> &first = this->FirstSplitPoint;
+    vtkIdType numPts = this->NumPts;
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        map[ptId] = ptId;
+        vtkIdType last = ptId + 1 < numPts ? first[ptId + 1] : map.size();
+        for (vtkIdType splitId = first[ptId]; splitId < last; ++splitId)
+        {
+          map[splitId] = ptId;
+        }
+      }
+    });
+
+    // Replace the points of the split cells. Each connectivity entry is
+    // replaced at most once.
+    vtkIdType *conn = this->Polys.Connectivity;
+    typedef std::vector<vtkPolyDataNormalsSplit> SplitList;
+    for (typename vtkSMPThreadLocal<SplitList>::iterator it =
+           marker.Splits.begin(); it != marker.Splits.end(); ++it)
+    {
+      const SplitList &splits = *it;
+      vtkSMPTools::For(0, static_cast<vtkIdType>(splits.size()),
+        [&](vtkIdType begin, vtkIdType end)
+      {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          conn[splits[i].Entry] =
+            first[splits[i].PtId] + splits[i].Region - 1;
+        }
+      });
+    }
+  }
+};
+
+// Sums the normals of the polygons using each point, in the order of the
+// polygons, and normalizes them.
+struct vtkPolyDataNormalsPointNormals
+{
+  const float *PolyNormals;
+  float *Normals;
+  vtkIdType NumPts;
+  double FlipDirection;
+
+  template <typename TIds>
+  void operator()(vtkStaticCellLinksTemplate<TIds> &links)
+  {
+    const float *polyNormals = this->PolyNormals;
+    float *normals = this->Normals;
+    double flipDirection = this->FlipDirection;
+    vtkSMPTools::For(0, this->NumPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        float *n = normals + 3 * ptId;
+        n[0] = n[1] = n[2] = 0.0f;
+        const TIds *cells = links.GetCells(ptId);
+        TIds ncells = links.GetNumberOfCells(ptId);
+        for (TIds i = 0; i < ncells; ++i)
+        {
+          const float *polyNormal = polyNormals + 3 * cells[i];
+          n[0] += polyNormal[0];
+          n[1] += polyNormal[1];
+          n[2] += polyNormal[2];
+        }
+        const double length =
+          sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * flipDirection;
+        if (length != 0.0)
+        {
+          n[0] /= length;
+          n[1] /= length;
+          n[2] /= length;
+        }
+      }
+    });
+  }
+};
+
+} // end anon namespace
+
+
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -91,7 +424,7 @@ int vtkPolyDataNormals::RequestData(
   vtkDataSetAttributes* outCD = output->GetCellData();
   double n[3];
   vtkCellArray *newPolys;
-  vtkIdType ptId, oldId;
+  vtkIdType ptId;
 
   vtkDebugMacro(<<"Generating surface normals");
 
@@ -174,7 +507,13 @@ int vtkPolyDataNormals::RequestData(
     this->OldMesh->SetPolys(inPolys);
     polys = inPolys;
   }
-  this->OldMesh->BuildLinks();
+  // The links are only needed by the (serial) traversal that orders the
+  // polygons consistently.
+  bool orderPolys = this->Consistency || this->AutoOrientNormals;
+  if (orderPolys)
+  {
+    this->OldMesh->BuildLinks();
+  }
   this->UpdateProgress(0.10);
 
   pd = input->GetPointData();
@@ -186,12 +525,12 @@ int vtkPolyDataNormals::RequestData(
   newPolys = vtkCellArray::New();
   newPolys->DeepCopy(polys);
   this->NewMesh->SetPolys(newPolys);
-  this->NewMesh->BuildCells(); //builds connectivity
 
   // The visited array keeps track of which polygons have been visited.
   //
-  if ( this->Consistency || this->Splitting || this->AutoOrientNormals )
+  if ( orderPolys )
   {
+    this->NewMesh->BuildCells(); //builds connectivity
     this->Visited = new int[numPolys];
     memset(this->Visited, VTK_CELL_NOT_VISITED, numPolys*sizeof(int));
     this->CellIds = vtkIdList::New();
@@ -338,28 +677,44 @@ int vtkPolyDataNormals::RequestData(
 
   this->UpdateProgress(0.333);
 
+  if ( orderPolys )
+  {
+    delete [] this->Visited;
+    this->Visited = NULL;
+    this->CellIds->Delete();
+  }
+
+  // The next passes are threaded. They access the polygons through the
+  // offsets storage, whose connectivity is modified in place by splitting.
+  newPolys->UseOffsetsStorage(false);
+  vtkPolyDataNormalsPolys cellPolys;
+  cellPolys.Offsets = static_cast<vtkIdTypeArray*>(
+    newPolys->GetOffsetsArray())->GetPointer(0);
+  cellPolys.Connectivity = static_cast<vtkIdTypeArray*>(
+    newPolys->GetConnectivityArray())->GetPointer(0);
+
   //  Initial pass to compute polygon normals without effects of neighbors
   //
   this->PolyNormals = vtkFloatArray::New();
   this->PolyNormals->SetNumberOfComponents(3);
-  this->PolyNormals->Allocate(3*numPolys);
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
+  float *fPolyNormals = this->PolyNormals->GetPointer(0);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
+  vtkSMPTools::For(0, numPolys, [&](vtkIdType begin, vtkIdType end)
   {
-    if ((cellId % 1000) == 0)
+    vtkIdType cellNpts, *cellPts;
+    double cellNormal[3];
+    for (vtkIdType polyId = begin; polyId < end; ++polyId)
     {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
+      cellNpts = cellPolys.GetCellPoints(polyId, cellPts);
+      vtkPolygon::ComputeNormal(inPts, cellNpts, cellPts, cellNormal);
+      fPolyNormals[3 * polyId] = static_cast<float>(cellNormal[0]);
+      fPolyNormals[3 * polyId + 1] = static_cast<float>(cellNormal[1]);
+      fPolyNormals[3 * polyId + 2] = static_cast<float>(cellNormal[2]);
     }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
-  }
+  });
+  this->UpdateProgress(0.5);
 
   // Split mesh if sharp features
   if ( this->Splitting )
@@ -368,23 +723,16 @@ int vtkPolyDataNormals::RequestData(
     //  edges found, split mesh creating new nodes.  Update polygon
     // connectivity.
     //
-      this->CosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
-    //  Splitting will create new points.  We have to create index array
-    // to map new points into old points.
-    //
-    this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i=0; i < numPts; i++)
-    {
-      this->Map->SetId(i,i);
-    }
-
-    for (ptId=0; ptId < numPts; ptId++)
-    {
-      this->MarkAndSplit(ptId);
-    }//for all input points
+    this->CosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
+    vtkPolyDataNormalsSplitWorker splitter;
+    splitter.Polys = cellPolys;
+    splitter.PolyNormals = fPolyNormals;
+    splitter.CosAngle = this->CosAngle;
+    splitter.NumPts = numPts;
+    vtkStaticCellLinksDispatch::Execute(this->NewMesh, splitter);
+    const std::vector<vtkIdType> &map = splitter.Map;
 
-    numNewPts = this->Map->GetNumberOfIds();
+    numNewPts = static_cast<vtkIdType>(map.size());
 
     vtkDebugMacro(<<"Created " << numNewPts-numPts << " new points");
 
@@ -418,13 +766,29 @@ int vtkPolyDataNormals::RequestData(
     }
 
     newPts->SetNumberOfPoints(numNewPts);
-    for (ptId=0; ptId < numNewPts; ptId++)
+    vtkSMPTools::For(0, numNewPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      double x[3];
+      for (vtkIdType newPtId = begin; newPtId < end; ++newPtId)
+      {
+        inPts->GetPoint(map[newPtId], x);
+        newPts->SetPoint(newPtId, x);
+      }
+    });
+
+    // The input points keep their ids, the split points copy the attributes
+    // of the points they duplicate.
+    outPD->CopyData(pd, 0, numPts, 0);
+    vtkNew<vtkIdList> fromIds;
+    vtkNew<vtkIdList> toIds;
+    fromIds->SetNumberOfIds(numNewPts - numPts);
+    toIds->SetNumberOfIds(numNewPts - numPts);
+    for (ptId=numPts; ptId < numNewPts; ptId++)
     {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId,inPts->GetPoint(oldId));
-      outPD->CopyData(pd,oldId,ptId);
+      fromIds->SetId(ptId - numPts, map[ptId]);
+      toIds->SetId(ptId - numPts, ptId);
     }
-    this->Map->Delete();
+    outPD->CopyData(pd, fromIds.GetPointer(), toIds.GetPointer());
   } //splitting
 
   else //no splitting, so no new points
@@ -434,16 +798,10 @@ int vtkPolyDataNormals::RequestData(
     outPD->PassData(pd);
   }
 
-  if ( this->Consistency || this->Splitting )
-  {
-    delete [] this->Visited;
-    this->CellIds->Delete();
-  }
-
   this->UpdateProgress(0.80);
 
-  //  Finally, traverse all elements, computing polygon normals and
-  //  accumulating them at the vertices.
+  //  Finally, accumulate the polygon normals at the points of the
+  //  (possibly split) polygons.
   //
   if ( this->FlipNormals && ! this->Consistency )
   {
@@ -454,37 +812,18 @@ int vtkPolyDataNormals::RequestData(
   newNormals->SetNumberOfComponents(3);
   newNormals->SetNumberOfTuples(numNewPts);
   newNormals->SetName("Normals");
-  float *fNormals = newNormals->WritePointer(0, 3 * numNewPts);
-  std::fill_n(fNormals, 3 * numNewPts, 0);
-
-  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
   if (this->ComputePointNormals)
   {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
-         ++cellId)
-    {
-      for (vtkIdType i = 0; i < npts; ++i)
-      {
-        fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
-        fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
-        fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
-      }
-    }
-
-    for (vtkIdType i = 0; i < numNewPts; ++i)
-    {
-      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
-                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
-                                 ) * flipDirection;
-      if (length != 0.0)
-      {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
-      }
-    }
+    vtkNew<vtkPolyData> splitMesh;
+    splitMesh->SetPoints(newPts ? newPts : inPts);
+    splitMesh->SetPolys(newPolys);
+    vtkPolyDataNormalsPointNormals accumulator;
+    accumulator.PolyNormals = fPolyNormals;
+    accumulator.Normals = newNormals->GetPointer(0);
+    accumulator.NumPts = numNewPts;
+    accumulator.FlipDirection = flipDirection;
+    vtkStaticCellLinksDispatch::Execute(splitMesh.GetPointer(), accumulator);
   }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -597,167 +936,6 @@ void vtkPolyDataNormals::TraverseAndOrder (void)
   return;
 }
 
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit (vtkIdType ptId)
-{
-  int i,j;
-
-  // Get the cells using this point and make sure that we have to do something
-  unsigned short ncells;
-  vtkIdType *cells;
-  this->OldMesh->GetPointCells(ptId,ncells,cells);
-  if ( ncells <= 1 )
-  {
-    return; //point does not need to be further disconnected
-  }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i=0; i<ncells; i++)
-  {
-    this->Visited[cells[i]] = -1;
-  }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  vtkIdType *pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j=0; j<ncells; j++) //for all cells connected to point
-  {
-    if ( this->Visited[cells[j]] < 0 ) //for all unvisited cells
-    {
-      this->Visited[cells[j]] = numRegions;
-      //okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j],numPts,pts);
-
-      //find the two edges
-      for (spot=0; spot < numPts; spot++)
-      {
-        if ( pts[spot] == ptId )
-        {
-          break;
-        }
-      }
-
-      if ( spot == 0 )
-      {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[numPts-1];
-      }
-      else if ( spot == (numPts-1) )
-      {
-        neiPt[0] = pts[spot-1];
-        neiPt[1] = pts[0];
-      }
-      else
-      {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[spot-1];
-      }
-
-      for (i=0; i<2; i++) //for each of the two edges of the seed cell
-      {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while ( cellId >= 0 ) //while we can grow this region
-        {
-          this->OldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,this->CellIds);
-          if ( this->CellIds->GetNumberOfIds() == 1 &&
-               this->Visited[(neiCellId=this->CellIds->GetId(0))] < 0 )
-          {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
-
-            if ( vtkMath::Dot(thisNormal,neiNormal) > CosAngle )
-            {
-              //visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId,numPts,pts);
-
-              for (spot=0; spot < numPts; spot++)
-              {
-                if ( pts[spot] == ptId )
-                {
-                  break;
-                }
-              }
-
-              if (spot == 0)
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
-              }
-              else if (spot == (numPts-1))
-              {
-                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
-              }
-              else
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
-              }
-
-            }//if not separated by edge angle
-            else
-            {
-              cellId = -1; //separated by edge angle
-            }
-          }//if can move to edge neighbor
-          else
-          {
-            cellId = -1;//separated by previous visit, boundary, or non-manifold
-          }
-        }//while visit wave is propagating
-      }//for each of the two edges of the starting cell
-      numRegions++;
-    }//if cell is unvisited
-  }//for all cells connected to point ptId
-
-  if ( numRegions <=1 )
-  {
-    return; //a single region, no splitting ever required
-  }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j=0; j<ncells; j++)
-  {
-    if (this->Visited[cells[j]] > 0 ) //replace point if splitting needed
-    {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-
-      this->Map->InsertId(replacementPoint, ptId);
-
-      this->NewMesh->GetCellPoints(cells[j],numPts,pts);
-      for (i=0; i < numPts; i++)
-      {
-        if ( pts[i] == ptId )
-        {
-          pts[i] = replacementPoint; // this is very nasty! direct write!
-          break;
-        }
-      }//replace ptId with split point
-    }//if not in first regions and requiring splitting
-  }//for all cells connected to ptId
-
-  return;
-}
-
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
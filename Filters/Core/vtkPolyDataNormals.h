@@ -39,6 +39,12 @@
  * are split and new points generated to prevent blurry edges (due to
  * Gouraud shading).
  *
+ * The polygon normals, the splitting of sharp edges and the point normals
+ * are computed in parallel with vtkSMPTools, on top of vtkStaticCellLinks.
+ * Only the traversal that orders the polygons consistently (Consistency or
+ * AutoOrientNormals) is serial. The output does not depend on the number
+ * of threads.
+ *
  * @warning
  * Normals are computed only for polygons and triangle strips. Normals are
  * not computed for lines or vertices.
@@ -195,7 +201,6 @@ private:
   vtkIdList *Wave;
   vtkIdList *Wave2;
   vtkIdList *CellIds;
-  vtkIdList *Map;
   vtkPolyData *OldMesh;
   vtkPolyData *NewMesh;
   int *Visited;
@@ -206,11 +211,6 @@ private:
   // checked and properly ordered polygons.
   void TraverseAndOrder(void);
 
-  // Check the point id give to see whether it lies on a feature
-  // edge. If so, split the point (i.e., duplicate it) to topologically
-  // separate the mesh.
-  void MarkAndSplit(vtkIdType ptId);
-
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&) VTK_DELETE_FUNCTION;
   void operator=(const vtkPolyDataNormals&) VTK_DELETE_FUNCTION;
@@ -123,12 +123,13 @@ void vtkSMPMergePoints::Merge(vtkSMPMergePoints* locator,
       {
         found = false;
         vtkIdType oldId = idOldArray[oldIdIdx];
-        double *x = oldDataArray->GetTuple( oldId );
-        double *pt;
+        // GetTuple(id) returns a shared buffer, not safe with threads.
+        double x[3], pt[3];
+        oldDataArray->GetTuple( oldId, x );
         for ( i=0; i < nbOfIds; i++ )
         {
           vtkIdType existingId = idArray[i];
-          pt = dataArray->GetTuple( existingId );
+          dataArray->GetTuple( existingId, pt );
           if ( x[0] == pt[0] && x[1] == pt[1] && x[2] == pt[2] )
           {
             // point is already in the list, return 0 and set the id parameter
@@ -147,7 +148,8 @@ void vtkSMPMergePoints::Merge(vtkSMPMergePoints* locator,
 
   // points have to be added
   vtkIdType NumberOfInsertions = oldIdToMerge->GetNumberOfIds();
-  vtkIdType first_id = (this->AtomicInsertionId += NumberOfInsertions);
+  vtkIdType first_id =
+    (this->AtomicInsertionId += NumberOfInsertions) - NumberOfInsertions;
   bucket->Resize( bucket->GetNumberOfIds() + NumberOfInsertions );
   for ( i = 0; i < NumberOfInsertions; ++i )
   {
@@ -161,7 +163,9 @@ void vtkSMPMergePoints::Merge(vtkSMPMergePoints* locator,
     }
     else
     {
-      this->Points->SetPoint( newId, locator->Points->GetPoint( oldId ) );
+      double x[3];
+      locator->Points->GetPoint( oldId, x );
+      this->Points->SetPoint( newId, x );
     }
     outPd->SetTuple( newId, oldId, ptData );
   }
@@ -31,14 +31,14 @@
 #ifndef vtkSMPMergePoints_h
 #define vtkSMPMergePoints_h
 
-#include "vtkFiltersSMPModule.h" // For export macro
+#include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkMergePoints.h"
 #include "vtkIdList.h" // For inline functions
 #include "vtkAtomicTypes.h" // For the atomic integer used in Merge()
 
 class vtkPointData;
 
-class VTKFILTERSSMP_EXPORT vtkSMPMergePoints : public vtkMergePoints
+class VTKFILTERSCORE_EXPORT vtkSMPMergePoints : public vtkMergePoints
 {
 public:
   vtkTypeMacro(vtkSMPMergePoints, vtkMergePoints);
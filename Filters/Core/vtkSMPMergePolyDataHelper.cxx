@@ -312,7 +312,7 @@ void MergeCells(std::vector<vtkMergeCellsData>& data,
       vtkSMPTools::For(0,  cells->GetNumberOfCells(), cellCopier);
       //cellCopier.operator()(0, polys->GetNumberOfCells());
 
-      outCellsOffset += (*itr).Output->GetPolys()->GetNumberOfCells();
+      outCellsOffset += cells->GetNumberOfCells();
     }
   }
 }
@@ -399,7 +399,7 @@ vtkPolyData* vtkSMPMergePolyDataHelper::MergePolyData(std::vector<InputData>& in
     mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).LineOffsets, (*itr).Input->GetLines()));
     ++itr;
     }
-    MergeCells(mcData, idMaps, numLines, vertSize, outLines.GetPointer());
+    MergeCells(mcData, idMaps, numLines, numVerts, outLines.GetPointer());
 
     outPolyData->SetLines(outLines.GetPointer());
 
@@ -417,7 +417,8 @@ vtkPolyData* vtkSMPMergePolyDataHelper::MergePolyData(std::vector<InputData>& in
       mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).PolyOffsets, (*itr).Input->GetPolys()));
       ++itr;
     }
-    MergeCells(mcData, idMaps, numPolys, vertSize + lineSize, outPolys.GetPointer());
+    MergeCells(mcData, idMaps, numPolys, numVerts + numLines,
+               outPolys.GetPointer());
 
     outPolyData->SetPolys(outPolys.GetPointer());
   }
@@ -25,7 +25,7 @@
 #define vtkSMPMergePolyDataHelper_h
 
 #include "vtkConfigure.h"
-#include "vtkFiltersSMPModule.h"
+#include "vtkFiltersCoreModule.h"
 
 #include <vector>
 
@@ -33,7 +33,7 @@ class vtkPolyData;
 class vtkSMPMergePoints;
 class vtkIdList;
 
-class VTKFILTERSSMP_EXPORT vtkSMPMergePolyDataHelper
+class VTKFILTERSCORE_EXPORT vtkSMPMergePolyDataHelper
 {
 public:
 
@@ -14,18 +14,29 @@
 =========================================================================*/
 #include "vtkThreshold.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
 
 #include <algorithm>
+#include <atomic>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
@@ -105,17 +116,9 @@ int vtkThreshold::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, newCellId;
-  vtkIdList *cellPts, *pointMap;
-  vtkIdList *newCellPts;
-  vtkCell *cell;
   vtkPoints *newPoints;
-  int i, ptId, newId, numPts;
-  int numCellPts;
-  double x[3];
   vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
-  int keepCell;
 
   vtkDebugMacro(<< "Executing threshold filter");
 
@@ -138,9 +141,6 @@ int vtkThreshold::RequestData(
   outCD->CopyGlobalIdsOn();
   outCD->CopyAllocate(cd);
 
-  numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
-
   newPoints = vtkPoints::New();
 
   // set precision for the points in the output
@@ -165,6 +165,64 @@ int vtkThreshold::RequestData(
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+
+  // Polyhedra are written with their face streams, and blanked cells of
+  // structured and uniform grids are only hidden by GetCell(): only the
+  // serial version handles them.
+  vtkUnstructuredGrid *inputUG = vtkUnstructuredGrid::SafeDownCast(input);
+  if ((inputUG && inputUG->GetFaces()) ||
+      input->HasAnyBlankCells() || input->HasAnyBlankPoints())
+  {
+    this->ThresholdCells(input, inScalars, usePointScalars, newPoints, output);
+  }
+  else if (vtkPointSet::SafeDownCast(input) ||
+           vtkImageData::SafeDownCast(input) ||
+           vtkRectilinearGrid::SafeDownCast(input))
+  {
+    this->ThresholdCellsInParallel(input, inScalars, usePointScalars,
+                                   newPoints, output);
+  }
+  else
+  {
+    // The cell and point queries of other datasets may not be thread safe
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+    {
+      this->ThresholdCellsInParallel(input, inScalars, usePointScalars,
+                                     newPoints, output);
+    });
+  }
+
+  vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
+                << " number of cells.");
+
+  // now clean up / update ourselves
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  output->Squeeze();
+
+  return 1;
+}
+
+void vtkThreshold::ThresholdCells(vtkDataSet *input, vtkDataArray *inScalars,
+                                  bool usePointScalars, vtkPoints *newPoints,
+                                  vtkUnstructuredGrid *output)
+{
+  vtkIdType cellId, newCellId;
+  vtkIdList *cellPts, *pointMap;
+  vtkIdList *newCellPts;
+  vtkCell *cell;
+  int i, ptId, newId, numPts;
+  int numCellPts;
+  double x[3];
+  vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
+  vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
+
+  numPts = input->GetNumberOfPoints();
+  output->Allocate(input->GetNumberOfCells());
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); //maps old point ids into new
@@ -176,10 +234,6 @@ int vtkThreshold::RequestData(
 
   newCellPts = vtkIdList::New();
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
-
   // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
   {
@@ -187,40 +241,8 @@ int vtkThreshold::RequestData(
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
 
-    if ( usePointScalars )
-    {
-      if (this->AllScalars)
-      {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-        }
-      }
-      else
-      {
-        if(!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-        else
-        {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-        }
-      }
-    }
-    else //use cell scalars
-    {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-    }
-
-    if (  numCellPts > 0 && keepCell )
+    if ( numCellPts > 0 &&
+         this->KeepCell(inScalars, usePointScalars, cellId, cellPts) )
     {
       // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
       for (i=0; i < numCellPts; i++)
@@ -251,19 +273,320 @@ int vtkThreshold::RequestData(
     } // satisfied thresholding
   } // for all cells
 
-  vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
-                << " number of cells.");
-
-  // now clean up / update ourselves
   pointMap->Delete();
   newCellPts->Delete();
+}
 
-  output->SetPoints(newPoints);
-  newPoints->Delete();
+namespace
+{
 
-  output->Squeeze();
+// Copy the tuples outToIn[outId] of the arrays of inAttr to the tuples
+// outId of the arrays of outAttr, allocated with CopyAllocate(). The typed
+// copies of vtkArrayListTemplate are done in parallel. It pairs the arrays
+// by name and writes through raw pointers, other arrays are copied serially
+// with CopyData().
+void CopyTuples(vtkDataSetAttributes *inAttr, vtkDataSetAttributes *outAttr,
+                const std::vector<vtkIdType> &outToIn)
+{
+  vtkIdType numOut = static_cast<vtkIdType>(outToIn.size());
+  bool canPair = true;
+  for (int i = 0; canPair && i < outAttr->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array = outAttr->GetArray(i);
+    canPair = array && array->GetName() && array->HasStandardMemoryLayout();
+  }
 
-  return 1;
+  if (!canPair)
+  {
+    vtkNew<vtkIdList> fromIds;
+    vtkNew<vtkIdList> toIds;
+    fromIds->SetNumberOfIds(numOut);
+    toIds->SetNumberOfIds(numOut);
+    for (vtkIdType outId = 0; outId < numOut; ++outId)
+    {
+      fromIds->SetId(outId, outToIn[outId]);
+      toIds->SetId(outId, outId);
+    }
+    outAttr->CopyData(inAttr, fromIds.GetPointer(), toIds.GetPointer());
+    return;
+  }
+
+  ArrayList arrays;
+  arrays.AddArrays(numOut, inAttr, outAttr, 0.0, false);
+  vtkSMPTools::For(0, numOut, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType outId = begin; outId < end; ++outId)
+    {
+      arrays.Copy(outToIn[outId], outId);
+    }
+  });
+}
+
+// Write the types, locations and connectivity of the output cells.
+struct vtkThresholdWriteCells
+{
+  vtkDataSet *Input;
+  const vtkIdType *CellMap;    // output cell id -> input cell id
+  const vtkIdType *CellOffsets; // input cell id -> connectivity offset
+  const vtkIdType *PointMap;   // input point id -> output point id
+  unsigned char *Types;
+  vtkIdType *Locations;
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    for (vtkIdType newCellId = begin; newCellId < end; ++newCellId)
+    {
+      vtkIdType cellId = this->CellMap[newCellId];
+      vtkIdType offset = this->CellOffsets[cellId];
+      this->Input->GetCellPoints(cellId, cellPts);
+      this->Types[newCellId] =
+        static_cast<unsigned char>(this->Input->GetCellType(cellId));
+      this->Locations[newCellId] = offset + newCellId;
+      this->Offsets[newCellId] = offset;
+
+      vtkIdType numCellPts = cellPts->GetNumberOfIds();
+      const vtkIdType *pts = cellPts->GetPointer(0);
+      vtkIdType *conn = this->Connectivity + offset;
+      for (vtkIdType i = 0; i < numCellPts; ++i)
+      {
+        conn[i] = this->PointMap[pts[i]];
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+void WriteCells(vtkDataSet *input, const std::vector<vtkIdType> &cellMap,
+                const std::vector<vtkIdType> &cellOffsets,
+                const std::vector<vtkIdType> &pointMap,
+                vtkUnstructuredGrid *output)
+{
+  vtkIdType numNewCells = static_cast<vtkIdType>(cellMap.size());
+  vtkIdType connSize = cellOffsets.back();
+
+  vtkNew<vtkUnsignedCharArray> types;
+  vtkNew<vtkIdTypeArray> locations;
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> connectivity;
+  types->SetNumberOfValues(numNewCells);
+  locations->SetNumberOfValues(numNewCells);
+  offsets->SetNumberOfValues(numNewCells + 1);
+  offsets->SetValue(numNewCells, connSize);
+  connectivity->SetNumberOfValues(connSize);
+
+  vtkThresholdWriteCells writer;
+  writer.Input = input;
+  writer.CellMap = numNewCells ? &cellMap[0] : NULL;
+  writer.CellOffsets = &cellOffsets[0];
+  writer.PointMap = pointMap.empty() ? NULL : &pointMap[0];
+  writer.Types = types->GetPointer(0);
+  writer.Locations = locations->GetPointer(0);
+  writer.Offsets = offsets->GetPointer(0);
+  writer.Connectivity = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, numNewCells, writer);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets.GetPointer(), connectivity.GetPointer());
+  output->SetCells(types.GetPointer(), locations.GetPointer(),
+                   cells.GetPointer());
+}
+
+} // end anon namespace
+
+void vtkThreshold::ThresholdCellsInParallel(vtkDataSet *input,
+                                            vtkDataArray *inScalars,
+                                            bool usePointScalars,
+                                            vtkPoints *newPoints,
+                                            vtkUnstructuredGrid *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+
+  // Build the lazy structures of the input (e.g. the cells of polydata)
+  // before the threads query the cells.
+  vtkNew<vtkIdList> firstCellPts;
+  if (numCells > 0)
+  {
+    input->GetCellType(0);
+    input->GetCellPoints(0, firstCellPts.GetPointer());
+  }
+
+  // Classify the cells. cellOffsets holds the number of points of the kept
+  // cells (0 for the others) and newCellIds flags the kept cells.
+  std::vector<vtkIdType> cellOffsets(numCells + 1, 0);
+  std::vector<vtkIdType> newCellIds(numCells + 1, 0);
+  vtkSMPThreadLocalObject<vtkIdList> threadCellPts;
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = threadCellPts.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      input->GetCellPoints(cellId, cellPts);
+      vtkIdType numCellPts = cellPts->GetNumberOfIds();
+      if ( numCellPts > 0 &&
+           this->KeepCell(inScalars, usePointScalars, cellId, cellPts) )
+      {
+        cellOffsets[cellId] = numCellPts;
+        newCellIds[cellId] = 1;
+      }
+    }
+  });
+
+  // The prefix sums turn the sizes and flags into output offsets and ids
+  vtkIdType connSize = vtkSMPTools::ExclusiveScan(
+    cellOffsets.begin(), cellOffsets.begin() + numCells,
+    cellOffsets.begin(), vtkIdType(0));
+  cellOffsets[numCells] = connSize;
+  vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+    newCellIds.begin(), newCellIds.begin() + numCells, newCellIds.begin(),
+    vtkIdType(0));
+  newCellIds[numCells] = numNewCells;
+
+  // The points are numbered in the order of their first use by the kept
+  // cells, as in the serial path. The first use of a point is the smallest
+  // output connectivity index that refers to it (connSize when unused).
+  std::atomic<vtkIdType> *firstUses = new std::atomic<vtkIdType>[numPts];
+  vtkSMPTools::Fill(firstUses, firstUses + numPts, connSize);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = threadCellPts.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (newCellIds[cellId] == newCellIds[cellId + 1])
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, cellPts);
+      vtkIdType numCellPts = cellPts->GetNumberOfIds();
+      for (vtkIdType i = 0; i < numCellPts; ++i)
+      {
+        std::atomic<vtkIdType> &firstUse = firstUses[cellPts->GetId(i)];
+        vtkIdType use = cellOffsets[cellId] + i;
+        vtkIdType current = firstUse.load(std::memory_order_relaxed);
+        while (use < current &&
+               !firstUse.compare_exchange_weak(current, use,
+                                               std::memory_order_relaxed))
+        {
+        }
+      }
+    }
+  });
+
+  // A prefix sum over the connectivity indices that are first uses gives
+  // the output point ids.
+  std::vector<vtkIdType> newPointIds(connSize, 0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      vtkIdType firstUse = firstUses[ptId].load(std::memory_order_relaxed);
+      if (firstUse < connSize)
+      {
+        newPointIds[firstUse] = 1;
+      }
+    }
+  });
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    newPointIds.begin(), newPointIds.end(), newPointIds.begin(),
+    vtkIdType(0));
+  std::vector<vtkIdType> pointMap(numPts);
+  std::vector<vtkIdType> outToInPoints(numNewPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      vtkIdType firstUse = firstUses[ptId].load(std::memory_order_relaxed);
+      if (firstUse < connSize)
+      {
+        pointMap[ptId] = newPointIds[firstUse];
+        outToInPoints[pointMap[ptId]] = ptId;
+      }
+      else
+      {
+        pointMap[ptId] = -1;
+      }
+    }
+  });
+  delete [] firstUses;
+
+  // An input cell is kept when its id differs from the next one
+  std::vector<vtkIdType> cellMap(numNewCells);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (newCellIds[cellId] != newCellIds[cellId + 1])
+      {
+        cellMap[newCellIds[cellId]] = cellId;
+      }
+    }
+  });
+
+  WriteCells(input, cellMap, cellOffsets, pointMap, output);
+
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkSMPTools::For(0, numNewPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType newPtId = begin; newPtId < end; ++newPtId)
+    {
+      input->GetPoint(outToInPoints[newPtId], x);
+      newPoints->SetPoint(newPtId, x);
+    }
+  });
+
+  CopyTuples(input->GetPointData(), output->GetPointData(), outToInPoints);
+  CopyTuples(input->GetCellData(), output->GetCellData(), cellMap);
+}
+
+int vtkThreshold::KeepCell( vtkDataArray *scalars, bool usePointScalars,
+                            vtkIdType cellId, vtkIdList *cellPts )
+{
+  int keepCell;
+  int numCellPts = cellPts->GetNumberOfIds();
+
+  if ( usePointScalars )
+  {
+    if (this->AllScalars)
+    {
+      keepCell = 1;
+      for ( int i=0; keepCell && (i < numCellPts); i++)
+      {
+        keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+      }
+    }
+    else
+    {
+      if(!this->UseContinuousCellRange)
+      {
+        keepCell = 0;
+        for ( int i=0; (!keepCell) && (i < numCellPts); i++)
+        {
+          keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+        }
+      }
+      else
+      {
+        keepCell = this->EvaluateCell(scalars, cellPts, numCellPts);
+      }
+    }
+  }
+  else //use cell scalars
+  {
+    keepCell = this->EvaluateComponents( scalars, cellId );
+  }
+  return keepCell;
 }
 
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
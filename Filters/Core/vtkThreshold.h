@@ -30,6 +30,14 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * The filter is multithreaded with vtkSMPTools: the cells are classified
+ * in parallel, the output cell and point ids are computed with prefix sums,
+ * and the connectivity, points and attributes are then written in
+ * parallel. Inputs with polyhedron cells or blanking are processed
+ * serially. In both
+ * cases, the output points are in the order in which the output cells
+ * first use them.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
 */
@@ -51,6 +59,7 @@
 
 class vtkDataArray;
 class vtkIdList;
+class vtkPoints;
 
 class VTKFILTERSCORE_EXPORT vtkThreshold : public vtkUnstructuredGridAlgorithm
 {
@@ -210,8 +219,25 @@ protected:
                                ( s <= this->UpperThreshold ? 1 : 0 ) : 0 );};
 
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
+  int KeepCell( vtkDataArray *scalars, bool usePointScalars,
+                vtkIdType cellId, vtkIdList *cellPts );
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
+
+  //@{
+  /**
+   * Extract the cells of input that satisfy the criterion into output. The
+   * serial version supports all cell types, the parallel one all cell types
+   * but polyhedra.
+   */
+  void ThresholdCells(vtkDataSet *input, vtkDataArray *inScalars,
+                      bool usePointScalars, vtkPoints *newPoints,
+                      vtkUnstructuredGrid *output);
+  void ThresholdCellsInParallel(vtkDataSet *input, vtkDataArray *inScalars,
+                                bool usePointScalars, vtkPoints *newPoints,
+                                vtkUnstructuredGrid *output);
+  //@}
+
 private:
   vtkThreshold(const vtkThreshold&) VTK_DELETE_FUNCTION;
   void operator=(const vtkThreshold&) VTK_DELETE_FUNCTION;
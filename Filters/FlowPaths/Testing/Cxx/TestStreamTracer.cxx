@@ -23,6 +23,11 @@
 #include "vtkPointData.h"
 #include "vtkSmartPointer.h"
 #include "vtkDoubleArray.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkSMPTools.h"
+#include "vtkStructuredGrid.h"
+#include <algorithm>
 #include <cassert>
 
 int TestFieldNames(int, char*[])
@@ -104,9 +109,179 @@ int TestFieldNames(int, char*[])
   return EXIT_SUCCESS;
 }
 
+// Check that two outputs of the tracer are identical.
+static bool SameTraces(vtkPolyData* a, vtkPolyData* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfLines() != b->GetNumberOfLines() ||
+      a->GetPointData()->GetNumberOfArrays() !=
+      b->GetPointData()->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+  {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      return false;
+    }
+  }
+  vtkDataSetAttributes* attributes[2][2] = {
+    { a->GetPointData(), b->GetPointData() },
+    { a->GetCellData(), b->GetCellData() } };
+  for (int k = 0; k < 2; k++)
+  {
+    for (int i = 0; i < attributes[k][0]->GetNumberOfArrays(); i++)
+    {
+      vtkDataArray* arrayA = attributes[k][0]->GetArray(i);
+      vtkDataArray* arrayB =
+        attributes[k][1]->GetArray(arrayA->GetName());
+      if (!arrayB || arrayA->GetNumberOfTuples() != arrayB->GetNumberOfTuples())
+      {
+        return false;
+      }
+      for (vtkIdType t = 0; t < arrayA->GetNumberOfTuples(); t++)
+      {
+        for (int c = 0; c < arrayA->GetNumberOfComponents(); c++)
+        {
+          if (arrayA->GetComponent(t, c) != arrayB->GetComponent(t, c))
+          {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  vtkIdType nptsA, *ptsA, nptsB, *ptsB;
+  vtkCellArray* linesA = a->GetLines();
+  vtkCellArray* linesB = b->GetLines();
+  linesB->InitTraversal();
+  for (linesA->InitTraversal(); linesA->GetNextCell(nptsA, ptsA); )
+  {
+    linesB->GetNextCell(nptsB, ptsB);
+    if (nptsA != nptsB || !std::equal(ptsA, ptsA + nptsA, ptsB))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compare the parallel integration of seeds in the dataset with the serial
+// integration, which runs when the input has several blocks: the second
+// block, a copy of the dataset, is out of the reach of the streamlines.
+bool SameParallelTraces(vtkStreamTracer* tracer,
+                        vtkDataSet* input, vtkDataSet* farInput)
+{
+  vtkNew<vtkMultiBlockDataSet> blocks;
+  blocks->SetNumberOfBlocks(2);
+  blocks->SetBlock(0, input);
+  blocks->SetBlock(1, farInput);
+  tracer->SetInputData(blocks.GetPointer());
+  tracer->Update();
+  vtkNew<vtkPolyData> serial;
+  serial->DeepCopy(tracer->GetOutput());
+  if (serial->GetNumberOfLines() < 200 ||
+      !serial->GetPointData()->GetArray("Normals"))
+  {
+    return false;
+  }
+
+  tracer->SetInputData(input);
+  for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+  {
+    tracer->Modified();
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(numThreads),
+                            [&]() { tracer->Update(); });
+    if (!SameTraces(serial.GetPointer(), tracer->GetOutput()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A structured grid with the points and point data of the image.
+vtkSmartPointer<vtkStructuredGrid> ImageToGrid(vtkImageData* image)
+{
+  vtkSmartPointer<vtkStructuredGrid> grid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  grid->SetExtent(image->GetExtent());
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+  {
+    points->SetPoint(i, image->GetPoint(i));
+  }
+  grid->SetPoints(points.GetPointer());
+  grid->GetPointData()->ShallowCopy(image->GetPointData());
+  return grid;
+}
+
+int TestParallelSeeds(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-10,10,-10,10,-10,10);
+  vtkNew<vtkImageGradient> gradient;
+  gradient->SetDimensionality(3);
+  gradient->SetInputConnection(source->GetOutputPort());
+  gradient->Update();
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->DeepCopy(vtkImageData::SafeDownCast(gradient->GetOutputDataObject(0)));
+  image->GetPointData()->SetActiveVectors("RTDataGradient");
+
+  // Seeds on a grid, some of them out of the image
+  vtkNew<vtkPolyData> seeds;
+  vtkNew<vtkPoints> seedPoints;
+  for (int i = 0; i < 200; i++)
+  {
+    seedPoints->InsertNextPoint(-12 + (i % 10) * 2.5, -9 + (i / 10 % 10) * 2,
+                                -5 + (i / 100) * 10);
+  }
+  seeds->SetPoints(seedPoints.GetPointer());
+
+  vtkNew<vtkStreamTracer> tracer;
+  tracer->SetSourceData(seeds.GetPointer());
+  tracer->SetMaximumPropagation(30.0);
+  tracer->SetIntegrationDirectionToBoth();
+  tracer->SetIntegratorTypeToRungeKutta45();
+
+  vtkSmartPointer<vtkImageData> farImage = vtkSmartPointer<vtkImageData>::New();
+  farImage->DeepCopy(image);
+  farImage->SetOrigin(1000, 0, 0);
+  if (!SameParallelTraces(tracer.GetPointer(), image, farImage))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The threads share the cell locator of the grid. The serial reference
+  // builds another locator, which may choose another of the cells sharing
+  // a face, so the seeds are moved off the faces of the cells.
+  for (vtkIdType i = 0; i < seedPoints->GetNumberOfPoints(); i++)
+  {
+    double x[3];
+    seedPoints->GetPoint(i, x);
+    seedPoints->SetPoint(i, x[0] + 0.01, x[1] + 0.01, x[2] + 0.01);
+  }
+  seedPoints->Modified();
+  tracer->SetInterpolatorTypeToCellLocator();
+  if (!SameParallelTraces(tracer.GetPointer(),
+                          ImageToGrid(image), ImageToGrid(farImage)))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
 int TestStreamTracer(int n, char* a[])
 {
   int numFailures(0);
   numFailures += TestFieldNames(n,a);
+  numFailures += TestParallelSeeds(n,a);
   return numFailures;
 }
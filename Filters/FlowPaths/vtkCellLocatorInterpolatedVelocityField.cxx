@@ -226,9 +226,42 @@ void vtkCellLocatorInterpolatedVelocityField::AddDataSet( vtkDataSet * dataset )
     return;
   }
 
+  vtkSmartPointer< vtkAbstractCellLocator > locator;
+  locator.TakeReference( this->NewCellLocator( dataset ) );
+  if ( locator )
+  {
+    locator->SetLazyEvaluation( 1 );
+  }
+  this->AddDataSet( dataset, locator );
+}
+
+//----------------------------------------------------------------------------
+void vtkCellLocatorInterpolatedVelocityField::AddDataSet
+  ( vtkDataSet * dataset, vtkAbstractCellLocator * locator )
+{
+  if ( !dataset )
+  {
+    vtkErrorMacro( <<"Dataset NULL!" );
+    return;
+  }
+
   // insert the dataset (do NOT register the dataset to 'this')
   this->DataSets->push_back( dataset );
+  this->CellLocators->push_back( locator );
 
+  int  size = dataset->GetMaxCellSize();
+  if ( size > this->WeightsSize )
+  {
+    this->WeightsSize = size;
+    delete[] this->Weights;
+    this->Weights = new double[size];
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractCellLocator * vtkCellLocatorInterpolatedVelocityField::NewCellLocator
+  ( vtkDataSet * dataset )
+{
   // We need to attach a valid vtkAbstractCellLocator to any vtkPointSet for
   // robust cell location as vtkPointSet::FindCell() may incur failures. For
   // any non-vtkPointSet dataset, either vtkImageData or vtkRectilinearGrid,
@@ -237,31 +270,22 @@ void vtkCellLocatorInterpolatedVelocityField::AddDataSet( vtkDataSet * dataset )
   // enable proper access to those valid cell locators) since these two kinds
   // of datasets themselves are able to guarantee robust as well as fast cell
   // location via vtkImageData/vtkRectilinearGrid::FindCell().
-  vtkSmartPointer< vtkAbstractCellLocator > locator = 0; // MUST inited with 0
-  if (  dataset->IsA( "vtkPointSet" )  )
+  if (  !dataset || !dataset->IsA( "vtkPointSet" )  )
   {
-
-    if ( !this->CellLocatorPrototype )
-    {
-      locator = vtkSmartPointer < vtkModifiedBSPTree >::New();
-    }
-    else
-    {
-      locator.TakeReference( this->CellLocatorPrototype->NewInstance() );
-    }
-
-    locator->SetLazyEvaluation( 1 );
-    locator->SetDataSet( dataset );
+    return NULL;
   }
-  this->CellLocators->push_back( locator );
 
-  int  size = dataset->GetMaxCellSize();
-  if ( size > this->WeightsSize )
+  vtkAbstractCellLocator * locator;
+  if ( !this->CellLocatorPrototype )
   {
-    this->WeightsSize = size;
-    delete[] this->Weights;
-    this->Weights = new double[size];
+    locator = vtkModifiedBSPTree::New();
+  }
+  else
+  {
+    locator = this->CellLocatorPrototype->NewInstance();
   }
+  locator->SetDataSet( dataset );
+  return locator;
 }
 
 //----------------------------------------------------------------------------
@@ -102,6 +102,22 @@ public:
    */
   void AddDataSet( vtkDataSet * dataset ) VTK_OVERRIDE;
 
+  /**
+   * Add a dataset with the cell locator to use for it (NULL for a dataset
+   * that is not a vtkPointSet). A locator that is built and not lazily
+   * evaluated is only read during the evaluation, so it may be shared by
+   * the instances of several threads. THIS FUNCTION DOES NOT CHANGE THE
+   * REFERENCE COUNT OF dataset FOR THREAD SAFETY REASONS.
+   */
+  void AddDataSet( vtkDataSet * dataset, vtkAbstractCellLocator * locator );
+
+  /**
+   * Return a new cell locator for the dataset, an instance of the cell
+   * locator prototype or a vtkModifiedBSPTree, or NULL if the dataset is
+   * not a vtkPointSet. The caller has to delete the locator.
+   */
+  vtkAbstractCellLocator * NewCellLocator( vtkDataSet * dataset );
+
   /**
    * Evaluate the velocity field f at point (x, y, z).
    */
@@ -45,8 +45,11 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkObjectFactoryNewMacro(vtkStreamTracer)
@@ -116,6 +119,7 @@ vtkStreamTracer::vtkStreamTracer()
   this->LastUsedStepSize = 0.0;
 
   this->GenerateNormalsInIntegrate = true;
+  this->IntegratingInParallel = false;
 
   this->InterpolatorPrototype = 0;
 
@@ -514,12 +518,22 @@ int vtkStreamTracer::RequestData(
       double propagation = 0;
       vtkIdType numSteps = 0;
       double integrationTime = 0;
-      this->Integrate(input0->GetPointData(), output,
-                      seeds, seedIds,
-                      integrationDirections,
-                      lastPoint, func,
-                      maxCellSize, vecType,vecName,
-                      propagation, numSteps, integrationTime);
+      if (seedIds->GetNumberOfIds() > 1 && this->CanIntegrateInParallel(func))
+      {
+        this->IntegrateInParallel(input0, output,
+                                  seeds, seedIds,
+                                  integrationDirections, func,
+                                  maxCellSize, vecType, vecName);
+      }
+      else
+      {
+        this->Integrate(input0->GetPointData(), output,
+                        seeds, seedIds,
+                        integrationDirections,
+                        lastPoint, func,
+                        maxCellSize, vecType,vecName,
+                        propagation, numSteps, integrationTime);
+      }
     }
     func->Delete();
     seeds->Delete();
@@ -795,7 +809,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (!this->IntegratingInParallel)
+    {
+      this->UpdateProgress(progress);
+    }
 
     switch (integrationDirections->GetValue(currentLine))
     {
@@ -922,9 +939,12 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
 
       if ( numSteps++ % 1000 == 1 )
       {
-        progress =
-          ( currentLine + propagation / this->MaximumPropagation ) / numLines;
-        this->UpdateProgress(progress);
+        if (!this->IntegratingInParallel)
+        {
+          progress =
+            ( currentLine + propagation / this->MaximumPropagation ) / numLines;
+          this->UpdateProgress(progress);
+        }
 
         if (this->GetAbortExecute())
         {
@@ -957,7 +977,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
         }
         maxStep = stepSize.Interval;
       }
-      this->LastUsedStepSize = stepSize.Interval;
+      if (!this->IntegratingInParallel)
+      {
+        this->LastUsedStepSize = stepSize.Interval;
+      }
 
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1163,7 +1186,7 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
     {
       // Assign geometry and attributes
       output->SetLines(outputLines);
-      if (this->GenerateNormalsInIntegrate)
+      if (this->GenerateNormalsInIntegrate && !this->IntegratingInParallel)
       {
         this->GenerateNormals(output, 0, vecName);
       }
@@ -1202,6 +1225,251 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   return;
 }
 
+bool vtkStreamTracer::CanIntegrateInParallel(
+  vtkAbstractInterpolatedVelocityField* func)
+{
+  // The interpolators keep the last dataset in which they found a cell, so
+  // with several datasets a streamline could start in another dataset than
+  // in the serial integration.
+  if (!this->Integrator || !this->InputData)
+  {
+    return false;
+  }
+  if (!vtkInterpolatedVelocityField::SafeDownCast(func) &&
+      (this->SurfaceStreamlines ||
+       !vtkCellLocatorInterpolatedVelocityField::SafeDownCast(func)))
+  {
+    return false;
+  }
+  int numDataSets = 0;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(this->InputData->NewIterator());
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    if (vtkDataSet::SafeDownCast(iter->GetCurrentDataObject()))
+    {
+      numDataSets++;
+    }
+  }
+  return numDataSets == 1;
+}
+
+namespace
+{
+  // Concatenate the tuples of the arrays of the batches, in order, in a new
+  // array like the array of the first batch.
+  vtkAbstractArray* ConcatenateArrays(
+    std::vector<vtkAbstractArray*>& arrays, vtkIdType numTuples)
+  {
+    vtkAbstractArray* result = arrays[0]->NewInstance();
+    result->SetName(arrays[0]->GetName());
+    result->SetNumberOfComponents(arrays[0]->GetNumberOfComponents());
+    result->CopyComponentNames(arrays[0]);
+    result->SetNumberOfTuples(numTuples);
+    vtkIdType offset = 0;
+    for (size_t i = 0; i < arrays.size(); i++)
+    {
+      vtkIdType n = arrays[i]->GetNumberOfTuples();
+      if (n > 0)
+      {
+        result->InsertTuples(offset, n, 0, arrays[i]);
+      }
+      offset += n;
+    }
+    return result;
+  }
+}
+
+void vtkStreamTracer::IntegrateInParallel(vtkDataSet* input,
+                                          vtkPolyData* output,
+                                          vtkDataArray* seedSource,
+                                          vtkIdList* seedIds,
+                                          vtkIntArray* integrationDirections,
+                                          vtkAbstractInterpolatedVelocityField* func,
+                                          int maxCellSize,
+                                          int vecType,
+                                          const char *vecName)
+{
+  vtkIdType numSeeds = seedIds->GetNumberOfIds();
+
+  // The datasets build their locators, links and bounds on first use:
+  // build them now, before the threads search for cells.
+  vtkNew<vtkGenericCell> cell;
+  std::vector<double> weights(input->GetMaxCellSize() + 1);
+  double center[3], pcoords[3];
+  int subId;
+  input->GetCenter(center);
+  input->FindCell(center, NULL, cell.GetPointer(), -1, 0.0, subId, pcoords,
+                  &weights[0]);
+
+  // The interpolators of the threads share one cell locator, built here.
+  // Built and not lazily evaluated, it is only read while searching cells.
+  vtkCellLocatorInterpolatedVelocityField* locatorFunc =
+    vtkCellLocatorInterpolatedVelocityField::SafeDownCast(func);
+  vtkSmartPointer<vtkAbstractCellLocator> locator;
+  if (locatorFunc)
+  {
+    locator.TakeReference(locatorFunc->NewCellLocator(input));
+    if (locator)
+    {
+      locator->SetLazyEvaluation(0);
+      locator->BuildLocator();
+    }
+  }
+
+  // Each batch of seeds is integrated into its own output, by a thread
+  // with its own interpolator. Several batches per thread balance the
+  // load since the lengths of the streamlines vary.
+  vtkIdType batchSize = numSeeds /
+    (8 * static_cast<vtkIdType>(vtkSMPTools::GetEstimatedNumberOfThreads()));
+  batchSize = std::max(static_cast<vtkIdType>(1),
+                       std::min(batchSize, static_cast<vtkIdType>(256)));
+  vtkIdType numBatches = (numSeeds + batchSize - 1) / batchSize;
+  std::vector<vtkSmartPointer<vtkPolyData> > batches(numBatches);
+
+  vtkSMPThreadLocal<vtkSmartPointer<vtkAbstractInterpolatedVelocityField> >
+    localFuncs;
+  this->IntegratingInParallel = true;
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkSmartPointer<vtkAbstractInterpolatedVelocityField>& localFunc =
+      localFuncs.Local();
+    if (!localFunc)
+    {
+      localFunc.TakeReference(func->NewInstance());
+      localFunc->CopyParameters(func);
+      if (locatorFunc)
+      {
+        vtkCellLocatorInterpolatedVelocityField::SafeDownCast(localFunc)
+          ->AddDataSet(input, locator);
+      }
+      else
+      {
+        vtkCompositeInterpolatedVelocityField::SafeDownCast(localFunc)
+          ->AddDataSet(input);
+      }
+      localFunc->SelectVectors(vecType, vecName);
+    }
+    vtkNew<vtkIdList> batchIds;
+    vtkNew<vtkIntArray> batchDirections;
+    for (vtkIdType batch = begin; batch < end; batch++)
+    {
+      if (this->GetAbortExecute())
+      {
+        break;
+      }
+      vtkIdType first = batch * batchSize;
+      vtkIdType last = std::min(first + batchSize, numSeeds);
+      batchIds->SetNumberOfIds(last - first);
+      batchDirections->SetNumberOfValues(last - first);
+      for (vtkIdType i = first; i < last; i++)
+      {
+        batchIds->SetId(i - first, seedIds->GetId(i));
+        batchDirections->SetValue(i - first,
+                                  integrationDirections->GetValue(i));
+      }
+
+      batches[batch] = vtkSmartPointer<vtkPolyData>::New();
+      double lastPoint[3];
+      double propagation = 0;
+      vtkIdType numSteps = 0;
+      double integrationTime = 0;
+      this->Integrate(input->GetPointData(), batches[batch],
+                      seedSource, batchIds.GetPointer(),
+                      batchDirections.GetPointer(),
+                      lastPoint, localFunc,
+                      maxCellSize, vecType, vecName,
+                      propagation, numSteps, integrationTime);
+    }
+  });
+  this->IntegratingInParallel = false;
+
+  if (this->GetAbortExecute())
+  {
+    return;
+  }
+
+  // Concatenate the batches in the order of the seeds
+  vtkIdType numPts = 0;
+  for (vtkIdType batch = 0; batch < numBatches; batch++)
+  {
+    numPts += batches[batch]->GetNumberOfPoints();
+  }
+  vtkPointData* outputPD = output->GetPointData();
+  vtkPointData* firstPD = batches[0]->GetPointData();
+  outputPD->ShallowCopy(firstPD);
+  std::vector<vtkAbstractArray*> arrays(numBatches);
+  for (int i = 0; i < firstPD->GetNumberOfArrays(); i++)
+  {
+    for (vtkIdType batch = 0; batch < numBatches; batch++)
+    {
+      arrays[batch] = batches[batch]->GetPointData()->GetAbstractArray(i);
+    }
+    vtkAbstractArray* array = ConcatenateArrays(arrays, numPts);
+    outputPD->AddArray(array);
+    array->Delete();
+  }
+
+  vtkPoints* outputPoints = vtkPoints::New();
+  outputPoints->SetDataType(batches[0]->GetPoints()->GetDataType());
+  for (vtkIdType batch = 0; batch < numBatches; batch++)
+  {
+    arrays[batch] = batches[batch]->GetPoints()->GetData();
+  }
+  vtkAbstractArray* pointsData = ConcatenateArrays(arrays, numPts);
+  outputPoints->SetData(vtkDataArray::SafeDownCast(pointsData));
+  pointsData->Delete();
+  output->SetPoints(outputPoints);
+  outputPoints->Delete();
+
+  if (numPts > 1)
+  {
+    vtkCellArray* outputLines = vtkCellArray::New();
+    vtkIntArray* retVals = vtkIntArray::New();
+    retVals->SetName("ReasonForTermination");
+    vtkIntArray* sids = vtkIntArray::New();
+    sids->SetName("SeedIds");
+
+    vtkIdType offset = 0;
+    for (vtkIdType batch = 0; batch < numBatches; batch++)
+    {
+      vtkPolyData* batchOutput = batches[batch];
+      vtkCellArray* lines = batchOutput->GetLines();
+      vtkIdType npts, *pts;
+      for (lines->InitTraversal(); lines->GetNextCell(npts, pts); )
+      {
+        outputLines->InsertNextCell(npts);
+        for (vtkIdType i = 0; i < npts; i++)
+        {
+          outputLines->InsertCellPoint(pts[i] + offset);
+        }
+      }
+      vtkCellData* batchCD = batchOutput->GetCellData();
+      vtkDataArray* batchRetVals = batchCD->GetArray("ReasonForTermination");
+      vtkDataArray* batchSids = batchCD->GetArray("SeedIds");
+      for (vtkIdType i = 0; i < lines->GetNumberOfCells(); i++)
+      {
+        retVals->InsertNextValue(static_cast<int>(batchRetVals->GetTuple1(i)));
+        sids->InsertNextValue(static_cast<int>(batchSids->GetTuple1(i)));
+      }
+      offset += batchOutput->GetNumberOfPoints();
+    }
+
+    output->SetLines(outputLines);
+    outputLines->Delete();
+    if (this->GenerateNormalsInIntegrate)
+    {
+      this->GenerateNormals(output, 0, vecName);
+    }
+    output->GetCellData()->AddArray(retVals);
+    output->GetCellData()->AddArray(sids);
+    retVals->Delete();
+    sids->Delete();
+  }
+
+  output->Squeeze();
+}
+
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal,
                                       const char *vecName)
 {
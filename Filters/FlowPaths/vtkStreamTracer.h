@@ -69,6 +69,13 @@
  * a source object, traces will be generated from each point in the source
  * that is inside the dataset.
  *
+ * When the input is a single dataset and the velocity field is interpolated
+ * with vtkInterpolatedVelocityField or vtkCellLocatorInterpolatedVelocityField,
+ * the seeds are integrated in parallel with vtkSMPTools. Each thread uses
+ * its own copy of the interpolator, and the streamlines are concatenated
+ * in the order of the seeds, so the output is the same as the serial one.
+ * The progress is not reported during the parallel integration.
+ *
  * @sa
  * vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver
  * vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkTemporalStreamTracer
@@ -383,6 +390,16 @@ protected:
                  double& propagation,
                  vtkIdType& numSteps,
                  double& integrationTime);
+  void IntegrateInParallel(vtkDataSet *input,
+                           vtkPolyData *output,
+                           vtkDataArray *seedSource,
+                           vtkIdList *seedIds,
+                           vtkIntArray *integrationDirections,
+                           vtkAbstractInterpolatedVelocityField *func,
+                           int maxCellSize,
+                           int vecType,
+                           const char *vecName);
+  bool CanIntegrateInParallel(vtkAbstractInterpolatedVelocityField *func);
   double SimpleIntegrate(double seed[3],
                          double lastPoint[3],
                          double stepSize,
@@ -393,6 +410,10 @@ protected:
 
   bool GenerateNormalsInIntegrate;
 
+  // Set while the seeds are integrated by several threads: Integrate()
+  // does not report the progress nor generate the normals then.
+  bool IntegratingInParallel;
+
   // starting from global x-y-z position
   double StartPosition[3];
 
@@ -74,6 +74,10 @@ protected:
   vtkQuantizePolyDataPoints();
   ~vtkQuantizePolyDataPoints() VTK_OVERRIDE {}
 
+  // Quantization only reads QFactor: it can run in parallel.
+  bool CanOperateOnPointsInParallel() VTK_OVERRIDE
+    { return true; }
+
   double QFactor;
 private:
   vtkQuantizePolyDataPoints(const vtkQuantizePolyDataPoints&) VTK_DELETE_FUNCTION;
@@ -0,0 +1,266 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the parallel surface extraction of unstructured grids made of
+// linear cells: the number of faces, the original cell and point ids, and
+// that the output is the one of the serial path whatever the number of
+// threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestCheck.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+
+// Always extracts the surface with the serial, hash based path.
+class vtkSerialSurfaceFilter : public vtkDataSetSurfaceFilter
+{
+public:
+  static vtkSerialSurfaceFilter *New();
+  vtkTypeMacro(vtkSerialSurfaceFilter, vtkDataSetSurfaceFilter);
+
+protected:
+  int UnstructuredGridExecuteInParallel(vtkUnstructuredGrid *,
+                                        vtkPolyData *) VTK_OVERRIDE
+  {
+    return 0;
+  }
+};
+vtkStandardNewMacro(vtkSerialSurfaceFilter);
+
+namespace
+{
+
+// A block of n x n x n hexahedra, a vertex and a line. When mixed, every
+// third hexahedron is split in five tetras and every fifth in two wedges,
+// whose faces do not match the faces of their neighbors.
+void MakeGrid(int n, bool mixed, vtkUnstructuredGrid *grid)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkIntArray> pointIds;
+  pointIds->SetName("PointIds");
+  for (int k = 0; k <= n; ++k)
+  {
+    for (int j = 0; j <= n; ++j)
+    {
+      for (int i = 0; i <= n; ++i)
+      {
+        pointIds->InsertNextValue(
+          static_cast<int>(points->InsertNextPoint(i, j, k)));
+      }
+    }
+  }
+  grid->SetPoints(points.GetPointer());
+  grid->GetPointData()->AddArray(pointIds.GetPointer());
+  grid->Allocate(5 * n * n * n);
+
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        vtkIdType p = (k * (n + 1) + j) * (n + 1) + i;
+        vtkIdType dj = n + 1;
+        vtkIdType dk = (n + 1) * (n + 1);
+        vtkIdType h[8] = { p, p + 1, p + dj + 1, p + dj,
+                           p + dk, p + dk + 1, p + dk + dj + 1, p + dk + dj };
+        int index = (k * n + j) * n + i;
+        if (mixed && index % 3 == 0)
+        {
+          vtkIdType tets[5][4] = { { h[0], h[1], h[3], h[4] },
+                                   { h[1], h[2], h[3], h[6] },
+                                   { h[1], h[4], h[5], h[6] },
+                                   { h[3], h[6], h[7], h[4] },
+                                   { h[1], h[3], h[4], h[6] } };
+          for (int t = 0; t < 5; ++t)
+          {
+            grid->InsertNextCell(VTK_TETRA, 4, tets[t]);
+          }
+        }
+        else if (mixed && index % 5 == 0)
+        {
+          vtkIdType wedges[2][6] = { { h[0], h[1], h[2], h[4], h[5], h[6] },
+                                     { h[0], h[2], h[3], h[4], h[6], h[7] } };
+          grid->InsertNextCell(VTK_WEDGE, 6, wedges[0]);
+          grid->InsertNextCell(VTK_WEDGE, 6, wedges[1]);
+        }
+        else
+        {
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, h);
+        }
+      }
+    }
+  }
+  vtkIdType vertex = 0;
+  vtkIdType line[2] = { 1, 2 };
+  grid->InsertNextCell(VTK_VERTEX, 1, &vertex);
+  grid->InsertNextCell(VTK_LINE, 2, line);
+
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+  }
+  grid->GetCellData()->AddArray(cellIds.GetPointer());
+}
+
+// Check that the points of the output cells are points of the cells they
+// come from, and that the attributes follow the points and the cells.
+int CheckSurface(vtkUnstructuredGrid *grid, vtkPolyData *surface)
+{
+  vtkDataArray *originalCellIds =
+    surface->GetCellData()->GetArray("vtkOriginalCellIds");
+  vtkDataArray *originalPointIds =
+    surface->GetPointData()->GetArray("vtkOriginalPointIds");
+  vtkDataArray *cellIds = surface->GetCellData()->GetArray("CellIds");
+  vtkDataArray *pointIds = surface->GetPointData()->GetArray("PointIds");
+  vtkTestCheckMacro(originalCellIds && originalPointIds && cellIds && pointIds);
+  vtkTestCheckMacro(originalCellIds->GetNumberOfTuples() ==
+    surface->GetNumberOfCells());
+  vtkTestCheckMacro(originalPointIds->GetNumberOfTuples() ==
+    surface->GetNumberOfPoints());
+
+  for (vtkIdType ptId = 0; ptId < surface->GetNumberOfPoints(); ++ptId)
+  {
+    vtkIdType inPtId =
+      static_cast<vtkIdType>(originalPointIds->GetTuple1(ptId));
+    vtkTestCheckMacro(pointIds->GetTuple1(ptId) == inPtId);
+    double x[3], y[3];
+    surface->GetPoint(ptId, x);
+    grid->GetPoint(inPtId, y);
+    vtkTestCheckMacro(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+  }
+
+  vtkNew<vtkIdList> cellPts;
+  vtkNew<vtkIdList> inCellPts;
+  for (vtkIdType cellId = 0; cellId < surface->GetNumberOfCells(); ++cellId)
+  {
+    vtkIdType inCellId =
+      static_cast<vtkIdType>(originalCellIds->GetTuple1(cellId));
+    vtkTestCheckMacro(cellIds->GetTuple1(cellId) == inCellId);
+    surface->GetCellPoints(cellId, cellPts.GetPointer());
+    grid->GetCellPoints(inCellId, inCellPts.GetPointer());
+    for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+    {
+      vtkIdType inPtId = static_cast<vtkIdType>(
+        originalPointIds->GetTuple1(cellPts->GetId(i)));
+      vtkTestCheckMacro(inCellPts->IsId(inPtId) >= 0);
+    }
+  }
+  return 0;
+}
+
+// Check that two outputs are identical.
+int SameOutput(vtkPolyData *a, vtkPolyData *b)
+{
+  vtkTestCheckMacro(a->GetNumberOfPoints() == b->GetNumberOfPoints());
+  vtkTestCheckMacro(a->GetNumberOfVerts() == b->GetNumberOfVerts());
+  vtkTestCheckMacro(a->GetNumberOfLines() == b->GetNumberOfLines());
+  vtkTestCheckMacro(a->GetNumberOfPolys() == b->GetNumberOfPolys());
+  vtkDataArray *pointIdsA = a->GetPointData()->GetArray("PointIds");
+  vtkDataArray *pointIdsB = b->GetPointData()->GetArray("PointIds");
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    vtkTestCheckMacro(pointIdsA->GetTuple1(ptId) == pointIdsB->GetTuple1(ptId));
+  }
+  vtkDataArray *cellIdsA = a->GetCellData()->GetArray("CellIds");
+  vtkDataArray *cellIdsB = b->GetCellData()->GetArray("CellIds");
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    vtkTestCheckMacro(cellIdsA->GetTuple1(cellId) ==
+      cellIdsB->GetTuple1(cellId));
+    a->GetCellPoints(cellId, ptsA.GetPointer());
+    b->GetCellPoints(cellId, ptsB.GetPointer());
+    vtkTestCheckMacro(ptsA->GetNumberOfIds() == ptsB->GetNumberOfIds());
+    for (vtkIdType i = 0; i < ptsA->GetNumberOfIds(); ++i)
+    {
+      vtkTestCheckMacro(ptsA->GetId(i) == ptsB->GetId(i));
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestDataSetSurfaceFilterParallel(int, char*[])
+{
+  // Let the local scopes below use 4 threads whatever the machine
+  vtkSMPTools::Initialize(4);
+  const int n = 12;
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(n, false, grid.GetPointer());
+
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(grid.GetPointer());
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { surface->Update(); });
+
+  // The boundary points and faces of the block
+  vtkPolyData *output = surface->GetOutput();
+  vtkTestCheckMacro(output->GetNumberOfPoints() == 6 * n * n + 2);
+  vtkTestCheckMacro(output->GetNumberOfVerts() == 1);
+  vtkTestCheckMacro(output->GetNumberOfLines() == 1);
+  vtkTestCheckMacro(output->GetNumberOfPolys() == 6 * n * n);
+  vtkTestCheckMacro(output->GetPolys()->GetMaxCellSize() == 4);
+  vtkTestCheckMacro(CheckSurface(grid.GetPointer(), output) == 0);
+
+  // Same cells, in the same order and with the same point ids, as the
+  // serial path
+  vtkNew<vtkSerialSurfaceFilter> serialSurface;
+  serialSurface->SetInputData(grid.GetPointer());
+  serialSurface->PassThroughCellIdsOn();
+  serialSurface->PassThroughPointIdsOn();
+  serialSurface->Update();
+  vtkPolyData *serial = serialSurface->GetOutput();
+  vtkTestCheckMacro(SameOutput(serial, output) == 0);
+
+  // Mixed cells
+  MakeGrid(n, true, grid.GetPointer());
+  serialSurface->Modified();
+  serialSurface->Update();
+  vtkTestCheckMacro(serial->GetNumberOfPolys() > 6 * n * n);
+  vtkTestCheckMacro(CheckSurface(grid.GetPointer(), serial) == 0);
+
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]() { surface->Update(); });
+  vtkTestCheckMacro(SameOutput(serial, surface->GetOutput()) == 0);
+
+  surface->Modified();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { surface->Update(); });
+  vtkTestCheckMacro(SameOutput(serial, surface->GetOutput()) == 0);
+
+  // The output does not depend on the storage of the cells
+  grid->GetCells()->UseOffsetsStorage();
+  grid->Modified();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { surface->Update(); });
+  vtkTestCheckMacro(SameOutput(serial, surface->GetOutput()) == 0);
+
+  return 0;
+}
@@ -46,7 +46,12 @@
 #include "vtkWedge.h"
 #include "vtkStructuredData.h"
 
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
 #include <algorithm>
+#include <atomic>
+#include <vector>
 #include <vtksys/hash_map.hxx>
 
 #include <cassert>
@@ -100,6 +105,284 @@ protected:
   MapType Map;
 };
 
+namespace
+{
+
+// The faces of the 3D cells handled by the parallel path, in the order in
+// which UnstructuredGridExecute inserts them in the hash.
+struct vtkDataSetSurfaceFaceTable
+{
+  int NumberOfFaces;
+  int Sizes[8];
+  int Ids[8][6];
+};
+
+const vtkDataSetSurfaceFaceTable vtkDataSetSurfaceTetraFaces =
+  { 4, { 3, 3, 3, 3 },
+    { {0,1,3}, {0,2,1}, {0,3,2}, {1,2,3} } };
+const vtkDataSetSurfaceFaceTable vtkDataSetSurfaceHexahedronFaces =
+  { 6, { 4, 4, 4, 4, 4, 4 },
+    { {0,1,5,4}, {0,3,2,1}, {0,4,7,3}, {1,2,6,5}, {2,3,7,6}, {4,5,6,7} } };
+const vtkDataSetSurfaceFaceTable vtkDataSetSurfaceVoxelFaces =
+  { 6, { 4, 4, 4, 4, 4, 4 },
+    { {0,1,5,4}, {0,2,3,1}, {0,4,6,2}, {1,3,7,5}, {2,6,7,3}, {4,5,7,6} } };
+const vtkDataSetSurfaceFaceTable vtkDataSetSurfaceWedgeFaces =
+  { 5, { 3, 3, 4, 4, 4 },
+    { {0,1,2}, {3,5,4}, {0,3,4,1}, {1,4,5,2}, {2,5,3,0} } };
+const vtkDataSetSurfaceFaceTable vtkDataSetSurfacePyramidFaces =
+  { 5, { 4, 3, 3, 3, 3 },
+    { {0,3,2,1}, {0,1,4}, {1,2,4}, {2,3,4}, {3,0,4} } };
+const vtkDataSetSurfaceFaceTable vtkDataSetSurfacePentagonalPrismFaces =
+  { 7, { 4, 4, 4, 4, 4, 5, 5 },
+    { {0,1,6,5}, {1,2,7,6}, {2,3,8,7}, {3,4,9,8}, {4,0,5,9},
+      {0,1,2,3,4}, {5,6,7,8,9} } };
+const vtkDataSetSurfaceFaceTable vtkDataSetSurfaceHexagonalPrismFaces =
+  { 8, { 4, 4, 4, 4, 4, 4, 6, 6 },
+    { {0,1,7,6}, {1,2,8,7}, {2,3,9,8}, {3,4,10,9}, {4,5,11,10}, {5,0,6,11},
+      {0,1,2,3,4,5}, {6,7,8,9,10,11} } };
+
+// Groups of the output cells, in the order of the output: verts, lines and
+// 2D cells, then the faces of the 3D cells.
+enum
+{
+  vtkDataSetSurfaceVerts = 0,
+  vtkDataSetSurfaceLines = 1,
+  vtkDataSetSurfacePolys = 2,
+  vtkDataSetSurface3D = 3,
+  vtkDataSetSurfaceIgnored = 4,
+  vtkDataSetSurfaceUnsupported = -1
+};
+
+int vtkDataSetSurfaceGetGroup(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_EMPTY_CELL:
+      return vtkDataSetSurfaceIgnored;
+    case VTK_VERTEX:
+    case VTK_POLY_VERTEX:
+      return vtkDataSetSurfaceVerts;
+    case VTK_LINE:
+    case VTK_POLY_LINE:
+      return vtkDataSetSurfaceLines;
+    case VTK_TRIANGLE:
+    case VTK_QUAD:
+    case VTK_PIXEL:
+    case VTK_POLYGON:
+    case VTK_TRIANGLE_STRIP:
+      return vtkDataSetSurfacePolys;
+    case VTK_TETRA:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+      return vtkDataSetSurface3D;
+    default:
+      return vtkDataSetSurfaceUnsupported;
+  }
+}
+
+const vtkDataSetSurfaceFaceTable *vtkDataSetSurfaceGetFaces(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      return &vtkDataSetSurfaceTetraFaces;
+    case VTK_HEXAHEDRON:
+      return &vtkDataSetSurfaceHexahedronFaces;
+    case VTK_VOXEL:
+      return &vtkDataSetSurfaceVoxelFaces;
+    case VTK_WEDGE:
+      return &vtkDataSetSurfaceWedgeFaces;
+    case VTK_PYRAMID:
+      return &vtkDataSetSurfacePyramidFaces;
+    case VTK_PENTAGONAL_PRISM:
+      return &vtkDataSetSurfacePentagonalPrismFaces;
+    default:
+      return &vtkDataSetSurfaceHexagonalPrismFaces;
+  }
+}
+
+// A face of a 3D cell, with its points ordered as in the hash: the
+// smallest id first, in the orientation of the cell.
+struct vtkDataSetSurfaceFace
+{
+  vtkIdType CellId;
+  int FaceId;
+  int NumberOfPoints;
+  vtkIdType Points[6];
+
+  void Initialize(vtkIdType cellId, int faceId, int npts,
+                  const vtkIdType *pts)
+  {
+    this->CellId = cellId;
+    this->FaceId = faceId;
+    this->NumberOfPoints = npts;
+    // Same reordering as InsertTriInHash, InsertQuadInHash and
+    // InsertPolygonInHash.
+    int offset = 0;
+    if (npts == 3)
+    {
+      offset = (pts[1] < pts[0] && pts[1] < pts[2]) ? 1 :
+               (pts[2] < pts[0] && pts[2] < pts[1]) ? 2 : 0;
+    }
+    else if (npts == 4)
+    {
+      offset = (pts[1] < pts[0] && pts[1] < pts[2] && pts[1] < pts[3]) ? 1 :
+               (pts[2] < pts[0] && pts[2] < pts[1] && pts[2] < pts[3]) ? 2 :
+               (pts[3] < pts[0] && pts[3] < pts[1] && pts[3] < pts[2]) ? 3 : 0;
+    }
+    else
+    {
+      for (int i = 1; i < npts; ++i)
+      {
+        if (pts[i] < pts[offset])
+        {
+          offset = i;
+        }
+      }
+    }
+    for (int i = 0; i < npts; ++i)
+    {
+      this->Points[i] = pts[(offset + i) % npts];
+    }
+  }
+
+  // The points in an order that does not depend on the orientation, so
+  // that two faces match in the hash iff they have the same key.
+  void GetKey(vtkIdType key[6]) const
+  {
+    const vtkIdType *pts = this->Points;
+    int npts = this->NumberOfPoints;
+    key[0] = pts[0];
+    if (npts == 4)
+    {
+      key[1] = pts[2];
+      key[2] = std::min(pts[1], pts[3]);
+      key[3] = std::max(pts[1], pts[3]);
+    }
+    else if (pts[1] <= pts[npts - 1])
+    {
+      std::copy(pts + 1, pts + npts, key + 1);
+    }
+    else
+    {
+      std::reverse_copy(pts + 1, pts + npts, key + 1);
+    }
+  }
+
+  static int CompareKeys(const vtkDataSetSurfaceFace &a,
+                         const vtkDataSetSurfaceFace &b)
+  {
+    if (a.Points[0] != b.Points[0])
+    {
+      return a.Points[0] < b.Points[0] ? -1 : 1;
+    }
+    if (a.NumberOfPoints != b.NumberOfPoints)
+    {
+      return a.NumberOfPoints < b.NumberOfPoints ? -1 : 1;
+    }
+    vtkIdType keyA[6], keyB[6];
+    a.GetKey(keyA);
+    b.GetKey(keyB);
+    for (int i = 1; i < a.NumberOfPoints; ++i)
+    {
+      if (keyA[i] != keyB[i])
+      {
+        return keyA[i] < keyB[i] ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+};
+
+// Sorts the faces so that matching faces are adjacent.
+struct vtkDataSetSurfaceCompareKeys
+{
+  bool operator()(const vtkDataSetSurfaceFace &a,
+                  const vtkDataSetSurfaceFace &b) const
+  {
+    int c = vtkDataSetSurfaceFace::CompareKeys(a, b);
+    return c < 0 ||
+      (c == 0 && (a.CellId < b.CellId ||
+                  (a.CellId == b.CellId && a.FaceId < b.FaceId)));
+  }
+};
+
+// Sorts the faces in the order of the traversal of the hash.
+struct vtkDataSetSurfaceCompareHashOrder
+{
+  bool operator()(const vtkDataSetSurfaceFace &a,
+                  const vtkDataSetSurfaceFace &b) const
+  {
+    return a.Points[0] < b.Points[0] ||
+      (a.Points[0] == b.Points[0] &&
+       (a.CellId < b.CellId ||
+        (a.CellId == b.CellId && a.FaceId < b.FaceId)));
+  }
+};
+
+// Counts of a block of cells: output cells, output connectivity and points
+// passed to GetOutputPointId for the verts, lines and 2D cells, and faces of
+// the 3D cells.
+struct vtkDataSetSurfaceBlock
+{
+  vtkIdType Cells[3];
+  vtkIdType Connectivity[3];
+  vtkIdType Emitted[3];
+  vtkIdType Faces;
+};
+
+// Number of output cells, connectivity size and emitted points of a cell
+// of the groups verts, lines or polys.
+void vtkDataSetSurfaceCountCell(int cellType, vtkIdType npts,
+                                vtkIdType &numCells, vtkIdType &connSize,
+                                vtkIdType &numEmitted)
+{
+  numCells = 1;
+  connSize = numEmitted = npts;
+  if (cellType == VTK_PIXEL)
+  {
+    connSize = numEmitted = 4;
+  }
+  else if (cellType == VTK_TRIANGLE_STRIP)
+  {
+    numCells = npts > 2 ? npts - 2 : 0;
+    connSize = 3 * numCells;
+    numEmitted = npts > 1 ? npts : 0;
+  }
+}
+
+// The points of a cell of the groups verts, lines or polys, in the order in
+// which the serial path passes them to GetOutputPointId.
+const vtkIdType *vtkDataSetSurfaceEmittedPoints(int cellType,
+                                                const vtkIdType *pts,
+                                                vtkIdType pixel[4])
+{
+  if (cellType != VTK_PIXEL)
+  {
+    return pts;
+  }
+  pixel[0] = pts[0];
+  pixel[1] = pts[1];
+  pixel[2] = pts[3];
+  pixel[3] = pts[2];
+  return pixel;
+}
+
+// Keeps the minimum of a value and the given one.
+void vtkDataSetSurfaceAtomicMin(std::atomic<vtkIdType> &value, vtkIdType v)
+{
+  vtkIdType current = value.load(std::memory_order_relaxed);
+  while (v < current && !value.compare_exchange_weak(current, v))
+  {
+  }
+}
+
+} // end anon namespace
+
 vtkStandardNewMacro(vtkDataSetSurfaceFilter);
 
 //----------------------------------------------------------------------------
@@ -1535,6 +1818,14 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   // Shallow copy field data not associated with points or cells
   outputFD->ShallowCopy(inputFD);
 
+  // Linear cells of an unstructured grid are processed in parallel
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (!handleSubdivision && grid &&
+      this->UnstructuredGridExecuteInParallel(grid, output))
+  {
+    return 1;
+  }
+
   // These are for the default case/
   vtkIdList *pts;
   vtkPoints *coords;
@@ -2180,6 +2471,469 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// The output is the same as the one of the serial path: the points are
+// numbered in the order of their first use by the verts, the lines, the 2D
+// cells and then the faces in the order of the traversal of the hash, i.e.
+// sorted by smallest point id and then by cell.
+int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInParallel(
+  vtkUnstructuredGrid *input, vtkPolyData *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+  const vtkIdType blockSize = 1024;
+  vtkIdType numBlocks = (numCells + blockSize - 1) / blockSize;
+
+  // Count the output of each block of cells, and check that all the cells
+  // are supported.
+  std::vector<vtkDataSetSurfaceBlock> blocks(numBlocks);
+  std::atomic<int> unsupported(0);
+  vtkSMPThreadLocalObject<vtkIdList> localPtIds;
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkIdList *ptIds = localPtIds.Local();
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkDataSetSurfaceBlock &counts = blocks[block];
+      std::fill(counts.Cells, counts.Cells + 3, 0);
+      std::fill(counts.Connectivity, counts.Connectivity + 3, 0);
+      std::fill(counts.Emitted, counts.Emitted + 3, 0);
+      counts.Faces = 0;
+      vtkIdType endCell = std::min(numCells, (block + 1) * blockSize);
+      for (vtkIdType cellId = block * blockSize; cellId < endCell; ++cellId)
+      {
+        int cellType = input->GetCellType(cellId);
+        int group = vtkDataSetSurfaceGetGroup(cellType);
+        if (group == vtkDataSetSurfaceUnsupported)
+        {
+          unsupported = 1;
+          return;
+        }
+        else if (group == vtkDataSetSurface3D)
+        {
+          counts.Faces += vtkDataSetSurfaceGetFaces(cellType)->NumberOfFaces;
+        }
+        else if (group != vtkDataSetSurfaceIgnored)
+        {
+          input->GetCellPoints(cellId, ptIds);
+          vtkIdType cells, connSize, emitted;
+          vtkDataSetSurfaceCountCell(cellType, ptIds->GetNumberOfIds(),
+                                     cells, connSize, emitted);
+          counts.Cells[group] += cells;
+          counts.Connectivity[group] += connSize;
+          counts.Emitted[group] += emitted;
+        }
+      }
+    }
+  });
+  if (unsupported)
+  {
+    return 0;
+  }
+
+  // Offsets of the blocks
+  vtkDataSetSurfaceBlock totals = {};
+  for (vtkIdType block = 0; block < numBlocks; ++block)
+  {
+    vtkDataSetSurfaceBlock counts = blocks[block];
+    blocks[block] = totals;
+    for (int group = 0; group < 3; ++group)
+    {
+      totals.Cells[group] += counts.Cells[group];
+      totals.Connectivity[group] += counts.Connectivity[group];
+      totals.Emitted[group] += counts.Emitted[group];
+    }
+    totals.Faces += counts.Faces;
+  }
+  this->UpdateProgress(0.1);
+
+  // Gather the faces of the 3D cells and find the ones that are not shared.
+  std::vector<vtkDataSetSurfaceFace> faces(totals.Faces);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkIdList *ptIds = localPtIds.Local();
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkDataSetSurfaceFace *face = faces.data() + blocks[block].Faces;
+      vtkIdType endCell = std::min(numCells, (block + 1) * blockSize);
+      for (vtkIdType cellId = block * blockSize; cellId < endCell; ++cellId)
+      {
+        int cellType = input->GetCellType(cellId);
+        if (vtkDataSetSurfaceGetGroup(cellType) != vtkDataSetSurface3D)
+        {
+          continue;
+        }
+        input->GetCellPoints(cellId, ptIds);
+        const vtkIdType *ids = ptIds->GetPointer(0);
+        const vtkDataSetSurfaceFaceTable *table =
+          vtkDataSetSurfaceGetFaces(cellType);
+        for (int faceId = 0; faceId < table->NumberOfFaces; ++faceId)
+        {
+          vtkIdType pts[6];
+          int npts = table->Sizes[faceId];
+          for (int i = 0; i < npts; ++i)
+          {
+            pts[i] = ids[table->Ids[faceId][i]];
+          }
+          (face++)->Initialize(cellId, faceId, npts, pts);
+        }
+      }
+    }
+  });
+  vtkSMPTools::Sort(faces.begin(), faces.end(),
+                    vtkDataSetSurfaceCompareKeys());
+  vtkIdType numFaces = static_cast<vtkIdType>(faces.size());
+  std::vector<vtkIdType> visible(numFaces + 1, 0);
+  vtkSMPTools::For(0, numFaces, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      visible[i] =
+        (i == 0 ||
+         vtkDataSetSurfaceFace::CompareKeys(faces[i - 1], faces[i]) != 0) &&
+        (i == numFaces - 1 ||
+         vtkDataSetSurfaceFace::CompareKeys(faces[i], faces[i + 1]) != 0);
+    }
+  });
+  vtkIdType numVisible = vtkSMPTools::ExclusiveScan(
+    visible.begin(), visible.end(), visible.begin(), vtkIdType(0));
+  std::vector<vtkDataSetSurfaceFace> surface(numVisible);
+  vtkSMPTools::For(0, numFaces, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (visible[i] != visible[i + 1])
+      {
+        surface[visible[i]] = faces[i];
+      }
+    }
+  });
+  std::vector<vtkDataSetSurfaceFace>().swap(faces);
+  std::vector<vtkIdType>().swap(visible);
+  vtkSMPTools::Sort(surface.begin(), surface.end(),
+                    vtkDataSetSurfaceCompareHashOrder());
+  this->UpdateProgress(0.4);
+
+  // Faces made of ghost points are skipped, after their points were used.
+  vtkUnsignedCharArray *ghosts = input->GetPointGhostArray();
+  std::vector<vtkIdType> faceEmitted(numVisible + 1);
+  std::vector<vtkIdType> faceCells(numVisible + 1);
+  std::vector<vtkIdType> faceConnectivity(numVisible + 1);
+  vtkSMPTools::For(0, numVisible, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkDataSetSurfaceFace &face = surface[i];
+      bool allGhosts = ghosts != NULL;
+      bool oneHidden = false;
+      for (int j = 0; ghosts && j < face.NumberOfPoints; ++j)
+      {
+        unsigned char val = ghosts->GetValue(face.Points[j]);
+        if (!(val & vtkDataSetAttributes::DUPLICATEPOINT))
+        {
+          allGhosts = false;
+        }
+        if (val & vtkDataSetAttributes::HIDDENPOINT)
+        {
+          oneHidden = true;
+        }
+      }
+      bool skip = allGhosts || oneHidden;
+      faceEmitted[i] = face.NumberOfPoints;
+      faceCells[i] = skip ? 0 : 1;
+      faceConnectivity[i] = skip ? 0 : face.NumberOfPoints;
+    }
+  });
+  vtkIdType faceEmittedSize = vtkSMPTools::ExclusiveScan(
+    faceEmitted.begin(), faceEmitted.end(), faceEmitted.begin(),
+    vtkIdType(0));
+  vtkIdType numFaceCells = vtkSMPTools::ExclusiveScan(
+    faceCells.begin(), faceCells.end(), faceCells.begin(), vtkIdType(0));
+  vtkIdType faceConnSize = vtkSMPTools::ExclusiveScan(
+    faceConnectivity.begin(), faceConnectivity.end(),
+    faceConnectivity.begin(), vtkIdType(0));
+
+  // Position of the first use of each point in the sequence of the points
+  // passed to GetOutputPointId by the serial path.
+  vtkIdType emittedBase[5];
+  emittedBase[0] = 0;
+  for (int group = 0; group < 3; ++group)
+  {
+    emittedBase[group + 1] = emittedBase[group] + totals.Emitted[group];
+  }
+  emittedBase[4] = emittedBase[3] + faceEmittedSize;
+  vtkIdType numEmitted = emittedBase[4];
+  std::atomic<vtkIdType> *firstUse = new std::atomic<vtkIdType>[numPts];
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      firstUse[ptId].store(numEmitted, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkIdList *ptIds = localPtIds.Local();
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType positions[3];
+      for (int group = 0; group < 3; ++group)
+      {
+        positions[group] = emittedBase[group] + blocks[block].Emitted[group];
+      }
+      vtkIdType endCell = std::min(numCells, (block + 1) * blockSize);
+      for (vtkIdType cellId = block * blockSize; cellId < endCell; ++cellId)
+      {
+        int cellType = input->GetCellType(cellId);
+        int group = vtkDataSetSurfaceGetGroup(cellType);
+        if (group >= vtkDataSetSurface3D)
+        {
+          continue;
+        }
+        input->GetCellPoints(cellId, ptIds);
+        vtkIdType cells, connSize, emitted, pixel[4];
+        vtkDataSetSurfaceCountCell(cellType, ptIds->GetNumberOfIds(),
+                                   cells, connSize, emitted);
+        const vtkIdType *pts = vtkDataSetSurfaceEmittedPoints(
+          cellType, ptIds->GetPointer(0), pixel);
+        for (vtkIdType i = 0; i < emitted; ++i)
+        {
+          vtkDataSetSurfaceAtomicMin(firstUse[pts[i]], positions[group]++);
+        }
+      }
+    }
+  });
+  vtkSMPTools::For(0, numVisible, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkDataSetSurfaceFace &face = surface[i];
+      for (int j = 0; j < face.NumberOfPoints; ++j)
+      {
+        vtkDataSetSurfaceAtomicMin(firstUse[face.Points[j]],
+                                   emittedBase[3] + faceEmitted[i] + j);
+      }
+    }
+  });
+
+  // The output ids are the ranks of the first uses
+  std::vector<vtkIdType> newIds(numEmitted + 1, 0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      if (firstUse[ptId] < numEmitted)
+      {
+        newIds[firstUse[ptId]] = 1;
+      }
+    }
+  });
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    newIds.begin(), newIds.end(), newIds.begin(), vtkIdType(0));
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  vtkNew<vtkIdList> inPtIds;
+  vtkNew<vtkIdList> outPtIds;
+  inPtIds->SetNumberOfIds(numNewPts);
+  outPtIds->SetNumberOfIds(numNewPts);
+  vtkIdType *pointSources = inPtIds->GetPointer(0);
+  vtkIdType *pointTargets = outPtIds->GetPointer(0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      if (firstUse[ptId] < numEmitted)
+      {
+        vtkIdType newId = newIds[firstUse[ptId]];
+        pointMap[ptId] = newId;
+        pointSources[newId] = ptId;
+        pointTargets[newId] = newId;
+      }
+    }
+  });
+  delete [] firstUse;
+  std::vector<vtkIdType>().swap(newIds);
+  this->UpdateProgress(0.6);
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(input->GetPoints()->GetData()->GetDataType());
+  newPts->InsertPoints(outPtIds.GetPointer(), inPtIds.GetPointer(),
+                       input->GetPoints());
+  vtkPointData *outputPD = output->GetPointData();
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(input->GetPointData(), numNewPts);
+  outputPD->CopyData(input->GetPointData(), inPtIds.GetPointer(),
+                     outPtIds.GetPointer());
+
+  // Output cells: verts, lines, then the 2D cells and the faces in the
+  // polys.
+  vtkIdType cellBase[3];
+  cellBase[0] = 0;
+  cellBase[1] = totals.Cells[0];
+  cellBase[2] = cellBase[1] + totals.Cells[1];
+  vtkIdType numNewCells = cellBase[2] + totals.Cells[2] + numFaceCells;
+  vtkNew<vtkIdTypeArray> offsets[3];
+  vtkNew<vtkIdTypeArray> connectivity[3];
+  vtkIdType *offsetsPtr[3], *connPtr[3];
+  for (int group = 0; group < 3; ++group)
+  {
+    vtkIdType groupCells = totals.Cells[group];
+    vtkIdType groupConnSize = totals.Connectivity[group];
+    if (group == vtkDataSetSurfacePolys)
+    {
+      groupCells += numFaceCells;
+      groupConnSize += faceConnSize;
+    }
+    offsets[group]->SetNumberOfValues(groupCells + 1);
+    offsets[group]->SetValue(groupCells, groupConnSize);
+    connectivity[group]->SetNumberOfValues(groupConnSize);
+    offsetsPtr[group] = offsets[group]->GetPointer(0);
+    connPtr[group] = connectivity[group]->GetPointer(0);
+  }
+  vtkNew<vtkIdList> inCellIds;
+  vtkNew<vtkIdList> outCellIds;
+  inCellIds->SetNumberOfIds(numNewCells);
+  outCellIds->SetNumberOfIds(numNewCells);
+  vtkIdType *cellSources = inCellIds->GetPointer(0);
+  vtkIdType *cellTargets = outCellIds->GetPointer(0);
+
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkIdList *ptIds = localPtIds.Local();
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType cellPos[3], connPos[3];
+      for (int group = 0; group < 3; ++group)
+      {
+        cellPos[group] = blocks[block].Cells[group];
+        connPos[group] = blocks[block].Connectivity[group];
+      }
+      vtkIdType endCell = std::min(numCells, (block + 1) * blockSize);
+      for (vtkIdType cellId = block * blockSize; cellId < endCell; ++cellId)
+      {
+        int cellType = input->GetCellType(cellId);
+        int group = vtkDataSetSurfaceGetGroup(cellType);
+        if (group >= vtkDataSetSurface3D)
+        {
+          continue;
+        }
+        input->GetCellPoints(cellId, ptIds);
+        vtkIdType npts = ptIds->GetNumberOfIds();
+        vtkIdType cells, connSize, emitted, pixel[4];
+        vtkDataSetSurfaceCountCell(cellType, npts, cells, connSize, emitted);
+        const vtkIdType *pts = vtkDataSetSurfaceEmittedPoints(
+          cellType, ptIds->GetPointer(0), pixel);
+        vtkIdType *conn = connPtr[group];
+        if (cellType == VTK_TRIANGLE_STRIP)
+        {
+          // Triangles of the strip, as in the serial path
+          vtkIdType triangle[3];
+          int toggle = 0;
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            triangle[i < 2 ? i : 2] = pointMap[pts[i]];
+            if (i >= 2)
+            {
+              offsetsPtr[group][cellPos[group]] = connPos[group];
+              cellSources[cellBase[group] + cellPos[group]] = cellId;
+              ++cellPos[group];
+              std::copy(triangle, triangle + 3, conn + connPos[group]);
+              connPos[group] += 3;
+              triangle[toggle] = triangle[2];
+              toggle = !toggle;
+            }
+          }
+        }
+        else
+        {
+          offsetsPtr[group][cellPos[group]] = connPos[group];
+          cellSources[cellBase[group] + cellPos[group]] = cellId;
+          ++cellPos[group];
+          for (vtkIdType i = 0; i < connSize; ++i)
+          {
+            conn[connPos[group]++] = pointMap[pts[i]];
+          }
+        }
+      }
+    }
+  });
+  vtkSMPTools::For(0, numVisible, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (faceCells[i] == faceCells[i + 1])
+      {
+        continue;
+      }
+      const vtkDataSetSurfaceFace &face = surface[i];
+      vtkIdType cellPos = totals.Cells[2] + faceCells[i];
+      vtkIdType connPos = totals.Connectivity[2] + faceConnectivity[i];
+      offsetsPtr[2][cellPos] = connPos;
+      cellSources[cellBase[2] + cellPos] = face.CellId;
+      for (int j = 0; j < face.NumberOfPoints; ++j)
+      {
+        connPtr[2][connPos + j] = pointMap[face.Points[j]];
+      }
+    }
+  });
+  vtkSMPTools::For(0, numNewCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      cellTargets[i] = i;
+    }
+  });
+  this->UpdateProgress(0.8);
+
+  vtkCellData *outputCD = output->GetCellData();
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(input->GetCellData(), numNewCells);
+  outputCD->CopyData(input->GetCellData(), inCellIds.GetPointer(),
+                     outCellIds.GetPointer());
+  if (this->PassThroughCellIds)
+  {
+    vtkNew<vtkIdTypeArray> originalCellIds;
+    originalCellIds->SetName(this->GetOriginalCellIdsName());
+    originalCellIds->SetNumberOfValues(numNewCells);
+    std::copy(cellSources, cellSources + numNewCells,
+              originalCellIds->GetPointer(0));
+    outputCD->AddArray(originalCellIds.GetPointer());
+  }
+  if (this->PassThroughPointIds)
+  {
+    vtkNew<vtkIdTypeArray> originalPointIds;
+    originalPointIds->SetName(this->GetOriginalPointIdsName());
+    originalPointIds->SetNumberOfValues(numNewPts);
+    std::copy(pointSources, pointSources + numNewPts,
+              originalPointIds->GetPointer(0));
+    outputPD->AddArray(originalPointIds.GetPointer());
+  }
+
+  output->SetPoints(newPts.GetPointer());
+  vtkCellArray *newCells[3];
+  for (int group = 0; group < 3; ++group)
+  {
+    newCells[group] = vtkCellArray::New();
+    newCells[group]->SetData(offsets[group].GetPointer(),
+                             connectivity[group].GetPointer());
+  }
+  output->SetPolys(newCells[vtkDataSetSurfacePolys]);
+  if (totals.Cells[vtkDataSetSurfaceVerts] > 0)
+  {
+    output->SetVerts(newCells[vtkDataSetSurfaceVerts]);
+  }
+  if (totals.Cells[vtkDataSetSurfaceLines] > 0)
+  {
+    output->SetLines(newCells[vtkDataSetSurfaceLines]);
+  }
+  for (int group = 0; group < 3; ++group)
+  {
+    newCells[group]->Delete();
+  }
+  output->Squeeze();
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
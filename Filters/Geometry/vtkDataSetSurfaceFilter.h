@@ -21,6 +21,10 @@
  * vtkGeometryFilter.  It only has one option: whether to use triangle strips
  * when the input type is structured.
  *
+ * The surface of unstructured grids made of linear cells is extracted in
+ * parallel with vtkSMPTools. The output is the same as the one of the
+ * serial path, which is used for the other cells.
+ *
  * @sa
  * vtkGeometryFilter vtkStructuredGridGeometryFilter.
 */
@@ -35,6 +39,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkIdTypeArray;
 class vtkStructuredGrid;
+class vtkUnstructuredGrid;
 
 // Helper structure for hashing faces.
 struct vtkFastGeomQuadStruct
@@ -209,6 +214,18 @@ protected:
                         int aAxis, int bAxis, int cAxis,
                         vtkIdType *wholeExt);
 
+  /**
+   * Extract the surface of an unstructured grid made of linear cells with
+   * vtkSMPTools: the faces of the 3D cells are gathered and sorted, the
+   * faces used by a single cell are found by comparing neighbors, and the
+   * output is written in parallel.
+   * The output is the same as the one of the hash based serial path.
+   * Return 0, without modifying the output, if the grid has cells that
+   * are not supported (polyhedra, nonlinear cells...).
+   */
+  virtual int UnstructuredGridExecuteInParallel(vtkUnstructuredGrid *input,
+                                        vtkPolyData *output);
+
   void InitializeQuadHash(vtkIdType numPoints);
   void DeleteQuadHash();
   virtual void InsertQuadInHash(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d,
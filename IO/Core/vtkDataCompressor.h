@@ -44,6 +44,13 @@ public:
    */
   virtual size_t GetMaximumCompressionSpace(size_t size)=0;
 
+  /**
+   * Return whether Compress() may be called concurrently from several
+   * threads, as vtkXMLWriter does to compress the blocks of an array.
+   * The default is false, in which case the calls are serialized.
+   */
+  virtual bool CanCompressConcurrently() { return false; }
+
   /**
    * Compress the given input data buffer into the given output
    * buffer.  The size of the output buffer must be at least as large
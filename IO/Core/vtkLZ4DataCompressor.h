@@ -37,6 +37,10 @@ public:
   // Compress method.
   size_t GetMaximumCompressionSpace(size_t size) VTK_OVERRIDE;
 
+  // Description:
+  // Compress() keeps no state, so it may be called concurrently.
+  bool CanCompressConcurrently() VTK_OVERRIDE { return true; }
+
   // Description:
   // Get/Set the compression level.
   vtkSetClampMacro(AccelerationLevel, int, 1, VTK_INT_MAX);
@@ -0,0 +1,333 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkZFPDataCompressor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkZFPDataCompressor.h"
+#include "vtkObjectFactory.h"
+#include "vtkZLibDataCompressor.h"
+#include "vtk_zfp.h"
+
+#include <cstring>
+#include <vector>
+
+vtkStandardNewMacro(vtkZFPDataCompressor);
+
+namespace
+{
+
+// The first byte of a compressed block tells how it was compressed.
+enum BlockMethod
+{
+  ZLIB_BLOCK = 0,
+  ZFP_BLOCK = 1
+};
+
+// Largest sizes that the zfp header can store for fields of 1, 2 and 3
+// dimensions.
+const size_t MaxFieldSize[3] =
+{
+  static_cast<size_t>(1) << 48,
+  static_cast<size_t>(1) << 24,
+  static_cast<size_t>(1) << 16
+};
+
+// Owns the zfp objects of one compression or decompression.
+struct ZFPStream
+{
+  std::vector<uint64> Buffer;
+  bitstream* Bits;
+  zfp_stream* Stream;
+  zfp_field* Field;
+
+  ZFPStream()
+    : Bits(NULL), Stream(zfp_stream_open(NULL)), Field(NULL)
+  {
+  }
+
+  ~ZFPStream()
+  {
+    if (this->Field)
+    {
+      zfp_field_free(this->Field);
+    }
+    zfp_stream_close(this->Stream);
+    if (this->Bits)
+    {
+      stream_close(this->Bits);
+    }
+  }
+
+  // Attach a word-aligned buffer of at least the given size to the stream.
+  void OpenBuffer(size_t bytes)
+  {
+    this->Buffer.resize((bytes + sizeof(uint64) - 1) / sizeof(uint64));
+    this->Bits = stream_open(&this->Buffer[0],
+                             this->Buffer.size() * sizeof(uint64));
+    zfp_stream_set_bit_stream(this->Stream, this->Bits);
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+vtkZFPDataCompressor::vtkZFPDataCompressor()
+{
+  this->Mode = REVERSIBLE;
+  this->Rate = 16.0;
+  this->Precision = 32;
+  this->Accuracy = 1e-6;
+  this->DataType = VTK_VOID;
+  this->Dimensions[0] = this->Dimensions[1] = this->Dimensions[2] = 0;
+  this->ZLibCompressor = vtkZLibDataCompressor::New();
+}
+
+//----------------------------------------------------------------------------
+vtkZFPDataCompressor::~vtkZFPDataCompressor()
+{
+  this->ZLibCompressor->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkZFPDataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Mode: " << this->Mode << endl;
+  os << indent << "Rate: " << this->Rate << endl;
+  os << indent << "Precision: " << this->Precision << endl;
+  os << indent << "Accuracy: " << this->Accuracy << endl;
+  os << indent << "DataType: " << this->DataType << endl;
+  os << indent << "Dimensions: " << this->Dimensions[0] << " "
+     << this->Dimensions[1] << " " << this->Dimensions[2] << endl;
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkZFPDataCompressor::CompressBuffer(unsigned char const* uncompressedData,
+                                     size_t uncompressedSize,
+                                     unsigned char* compressedData,
+                                     size_t compressionSpace)
+{
+  if (compressionSpace < 1)
+  {
+    vtkErrorMacro("Not enough space to compress data.");
+    return 0;
+  }
+
+  size_t cs = this->CompressZFP(uncompressedData, uncompressedSize,
+                                compressedData + 1, compressionSpace - 1);
+  if (cs)
+  {
+    compressedData[0] = ZFP_BLOCK;
+    return cs + 1;
+  }
+
+  // zfp does not apply, use zlib.
+  compressedData[0] = ZLIB_BLOCK;
+  cs = this->ZLibCompressor->Compress(uncompressedData, uncompressedSize,
+                                      compressedData + 1,
+                                      compressionSpace - 1);
+  return cs ? cs + 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkZFPDataCompressor::CompressZFP(unsigned char const* uncompressedData,
+                                  size_t uncompressedSize,
+                                  unsigned char* compressedData,
+                                  size_t compressionSpace)
+{
+  zfp_type type;
+  size_t wordSize;
+  if (this->DataType == VTK_FLOAT)
+  {
+    type = zfp_type_float;
+    wordSize = sizeof(float);
+  }
+  else if (this->DataType == VTK_DOUBLE)
+  {
+    type = zfp_type_double;
+    wordSize = sizeof(double);
+  }
+  else
+  {
+    return 0;
+  }
+  size_t numValues = uncompressedSize / wordSize;
+  if (this->Mode == REVERSIBLE || numValues == 0 ||
+      numValues * wordSize != uncompressedSize)
+  {
+    return 0;
+  }
+
+  // Lay the values out as whole slices or rows of the structured array
+  // when they are, ignoring the dimensions of size one.
+  size_t dims[3] = { 0, 0, 0 };
+  int numDims = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (this->Dimensions[i] > 1)
+    {
+      dims[numDims++] = static_cast<size_t>(this->Dimensions[i]);
+    }
+  }
+  size_t size[3] = { numValues, 0, 0 };
+  int fieldDims = 1;
+  if (numDims >= 1 && numValues % dims[0] == 0 && numValues > dims[0])
+  {
+    size[0] = dims[0];
+    size[1] = numValues / dims[0];
+    fieldDims = 2;
+    if (numDims >= 2 && size[1] % dims[1] == 0 && size[1] > dims[1])
+    {
+      size[1] = dims[1];
+      size[2] = numValues / (dims[0] * dims[1]);
+      fieldDims = 3;
+    }
+  }
+  for (int i = 0; i < fieldDims; ++i)
+  {
+    if (size[i] > MaxFieldSize[fieldDims - 1])
+    {
+      if (numValues > MaxFieldSize[0])
+      {
+        return 0;
+      }
+      size[0] = numValues;
+      fieldDims = 1;
+      break;
+    }
+  }
+
+  // zfp does not write to the data, but its fields are not const.
+  void* data = const_cast<unsigned char*>(uncompressedData);
+  ZFPStream out;
+  switch (fieldDims)
+  {
+    case 3:
+      out.Field = zfp_field_3d(data, type, static_cast<uint>(size[0]),
+                               static_cast<uint>(size[1]),
+                               static_cast<uint>(size[2]));
+      break;
+    case 2:
+      out.Field = zfp_field_2d(data, type, static_cast<uint>(size[0]),
+                               static_cast<uint>(size[1]));
+      break;
+    default:
+      out.Field = zfp_field_1d(data, type, static_cast<uint>(size[0]));
+      break;
+  }
+
+  switch (this->Mode)
+  {
+    case FIXED_RATE:
+      zfp_stream_set_rate(out.Stream, this->Rate, type, fieldDims, 0);
+      break;
+    case FIXED_PRECISION:
+      zfp_stream_set_precision(out.Stream, this->Precision, type);
+      break;
+    default:
+      zfp_stream_set_accuracy(out.Stream, this->Accuracy, type);
+      break;
+  }
+
+  out.OpenBuffer(zfp_stream_maximum_size(out.Stream, out.Field));
+  size_t cs = 0;
+  if (zfp_write_header(out.Stream, out.Field, ZFP_HEADER_FULL))
+  {
+    cs = zfp_compress(out.Stream, out.Field);
+  }
+
+  // Keep zfp only if it is smaller than the data.
+  if (cs == 0 || cs >= uncompressedSize || cs > compressionSpace)
+  {
+    return 0;
+  }
+  memcpy(compressedData, &out.Buffer[0], cs);
+  return cs;
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkZFPDataCompressor::UncompressBuffer(unsigned char const* compressedData,
+                                       size_t compressedSize,
+                                       unsigned char* uncompressedData,
+                                       size_t uncompressedSize)
+{
+  if (compressedSize < 1)
+  {
+    vtkErrorMacro("Compressed data is empty.");
+    return 0;
+  }
+  switch (compressedData[0])
+  {
+    case ZFP_BLOCK:
+      return this->UncompressZFP(compressedData + 1, compressedSize - 1,
+                                 uncompressedData, uncompressedSize);
+    case ZLIB_BLOCK:
+      return this->ZLibCompressor->Uncompress(compressedData + 1,
+                                              compressedSize - 1,
+                                              uncompressedData,
+                                              uncompressedSize);
+    default:
+      vtkErrorMacro("Unknown compression method " <<
+                    static_cast<int>(compressedData[0]) << ".");
+      return 0;
+  }
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkZFPDataCompressor::UncompressZFP(unsigned char const* compressedData,
+                                    size_t compressedSize,
+                                    unsigned char* uncompressedData,
+                                    size_t uncompressedSize)
+{
+  // zfp reads the stream a word at a time, so copy it to aligned memory.
+  ZFPStream in;
+  in.OpenBuffer(compressedSize);
+  memcpy(&in.Buffer[0], compressedData, compressedSize);
+  in.Field = zfp_field_alloc();
+  if (!zfp_read_header(in.Stream, in.Field, ZFP_HEADER_FULL))
+  {
+    vtkErrorMacro("zfp error while reading the header of compressed data.");
+    return 0;
+  }
+
+  // Make sure the output size matches that expected.
+  size_t us = zfp_field_size(in.Field, NULL) *
+    (zfp_field_type(in.Field) == zfp_type_float ? sizeof(float)
+                                                : sizeof(double));
+  if (us != uncompressedSize)
+  {
+    vtkErrorMacro("Decompression produced incorrect size.\n"
+                  "Expected " << uncompressedSize << " and got " << us);
+    return 0;
+  }
+
+  zfp_field_set_pointer(in.Field, uncompressedData);
+  if (!zfp_decompress(in.Stream, in.Field))
+  {
+    vtkErrorMacro("zfp error while uncompressing data.");
+    return 0;
+  }
+  return us;
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkZFPDataCompressor::GetMaximumCompressionSpace(size_t size)
+{
+  // Blocks that zfp does not make smaller are compressed with zlib.
+  return this->ZLibCompressor->GetMaximumCompressionSpace(size) + 1;
+}
@@ -0,0 +1,174 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkZFPDataCompressor.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkZFPDataCompressor
+ * @brief   Data compression of floating-point arrays using zfp.
+ *
+ * vtkZFPDataCompressor provides a concrete vtkDataCompressor class
+ * using zfp for compressing and uncompressing floating-point data.
+ * zfp is lossy in the fixed-rate, fixed-precision and fixed-accuracy
+ * modes, which bound respectively the number of bits stored per value,
+ * the number of bit planes stored per value and the absolute error.
+ * zfp 0.5 has no lossless mode, so the reversible mode, the default,
+ * compresses all the data with zlib. A lossy mode has to be selected
+ * explicitly, with a bound that suits the range of the data.
+ *
+ * zfp only applies to arrays of floats or doubles in the native byte
+ * order. The type of the values, and optionally the dimensions of the
+ * structured array they belong to, must be given with SetDataType() and
+ * SetDimensions() before compressing; vtkXMLWriter does this for each
+ * array. Other data, and blocks that zfp does not make smaller, are
+ * compressed with zlib.
+ * Each compressed block records how it was compressed, so uncompressing
+ * needs no settings.
+*/
+
+#ifndef vtkZFPDataCompressor_h
+#define vtkZFPDataCompressor_h
+
+#include "vtkIOCoreModule.h" // For export macro
+#include "vtkDataCompressor.h"
+
+class vtkZLibDataCompressor;
+
+class VTKIOCORE_EXPORT vtkZFPDataCompressor : public vtkDataCompressor
+{
+public:
+  vtkTypeMacro(vtkZFPDataCompressor,vtkDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+  static vtkZFPDataCompressor* New();
+
+  /**
+   * Get the maximum space that may be needed to store data of the
+   * given uncompressed size after compression.  This is the minimum
+   * size of the output buffer that can be passed to the four-argument
+   * Compress method.
+   */
+  size_t GetMaximumCompressionSpace(size_t size) VTK_OVERRIDE;
+
+  /**
+   * Compress() only reads the settings, so it may be called concurrently
+   * as long as they do not change.
+   */
+  bool CanCompressConcurrently() VTK_OVERRIDE { return true; }
+
+  enum CompressionMode
+  {
+    FIXED_RATE,
+    FIXED_PRECISION,
+    FIXED_ACCURACY,
+    REVERSIBLE
+  };
+
+  //@{
+  /**
+   * Get/Set the compression mode. The default is REVERSIBLE, which is
+   * lossless.
+   */
+  vtkSetClampMacro(Mode, int, FIXED_RATE, REVERSIBLE);
+  vtkGetMacro(Mode, int);
+  void SetModeToFixedRate() { this->SetMode(FIXED_RATE); }
+  void SetModeToFixedPrecision() { this->SetMode(FIXED_PRECISION); }
+  void SetModeToFixedAccuracy() { this->SetMode(FIXED_ACCURACY); }
+  void SetModeToReversible() { this->SetMode(REVERSIBLE); }
+  //@}
+
+  //@{
+  /**
+   * Get/Set the number of compressed bits stored per value in the
+   * fixed-rate mode. The default is 16.
+   */
+  vtkSetClampMacro(Rate, double, 1.0, 64.0);
+  vtkGetMacro(Rate, double);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the number of bit planes stored per value in the
+   * fixed-precision mode. The default is 32.
+   */
+  vtkSetClampMacro(Precision, int, 1, 64);
+  vtkGetMacro(Precision, int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the maximum absolute error of the fixed-accuracy mode.
+   * The default is 1e-6.
+   */
+  vtkSetClampMacro(Accuracy, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Accuracy, double);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the type of the values to compress. Only VTK_FLOAT and
+   * VTK_DOUBLE are compressed with zfp. The default is VTK_VOID.
+   */
+  vtkSetMacro(DataType, int);
+  vtkGetMacro(DataType, int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the dimensions of the structured array the values to
+   * compress belong to, x varying fastest. A block holding whole rows or
+   * slices of it is compressed as a 2D or 3D field, which zfp compresses
+   * better. Zero dimensions, the default, compress blocks as 1D fields.
+   */
+  vtkSetVector3Macro(Dimensions, int);
+  vtkGetVector3Macro(Dimensions, int);
+  //@}
+
+protected:
+  vtkZFPDataCompressor();
+  ~vtkZFPDataCompressor() VTK_OVERRIDE;
+
+  int Mode;
+  double Rate;
+  int Precision;
+  double Accuracy;
+  int DataType;
+  int Dimensions[3];
+
+  vtkZLibDataCompressor* ZLibCompressor;
+
+  // Compression method required by vtkDataCompressor.
+  size_t CompressBuffer(unsigned char const* uncompressedData,
+                        size_t uncompressedSize,
+                        unsigned char* compressedData,
+                        size_t compressionSpace) VTK_OVERRIDE;
+  // Decompression method required by vtkDataCompressor.
+  size_t UncompressBuffer(unsigned char const* compressedData,
+                          size_t compressedSize,
+                          unsigned char* uncompressedData,
+                          size_t uncompressedSize) VTK_OVERRIDE;
+
+  // Compress with zfp into compressedData, or return 0 if zfp does not
+  // apply (e.g. in the reversible mode) or does not make the data smaller.
+  size_t CompressZFP(unsigned char const* uncompressedData,
+                     size_t uncompressedSize,
+                     unsigned char* compressedData,
+                     size_t compressionSpace);
+  size_t UncompressZFP(unsigned char const* compressedData,
+                       size_t compressedSize,
+                       unsigned char* uncompressedData,
+                       size_t uncompressedSize);
+private:
+  vtkZFPDataCompressor(const vtkZFPDataCompressor&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkZFPDataCompressor&) VTK_DELETE_FUNCTION;
+};
+
+#endif
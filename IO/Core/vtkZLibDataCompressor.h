@@ -41,6 +41,11 @@ public:
    */
   size_t GetMaximumCompressionSpace(size_t size) VTK_OVERRIDE;
 
+  /**
+   * Compress() keeps no state, so it may be called concurrently.
+   */
+  bool CanCompressConcurrently() VTK_OVERRIDE { return true; }
+
   //@{
   /**
    * Get/Set the compression level.
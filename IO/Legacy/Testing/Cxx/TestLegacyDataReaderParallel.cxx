@@ -0,0 +1,248 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLegacyDataReaderParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the arrays and cells of ascii and binary legacy files read
+// in parallel are those written, whatever the number of threads, and that
+// ascii values are rounded as the stream operators round them. An ascii
+// file with CRLF line endings reads the same.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkCharArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestCheck.h"
+#include "vtkTestUtilities.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkUnstructuredGridReader.h"
+#include "vtkUnstructuredGridWriter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+
+// A grid of triangles and quads with arrays of several types, with
+// values that need more than one block of the file, and values that
+// cannot be parsed exactly with a single multiplication.
+void MakeGrid(vtkUnstructuredGrid *grid)
+{
+  const vtkIdType numPts = 20000;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    points->InsertNextPoint(std::sin(0.001 * i), 1e-300 * i, 1e200 * i);
+  }
+  grid->SetPoints(points.GetPointer());
+  grid->Allocate(numPts);
+  for (vtkIdType i = 0; i + 3 < numPts; i += 2)
+  {
+    vtkIdType pts[4] = { i, i + 1, i + 2, i + 3 };
+    grid->InsertNextCell(i % 4 ? VTK_QUAD : VTK_TRIANGLE, i % 4 ? 4 : 3,
+                         pts);
+  }
+
+  vtkNew<vtkFloatArray> floats;
+  floats->SetName("Floats");
+  floats->SetNumberOfComponents(3);
+  floats->SetNumberOfTuples(numPts);
+  vtkNew<vtkCharArray> chars;
+  chars->SetName("Chars");
+  chars->SetNumberOfTuples(numPts);
+  vtkNew<vtkUnsignedCharArray> bytes;
+  bytes->SetName("Bytes");
+  bytes->SetNumberOfTuples(numPts);
+  vtkNew<vtkShortArray> shorts;
+  shorts->SetName("Shorts");
+  shorts->SetNumberOfTuples(numPts);
+  vtkNew<vtkTypeInt64Array> longs;
+  longs->SetName("Longs");
+  longs->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    floats->SetTuple3(i, std::cos(0.01 * i), -1e-20 * i, 3e30 * i);
+    chars->SetValue(i, static_cast<char>(i % 100 - 50));
+    bytes->SetValue(i, static_cast<unsigned char>(i % 256));
+    shorts->SetValue(i, static_cast<short>(i * 7 % 65536 - 32768));
+    longs->SetValue(i, i % 2 ? VTK_TYPE_INT64_MAX - i
+                             : VTK_TYPE_INT64_MIN + i);
+  }
+  grid->GetPointData()->AddArray(floats.GetPointer());
+  grid->GetPointData()->AddArray(chars.GetPointer());
+  grid->GetPointData()->AddArray(bytes.GetPointer());
+  grid->GetPointData()->AddArray(shorts.GetPointer());
+  grid->GetPointData()->AddArray(longs.GetPointer());
+
+  // Small arrays follow each other closely in the file.
+  for (int a = 0; a < 3; ++a)
+  {
+    vtkNew<vtkIntArray> ints;
+    std::string name = "Ints" + std::to_string(a);
+    ints->SetName(name.c_str());
+    ints->SetNumberOfTuples(grid->GetNumberOfCells());
+    for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+    {
+      ints->SetValue(i, static_cast<int>(i * 7919 % 1000) - 500 + a);
+    }
+    grid->GetCellData()->AddArray(ints.GetPointer());
+  }
+}
+
+// The value read back from value written in ascii with format.
+double AsciiValue(double value, const char *format, int dataType)
+{
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), format, value);
+  return dataType == VTK_FLOAT ? std::strtof(buffer, NULL)
+                               : std::strtod(buffer, NULL);
+}
+
+// Check that the arrays of a are those of b, as written in ascii if
+// ascii is true.
+int SameArrays(vtkDataSetAttributes *a, vtkDataSetAttributes *b, bool ascii)
+{
+  vtkTestCheckMacro(a->GetNumberOfArrays() == b->GetNumberOfArrays());
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(arrayA->GetName());
+    vtkTestCheckMacro(arrayB && arrayB->GetDataType() == arrayA->GetDataType());
+    vtkTestCheckMacro(arrayB->GetNumberOfTuples() ==
+      arrayA->GetNumberOfTuples());
+    int dataType = arrayA->GetDataType();
+    bool real = dataType == VTK_FLOAT || dataType == VTK_DOUBLE;
+    for (vtkIdType t = 0; t < arrayA->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < arrayA->GetNumberOfComponents(); ++c)
+      {
+        double value = arrayB->GetComponent(t, c);
+        if (ascii && real)
+        {
+          value = AsciiValue(value, dataType == VTK_FLOAT ? "%g" : "%.11lg",
+                             dataType);
+        }
+        vtkTestCheckMacro(arrayA->GetComponent(t, c) == value);
+      }
+    }
+  }
+  return 0;
+}
+
+// Check that the points, cells and arrays of a are those of b.
+int SameGrid(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b, bool ascii)
+{
+  vtkTestCheckMacro(a->GetNumberOfPoints() == b->GetNumberOfPoints());
+  vtkTestCheckMacro(a->GetNumberOfCells() == b->GetNumberOfCells());
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    vtkTestCheckMacro(a->GetCellType(i) == b->GetCellType(i));
+    vtkIdType nptsA, *ptsA, nptsB, *ptsB;
+    a->GetCellPoints(i, nptsA, ptsA);
+    b->GetCellPoints(i, nptsB, ptsB);
+    vtkTestCheckMacro(nptsA == nptsB);
+    for (vtkIdType j = 0; j < nptsA; ++j)
+    {
+      vtkTestCheckMacro(ptsA[j] == ptsB[j]);
+    }
+  }
+  vtkNew<vtkPointData> pointsA;
+  pointsA->AddArray(a->GetPoints()->GetData());
+  vtkNew<vtkPointData> pointsB;
+  pointsB->AddArray(b->GetPoints()->GetData());
+  vtkTestCheckMacro(SameArrays(pointsA.GetPointer(), pointsB.GetPointer(),
+    ascii) == 0);
+  vtkTestCheckMacro(
+    SameArrays(a->GetPointData(), b->GetPointData(), ascii) == 0);
+  vtkTestCheckMacro(SameArrays(a->GetCellData(), b->GetCellData(), ascii) == 0);
+  return 0;
+}
+
+// Read the grid in data with the given number of threads.
+vtkSmartPointer<vtkUnstructuredGrid> Read(const std::string &data,
+                                          int numThreads)
+{
+  vtkNew<vtkUnstructuredGridReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(data);
+  reader->ReadAllScalarsOn();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(numThreads),
+                          [&]() { reader->Update(); });
+  return reader->GetOutput();
+}
+
+} // end anon namespace
+
+int TestLegacyDataReaderParallel(int argc, char* argv[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer());
+
+  for (int fileType = VTK_ASCII; fileType <= VTK_BINARY; ++fileType)
+  {
+    vtkNew<vtkUnstructuredGridWriter> writer;
+    writer->SetInputData(grid.GetPointer());
+    writer->SetFileType(fileType);
+    writer->WriteToOutputStringOn();
+    vtkTestCheckMacro(writer->Write());
+    std::string data = writer->GetOutputStdString();
+
+    vtkSmartPointer<vtkUnstructuredGrid> serial = Read(data, 1);
+    vtkTestCheckMacro(
+      SameGrid(serial, grid.GetPointer(), fileType == VTK_ASCII) == 0);
+    vtkTestCheckMacro(SameGrid(serial, Read(data, 4), false) == 0);
+
+    // The same ascii file with CRLF line endings, read from a file.
+    if (fileType == VTK_ASCII)
+    {
+      char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+        "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+      std::string fileName = std::string(tempDir) +
+        "/TestLegacyDataReaderParallelCRLF.vtk";
+      delete [] tempDir;
+      FILE *file = fopen(fileName.c_str(), "wb");
+      vtkTestCheckMacro(file);
+      for (size_t i = 0; i < data.size(); ++i)
+      {
+        if (data[i] == '\n')
+        {
+          fputc('\r', file);
+        }
+        fputc(data[i], file);
+      }
+      fclose(file);
+
+      vtkNew<vtkUnstructuredGridReader> reader;
+      reader->SetFileName(fileName.c_str());
+      reader->ReadAllScalarsOn();
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4),
+                              [&]() { reader->Update(); });
+      vtkTestCheckMacro(SameGrid(serial, reader->GetOutput(), false) == 0);
+    }
+  }
+
+  return 0;
+}
@@ -43,6 +43,7 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
@@ -54,7 +55,12 @@
 #include "vtkUnsignedLongArray.h"
 #include "vtkUnsignedShortArray.h"
 #include "vtkVariantArray.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <sstream>
+#include <vector>
 
 #include "vtkTypeUInt64Array.h"
 
@@ -378,6 +384,7 @@ size_t vtkDataReader::Peek(char *str, size_t n)
     return 0;
   }
 
+  std::streampos pos = this->IS->tellg();
   this->IS->read(str, n);
   std::streamsize len = this->IS->gcount();
 
@@ -386,7 +393,7 @@ size_t vtkDataReader::Peek(char *str, size_t n)
     this->IS->clear();
   }
 
-  this->IS->seekg(-len, std::ios_base::cur);
+  this->IS->seekg(pos);
 
   return len;
 }
@@ -546,11 +553,7 @@ int vtkDataReader::ReadHeader()
     vtkDebugMacro(<< "Opening vtk file as binary");
     delete this->IS;
     this->IS = 0;
-#ifdef _WIN32
     this->IS = new ifstream(this->FileName, ios::in | ios::binary);
-#else
-    this->IS = new ifstream(this->FileName, ios::in);
-#endif
     if (this->IS->fail())
     {
       vtkErrorMacro(<< "Unable to open file: "<< this->FileName);
@@ -1419,27 +1422,312 @@ int vtkReadBinaryData(istream *IS, T *data, int numTuples, int numComp)
   return 1;
 }
 
-// General templated function to read data of various types.
+namespace
+{
+
+// Buffered blocks of ascii values are parsed in chunks of at least this
+// many values per thread.
+const vtkIdType vtkDataReaderParseGrain = 4096;
+
+inline bool vtkDataReaderIsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' ||
+    c == '\f';
+}
+
+// The type read by the stream operators for values of type T: char types
+// are read as integers.
+template <class T> struct vtkDataReaderStreamType { typedef T Type; };
+template <> struct vtkDataReaderStreamType<char> { typedef int Type; };
+template <> struct vtkDataReaderStreamType<signed char> { typedef int Type; };
+template <> struct vtkDataReaderStreamType<unsigned char>
+{
+  typedef int Type;
+};
+
+// Parse the plain decimal integer in [p, last).  Returns false for
+// anything else, which the stream operators then parse.
 template <class T>
-int vtkReadASCIIData(vtkDataReader *self, T *data, int numTuples, int numComp)
+bool vtkDataReaderParseFast(const char* p, const char* last, T& value)
 {
-  int i, j;
+  typedef typename vtkDataReaderStreamType<T>::Type S;
+  if (p == last)
+  {
+    return false;
+  }
+  bool negative = (*p == '-');
+  if (*p == '-' || *p == '+')
+  {
+    ++p;
+  }
+  if (p == last)
+  {
+    return false;
+  }
+  vtkTypeUInt64 v = 0;
+  for (; p != last; ++p)
+  {
+    unsigned int digit = static_cast<unsigned int>(*p - '0');
+    if (digit > 9 || v > (VTK_TYPE_UINT64_MAX - digit) / 10)
+    {
+      return false;
+    }
+    v = 10 * v + digit;
+  }
+  if (negative)
+  {
+    if (!std::numeric_limits<S>::is_signed || v == 0 ||
+        v - 1 > static_cast<vtkTypeUInt64>(std::numeric_limits<S>::max()))
+    {
+      return false;
+    }
+    value = static_cast<T>(-static_cast<S>(v - 1) - 1);
+  }
+  else
+  {
+    if (v > static_cast<vtkTypeUInt64>(std::numeric_limits<S>::max()))
+    {
+      return false;
+    }
+    value = static_cast<T>(static_cast<S>(v));
+  }
+  return true;
+}
 
-  for (i=0; i<numTuples; i++)
+// Parse the decimal number in [p, last) when its significand and power of
+// ten are exact in T, so that a single multiplication or division rounds
+// it correctly.  Returns false otherwise, and for special values, which
+// the stream operators then parse.
+template <class T>
+bool vtkDataReaderParseReal(const char* p, const char* last, T& value,
+                            vtkTypeUInt64 maxSignificand, int maxExponent)
+{
+  static const T powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  bool negative = (*p == '-');
+  if (*p == '-' || *p == '+')
+  {
+    ++p;
+  }
+  vtkTypeUInt64 significand = 0;
+  int exponent = 0;
+  int digits = 0;
+  bool point = false;
+  for (; p != last; ++p)
   {
-    for (j=0; j<numComp; j++)
+    if (*p == '.' && !point)
+    {
+      point = true;
+      continue;
+    }
+    unsigned int digit = static_cast<unsigned int>(*p - '0');
+    if (digit > 9)
     {
-      if ( !self->Read(data++) )
+      break;
+    }
+    if (significand > maxSignificand / 10)
+    {
+      return false;
+    }
+    significand = 10 * significand + digit;
+    exponent -= point ? 1 : 0;
+    ++digits;
+  }
+  if (digits == 0)
+  {
+    return false;
+  }
+  if (p != last)
+  {
+    if (*p != 'e' && *p != 'E')
+    {
+      return false;
+    }
+    ++p;
+    int exponentValue = 0;
+    if (!vtkDataReaderParseFast(p, last, exponentValue) ||
+        exponentValue > 1000 || exponentValue < -1000)
+    {
+      return false;
+    }
+    exponent += exponentValue;
+  }
+  if (significand > maxSignificand || exponent > maxExponent ||
+      exponent < -maxExponent)
+  {
+    return false;
+  }
+  T result = static_cast<T>(significand);
+  result = (exponent < 0) ? result / powers[-exponent] :
+    result * powers[exponent];
+  value = negative ? -result : result;
+  return true;
+}
+
+bool vtkDataReaderParseFast(const char* p, const char* last, float& value)
+{
+  return vtkDataReaderParseReal(p, last, value, 1 << 24, 10);
+}
+
+bool vtkDataReaderParseFast(const char* p, const char* last, double& value)
+{
+  return vtkDataReaderParseReal(p, last, value,
+                                static_cast<vtkTypeUInt64>(1) << 53, 22);
+}
+
+// Parse the value in [p, last) as the stream operators do.
+template <class T>
+bool vtkDataReaderParseValue(const char* p, const char* last, T& value)
+{
+  if (vtkDataReaderParseFast(p, last, value))
+  {
+    return true;
+  }
+  typename vtkDataReaderStreamType<T>::Type streamValue;
+  std::istringstream is(std::string(p, last));
+  is.imbue(std::locale::classic());
+  is >> streamValue;
+  if (is.fail())
+  {
+    return false;
+  }
+  value = static_cast<T>(streamValue);
+  return true;
+}
+
+// Swap the big endian words of a binary file to the native byte order in
+// parallel.
+void vtkDataReaderSwapBERange(void* data, vtkIdType numWords, int wordSize)
+{
+#ifndef VTK_WORDS_BIGENDIAN
+  char* words = static_cast<char*>(data);
+  vtkSMPTools::For(0, numWords, 16 * vtkDataReaderParseGrain,
+    [words, wordSize](vtkIdType first, vtkIdType last)
+    {
+      void* p = words + first * wordSize;
+      size_t num = static_cast<size_t>(last - first);
+      switch (wordSize)
       {
-        vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
-          "datasize with declaration.");
-        return 0;
+        case 2: vtkByteSwap::Swap2BERange(p, num); break;
+        case 4: vtkByteSwap::Swap4BERange(p, num); break;
+        case 8: vtkByteSwap::Swap8BERange(p, num); break;
       }
+    });
+#else
+  (void)data;
+  (void)numWords;
+  (void)wordSize;
+#endif
+}
+
+} // end anon namespace
+
+// General templated function to read ascii data of various types.  The
+// values are read in blocks whose tokens are parsed in parallel, then the
+// stream is put back after the last value. The stream is repositioned
+// from where it started, which requires it to be opened in binary mode.
+template <class T>
+int vtkReadASCIIData(istream *IS, T *data, vtkIdType numValues)
+{
+  std::vector<char> buffer;
+  std::vector<size_t> tokens;
+  size_t begin = 0;
+  std::streampos start = IS->tellg();
+  std::streamoff numRead = 0;
+  while (numValues > 0)
+  {
+    // Read more of the file, keeping the start of a token cut by the end
+    // of the last block.  Values take a few characters each.
+    size_t blockSize = static_cast<size_t>(std::min<vtkIdType>(
+      std::max<vtkIdType>(16 * numValues, 4096), 1 << 24));
+    buffer.erase(buffer.begin(), buffer.begin() + begin);
+    size_t kept = buffer.size();
+    buffer.resize(kept + blockSize);
+    IS->read(&buffer[kept], blockSize);
+    size_t size = kept + static_cast<size_t>(IS->gcount());
+    numRead += IS->gcount();
+    buffer.resize(size);
+    bool end = !*IS;
+    if (end)
+    {
+      IS->clear();
     }
+
+    // Find the complete tokens needed.
+    tokens.clear();
+    size_t i = 0;
+    begin = size;
+    while (static_cast<vtkIdType>(tokens.size()) < numValues)
+    {
+      while (i < size && vtkDataReaderIsSpace(buffer[i]))
+      {
+        ++i;
+      }
+      size_t first = i;
+      while (i < size && !vtkDataReaderIsSpace(buffer[i]))
+      {
+        ++i;
+      }
+      if (first == size || (i == size && !end))
+      {
+        begin = first;
+        break;
+      }
+      tokens.push_back(first);
+      begin = i;
+    }
+    if (tokens.empty() && end)
+    {
+      vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
+        "datasize with declaration.");
+      return 0;
+    }
+
+    // Parse them.
+    std::atomic<int> failed(0);
+    vtkIdType numTokens = static_cast<vtkIdType>(tokens.size());
+    vtkSMPTools::For(0, numTokens, vtkDataReaderParseGrain,
+      [&](vtkIdType first, vtkIdType last)
+      {
+        for (vtkIdType t = first; t < last; ++t)
+        {
+          const char* p = &buffer[tokens[t]];
+          const char* tokenEnd = p;
+          const char* bufferEnd = &buffer[0] + buffer.size();
+          while (tokenEnd != bufferEnd && !vtkDataReaderIsSpace(*tokenEnd))
+          {
+            ++tokenEnd;
+          }
+          if (!vtkDataReaderParseValue(p, tokenEnd, data[t]))
+          {
+            failed = 1;
+          }
+        }
+      });
+    if (failed)
+    {
+      vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
+        "datasize with declaration.");
+      return 0;
+    }
+    data += numTokens;
+    numValues -= numTokens;
   }
+
+  // Put back what follows the values.
+  IS->seekg(start + (numRead -
+                     static_cast<std::streamoff>(buffer.size() - begin)));
   return 1;
 }
 
+template <class T>
+int vtkReadASCIIData(istream *IS, T *data, int numTuples, int numComp)
+{
+  return vtkReadASCIIData(IS, data,
+    static_cast<vtkIdType>(numTuples) * numComp);
+}
+
 // Decription:
 // Read data array. Return pointer to array object if successful read;
 // otherwise return NULL. Note: this method instantiates a reference counted
@@ -1507,7 +1795,7 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1522,7 +1810,7 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1534,11 +1822,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap2BERange(ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 2);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1550,11 +1838,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap2BERange((short *)ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 2);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1567,11 +1855,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange(ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 4);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
     vtkIdType *ptr2 = ((vtkIdTypeArray *)array)->WritePointer(
       0,numTuples*numComp);
@@ -1590,11 +1878,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange(ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 4);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1606,11 +1894,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange((int *)ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 4);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1622,12 +1910,12 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange((int *)ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 4);
     }
 
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1639,11 +1927,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange((int *)ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 4);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1655,12 +1943,12 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap8BERange(ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 8);
     }
 
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1672,12 +1960,12 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap8BERange(ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 8);
     }
 
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1689,11 +1977,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange(ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 4);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -1705,11 +1993,11 @@ vtkAbstractArray *vtkDataReader::ReadArray(const char *dataType, int numTuples,
     if ( this->FileType == VTK_BINARY )
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap8BERange(ptr,numTuples*numComp);
+      vtkDataReaderSwapBERange(ptr, numTuples*numComp, 8);
     }
     else
     {
-      vtkReadASCIIData(this, ptr, numTuples, numComp);
+      vtkReadASCIIData(this->IS, ptr, numTuples, numComp);
     }
   }
 
@@ -3041,7 +3329,6 @@ int vtkDataReader::ReadLutData(vtkDataSetAttributes *a)
 int vtkDataReader::ReadCells(int size, int *data)
 {
   char line[256];
-  int i;
 
   if ( this->FileType == VTK_BINARY)
   {
@@ -3054,18 +3341,15 @@ int vtkDataReader::ReadCells(int size, int *data)
                     << (this->FileName?this->FileName:"(Null FileName)"));
       return 0;
     }
-    vtkByteSwap::Swap4BERange(data,size);
+    vtkDataReaderSwapBERange(data, size, 4);
   }
   else // ascii
   {
-    for (i=0; i<size; i++)
+    if (!vtkReadASCIIData(this->IS, data, size, 1))
     {
-      if (!this->Read(data+i))
-      {
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (this->FileName?this->FileName:"(Null FileName)"));
-        return 0;
-      }
+      vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
+                    << (this->FileName?this->FileName:"(Null FileName)"));
+      return 0;
     }
   }
 
@@ -3079,21 +3363,21 @@ int vtkDataReader::ReadCells(int size, int *data,
                              int skip1, int read2, int skip3)
 {
   char line[256];
-  int i, numCellPts, junk, *tmp, *pTmp;
+  int i, *tmp, *pTmp;
 
+  // first read all the cells as one chunk (each cell has different length).
+  if (skip1 == 0 && skip3 == 0)
+  {
+    tmp = data;
+  }
+  else
+  {
+    tmp = new int[size];
+  }
   if ( this->FileType == VTK_BINARY)
   {
     // suck up newline
     this->IS->getline(line,256);
-    // first read all the cells as one chunk (each cell has different length).
-    if (skip1 == 0 && skip3 == 0)
-    {
-      tmp = data;
-    }
-    else
-    {
-      tmp = new int[size];
-    }
     this->IS->read((char *)tmp,sizeof(int)*size);
     if (this->IS->eof())
     {
@@ -3105,11 +3389,24 @@ int vtkDataReader::ReadCells(int size, int *data,
       }
       return 0;
     }
-    vtkByteSwap::Swap4BERange(tmp,size);
-    if (tmp == data)
+    vtkDataReaderSwapBERange(tmp, size, 4);
+  }
+  else // ascii
+  {
+    if (!vtkReadASCIIData(this->IS, tmp, size, 1))
     {
-      return 1;
+      vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
+                    << (this->FileName?this->FileName:"(Null FileName)"));
+      if (tmp != data)
+      {
+        delete [] tmp;
+      }
+      return 0;
     }
+  }
+
+  if (tmp != data)
+  {
     // skip cells before the piece
     pTmp = tmp;
     while (skip1 > 0)
@@ -3134,52 +3431,6 @@ int vtkDataReader::ReadCells(int size, int *data,
     // delete the temporary array
     delete [] tmp;
   }
-  else // ascii
-  {
-    // skip cells before the piece
-    for (i=0; i<skip1; i++)
-    {
-      if (!this->Read(&numCellPts))
-      {
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (this->FileName?this->FileName:"(Null FileName)"));
-        return 0;
-      }
-      while (numCellPts-- > 0)
-      {
-        this->Read(&junk);
-      }
-    }
-    // read the cells in the piece
-    for (i=0; i<read2; i++)
-    {
-      if (!this->Read(data))
-      {
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (this->FileName?this->FileName:"(Null FileName)"));
-        return 0;
-      }
-      numCellPts = *data++;
-      while (numCellPts-- > 0)
-      {
-        this->Read(data++);
-      }
-    }
-    // skip cells after the piece
-    for (i=0; i<skip3; i++)
-    {
-      if (!this->Read(&numCellPts))
-      {
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (this->FileName?this->FileName:"(Null FileName)"));
-        return 0;
-      }
-      while (numCellPts-- > 0)
-      {
-        this->Read(&junk);
-      }
-    }
-  }
 
   float progress = this->GetProgress();
   this->UpdateProgress(progress + 0.5*(1.0 - progress));
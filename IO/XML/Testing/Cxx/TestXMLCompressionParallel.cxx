@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressionParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the blocks of compressed arrays written and read in parallel
+// give the same file and arrays whatever the number of threads, with
+// byte swapping and id conversion, and that the calls to a compressor
+// that cannot compress concurrently are serialized.
+
+#include "vtkAtomic.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestCheck.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <cmath>
+#include <string>
+
+// A zlib compressor that does not declare itself safe to call
+// concurrently, and counts the calls that overlap.
+class vtkSerialZLibDataCompressor : public vtkZLibDataCompressor
+{
+public:
+  static vtkSerialZLibDataCompressor* New();
+  vtkTypeMacro(vtkSerialZLibDataCompressor, vtkZLibDataCompressor);
+
+  bool CanCompressConcurrently() VTK_OVERRIDE { return false; }
+
+  vtkAtomic<int> Running;
+  vtkAtomic<int> Overlaps;
+
+protected:
+  vtkSerialZLibDataCompressor() : Running(0), Overlaps(0) {}
+
+  size_t CompressBuffer(unsigned char const* uncompressedData,
+                        size_t uncompressedSize,
+                        unsigned char* compressedData,
+                        size_t compressionSpace) VTK_OVERRIDE
+  {
+    if (++this->Running > 1)
+    {
+      ++this->Overlaps;
+    }
+    size_t size = this->Superclass::CompressBuffer(
+      uncompressedData, uncompressedSize, compressedData, compressionSpace);
+    --this->Running;
+    return size;
+  }
+};
+
+vtkStandardNewMacro(vtkSerialZLibDataCompressor);
+
+namespace
+{
+
+// Write image to a string with a new writer and the given number of
+// threads.
+std::string Write(vtkImageData *image, int compressor, int byteOrder,
+                  int dataMode, int numThreads)
+{
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image);
+  writer->WriteToOutputStringOn();
+  writer->SetBlockSize(4096);
+  writer->SetCompressorType(compressor);
+  writer->SetByteOrder(byteOrder);
+  writer->SetIdType(byteOrder == vtkXMLWriter::BigEndian ?
+                    vtkXMLWriter::Int32 : vtkXMLWriter::Int64);
+  writer->SetDataMode(dataMode);
+  writer->EncodeAppendedDataOff();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(numThreads),
+                          [&]() { writer->Write(); });
+  return writer->GetOutputString();
+}
+
+// Read the image written to data with the given number of threads, and
+// check that its arrays are those of image.
+int CheckRead(vtkImageData *image, const std::string &data, int numThreads)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(data);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(numThreads),
+                          [&]() { reader->Update(); });
+  vtkPointData *in = image->GetPointData();
+  vtkPointData *out = reader->GetOutput()->GetPointData();
+  vtkTestCheckMacro(in->GetNumberOfArrays() == out->GetNumberOfArrays());
+  for (int i = 0; i < in->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *inArray = in->GetArray(i);
+    vtkDataArray *outArray = out->GetArray(inArray->GetName());
+    vtkTestCheckMacro(outArray);
+    vtkTestCheckMacro(outArray->GetNumberOfTuples() ==
+      inArray->GetNumberOfTuples());
+    for (vtkIdType t = 0; t < inArray->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < inArray->GetNumberOfComponents(); ++c)
+      {
+        vtkTestCheckMacro(outArray->GetComponent(t, c) ==
+          inArray->GetComponent(t, c));
+      }
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestXMLCompressionParallel(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(50, 40, 30);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    vectors->SetTuple3(i, std::sin(0.01 * i), std::cos(0.02 * i), 0.5 * i);
+    ids->SetValue(i, (i * 7919) % numPts);
+  }
+  image->GetPointData()->AddArray(vectors.GetPointer());
+  image->GetPointData()->AddArray(ids.GetPointer());
+
+  // The first write caches the norm ranges of the arrays in their
+  // information, which the next writes include.
+  Write(image.GetPointer(), vtkXMLWriter::NONE, vtkXMLWriter::LittleEndian,
+        vtkXMLWriter::Appended, 1);
+
+  const int compressors[2] = { vtkXMLWriter::ZLIB, vtkXMLWriter::LZ4 };
+  const int dataModes[2] = { vtkXMLWriter::Appended, vtkXMLWriter::Binary };
+  for (int i = 0; i < 2; ++i)
+  {
+    for (int byteOrder = 0; byteOrder < 2; ++byteOrder)
+    {
+      for (int m = 0; m < 2; ++m)
+      {
+        std::string serial = Write(image.GetPointer(), compressors[i],
+                                   byteOrder, dataModes[m], 1);
+        vtkTestCheckMacro(serial == Write(image.GetPointer(), compressors[i],
+          byteOrder, dataModes[m], 4));
+        vtkTestCheckMacro(CheckRead(image.GetPointer(), serial, 1) == 0);
+        vtkTestCheckMacro(CheckRead(image.GetPointer(), serial, 4) == 0);
+      }
+    }
+  }
+
+  // A compressor that cannot compress concurrently gives the same file,
+  // but for the name of the compressor.
+  vtkNew<vtkSerialZLibDataCompressor> serialZLib;
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image.GetPointer());
+  writer->WriteToOutputStringOn();
+  writer->SetBlockSize(4096);
+  writer->SetCompressor(serialZLib.GetPointer());
+  writer->SetByteOrder(vtkXMLWriter::LittleEndian);
+  writer->SetIdType(vtkXMLWriter::Int64);
+  writer->SetDataMode(vtkXMLWriter::Appended);
+  writer->EncodeAppendedDataOff();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4),
+                          [&]() { writer->Write(); });
+  vtkTestCheckMacro(serialZLib->Overlaps == 0);
+  std::string serialZLibData = writer->GetOutputString();
+  std::string::size_type name = serialZLibData.find("vtkSerialZLib");
+  vtkTestCheckMacro(name != std::string::npos);
+  serialZLibData.replace(name, 13, "vtkZLib");
+  vtkTestCheckMacro(serialZLibData ==
+    Write(image.GetPointer(), vtkXMLWriter::ZLIB, vtkXMLWriter::LittleEndian,
+          vtkXMLWriter::Appended, 1));
+
+  return 0;
+}
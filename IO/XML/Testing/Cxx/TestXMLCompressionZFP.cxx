@@ -0,0 +1,228 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressionZFP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that image data written with vtkZFPDataCompressor reads back
+// within the error bounds of each compression mode, exactly in the
+// reversible mode, the default, and for the arrays zfp does not apply to,
+// and that the lossy modes compress with zfp.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTestCheck.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkZFPDataCompressor.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Smooth floating-point fields, an integer array, a vector array and a
+// noisy float array on the points of an image, and a float array on its
+// cells.
+void MakeImage(vtkImageData *image)
+{
+  image->SetExtent(0, 39, 0, 29, 0, 19);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkFloatArray> floats;
+  floats->SetName("Floats");
+  floats->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetName("Doubles");
+  doubles->SetNumberOfTuples(numPts);
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  ints->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> noise;
+  noise->SetName("Noise");
+  noise->SetNumberOfTuples(numPts);
+  double x[3];
+  unsigned int seed = 12345;
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    image->GetPoint(i, x);
+    double value = std::sin(0.2 * x[0]) * std::cos(0.3 * x[1]) + 0.05 * x[2];
+    floats->SetValue(i, static_cast<float>(value));
+    doubles->SetValue(i, std::exp(-0.01 * (x[0] * x[0] + x[1] * x[1])) *
+                         (1.0 + x[2]));
+    ints->SetValue(i, static_cast<int>(i * 7919 % 1000) - 500);
+    vectors->SetTuple3(i, value, -value, 2.0 * value);
+    seed = seed * 1103515245u + 12345u;
+    noise->SetValue(i, static_cast<float>(seed >> 8) * 1e-30f);
+  }
+  image->GetPointData()->AddArray(floats.GetPointer());
+  image->GetPointData()->AddArray(doubles.GetPointer());
+  image->GetPointData()->AddArray(ints.GetPointer());
+  image->GetPointData()->AddArray(vectors.GetPointer());
+  image->GetPointData()->AddArray(noise.GetPointer());
+
+  vtkNew<vtkFloatArray> cellFloats;
+  cellFloats->SetName("CellFloats");
+  cellFloats->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    cellFloats->SetValue(i, static_cast<float>(std::sqrt(1.0 + i)));
+  }
+  image->GetCellData()->AddArray(cellFloats.GetPointer());
+}
+
+// Write image to a string with the given compressor and data mode.
+std::string Write(vtkImageData *image, vtkDataCompressor *compressor,
+                  int dataMode)
+{
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image);
+  writer->SetCompressor(compressor);
+  writer->SetDataMode(dataMode);
+  writer->WriteToOutputStringOn();
+  writer->Write();
+  return writer->GetOutputString();
+}
+
+// Read back the image written to data and check the largest error of
+// its floating-point arrays, and that its integer array is unchanged.
+int CheckImage(vtkImageData *image, const std::string &data,
+               double tolerance)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(data);
+  reader->Update();
+  vtkImageData *output = reader->GetOutput();
+  vtkTestCheckMacro(output->GetNumberOfPoints() == image->GetNumberOfPoints());
+
+  vtkDataSetAttributes *attributes[2][2] =
+  {
+    { image->GetPointData(), output->GetPointData() },
+    { image->GetCellData(), output->GetCellData() }
+  };
+  for (int a = 0; a < 2; ++a)
+  {
+    vtkDataSetAttributes *in = attributes[a][0];
+    vtkDataSetAttributes *out = attributes[a][1];
+    vtkTestCheckMacro(in->GetNumberOfArrays() == out->GetNumberOfArrays());
+    for (int i = 0; i < in->GetNumberOfArrays(); ++i)
+    {
+      vtkDataArray *inArray = in->GetArray(i);
+      vtkDataArray *outArray = out->GetArray(inArray->GetName());
+      vtkTestCheckMacro(outArray &&
+        outArray->GetDataType() == inArray->GetDataType());
+      vtkTestCheckMacro(outArray->GetNumberOfTuples() ==
+        inArray->GetNumberOfTuples());
+      bool exact = inArray->GetDataType() == VTK_INT;
+      for (vtkIdType t = 0; t < inArray->GetNumberOfTuples(); ++t)
+      {
+        for (int c = 0; c < inArray->GetNumberOfComponents(); ++c)
+        {
+          double error = std::fabs(outArray->GetComponent(t, c) -
+                                   inArray->GetComponent(t, c));
+          vtkTestCheckMacro(!exact || error == 0.0);
+          vtkTestCheckMacro(error <= tolerance);
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestXMLCompressionZFP(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  MakeImage(image.GetPointer());
+
+  vtkNew<vtkZFPDataCompressor> defaultZFP;
+  vtkTestCheckMacro(defaultZFP->GetMode() ==
+    vtkZFPDataCompressor::REVERSIBLE);
+  vtkNew<vtkZFPDataCompressor> zfp;
+  const int dataModes[2] = { vtkXMLWriter::Appended, vtkXMLWriter::Binary };
+  for (int m = 0; m < 2; ++m)
+  {
+    // The default, reversible mode is lossless.
+    std::string reversible = Write(image.GetPointer(), defaultZFP.GetPointer(),
+                                   dataModes[m]);
+    vtkTestCheckMacro(CheckImage(image.GetPointer(), reversible, 0.0) == 0);
+
+    // The lossy modes bound the error. The accuracy of 1e-6 adds to the
+    // rounding to float of cell values up to 150.
+    zfp->SetModeToFixedAccuracy();
+    zfp->SetAccuracy(1e-6);
+    std::string fine = Write(image.GetPointer(), zfp.GetPointer(),
+                             dataModes[m]);
+    vtkTestCheckMacro(CheckImage(image.GetPointer(), fine, 1e-5) == 0);
+    vtkTestCheckMacro(fine.size() < reversible.size());
+
+    zfp->SetAccuracy(1e-4);
+    std::string accuracy = Write(image.GetPointer(), zfp.GetPointer(),
+                                 dataModes[m]);
+    vtkTestCheckMacro(CheckImage(image.GetPointer(), accuracy, 1e-4) == 0);
+    vtkTestCheckMacro(accuracy.size() < reversible.size());
+
+    zfp->SetModeToFixedPrecision();
+    zfp->SetPrecision(24);
+    std::string precision = Write(image.GetPointer(), zfp.GetPointer(),
+                                  dataModes[m]);
+    vtkTestCheckMacro(CheckImage(image.GetPointer(), precision, 1e-3) == 0);
+
+    zfp->SetModeToFixedRate();
+    zfp->SetRate(12);
+    std::string rate = Write(image.GetPointer(), zfp.GetPointer(),
+                             dataModes[m]);
+    vtkTestCheckMacro(CheckImage(image.GetPointer(), rate, 1e-1) == 0);
+    vtkTestCheckMacro(rate.size() < reversible.size());
+  }
+
+  // The lossy modes write zfp blocks, whose first byte is 1, for the
+  // floating-point arrays.
+  vtkNew<vtkZFPDataCompressor> lossyZFP;
+  lossyZFP->SetModeToFixedAccuracy();
+  vtkFloatArray *floats = vtkFloatArray::SafeDownCast(
+    image->GetPointData()->GetArray("Floats"));
+  size_t floatsSize = floats->GetNumberOfTuples() * sizeof(float);
+  std::vector<unsigned char> zfpBlock(
+    lossyZFP->GetMaximumCompressionSpace(floatsSize));
+  lossyZFP->SetDataType(VTK_FLOAT);
+  lossyZFP->SetDimensions(image->GetDimensions());
+  size_t zfpSize = lossyZFP->Compress(
+    reinterpret_cast<unsigned char*>(floats->GetPointer(0)), floatsSize,
+    &zfpBlock[0], zfpBlock.size());
+  vtkTestCheckMacro(zfpSize > 0 && zfpSize < floatsSize / 2);
+  vtkTestCheckMacro(zfpBlock[0] == 1);
+
+  // Arrays that zfp does not apply to are compressed with zlib.
+  const unsigned char data[5] = { 'v', 't', 'k', 'v', 't' };
+  zfp->SetDataType(VTK_UNSIGNED_CHAR);
+  unsigned char compressed[64];
+  size_t size = zfp->Compress(data, 5, compressed,
+                              zfp->GetMaximumCompressionSpace(5));
+  vtkTestCheckMacro(size > 0);
+  unsigned char uncompressed[5];
+  vtkTestCheckMacro(zfp->Uncompress(compressed, size, uncompressed, 5) == 5);
+  vtkTestCheckMacro(memcmp(data, uncompressed, 5) == 0);
+
+  return 0;
+}
@@ -0,0 +1,304 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLLazyArrayLoading.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the arrays of XML files read with LazyArrayLoading on are
+// read when first accessed, have the values the file holds, and outlive
+// the reader.
+
+#include "vtkAOSDataArrayTemplate.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestCheck.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLLazyDataArrayTemplate.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Add a float scalar, a double vector and an int array to the data.
+void AddArrays(vtkFieldData *fd, vtkIdType numTuples)
+{
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numTuples);
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numTuples);
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+  {
+    scalars->SetValue(i, static_cast<float>(std::sin(0.01 * i)));
+    vectors->SetTuple3(i, i, std::cos(0.02 * i), -0.5 * i);
+    ids->SetValue(i, static_cast<int>(7 * i - 1000));
+  }
+  fd->AddArray(scalars.GetPointer());
+  fd->AddArray(vectors.GetPointer());
+  fd->AddArray(ids.GetPointer());
+}
+
+bool IsLazy(vtkDataArray *array)
+{
+  return vtkXMLLazyDataArrayTemplate<float>::SafeDownCast(array) ||
+    vtkXMLLazyDataArrayTemplate<double>::SafeDownCast(array) ||
+    vtkXMLLazyDataArrayTemplate<int>::SafeDownCast(array);
+}
+
+bool IsLoaded(vtkDataArray *array)
+{
+  if (vtkXMLLazyDataArrayTemplate<float> *f =
+      vtkXMLLazyDataArrayTemplate<float>::SafeDownCast(array))
+  {
+    return f->IsLoaded();
+  }
+  if (vtkXMLLazyDataArrayTemplate<double> *d =
+      vtkXMLLazyDataArrayTemplate<double>::SafeDownCast(array))
+  {
+    return d->IsLoaded();
+  }
+  return vtkXMLLazyDataArrayTemplate<int>::SafeDownCast(array)->IsLoaded();
+}
+
+// Check that the lazy arrays of fd are not read yet, and then that they
+// hold the values of the eagerly read arrays of expected.
+int CheckArrays(vtkFieldData *fd, vtkFieldData *expected)
+{
+  vtkTestCheckMacro(fd->GetNumberOfArrays() == 3);
+  vtkTestCheckMacro(expected->GetNumberOfArrays() == 3);
+  for (int a = 0; a < 3; ++a)
+  {
+    vtkDataArray *array = fd->GetArray(a);
+    vtkDataArray *eager = expected->GetArray(array->GetName());
+    vtkTestCheckMacro(IsLazy(array));
+    vtkTestCheckMacro(!IsLazy(eager));
+    vtkTestCheckMacro(!IsLoaded(array));
+    vtkTestCheckMacro(array->GetDataType() == eager->GetDataType());
+    vtkTestCheckMacro(array->GetNumberOfComponents() ==
+      eager->GetNumberOfComponents());
+    vtkTestCheckMacro(array->GetNumberOfTuples() == eager->GetNumberOfTuples());
+    vtkTestCheckMacro(!IsLoaded(array));
+
+    // New instances are plain arrays.
+    vtkSmartPointer<vtkDataArray> instance;
+    instance.TakeReference(array->NewInstance());
+    vtkTestCheckMacro(!IsLazy(instance));
+    vtkTestCheckMacro(instance->GetDataType() == array->GetDataType());
+    vtkTestCheckMacro(!IsLoaded(array));
+  }
+
+  // The first array is first accessed from several threads at once.
+  vtkDataArray *first = fd->GetArray(0);
+  vtkDataArray *firstEager = expected->GetArray(first->GetName());
+  vtkIdType numTuples = first->GetNumberOfTuples();
+  std::vector<unsigned char> ok(numTuples, 0);
+  vtkSMPTools::For(0, numTuples, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      ok[i] = first->GetComponent(i, 0) == firstEager->GetComponent(i, 0);
+    }
+  });
+  vtkTestCheckMacro(IsLoaded(first));
+  for (vtkIdType i = 0; i < numTuples; ++i)
+  {
+    vtkTestCheckMacro(ok[i]);
+  }
+
+  // The others through their pointers.
+  for (int a = 1; a < 3; ++a)
+  {
+    vtkDataArray *array = fd->GetArray(a);
+    vtkDataArray *eager = expected->GetArray(array->GetName());
+    vtkIdType numValues =
+      array->GetNumberOfTuples() * array->GetNumberOfComponents();
+    if (array->GetDataType() == VTK_INT)
+    {
+      int *values = static_cast<int*>(array->GetVoidPointer(0));
+      vtkTestCheckMacro(IsLoaded(array));
+      int *eagerValues = static_cast<int*>(eager->GetVoidPointer(0));
+      for (vtkIdType i = 0; i < numValues; ++i)
+      {
+        vtkTestCheckMacro(values[i] == eagerValues[i]);
+      }
+    }
+    else
+    {
+      double *values = static_cast<double*>(array->GetVoidPointer(0));
+      vtkTestCheckMacro(IsLoaded(array));
+      double *eagerValues = static_cast<double*>(eager->GetVoidPointer(0));
+      for (vtkIdType i = 0; i < numValues; ++i)
+      {
+        vtkTestCheckMacro(values[i] == eagerValues[i]);
+      }
+    }
+
+    // Once read, the arrays can be modified and resized.
+    array->SetComponent(0, 0, 42);
+    vtkTestCheckMacro(array->GetComponent(0, 0) == 42);
+    array->InsertNextTuple(1, eager);
+    vtkTestCheckMacro(array->GetNumberOfTuples() ==
+      eager->GetNumberOfTuples() + 1);
+    vtkTestCheckMacro(array->GetComponent(eager->GetNumberOfTuples(), 0) ==
+      eager->GetComponent(1, 0));
+  }
+  return 0;
+}
+
+int TestImageData(const std::string &fileName, int dataMode, int compress)
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 29, 0, 19, 0, 9);
+  AddArrays(image->GetPointData(), image->GetNumberOfPoints());
+  AddArrays(image->GetCellData(), image->GetNumberOfCells());
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image.GetPointer());
+  writer->SetFileName(fileName.c_str());
+  writer->SetDataMode(dataMode);
+  if (!compress)
+  {
+    writer->SetCompressorTypeToNone();
+  }
+  writer->SetBlockSize(1024);
+  vtkTestCheckMacro(writer->Write());
+
+  vtkNew<vtkXMLImageDataReader> eagerReader;
+  eagerReader->SetFileName(fileName.c_str());
+  eagerReader->Update();
+
+  vtkSmartPointer<vtkImageData> output;
+  {
+    vtkNew<vtkXMLImageDataReader> reader;
+    reader->SetFileName(fileName.c_str());
+    reader->LazyArrayLoadingOn();
+    reader->Update();
+    output = reader->GetOutput();
+  }
+  vtkTestCheckMacro(output->GetNumberOfPoints() == image->GetNumberOfPoints());
+  vtkTestCheckMacro(CheckArrays(output->GetPointData(),
+    eagerReader->GetOutput()->GetPointData()) == 0);
+  vtkTestCheckMacro(CheckArrays(output->GetCellData(),
+    eagerReader->GetOutput()->GetCellData()) == 0);
+
+  // Arrays of sub-extents are read as usual.
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->LazyArrayLoadingOn();
+  int extent[6] = { 2, 9, 0, 19, 3, 3 };
+  vtkAlgorithm *algorithm = reader.GetPointer();
+  vtkTestCheckMacro(algorithm->UpdateExtent(extent));
+  vtkDataArray *sub = reader->GetOutput()->GetPointData()->GetArray("Ids");
+  vtkTestCheckMacro(!IsLazy(sub));
+  vtkTestCheckMacro(sub->GetNumberOfTuples() == 8 * 20);
+  vtkTestCheckMacro(sub->GetComponent(0, 0) == 7 * (3 * 600 + 2) - 1000);
+  return 0;
+}
+
+int TestUnstructuredGrid(const std::string &fileName, int dataMode,
+                         int compress)
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  vtkNew<vtkPoints> points;
+  const vtkIdType numCells = 500;
+  grid->Allocate(numCells);
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    vtkIdType ids[2];
+    ids[0] = points->InsertNextPoint(i, 0, 0);
+    ids[1] = points->InsertNextPoint(i, 1, 0);
+    grid->InsertNextCell(VTK_LINE, 2, ids);
+  }
+  grid->SetPoints(points.GetPointer());
+  AddArrays(grid->GetPointData(), grid->GetNumberOfPoints());
+  AddArrays(grid->GetCellData(), grid->GetNumberOfCells());
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetInputData(grid.GetPointer());
+  writer->SetFileName(fileName.c_str());
+  writer->SetDataMode(dataMode);
+  if (!compress)
+  {
+    writer->SetCompressorTypeToNone();
+  }
+  vtkTestCheckMacro(writer->Write());
+
+  vtkNew<vtkXMLUnstructuredGridReader> eagerReader;
+  eagerReader->SetFileName(fileName.c_str());
+  eagerReader->Update();
+
+  vtkSmartPointer<vtkUnstructuredGrid> output;
+  {
+    vtkNew<vtkXMLUnstructuredGridReader> reader;
+    reader->SetFileName(fileName.c_str());
+    reader->LazyArrayLoadingOn();
+    reader->Update();
+    output = reader->GetOutput();
+  }
+  vtkTestCheckMacro(output->GetNumberOfCells() == numCells);
+  vtkTestCheckMacro(output->GetPoint(3)[0] == 1);
+  vtkTestCheckMacro(CheckArrays(output->GetPointData(),
+    eagerReader->GetOutput()->GetPointData()) == 0);
+  vtkTestCheckMacro(CheckArrays(output->GetCellData(),
+    eagerReader->GetOutput()->GetCellData()) == 0);
+  return 0;
+}
+
+} // end anon namespace
+
+int TestXMLLazyArrayLoading(int argc, char *argv[])
+{
+  char *tempDirC = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string prefix = std::string(tempDirC) + "/TestXMLLazyArrayLoading";
+  delete [] tempDirC;
+
+  // Raw and compressed appended data, compressed inline binary data and
+  // ascii data.
+  const int modes[4][2] =
+  {
+    { vtkXMLWriter::Appended, 0 },
+    { vtkXMLWriter::Appended, 1 },
+    { vtkXMLWriter::Binary, 1 },
+    { vtkXMLWriter::Ascii, 0 }
+  };
+  for (int m = 0; m < 4; ++m)
+  {
+    int result = 0;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(m % 2 ? 1 : 4), [&]()
+    {
+      result = TestImageData(prefix + ".vti", modes[m][0], modes[m][1]) ||
+        TestUnstructuredGrid(prefix + ".vtu", modes[m][0], modes[m][1]);
+    });
+    vtkTestCheckMacro(result == 0);
+  }
+  return 0;
+}
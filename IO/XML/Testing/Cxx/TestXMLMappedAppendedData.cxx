@@ -0,0 +1,239 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMappedAppendedData.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the arrays read with MemoryMapAppendedData on are those read
+// without it, that they can be modified and resized without changing the
+// file, and that they outlive the reader.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestCheck.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <cmath>
+#include <string>
+
+namespace
+{
+
+// Check that the arrays of a and b are identical.
+int SameArrays(vtkDataSetAttributes *a, vtkDataSetAttributes *b)
+{
+  vtkTestCheckMacro(a->GetNumberOfArrays() == b->GetNumberOfArrays());
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(arrayA->GetName());
+    vtkTestCheckMacro(arrayB && arrayB->GetDataType() == arrayA->GetDataType());
+    vtkTestCheckMacro(arrayB->GetNumberOfTuples() ==
+      arrayA->GetNumberOfTuples());
+    for (vtkIdType t = 0; t < arrayA->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < arrayA->GetNumberOfComponents(); ++c)
+      {
+        vtkTestCheckMacro(arrayA->GetComponent(t, c) ==
+          arrayB->GetComponent(t, c));
+      }
+    }
+  }
+  return 0;
+}
+
+// Read the image in fileName with or without mapping its data.
+vtkSmartPointer<vtkImageData> ReadImage(const std::string &fileName,
+                                        bool map)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMemoryMapAppendedData(map);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Read the grid in fileName with or without mapping its data.
+vtkSmartPointer<vtkUnstructuredGrid> ReadGrid(const std::string &fileName,
+                                              bool map)
+{
+  vtkNew<vtkXMLUnstructuredGridReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMemoryMapAppendedData(map);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+int TestImage(const std::string &tempDir)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(31, 21, 11);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  vtkNew<vtkUnsignedCharArray> bytes;
+  bytes->SetName("Bytes");
+  bytes->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> floats;
+  floats->SetName("Floats");
+  floats->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    vectors->SetTuple3(i, std::sin(0.01 * i), std::cos(0.02 * i), 0.5 * i);
+    bytes->SetValue(i, static_cast<unsigned char>(i % 251));
+    floats->SetValue(i, static_cast<float>(std::sqrt(1.0 + i)));
+  }
+  // Odd-sized arrays leave the arrays that follow them unaligned unless
+  // the writer aligns them.
+  image->GetPointData()->AddArray(bytes.GetPointer());
+  image->GetPointData()->AddArray(vectors.GetPointer());
+  image->GetPointData()->AddArray(floats.GetPointer());
+
+  // Aligned and unaligned raw, base64 encoded and compressed appended data.
+  for (int mode = 0; mode < 4; ++mode)
+  {
+    std::string fileName = tempDir + "/TestXMLMappedAppendedData.vti";
+    vtkNew<vtkXMLImageDataWriter> writer;
+    writer->SetInputData(image.GetPointer());
+    writer->SetFileName(fileName.c_str());
+    writer->SetDataModeToAppended();
+    writer->SetAlignAppendedData(mode == 0);
+    writer->SetEncodeAppendedData(mode == 2);
+    if (mode != 3)
+    {
+      writer->SetCompressorTypeToNone();
+    }
+    vtkTestCheckMacro(writer->Write());
+
+    vtkSmartPointer<vtkImageData> mapped = ReadImage(fileName, true);
+    vtkTestCheckMacro(SameArrays(image->GetPointData(),
+      mapped->GetPointData()) == 0);
+
+    // Modifying and growing the arrays leaves the file unchanged.
+    vtkDataArray *array = mapped->GetPointData()->GetArray("Vectors");
+    array->SetComponent(0, 0, -1.0);
+    vtkTestCheckMacro(array->GetComponent(0, 0) == -1.0);
+    array->InsertNextTuple3(1.0, 2.0, 3.0);
+    vtkTestCheckMacro(array->GetComponent(numPts, 2) == 3.0);
+    vtkTestCheckMacro(array->GetComponent(1, 1) == vectors->GetComponent(1, 1));
+    vtkTestCheckMacro(SameArrays(image->GetPointData(),
+      ReadImage(fileName, true)->GetPointData()) == 0);
+    vtkTestCheckMacro(SameArrays(image->GetPointData(),
+      ReadImage(fileName, false)->GetPointData()) == 0);
+  }
+
+  // The raw data is only padded when aligned.
+  unsigned long rawSizes[2];
+  for (int align = 0; align < 2; ++align)
+  {
+    std::string fileName = tempDir + "/TestXMLMappedAppendedData.vti";
+    vtkNew<vtkXMLImageDataWriter> writer;
+    writer->SetInputData(image.GetPointer());
+    writer->SetFileName(fileName.c_str());
+    writer->SetDataModeToAppended();
+    writer->SetAlignAppendedData(align);
+    writer->EncodeAppendedDataOff();
+    writer->SetCompressorTypeToNone();
+    vtkTestCheckMacro(writer->Write());
+    rawSizes[align] = vtksys::SystemTools::FileLength(fileName);
+  }
+  vtkTestCheckMacro(rawSizes[1] > rawSizes[0]);
+  return 0;
+}
+
+int TestGrid(const std::string &tempDir)
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  vtkNew<vtkPoints> points;
+  const vtkIdType numCells = 500;
+  for (vtkIdType i = 0; i < numCells + 3; ++i)
+  {
+    points->InsertNextPoint(std::cos(0.1 * i), std::sin(0.1 * i), 0.01 * i);
+  }
+  grid->SetPoints(points.GetPointer());
+  grid->Allocate(numCells);
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    vtkIdType pts[4] = { i, i + 1, i + 2, i + 3 };
+    grid->InsertNextCell(i % 2 ? VTK_TETRA : VTK_TRIANGLE, i % 2 ? 4 : 3,
+                         pts);
+  }
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  ints->SetNumberOfTuples(numCells);
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    ints->SetValue(i, static_cast<int>(i * 7919 % 1000) - 500);
+  }
+  grid->GetCellData()->AddArray(ints.GetPointer());
+
+  std::string fileName = tempDir + "/TestXMLMappedAppendedData.vtu";
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetInputData(grid.GetPointer());
+  writer->SetFileName(fileName.c_str());
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->AlignAppendedDataOn();
+  writer->SetCompressorTypeToNone();
+  vtkTestCheckMacro(writer->Write());
+
+  // The arrays outlive the reader that mapped them.
+  vtkSmartPointer<vtkUnstructuredGrid> mapped = ReadGrid(fileName, true);
+  vtkSmartPointer<vtkUnstructuredGrid> read = ReadGrid(fileName, false);
+  vtkTestCheckMacro(mapped->GetNumberOfCells() == numCells);
+  vtkTestCheckMacro(
+    SameArrays(read->GetCellData(), mapped->GetCellData()) == 0);
+  vtkTestCheckMacro(
+    SameArrays(grid->GetCellData(), mapped->GetCellData()) == 0);
+  for (vtkIdType i = 0; i < mapped->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    mapped->GetPoint(i, x);
+    grid->GetPoint(i, y);
+    vtkTestCheckMacro(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+  }
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    vtkTestCheckMacro(mapped->GetCellType(i) == grid->GetCellType(i));
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestXMLMappedAppendedData(int argc, char *argv[])
+{
+  char *tempDirC = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string tempDir = tempDirC;
+  delete [] tempDirC;
+
+  vtkTestCheckMacro(TestImage(tempDir) == 0);
+  vtkTestCheckMacro(TestGrid(tempDir) == 0);
+  return 0;
+}
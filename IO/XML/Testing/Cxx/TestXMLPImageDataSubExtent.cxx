@@ -0,0 +1,212 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLPImageDataSubExtent.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that slabs, rows and probes of a partitioned image with compressed
+// data are read correctly, for the selected arrays only, and without
+// opening the pieces they do not overlap.
+
+#include "vtkDataArraySelection.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTestCheck.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLPImageDataReader.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace
+{
+
+double Value(int i, int j, int k, int c)
+{
+  return std::sin(0.1 * i) + std::cos(0.2 * j) * k + c;
+}
+
+// The image of the given extent, with a scalar and a vector array.
+void MakePiece(vtkImageData *image, const int extent[6])
+{
+  image->SetExtent(const_cast<int*>(extent));
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkIdType id = 0;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i, ++id)
+      {
+        scalars->SetValue(id, static_cast<float>(Value(i, j, k, 0)));
+        vectors->SetTuple3(id, Value(i, j, k, 1), Value(i, j, k, 2),
+                           Value(i, j, k, 3));
+      }
+    }
+  }
+  image->GetPointData()->AddArray(scalars.GetPointer());
+  image->GetPointData()->AddArray(vectors.GetPointer());
+}
+
+// Write the image as two pieces split along z, and the summary file
+// that refers to them.
+int Write(const std::string &prefix, int dataMode, bool encode)
+{
+  const int pieceExtents[2][6] =
+  {
+    { 0, 39, 0, 29, 0, 9 },
+    { 0, 39, 0, 29, 9, 19 }
+  };
+  std::ofstream summary((prefix + ".pvti").c_str());
+  summary <<
+    "<?xml version=\"1.0\"?>\n"
+    "<VTKFile type=\"PImageData\" version=\"1.0\">\n"
+    "  <PImageData WholeExtent=\"0 39 0 29 0 19\" GhostLevel=\"0\""
+    " Origin=\"0 0 0\" Spacing=\"1 1 1\">\n"
+    "    <PPointData>\n"
+    "      <PDataArray type=\"Float32\" Name=\"Scalars\"/>\n"
+    "      <PDataArray type=\"Float64\" Name=\"Vectors\""
+    " NumberOfComponents=\"3\"/>\n"
+    "    </PPointData>\n";
+  for (int p = 0; p < 2; ++p)
+  {
+    char name[64];
+    snprintf(name, sizeof(name), "_%d.vti", p);
+    vtkNew<vtkImageData> piece;
+    MakePiece(piece.GetPointer(), pieceExtents[p]);
+    vtkNew<vtkXMLImageDataWriter> writer;
+    writer->SetInputData(piece.GetPointer());
+    writer->SetFileName((prefix + name).c_str());
+    writer->SetDataMode(dataMode);
+    writer->SetEncodeAppendedData(encode);
+    // Small blocks make the rows of the slabs share blocks.
+    writer->SetBlockSize(1000);
+    vtkTestCheckMacro(writer->Write());
+
+    std::string fileName = prefix + name;
+    summary << "    <Piece Extent=\"" << pieceExtents[p][0];
+    for (int i = 1; i < 6; ++i)
+    {
+      summary << " " << pieceExtents[p][i];
+    }
+    summary << "\" Source=\""
+            << fileName.substr(fileName.find_last_of('/') + 1) << "\"/>\n";
+  }
+  summary << "  </PImageData>\n</VTKFile>\n";
+  return 0;
+}
+
+// Read the extent of the image, with or without its vectors, and check
+// the values read.
+int CheckExtent(vtkXMLPImageDataReader *reader, const int extent[6],
+                bool vectors)
+{
+  if (vectors)
+  {
+    reader->GetPointDataArraySelection()->EnableArray("Vectors");
+  }
+  else
+  {
+    reader->GetPointDataArraySelection()->DisableArray("Vectors");
+  }
+  // The reader hides vtkAlgorithm::UpdateExtent with its own member.
+  vtkAlgorithm *algorithm = reader;
+  vtkTestCheckMacro(algorithm->UpdateExtent(extent));
+  vtkImageData *output = reader->GetOutput();
+  int outExtent[6];
+  output->GetExtent(outExtent);
+  for (int i = 0; i < 6; ++i)
+  {
+    vtkTestCheckMacro(outExtent[i] == extent[i]);
+  }
+  vtkPointData *pd = output->GetPointData();
+  vtkTestCheckMacro(pd->GetNumberOfArrays() == (vectors ? 2 : 1));
+  vtkDataArray *scalarArray = pd->GetArray("Scalars");
+  vtkDataArray *vectorArray = pd->GetArray("Vectors");
+  vtkTestCheckMacro(scalarArray);
+  vtkTestCheckMacro(!vectors || vectorArray);
+  vtkIdType id = 0;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i, ++id)
+      {
+        vtkTestCheckMacro(scalarArray->GetComponent(id, 0) ==
+          static_cast<float>(Value(i, j, k, 0)));
+        for (int c = 0; vectors && c < 3; ++c)
+        {
+          vtkTestCheckMacro(vectorArray->GetComponent(id, c) ==
+            Value(i, j, k, c + 1));
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestXMLPImageDataSubExtent(int argc, char *argv[])
+{
+  char *tempDirC = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string prefix = std::string(tempDirC) + "/TestXMLPImageDataSubExtent";
+  delete [] tempDirC;
+
+  // Slabs across both pieces, rows and probes within one of them, the
+  // whole image, and the same row twice.
+  const int extents[7][6] =
+  {
+    { 0, 39, 0, 29, 8, 11 },
+    { 0, 39, 12, 12, 0, 19 },
+    { 5, 17, 3, 25, 2, 6 },
+    { 21, 21, 0, 29, 0, 19 },
+    { 0, 39, 0, 29, 0, 19 },
+    { 7, 7, 7, 7, 15, 15 },
+    { 7, 7, 7, 7, 15, 15 }
+  };
+
+  // Appended raw and base64 encoded data, and inline binary data.
+  for (int mode = 0; mode < 3; ++mode)
+  {
+    vtkTestCheckMacro(Write(prefix,
+      mode == 2 ? vtkXMLWriter::Binary : vtkXMLWriter::Appended,
+      mode == 1) == 0);
+    vtkNew<vtkXMLPImageDataReader> reader;
+    reader->SetFileName((prefix + ".pvti").c_str());
+    for (int e = 0; e < 7; ++e)
+    {
+      vtkTestCheckMacro(
+        CheckExtent(reader.GetPointer(), extents[e], e % 2 == 0) == 0);
+    }
+  }
+
+  // The first piece is not needed for extents within the second one.
+  std::remove((prefix + "_0.vti").c_str());
+  vtkNew<vtkXMLPImageDataReader> reader;
+  reader->SetFileName((prefix + ".pvti").c_str());
+  vtkTestCheckMacro(CheckExtent(reader.GetPointer(), extents[5], true) == 0);
+
+  return 0;
+}
@@ -474,6 +474,7 @@ void vtkXMLCompositeDataWriter::CreateWriters(vtkCompositeDataSet* hdInput)
       writer->SetBlockSize(this->GetBlockSize());
       writer->SetDataMode(this->GetDataMode());
       writer->SetEncodeAppendedData(this->GetEncodeAppendedData());
+      writer->SetAlignAppendedData(this->GetAlignAppendedData());
       writer->SetHeaderType(this->GetHeaderType());
       writer->SetIdType(this->GetIdType());
 
@@ -27,11 +27,41 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
-
+#include "vtkXMLLazyDataArrayTemplate.h"
 
 #include <cassert>
 
 
+namespace
+{
+//----------------------------------------------------------------------------
+template <class ValueType>
+vtkAbstractArray* vtkXMLDataReaderNewLazyArray(ValueType*,
+  vtkAbstractArray* prototype, vtkXMLDataParser* parser,
+  vtkXMLDataElement* da, const char* fileName, vtkIdType numTuples)
+{
+  vtkXMLLazyDataArrayTemplate<ValueType>* array =
+    vtkXMLLazyDataArrayTemplate<ValueType>::New();
+  array->SetName(prototype->GetName());
+  array->SetNumberOfComponents(prototype->GetNumberOfComponents());
+  array->CopyComponentNames(prototype);
+  array->CopyInformation(prototype->GetInformation());
+  array->SetSource(parser, da, fileName, numTuples);
+  return array;
+}
+
+//----------------------------------------------------------------------------
+bool vtkXMLDataReaderIsLazyArray(vtkAbstractArray* array)
+{
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(
+      return dynamic_cast<vtkXMLLazyDataArrayTemplate<VTK_TT>*>(array) != NULL);
+  }
+  return false;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkXMLDataReader::vtkXMLDataReader()
 {
@@ -41,6 +71,7 @@ vtkXMLDataReader::vtkXMLDataReader()
   this->Piece = 0;
   this->NumberOfPointArrays = 0;
   this->NumberOfCellArrays = 0;
+  this->LazyArrayLoading = 0;
 
   // Setup a callback for when the XMLParser's data reading routines
   // report progress.
@@ -82,6 +113,7 @@ vtkXMLDataReader::~vtkXMLDataReader()
 void vtkXMLDataReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "LazyArrayLoading: " << this->LazyArrayLoading << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -270,6 +302,7 @@ void vtkXMLDataReader::SetupOutputData()
   // from one piece because all pieces have the same set of arrays.
   vtkXMLDataElement* ePointData = this->PointDataElements[0];
   vtkXMLDataElement* eCellData = this->CellDataElements[0];
+  int lazy = this->LazyArrayLoading && this->CanCreateLazyArrays();
   this->NumberOfPointArrays = 0;
   if (ePointData)
   {
@@ -280,10 +313,14 @@ void vtkXMLDataReader::SetupOutputData()
           !pointData->HasArray(eNested->GetAttribute("Name")))
       {
         this->NumberOfPointArrays++;
-        vtkAbstractArray* array = this->CreateArray(eNested);
-        if (array)
+        vtkAbstractArray* array = lazy ?
+          this->CreateLazyArray(eNested, pointTuples) : NULL;
+        if (!array && (array = this->CreateArray(eNested)))
         {
           array->SetNumberOfTuples(pointTuples);
+        }
+        if (array)
+        {
           pointData->AddArray(array);
           array->Delete();
         }
@@ -306,10 +343,14 @@ void vtkXMLDataReader::SetupOutputData()
           !cellData->HasArray(eNested->GetAttribute("Name")))
       {
         this->NumberOfCellArrays++;
-        vtkAbstractArray* array = this->CreateArray(eNested);
-        if (array)
+        vtkAbstractArray* array = lazy ?
+          this->CreateLazyArray(eNested, cellTuples) : NULL;
+        if (!array && (array = this->CreateArray(eNested)))
         {
           array->SetNumberOfTuples(cellTuples);
+        }
+        if (array)
+        {
           cellData->AddArray(array);
           array->Delete();
         }
@@ -357,6 +398,44 @@ void vtkXMLDataReader::SetupOutputData()
   }
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataReader::CanCreateLazyArrays()
+{
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractArray* vtkXMLDataReader::CreateLazyArray(vtkXMLDataElement* da,
+                                                   vtkIdType numTuples)
+{
+  // The values are read from the file again, once, and as they are in
+  // the file.  Old ghost level arrays are converted as they are read.
+  const char* name = da->GetAttribute("Name");
+  int dataType = 0;
+  if (!this->IsReadingFromFile() || this->NumberOfTimeSteps > 0 ||
+      da->GetAttribute("TimeStep") ||
+      (name && strcmp(name, "vtkGhostLevels") == 0) ||
+      !da->GetWordTypeAttribute("type", dataType))
+  {
+    return NULL;
+  }
+
+  vtkAbstractArray* prototype = this->CreateArray(da);
+  if (!prototype)
+  {
+    return NULL;
+  }
+  vtkAbstractArray* array = NULL;
+  switch (dataType)
+  {
+    vtkTemplateMacro(
+      array = vtkXMLDataReaderNewLazyArray(static_cast<VTK_TT*>(NULL),
+        prototype, this->XMLParser, da, this->FileName, numTuples));
+  }
+  prototype->Delete();
+  return array;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLDataReader::ReadPiece(vtkXMLDataElement* ePiece, int piece)
 {
@@ -433,7 +512,8 @@ int vtkXMLDataReader::ReadPieceData()
 
           // Read the array.
           vtkAbstractArray* array = pointData->GetAbstractArray(a++);
-          if (array && !this->ReadArrayForPoints(eNested, array))
+          if (array && !vtkXMLDataReaderIsLazyArray(array) &&
+              !this->ReadArrayForPoints(eNested, array))
           {
             if (!this->AbortExecute)
             {
@@ -471,7 +551,9 @@ int vtkXMLDataReader::ReadPieceData()
           this->SetProgressRange(progressRange, currentArray++, numArrays);
 
           // Read the array.
-          if (!this->ReadArrayForCells(eNested, cellData->GetAbstractArray(a++)))
+          vtkAbstractArray* array = cellData->GetAbstractArray(a++);
+          if (!vtkXMLDataReaderIsLazyArray(array) &&
+              !this->ReadArrayForCells(eNested, array))
           {
             vtkErrorMacro("Cannot read cell data array \""
               << cellData->GetAbstractArray(a-1)->GetName() << "\" from "
@@ -51,6 +51,22 @@ public:
   // SetupOutputInformation to outInfo
   void CopyOutputInformation(vtkInformation *outInfo, int port) VTK_OVERRIDE;
 
+  //@{
+  /**
+   * Enable creating the point and cell data arrays of the output as
+   * vtkXMLLazyDataArrayTemplate arrays, which read their values from the
+   * file when first accessed instead of when the reader executes.  The
+   * arrays that are never used then cost neither I/O nor memory.  This
+   * applies to the numeric arrays of a file read from its name, when the
+   * output is a single piece of the file read whole and the file has no
+   * time steps; other arrays are read as usual.  The file must not be
+   * modified while the arrays exist.  The default is off.
+   */
+  vtkSetMacro(LazyArrayLoading, int);
+  vtkGetMacro(LazyArrayLoading, int);
+  vtkBooleanMacro(LazyArrayLoading, int);
+  //@}
+
 protected:
   vtkXMLDataReader();
   ~vtkXMLDataReader() VTK_OVERRIDE;
@@ -77,6 +93,15 @@ protected:
 
   void ReadXMLData() VTK_OVERRIDE;
 
+  // Return whether the output arrays are those of a single piece read
+  // whole, which lazy arrays can stand for.  Valid in SetupOutputData.
+  virtual int CanCreateLazyArrays();
+
+  // Create an array that reads the values of da when first accessed, or
+  // return NULL if the array must be read as usual.
+  vtkAbstractArray* CreateLazyArray(vtkXMLDataElement* da,
+                                    vtkIdType numTuples);
+
   // Read a data array whose tuples coorrespond to points or cells.
   virtual int ReadArrayForPoints(vtkXMLDataElement* da,
                                  vtkAbstractArray* outArray);
@@ -105,6 +130,8 @@ protected:
   int NumberOfPointArrays;
   int NumberOfCellArrays;
 
+  int LazyArrayLoading;
+
   // The observer to report progress from reading data from XMLParser.
   vtkCallbackCommand* DataProgressObserver;
 
@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkXMLLazyDataArrayTemplate.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkXMLLazyDataArrayTemplate
+ * @brief   Array-Of-Structs array that reads its values
+ * from a VTK XML file when they are first accessed.
+ *
+ *
+ * vtkXMLLazyDataArrayTemplate stands for a data array of a VTK XML file
+ * in the output of a reader with LazyArrayLoading on.  It knows its
+ * number of tuples from the start, but reads and decodes its values only
+ * when they are first accessed through any part of the vtkDataArray API,
+ * so the arrays that are never used cost neither I/O nor memory.  After
+ * that it behaves like a vtkAOSDataArrayTemplate, and new instances are
+ * vtkAOSDataArrayTemplate arrays.  The values are read at most once, even
+ * when they are first accessed from several threads.
+ *
+ * @sa
+ * vtkXMLDataReader vtkGenericDataArray vtkAOSDataArrayTemplate
+*/
+
+#ifndef vtkXMLLazyDataArrayTemplate_h
+#define vtkXMLLazyDataArrayTemplate_h
+
+#include "vtkGenericDataArray.h"
+#include "vtkBuffer.h" // For storage
+#include "vtkSimpleCriticalSection.h" // For the first read
+
+#include <algorithm> // For std::copy
+#include <atomic> // For the first read
+#include <string> // For the file name
+
+class vtkXMLDataElement;
+class vtkXMLDataParser;
+
+template <class ValueTypeT>
+class vtkXMLLazyDataArrayTemplate :
+    public vtkGenericDataArray<vtkXMLLazyDataArrayTemplate<ValueTypeT>,
+                               ValueTypeT>
+{
+  typedef vtkGenericDataArray<vtkXMLLazyDataArrayTemplate<ValueTypeT>,
+                              ValueTypeT> GenericDataArrayType;
+public:
+  typedef vtkXMLLazyDataArrayTemplate<ValueTypeT> SelfType;
+  vtkAbstractTemplateTypeMacro(SelfType, GenericDataArrayType)
+  vtkAOSArrayNewInstanceMacro(SelfType)
+  typedef typename Superclass::ValueType ValueType;
+
+  static vtkXMLLazyDataArrayTemplate* New();
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * Make the array hold numTuples tuples that are read from the data
+   * array element da of fileName with parser, the parser that parsed the
+   * file, when first accessed.  The number of components must be set
+   * first.  The parser is kept until then.
+   */
+  void SetSource(vtkXMLDataParser* parser, vtkXMLDataElement* da,
+                 const char* fileName, vtkIdType numTuples);
+
+  /**
+   * Return whether the values have been read, or the array has no
+   * values to read.
+   */
+  bool IsLoaded() const
+  {
+    return this->Loaded.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Get the value at @a valueIdx.  @a valueIdx assumes AOS ordering.
+   */
+  inline ValueType GetValue(vtkIdType valueIdx) const
+  {
+    return this->GetValues()[valueIdx];
+  }
+
+  /**
+   * Set the value at @a valueIdx to @a value.  @a valueIdx assumes AOS
+   * ordering.
+   */
+  inline void SetValue(vtkIdType valueIdx, ValueType value)
+  {
+    this->GetValues()[valueIdx] = value;
+  }
+
+  /**
+   * Copy the tuple at @a tupleIdx into @a tuple.
+   */
+  inline void GetTypedTuple(vtkIdType tupleIdx, ValueType* tuple) const
+  {
+    const ValueType* values =
+      this->GetValues() + tupleIdx * this->NumberOfComponents;
+    std::copy(values, values + this->NumberOfComponents, tuple);
+  }
+
+  /**
+   * Set this array's tuple at @a tupleIdx to the values in @a tuple.
+   */
+  inline void SetTypedTuple(vtkIdType tupleIdx, const ValueType* tuple)
+  {
+    std::copy(tuple, tuple + this->NumberOfComponents,
+              this->GetValues() + tupleIdx * this->NumberOfComponents);
+  }
+
+  /**
+   * Get component @a comp of the tuple at @a tupleIdx.
+   */
+  inline ValueType GetTypedComponent(vtkIdType tupleIdx, int comp) const
+  {
+    return this->GetValues()[this->NumberOfComponents * tupleIdx + comp];
+  }
+
+  /**
+   * Set component @a comp of the tuple at @a tupleIdx to @a value.
+   */
+  inline void SetTypedComponent(vtkIdType tupleIdx, int comp, ValueType value)
+  {
+    this->GetValues()[this->NumberOfComponents * tupleIdx + comp] = value;
+  }
+
+  /**
+   * Read the values if needed and return a pointer to them.
+   */
+  void* GetVoidPointer(vtkIdType valueIdx) VTK_OVERRIDE;
+
+  VTK_NEWINSTANCE vtkArrayIterator* NewIterator() VTK_OVERRIDE;
+
+protected:
+  vtkXMLLazyDataArrayTemplate();
+  ~vtkXMLLazyDataArrayTemplate() VTK_OVERRIDE;
+
+  /**
+   * Allocate space for numTuples.  Old data is not preserved, and are
+   * not read.  If numTuples == 0, all data is freed.
+   */
+  bool AllocateTuples(vtkIdType numTuples);
+
+  /**
+   * Allocate space for numTuples.  Old data is preserved, and are read
+   * first if needed.  If numTuples == 0, all data is freed.
+   */
+  bool ReallocateTuples(vtkIdType numTuples);
+
+  /**
+   * Return the values, reading them first if needed.
+   */
+  ValueType* GetValues() const
+  {
+    if (!this->IsLoaded())
+    {
+      // Reading the values does not change them.
+      const_cast<SelfType*>(this)->Load();
+    }
+    return this->Buffer->GetBuffer();
+  }
+
+  // Read the values, unless another thread did.
+  void Load();
+
+  // Forget the source of the values.
+  void ReleaseSource();
+
+  vtkBuffer<ValueType>* Buffer;
+
+  // Where the values are read from until they are.
+  vtkXMLDataParser* Parser;
+  vtkXMLDataElement* Element;
+  std::string FileName;
+  std::atomic<bool> Loaded;
+  vtkSimpleCriticalSection LoadLock;
+
+private:
+  vtkXMLLazyDataArrayTemplate(const vtkXMLLazyDataArrayTemplate&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkXMLLazyDataArrayTemplate&) VTK_DELETE_FUNCTION;
+
+  friend class vtkGenericDataArray<vtkXMLLazyDataArrayTemplate<ValueTypeT>,
+                                   ValueTypeT>;
+};
+
+#include "vtkXMLLazyDataArrayTemplate.txx"
+
+#endif
+
+// VTK-HeaderTest-Exclude: vtkXMLLazyDataArrayTemplate.h
@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkXMLLazyDataArrayTemplate.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef vtkXMLLazyDataArrayTemplate_txx
+#define vtkXMLLazyDataArrayTemplate_txx
+
+#include "vtkXMLLazyDataArrayTemplate.h"
+
+#include "vtkArrayIteratorTemplate.h"
+#include "vtkObjectFactory.h"
+#include "vtkXMLDataParser.h"
+
+#include <cstring>
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+vtkXMLLazyDataArrayTemplate<ValueType>*
+vtkXMLLazyDataArrayTemplate<ValueType>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkXMLLazyDataArrayTemplate<ValueType>);
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+vtkXMLLazyDataArrayTemplate<ValueType>::vtkXMLLazyDataArrayTemplate()
+  : Buffer(vtkBuffer<ValueType>::New()),
+    Parser(NULL),
+    Element(NULL),
+    Loaded(true)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+vtkXMLLazyDataArrayTemplate<ValueType>::~vtkXMLLazyDataArrayTemplate()
+{
+  this->ReleaseSource();
+  this->Buffer->Delete();
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+void vtkXMLLazyDataArrayTemplate<ValueType>::PrintSelf(ostream& os,
+                                                       vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Loaded: " << this->IsLoaded() << "\n";
+  os << indent << "FileName: " << this->FileName << "\n";
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+void vtkXMLLazyDataArrayTemplate<ValueType>::SetSource(
+  vtkXMLDataParser* parser, vtkXMLDataElement* da, const char* fileName,
+  vtkIdType numTuples)
+{
+  this->ReleaseSource();
+  this->Buffer->Allocate(0);
+  this->Size = numTuples * this->NumberOfComponents;
+  this->MaxId = this->Size - 1;
+  if (this->Size > 0)
+  {
+    // The parser owns the element.
+    this->Parser = parser;
+    this->Parser->Register(this);
+    this->Element = da;
+    this->FileName = fileName;
+    this->Loaded.store(false, std::memory_order_release);
+  }
+  this->DataChanged();
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+void vtkXMLLazyDataArrayTemplate<ValueType>::ReleaseSource()
+{
+  if (this->Parser)
+  {
+    this->Parser->UnRegister(this);
+    this->Parser = NULL;
+  }
+  this->Element = NULL;
+  this->FileName.clear();
+  this->Loaded.store(true, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+void vtkXMLLazyDataArrayTemplate<ValueType>::Load()
+{
+  this->LoadLock.Lock();
+  if (!this->IsLoaded())
+  {
+    vtkIdType numValues = this->Size;
+    if (!this->Buffer->Allocate(numValues))
+    {
+      vtkErrorMacro("Error allocating " << numValues << " values for array "
+                    << (this->Name ? this->Name : "") << ".");
+    }
+    else if (this->Parser->ReadDataArrayFromFile(
+               this->FileName.c_str(), this->Element, this->Buffer->GetBuffer(),
+               static_cast<size_t>(numValues), this->GetDataType()) !=
+             static_cast<size_t>(numValues))
+    {
+      vtkErrorMacro("Cannot read the values of array "
+                    << (this->Name ? this->Name : "") << " from "
+                    << this->FileName << ".");
+      memset(this->Buffer->GetBuffer(), 0, numValues * sizeof(ValueType));
+    }
+    this->ReleaseSource();
+  }
+  this->LoadLock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+void* vtkXMLLazyDataArrayTemplate<ValueType>::GetVoidPointer(
+  vtkIdType valueIdx)
+{
+  return this->GetValues() + valueIdx;
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+vtkArrayIterator* vtkXMLLazyDataArrayTemplate<ValueType>::NewIterator()
+{
+  vtkArrayIterator* iter = vtkArrayIteratorTemplate<ValueType>::New();
+  iter->Initialize(this);
+  return iter;
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+bool vtkXMLLazyDataArrayTemplate<ValueType>::AllocateTuples(
+  vtkIdType numTuples)
+{
+  this->ReleaseSource();
+  vtkIdType numValues = numTuples * this->GetNumberOfComponents();
+  if (this->Buffer->Allocate(numValues))
+  {
+    this->Size = this->Buffer->GetSize();
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+template<class ValueType>
+bool vtkXMLLazyDataArrayTemplate<ValueType>::ReallocateTuples(
+  vtkIdType numTuples)
+{
+  if (numTuples == 0)
+  {
+    this->ReleaseSource();
+  }
+  else if (!this->IsLoaded())
+  {
+    this->Load();
+  }
+  if (this->Buffer->Reallocate(numTuples * this->GetNumberOfComponents()))
+  {
+    this->Size = this->Buffer->GetSize();
+    return true;
+  }
+  return false;
+}
+
+#endif // header guard
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkXMLReader.h"
 
+#include "vtkAOSDataArrayTemplate.h"
 #include "vtkArrayIteratorIncludes.h"
 #include "vtkCallbackCommand.h"
 #include "vtkDataArraySelection.h"
@@ -41,6 +42,7 @@
 #include "vtkXMLDataParser.h"
 #include "vtkXMLFileReadTester.h"
 #include "vtkXMLReaderVersion.h"
+#include "vtkZFPDataCompressor.h"
 #include "vtkZLibDataCompressor.h"
 
 #include <algorithm>
@@ -104,6 +106,7 @@ vtkXMLReader::vtkXMLReader()
   this->StringStream = 0;
   this->ReadFromInputString = 0;
   this->InputString = "";
+  this->MemoryMapAppendedData = 0;
   this->XMLParser = 0;
   this->ReaderErrorObserver = 0;
   this->ParserErrorObserver = 0;
@@ -184,6 +187,8 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
      << "\n";
   os << indent << "PointDataArraySelection: " << this->PointDataArraySelection
      << "\n";
+  os << indent << "MemoryMapAppendedData: " << this->MemoryMapAppendedData
+     << "\n";
   if (this->Stream)
   {
     os << indent << "Stream: " << this->Stream << "\n";
@@ -416,6 +421,10 @@ void vtkXMLReader::SetupCompressor(const char* type)
     {
       compressor = vtkLZ4DataCompressor::New();
     }
+    else if (strcmp(type, "vtkZFPDataCompressor") == 0)
+    {
+      compressor = vtkZFPDataCompressor::New();
+    }
   }
 
   if (!compressor)
@@ -786,6 +795,28 @@ int vtkXMLDataReaderReadArrayValues(
   return result;
 }
 
+//----------------------------------------------------------------------------
+template <class ValueType>
+int vtkXMLReaderMapArrayValues(vtkXMLDataParser* xmlparser,
+  const char* fileName, vtkTypeInt64 offset,
+  vtkAOSDataArrayTemplate<ValueType>* array)
+{
+  if (!array)
+  {
+    return 0;
+  }
+  vtkIdType numValues = array->GetNumberOfValues();
+  void* data = xmlparser->MapAppendedData(fileName, offset, numValues,
+    array->GetDataType());
+  if (!data)
+  {
+    return 0;
+  }
+  array->SetArray(static_cast<ValueType*>(data), numValues, 1);
+  array->SetArrayFreeFunction(vtkXMLDataParser::FreeMappedData);
+  return 1;
+}
+
 }
 
 //----------------------------------------------------------------------------
@@ -801,19 +832,28 @@ int vtkXMLReader::ReadArrayValues(
   }
   this->InReadData = 1;
   int result;
-  // All arrays types except vtkBitArray.
-  vtkArrayIterator* iter = array->NewIterator();
-  switch (array->GetDataType())
+  if (this->MemoryMapAppendedData && arrayIndex == 0 && startIndex == 0 &&
+      numValues == array->GetNumberOfValues() &&
+      this->MapArrayValues(da, array))
   {
-    vtkArrayIteratorTemplateMacro(
-      result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-        arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-  default:
-    result = 0;
+    result = 1;
   }
-  if (iter)
+  else
   {
-    iter->Delete();
+    // All arrays types except vtkBitArray.
+    vtkArrayIterator* iter = array->NewIterator();
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
+          arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+    default:
+      result = 0;
+    }
+    if (iter)
+    {
+      iter->Delete();
+    }
   }
 
   this->ConvertGhostLevelsToGhostType(fieldType, array, startIndex, numValues);
@@ -829,6 +869,37 @@ int vtkXMLReader::ReadArrayValues(
   return result;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLReader::MapArrayValues(vtkXMLDataElement* da,
+                                 vtkAbstractArray* array)
+{
+  // The data must be appended to the file this reader opened, and be of
+  // the type of the array.
+  vtkTypeInt64 offset = 0;
+  int dataType = 0;
+  if (!this->IsReadingFromFile() || array->GetNumberOfValues() == 0 ||
+      !da->GetScalarAttribute("offset", offset) ||
+      !da->GetWordTypeAttribute("type", dataType) ||
+      dataType != array->GetDataType())
+  {
+    return 0;
+  }
+  switch (dataType)
+  {
+    vtkTemplateMacro(
+      return vtkXMLReaderMapArrayValues(this->XMLParser, this->FileName,
+        offset, vtkAOSDataArrayTemplate<VTK_TT>::FastDownCast(array)));
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLReader::IsReadingFromFile()
+{
+  return !this->ReadFromInputString && this->FileName &&
+    this->FileStream && this->Stream == this->FileStream;
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLReader::ReadXMLData()
 {
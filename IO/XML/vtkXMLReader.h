@@ -72,6 +72,22 @@ public:
   void SetInputString(std::string s) { this->InputString = s; }
   //@}
 
+  //@{
+  /**
+   * Enable mapping the raw appended data of the arrays read from the file
+   * into memory instead of reading it.  The arrays then point directly
+   * into the file, whose pages are loaded when first accessed and copied
+   * on write.  This applies to arrays read whole, in the native byte
+   * order and without compression or encoding, on platforms with mmap;
+   * other arrays are read as usual, as are arrays whose values are not
+   * aligned in the file (see vtkXMLWriter::AlignAppendedData).  The file
+   * must not be modified while the arrays exist.  The default is off.
+   */
+  vtkSetMacro(MemoryMapAppendedData, int);
+  vtkGetMacro(MemoryMapAppendedData, int);
+  vtkBooleanMacro(MemoryMapAppendedData, int);
+  //@}
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -272,6 +288,14 @@ protected:
     vtkXMLDataElement* da, vtkIdType arrayIndex, vtkAbstractArray* array,
     vtkIdType startIndex, vtkIdType numValues, FieldType type = OTHER);
 
+  // Map the appended data of a whole array into memory as its values.
+  // Returns 0 if the data cannot be mapped and must be read.
+  int MapArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array);
+
+  // Return whether the input is the file FileName, which can be opened
+  // again, rather than a string or a stream given by the user.
+  int IsReadingFromFile();
+
   // Setup the data array selections for the input's set of arrays.
   void SetDataArraySelections(vtkXMLDataElement* eDSA,
                               vtkDataArraySelection* sel);
@@ -310,6 +334,9 @@ protected:
   // The input string.
   std::string InputString;
 
+  // Whether to map raw appended data into memory instead of reading it.
+  int MemoryMapAppendedData;
+
   // The array selections.
   vtkDataArraySelection* PointDataArraySelection;
   vtkDataArraySelection* CellDataArraySelection;
@@ -22,6 +22,8 @@
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
 
+#include <algorithm>
+
 
 //----------------------------------------------------------------------------
 vtkXMLStructuredDataReader::vtkXMLStructuredDataReader()
@@ -340,6 +342,16 @@ void vtkXMLStructuredDataReader::ReadXMLData()
   this->SetOutputExtent(this->UpdateExtent);
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLStructuredDataReader::CanCreateLazyArrays()
+{
+  // The output arrays are set up from the first piece, so they can only
+  // stand for the arrays of the file when it is the only piece, and is
+  // read as a whole.
+  return this->NumberOfPieces == 1 &&
+    std::equal(this->PieceExtents, this->PieceExtents + 6, this->UpdateExtent);
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLStructuredDataReader::ReadArrayForPoints(vtkXMLDataElement* da,
                                                    vtkAbstractArray* outArray)
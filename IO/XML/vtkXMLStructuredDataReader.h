@@ -106,6 +106,7 @@ protected:
   void SetupEmptyOutput() VTK_OVERRIDE;
   void SetupPieces(int numPieces) VTK_OVERRIDE;
   void DestroyPieces() VTK_OVERRIDE;
+  int CanCreateLazyArrays() VTK_OVERRIDE;
   int ReadArrayForPoints(vtkXMLDataElement* da,
     vtkAbstractArray* outArray) VTK_OVERRIDE;
   int ReadArrayForCells(vtkXMLDataElement* da,
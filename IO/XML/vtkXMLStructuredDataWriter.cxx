@@ -583,17 +583,21 @@ void vtkXMLStructuredDataWriter::WriteAppendedPieceData(int index)
 
   // Set the range of progress for the point data arrays.
   this->SetProgressRange(progressRange, 0, fractions);
+  this->SetArrayDimensions(ext, 0);
   this->WritePointDataAppendedData(input->GetPointData(), this->CurrentTimeIndex,
                                    &this->PointDataOM->GetPiece(index));
   if (this->ErrorCode == vtkErrorCode::OutOfDiskSpaceError)
   {
+    this->SetArrayDimensions(NULL, 0);
     return;
   }
 
   // Set the range of progress for the cell data arrays.
   this->SetProgressRange(progressRange, 1, fractions);
+  this->SetArrayDimensions(ext, 1);
   this->WriteCellDataAppendedData(input->GetCellData(), this->CurrentTimeIndex,
                                   &this->CellDataOM->GetPiece(index));
+  this->SetArrayDimensions(NULL, 0);
 }
 
 //----------------------------------------------------------------------------
@@ -601,6 +605,7 @@ void vtkXMLStructuredDataWriter::WriteInlinePiece(vtkIndent indent)
 {
   // Write the point data and cell data arrays.
   vtkDataSet* input = this->GetInputAsDataSet();
+  int* ext = input->GetInformation()->Get(vtkDataObject::DATA_EXTENT());
 
   // Split progress between point data and cell data arrays.
   float progressRange[2] = { 0.f, 0.f };
@@ -617,15 +622,33 @@ void vtkXMLStructuredDataWriter::WriteInlinePiece(vtkIndent indent)
 
   // Set the range of progress for the point data arrays.
   this->SetProgressRange(progressRange, 0, fractions);
+  this->SetArrayDimensions(ext, 0);
   this->WritePointDataInline(input->GetPointData(), indent);
   if (this->ErrorCode == vtkErrorCode::OutOfDiskSpaceError)
   {
+    this->SetArrayDimensions(NULL, 0);
     return;
   }
 
   // Set the range of progress for the cell data arrays.
   this->SetProgressRange(progressRange, 1, fractions);
+  this->SetArrayDimensions(ext, 1);
   this->WriteCellDataInline(input->GetCellData(), indent);
+  this->SetArrayDimensions(NULL, 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkXMLStructuredDataWriter::SetArrayDimensions(int* extent, int cells)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    int dim = extent ? extent[2*i+1] - extent[2*i] + 1 : 0;
+    if (cells && dim > 1)
+    {
+      --dim;
+    }
+    this->ArrayDimensions[i] = dim;
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -91,6 +91,10 @@ protected:
   virtual void DeletePositionArrays();
 
   virtual int WriteInlineMode(vtkIndent indent);
+  // Set the dimensions of the point or cell arrays of the given extent
+  // for the compressor, or clear them when extent is NULL.
+  void SetArrayDimensions(int* extent, int cells);
+
   vtkIdType GetStartTuple(int* extent, vtkIdType* increments,
                           int i, int j, int k);
   void CalculatePieceFractions(float* fractions);
@@ -408,6 +408,15 @@ void vtkXMLUnstructuredDataReader::SetupOutputData()
   points->Delete();
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLUnstructuredDataReader::CanCreateLazyArrays()
+{
+  // The output arrays are set up from the first piece, so they can only
+  // stand for the arrays of the file when it is the only piece read.
+  return this->NumberOfPieces == 1 && this->StartPiece == 0 &&
+    this->EndPiece == 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLUnstructuredDataReader::ReadPiece(vtkXMLDataElement* ePiece)
 {
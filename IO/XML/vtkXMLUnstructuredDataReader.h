@@ -93,6 +93,7 @@ protected:
   void SetupOutputInformation(vtkInformation *outInfo) VTK_OVERRIDE;
 
   void SetupOutputData() VTK_OVERRIDE;
+  int CanCreateLazyArrays() VTK_OVERRIDE;
   int ReadPiece(vtkXMLDataElement* ePiece) VTK_OVERRIDE;
   int ReadPieceData() VTK_OVERRIDE;
   int ReadCellArray(vtkIdType numberOfCells, vtkIdType totalNumberOfCells,
@@ -41,9 +41,13 @@
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSimpleCriticalSection.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
+#include "vtkZFPDataCompressor.h"
 #include "vtkZLibDataCompressor.h"
 #define vtkXMLOffsetsManager_DoNotInclude
 #include "vtkXMLOffsetsManager.h"
@@ -57,11 +61,13 @@
 #include "vtkQuadratureSchemeDefinition.h"
 #include "vtkInformationStringKey.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 # include <unistd.h> /* unlink */
@@ -88,6 +94,15 @@ public:
  {
    return writer->WriteBinaryDataBlock(in_data, numWords, wordType);
  }
+ static inline int WriteCompressionBlocks(vtkXMLWriter* writer,
+   unsigned char* in_data, size_t numWords, int wordType)
+ {
+   return writer->WriteCompressionBlocks(in_data, numWords, wordType);
+ }
+ static inline vtkDataCompressor* GetCompressor(vtkXMLWriter* writer)
+ {
+   return writer->Compressor;
+ }
  static inline void* GetInt32IdTypeBuffer(vtkXMLWriter* writer)
  {
    return static_cast<void*>(writer->Int32IdTypeBuffer);
@@ -125,6 +140,15 @@ struct WriteBinaryDataBlockWorker
     // Get the raw pointer to the array data:
     ValueType *iter = array->GetPointer(0);
 
+    // Compressed blocks can be compressed concurrently.
+    if (vtkXMLWriterHelper::GetCompressor(this->Writer))
+    {
+      this->Result = vtkXMLWriterHelper::WriteCompressionBlocks(
+        this->Writer, reinterpret_cast<unsigned char*>(iter), this->NumWords,
+        this->WordType) != 0;
+      return;
+    }
+
     // generic implementation for fixed component length arrays.
     size_t blockWords = this->Writer->GetBlockSize() / this->OutWordSize;
     size_t memBlockSize = blockWords * this->MemWordSize;
@@ -420,10 +444,14 @@ vtkXMLWriter::vtkXMLWriter()
   this->BlockSize = 32768; //2^15
   this->Compressor = vtkZLibDataCompressor::New();
   this->CompressionHeader = 0;
+  this->ArrayDimensions[0] = 0;
+  this->ArrayDimensions[1] = 0;
+  this->ArrayDimensions[2] = 0;
   this->Int32IdTypeBuffer = 0;
   this->ByteSwapBuffer = 0;
 
   this->EncodeAppendedData = 1;
+  this->AlignAppendedData = 0;
   this->AppendedDataPosition = 0;
   this->DataMode = vtkXMLWriter::Appended;
   this->ProgressRange[0] = 0;
@@ -488,6 +516,16 @@ void vtkXMLWriter::SetCompressorType(int compressorType)
     this->Compressor = vtkLZ4DataCompressor::New();
     this->Modified();
   }
+  else if (compressorType == ZFP)
+  {
+    if (this->Compressor &&
+        !this->Compressor->IsTypeOf("vtkZFPDataCompressor"))
+    {
+      this->Compressor->Delete();
+    }
+    this->Compressor = vtkZFPDataCompressor::New();
+    this->Modified();
+  }
   else
   {
     vtkWarningMacro("Invalid compressorType:" << compressorType);
@@ -537,6 +575,7 @@ void vtkXMLWriter::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "Compressor: (none)\n";
   }
   os << indent << "EncodeAppendedData: " << this->EncodeAppendedData << "\n";
+  os << indent << "AlignAppendedData: " << this->AlignAppendedData << "\n";
   os << indent << "BlockSize: " << this->BlockSize << "\n";
   if (this->Stream)
   {
@@ -1226,10 +1265,64 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
   size_t data_size = a->GetDataSize();
   if (this->Compressor)
   {
+    // zfp compresses floating-point values in the native byte order.  It
+    // works on blocks of 4^d values, so give it whole groups of four rows
+    // or slices of structured arrays.
+    size_t blockSize = this->BlockSize;
+    if (vtkZFPDataCompressor* zfp =
+        vtkZFPDataCompressor::SafeDownCast(this->Compressor))
+    {
+#ifdef VTK_WORDS_BIGENDIAN
+      bool swap = this->ByteOrder != vtkXMLWriter::BigEndian;
+#else
+      bool swap = this->ByteOrder != vtkXMLWriter::LittleEndian;
+#endif
+      bool floating = (wordType == VTK_FLOAT || wordType == VTK_DOUBLE);
+      zfp->SetDataType(floating && !swap ? wordType : VTK_VOID);
+
+      int dims[3] = { 0, 0, 0 };
+      vtkIdType numTuples = static_cast<vtkIdType>(this->ArrayDimensions[0]) *
+        this->ArrayDimensions[1] * this->ArrayDimensions[2];
+      if (floating && !swap && numTuples > 0 &&
+          a->GetNumberOfComponents() == 1 &&
+          a->GetNumberOfTuples() == numTuples)
+      {
+        // units[i] is the size of four layers along the i-th dimension
+        // larger than one: four values, four rows, four slices.
+        size_t units[3] = { 0, 0, 0 };
+        size_t unit = 4 * outWordSize;
+        int numDims = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+          dims[i] = this->ArrayDimensions[i];
+          if (dims[i] > 1)
+          {
+            units[numDims++] = unit;
+            unit *= dims[i];
+          }
+        }
+        // Allow larger blocks than requested, within reason.
+        size_t maxBlockSize = std::max(this->BlockSize,
+                                       static_cast<size_t>(1) << 24);
+        for (int i = numDims - 1; i > 0; --i)
+        {
+          if (units[i] <= maxBlockSize)
+          {
+            this->BlockSize =
+              std::max(this->BlockSize / units[i], static_cast<size_t>(1)) *
+              units[i];
+            break;
+          }
+        }
+      }
+      zfp->SetDimensions(dims);
+    }
+
     // Need to compress the data.  Create compression header.  This
     // reserves enough space in the output.
     if (!this->CreateCompressionHeader(data_size*outWordSize))
     {
+      this->BlockSize = blockSize;
       return 0;
     }
     // Start writing the data.
@@ -1256,6 +1349,7 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
     // Destroy the compression header if it was used.
     delete this->CompressionHeader;
     this->CompressionHeader = 0;
+    this->BlockSize = blockSize;
 
     return result;
   }
@@ -1621,6 +1715,126 @@ int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
   return result;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLWriter::WriteCompressionBlocks(unsigned char* data, size_t numWords,
+                                         int wordType)
+{
+  size_t memWordSize = this->GetWordTypeSize(wordType);
+  size_t outWordSize = this->GetOutputWordTypeSize(wordType);
+  size_t blockWords = this->BlockSize / outWordSize;
+  size_t numBlocks = (numWords + blockWords - 1) / blockWords;
+  bool convert = memWordSize != outWordSize;
+#ifdef VTK_WORDS_BIGENDIAN
+  bool swap = outWordSize > 1 && this->ByteOrder != vtkXMLWriter::BigEndian;
+#else
+  bool swap = outWordSize > 1 && this->ByteOrder != vtkXMLWriter::LittleEndian;
+#endif
+
+  // Compress the blocks in batches, the blocks of a batch in parallel,
+  // and write them in order.  The compressed blocks of a batch take at
+  // most about 64 MB, to bound the memory used.
+  size_t blockSpace =
+    this->Compressor->GetMaximumCompressionSpace(this->BlockSize);
+  size_t batchSize = std::max(static_cast<size_t>(1),
+                              (static_cast<size_t>(1) << 26) / blockSpace);
+  batchSize = std::min(batchSize, numBlocks);
+  bool concurrent = this->Compressor->CanCompressConcurrently();
+  vtkSimpleCriticalSection compressLock;
+  std::vector<std::vector<unsigned char> > compressed(batchSize);
+  std::vector<size_t> compressedSizes(batchSize);
+  vtkSMPThreadLocal<std::vector<unsigned char> > convertBuffers;
+
+  this->SetProgressPartial(0);
+  for (size_t first = 0; first < numBlocks; first += batchSize)
+  {
+    size_t batchBlocks = std::min(batchSize, numBlocks - first);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(batchBlocks),
+      [&](vtkIdType begin, vtkIdType end)
+      {
+        std::vector<unsigned char>& convertBuffer = convertBuffers.Local();
+        for (vtkIdType b = begin; b < end; ++b)
+        {
+          size_t firstWord = (first + b) * blockWords;
+          size_t words = std::min(blockWords, numWords - firstWord);
+          unsigned char* block = data + firstWord * memWordSize;
+
+          // Convert the ids and swap the bytes in a copy of the block.
+          if (convert || swap)
+          {
+            convertBuffer.resize(words * outWordSize);
+#ifdef VTK_USE_64BIT_IDS
+            if (convert)
+            {
+              vtkIdType* ids = reinterpret_cast<vtkIdType*>(block);
+              Int32IdType* out =
+                reinterpret_cast<Int32IdType*>(&convertBuffer[0]);
+              for (size_t i = 0; i < words; ++i)
+              {
+                out[i] = static_cast<Int32IdType>(ids[i]);
+              }
+            }
+            else
+#endif
+            {
+              memcpy(&convertBuffer[0], block, words * outWordSize);
+            }
+            if (swap)
+            {
+              this->PerformByteSwap(&convertBuffer[0], words, outWordSize);
+            }
+            block = &convertBuffer[0];
+          }
+
+          size_t size = words * outWordSize;
+          std::vector<unsigned char>& out = compressed[b];
+          out.resize(this->Compressor->GetMaximumCompressionSpace(size));
+          if (concurrent)
+          {
+            compressedSizes[b] =
+              this->Compressor->Compress(block, size, &out[0], out.size());
+          }
+          else
+          {
+            compressLock.Lock();
+            compressedSizes[b] =
+              this->Compressor->Compress(block, size, &out[0], out.size());
+            compressLock.Unlock();
+          }
+        }
+      });
+
+    // Write the compressed blocks and store their sizes in the
+    // compression header.
+    for (size_t b = 0; b < batchBlocks; ++b)
+    {
+      if (compressedSizes[b] == 0)
+      {
+        vtkErrorMacro("Error compressing block " << first + b << ".");
+        return 0;
+      }
+      int result = this->DataStream->Write(&compressed[b][0],
+                                           compressedSizes[b]);
+      this->Stream->flush();
+      if (this->Stream->fail())
+      {
+        this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+        return 0;
+      }
+      if (!result)
+      {
+        return 0;
+      }
+      this->CompressionHeader->Set(3+this->CompressionBlockNumber++,
+                                   compressedSizes[b]);
+    }
+    this->SetProgressPartial(static_cast<float>(first + batchBlocks) /
+                             numBlocks);
+  }
+  this->SetProgressPartial(1);
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionHeader()
 {
@@ -2218,6 +2432,20 @@ void vtkXMLWriter::WriteArrayAppendedData(vtkAbstractArray* a,
                                           vtkTypeInt64 pos,
                                           vtkTypeInt64& lastoffset)
 {
+  // Start the values of raw arrays at a multiple of the largest word size
+  // in the file so that readers can map them into memory in place.
+  if (this->AlignAppendedData && !this->EncodeAppendedData &&
+      !this->Compressor)
+  {
+    ostream& os = *(this->Stream);
+    vtkTypeInt64 headerSize =
+      (this->HeaderType == vtkXMLWriter::UInt64) ? 8 : 4;
+    vtkTypeInt64 dataStart = static_cast<vtkTypeInt64>(os.tellp()) + headerSize;
+    for (; dataStart % 8 != 0; ++dataStart)
+    {
+      os.put('\0');
+    }
+  }
   this->WriteAppendedDataOffset(pos, lastoffset, "offset");
   this->WriteBinaryData(a);
 }
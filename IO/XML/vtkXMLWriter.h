@@ -138,6 +138,9 @@ public:
   /**
    * Get/Set the compressor used to compress binary and appended data
    * before writing to the file.  Default is a vtkZLibDataCompressor.
+   * The blocks of an array are compressed concurrently with vtkSMPTools
+   * when the compressor's CanCompressConcurrently() returns true, and one
+   * at a time otherwise.
    */
   virtual void SetCompressor(vtkDataCompressor*);
   vtkGetObjectMacro(Compressor, vtkDataCompressor);
@@ -147,12 +150,15 @@ public:
   {
     NONE,
     ZLIB,
-    LZ4
+    LZ4,
+    ZFP
   };
 
   //@{
   /**
    * Convenience functions to set the compressor to certain known types.
+   * ZFP is lossless unless a lossy mode is selected on the compressor:
+   * see vtkZFPDataCompressor.
    */
   void SetCompressorType(int compressorType);
   void SetCompressorTypeToNone()
@@ -167,6 +173,10 @@ public:
   {
     this->SetCompressorType(ZLIB);
   }
+  void SetCompressorTypeToZFP()
+  {
+    this->SetCompressorType(ZFP);
+  }
   //@}
 
   //@{
@@ -206,6 +216,20 @@ public:
   vtkBooleanMacro(EncodeAppendedData, int);
   //@}
 
+  //@{
+  /**
+   * Get/Set whether the values of each array in raw, uncompressed
+   * appended data start at a multiple of 8 bytes in the file.  The
+   * writer then pads the appended data section with zero bytes, which
+   * lets vtkXMLReader::MemoryMapAppendedData map the arrays in place.
+   * Padded files are still read by readers that do not know about it,
+   * as arrays are located by their offsets.  The default is off.
+   */
+  vtkSetMacro(AlignAppendedData, int);
+  vtkGetMacro(AlignAppendedData, int);
+  vtkBooleanMacro(AlignAppendedData, int);
+  //@}
+
   //@{
   /**
    * Assign a data object as input. Note that this method does not
@@ -292,6 +316,9 @@ protected:
   // Whether to base64-encode the appended data section.
   int EncodeAppendedData;
 
+  // Whether to align the arrays of raw appended data on 8 bytes.
+  int AlignAppendedData;
+
   // The stream position at which appended data starts.
   vtkTypeInt64 AppendedDataPosition;
 
@@ -324,6 +351,11 @@ protected:
   vtkXMLDataHeader* CompressionHeader;
   vtkTypeInt64 CompressionHeaderPosition;
 
+  // Dimensions of the point or cell arrays being written when they are
+  // structured, for compressors that take the layout of the values into
+  // account.  All zero otherwise.
+  int ArrayDimensions[3];
+
   // The output stream used to write binary and appended data.  May
   // transparently encode the data.
   vtkOutputStream* DataStream;
@@ -458,6 +490,8 @@ protected:
   void PerformByteSwap(void* data, size_t numWords, size_t wordSize);
   int CreateCompressionHeader(size_t size);
   int WriteCompressionBlock(unsigned char* data, size_t size);
+  int WriteCompressionBlocks(unsigned char* data, size_t numWords,
+                             int wordType);
   int WriteCompressionHeader();
   size_t GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
@@ -20,16 +20,28 @@
 #include "vtkDataCompressor.h"
 #include "vtkInputStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkSimpleCriticalSection.h"
 #include "vtkXMLDataElement.h"
 #define vtkXMLDataHeaderPrivate_DoNotInclude
 #include "vtkXMLDataHeaderPrivate.h"
 #undef vtkXMLDataHeaderPrivate_DoNotInclude
 
+#include <algorithm>
+#include <locale>
+#include <map>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 #include "vtkXMLUtilities.h"
 
+#if !defined(_WIN32)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
 
 vtkStandardNewMacro(vtkXMLDataParser);
 vtkCxxSetObjectMacro(vtkXMLDataParser, Compressor, vtkDataCompressor);
@@ -50,6 +62,10 @@ vtkXMLDataParser::vtkXMLDataParser()
   this->BlockCompressedSizes = 0;
   this->BlockStartOffsets = 0;
   this->Compressor = 0;
+  this->CompressionHeaderPosition = -1;
+  this->CompressedDataPosition = -1;
+  this->CachedBlock = 0;
+  this->CachedBlockIndex = -1;
 
   this->AsciiDataBuffer = 0;
   this->AsciiDataBufferLength = 0;
@@ -83,6 +99,7 @@ vtkXMLDataParser::~vtkXMLDataParser()
   this->AppendedDataStream->Delete();
   delete [] this->BlockCompressedSizes;
   delete [] this->BlockStartOffsets;
+  delete [] this->CachedBlock;
   this->SetCompressor(0);
   if(this->AsciiDataBuffer) { this->FreeAsciiBuffer(); }
 }
@@ -116,6 +133,10 @@ int vtkXMLDataParser::Parse()
   // Delete any elements left from previous parsing.
   this->FreeAllElements();
 
+  // Forget the data read from the previous input.
+  this->CompressionHeaderPosition = -1;
+  this->CachedBlockIndex = -1;
+
   // Parse the input from the stream.
   int result = this->Superclass::Parse();
 
@@ -534,6 +555,30 @@ int vtkXMLDataParser::ReadCompressionHeader()
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadCachedCompressionHeader()
+{
+  vtkTypeInt64 position = this->TellG();
+  if(position >= 0 && position == this->CompressionHeaderPosition)
+  {
+    // Skip the header, which is the same.
+    this->SeekG(this->CompressedDataPosition);
+    return 1;
+  }
+
+  this->CompressionHeaderPosition = -1;
+  this->CachedBlockIndex = -1;
+  delete [] this->CachedBlock;
+  this->CachedBlock = 0;
+  if(!this->ReadCompressionHeader())
+  {
+    return 0;
+  }
+  this->CompressionHeaderPosition = position;
+  this->CompressedDataPosition = this->TellG();
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 size_t vtkXMLDataParser::FindBlockSize(vtkTypeUInt64 block)
 {
@@ -587,6 +632,69 @@ unsigned char* vtkXMLDataParser::ReadBlock(vtkTypeUInt64 block)
   return decompressBuffer;
 }
 
+//----------------------------------------------------------------------------
+unsigned char* vtkXMLDataParser::ReadCachedBlock(vtkTypeUInt64 block)
+{
+  if(this->CachedBlockIndex == static_cast<vtkTypeInt64>(block))
+  {
+    return this->CachedBlock;
+  }
+
+  // All blocks but the last have the same size, so the buffer can hold
+  // any of them.
+  if(!this->CachedBlock)
+  {
+    this->CachedBlock = new unsigned char[this->BlockUncompressedSize];
+  }
+  this->CachedBlockIndex = -1;
+  if(!this->ReadBlock(block, this->CachedBlock))
+  {
+    return 0;
+  }
+  this->CachedBlockIndex = static_cast<vtkTypeInt64>(block);
+  return this->CachedBlock;
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadBlocks(vtkTypeUInt64 firstBlock,
+                                 vtkTypeUInt64 numBlocks,
+                                 unsigned char* buffer, size_t wordSize)
+{
+  // The blocks are stored one after the other, so read them at once.
+  std::vector<size_t> offsets(numBlocks+1, 0);
+  for(vtkTypeUInt64 i=0; i < numBlocks; ++i)
+  {
+    offsets[i+1] = offsets[i] + this->BlockCompressedSizes[firstBlock+i];
+  }
+  std::vector<unsigned char> readBuffer(offsets[numBlocks]+1);
+  if(!this->DataStream->Seek(this->BlockStartOffsets[firstBlock]) ||
+     this->DataStream->Read(&readBuffer[0], offsets[numBlocks]) <
+     offsets[numBlocks])
+  {
+    return 0;
+  }
+
+  // Uncompress and byte swap the blocks in parallel.
+  size_t blockSize = this->BlockUncompressedSize;
+  std::vector<unsigned char> results(numBlocks, 0);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks),
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for(vtkIdType i=begin; i < end; ++i)
+      {
+        unsigned char* block = buffer + i*blockSize;
+        if(this->Compressor->Uncompress(&readBuffer[offsets[i]],
+                                        offsets[i+1] - offsets[i],
+                                        block, blockSize) > 0)
+        {
+          this->PerformByteSwap(block, blockSize / wordSize, wordSize);
+          results[i] = 1;
+        }
+      }
+    });
+  return std::find(results.begin(), results.end(), 0) == results.end();
+}
+
 //----------------------------------------------------------------------------
 size_t vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
                                               vtkTypeUInt64 startWord,
@@ -729,11 +837,10 @@ size_t vtkXMLDataParser::ReadCompressedData(unsigned char* data,
   if(firstBlock == lastBlock)
   {
     // Everything fits in one block.
-    unsigned char* blockBuffer = this->ReadBlock(firstBlock);
+    unsigned char* blockBuffer = this->ReadCachedBlock(firstBlock);
     if(!blockBuffer) { return 0; }
     size_t n = endBlockOffset - beginBlockOffset;
     memcpy(data, blockBuffer+beginBlockOffset, n);
-    delete [] blockBuffer;
 
     // Byte swap this block.  Note that n will always be an integer
     // multiple of the word size.
@@ -747,14 +854,13 @@ size_t vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     size_t blockSize = this->FindBlockSize(firstBlock);
 
     // Read the first block.
-    unsigned char* blockBuffer = this->ReadBlock(firstBlock);
+    unsigned char* blockBuffer = this->ReadCachedBlock(firstBlock);
     if(!blockBuffer)
     {
       return 0;
     }
     size_t n = blockSize-beginBlockOffset;
     memcpy(outputPointer, blockBuffer+beginBlockOffset, n);
-    delete [] blockBuffer;
 
     // Byte swap the first block.  Note that n will always be an
     // integer multiple of the word size.
@@ -766,18 +872,26 @@ size_t vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     // Report progress.
     this->UpdateProgress(float(outputPointer-data)/length);
 
-    unsigned int currentBlock = firstBlock+1;
-    for(;currentBlock != lastBlock && !this->Abort; ++currentBlock)
+    // Read the complete blocks in batches, uncompressing the blocks of a
+    // batch in parallel.  The batches hold a few blocks per thread, or
+    // about 64 MB of data, to bound the memory used.
+    vtkTypeUInt64 batchSize = std::max(
+      static_cast<vtkTypeUInt64>(4*vtkSMPTools::GetEstimatedNumberOfThreads()),
+      static_cast<vtkTypeUInt64>((size_t(1) << 26) / blockSize));
+    vtkTypeUInt64 currentBlock = firstBlock+1;
+    while(currentBlock < lastBlock && !this->Abort)
     {
-      // Read this block.
-      if(!this->ReadBlock(currentBlock, outputPointer)) { return 0; }
-
-      // Byte swap this block.  Note that blockSize will always be an
+      // Read these blocks.  Note that blockSize will always be an
       // integer multiple of the word size.
-      this->PerformByteSwap(outputPointer, blockSize / wordSize, wordSize);
+      vtkTypeUInt64 numBlocks = std::min(batchSize, lastBlock-currentBlock);
+      if(!this->ReadBlocks(currentBlock, numBlocks, outputPointer, wordSize))
+      {
+        return 0;
+      }
 
       // Advance the pointer to the beginning of the next block.
-      outputPointer += this->FindBlockSize(currentBlock);
+      outputPointer += numBlocks*blockSize;
+      currentBlock += numBlocks;
 
       // Report progress.
       this->UpdateProgress(float(outputPointer-data)/length);
@@ -786,13 +900,12 @@ size_t vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     // Now read the final block, which is incomplete if it exists.
     if(endBlockOffset > 0 && !this->Abort)
     {
-      blockBuffer = this->ReadBlock(lastBlock);
+      blockBuffer = this->ReadCachedBlock(lastBlock);
       if(!blockBuffer)
       {
         return 0;
       }
       memcpy(outputPointer, blockBuffer, endBlockOffset);
-      delete [] blockBuffer;
 
       // Byte swap the partial block.  Note that endBlockOffset will
       // always be an integer multiple of the word size.
@@ -834,7 +947,7 @@ size_t vtkXMLDataParser::ReadBinaryData(void* in_buffer,
   size_t actualWords;
   if(this->Compressor)
   {
-    if (!this->ReadCompressionHeader())
+    if (!this->ReadCachedCompressionHeader())
     {
       vtkErrorMacro("ReadCompressionHeader failed. Aborting read.");
       return 0;
@@ -926,6 +1039,187 @@ size_t vtkXMLDataParser::ReadAppendedData(vtkTypeInt64 offset,
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+namespace
+{
+// Serializes the reads of ReadDataArrayFromFile, which may come from
+// arrays accessed by several threads.
+vtkSimpleCriticalSection vtkXMLDataParserFileLock;
+}
+
+//----------------------------------------------------------------------------
+size_t vtkXMLDataParser::ReadDataArrayFromFile(const char* fileName,
+                                               vtkXMLDataElement* da,
+                                               void* buffer,
+                                               size_t numWords,
+                                               int wordType)
+{
+  ifstream file(fileName, ios::in | ios::binary);
+  if(!file)
+  {
+    vtkErrorMacro("Error opening file " << fileName);
+    return 0;
+  }
+  file.imbue(std::locale::classic());
+
+  vtkXMLDataParserFileLock.Lock();
+  istream* stream = this->Stream;
+  int abort = this->Abort;
+  this->Stream = &file;
+  this->Abort = 0;
+  size_t result;
+  vtkTypeInt64 offset = 0;
+  if(da->GetScalarAttribute("offset", offset))
+  {
+    result = this->ReadAppendedData(offset, buffer, 0, numWords, wordType);
+  }
+  else
+  {
+    const char* format = da->GetAttribute("format");
+    int isAscii = !(format && strcmp(format, "binary") == 0);
+    result = this->ReadInlineData(da, isAscii, buffer, 0, numWords,
+                                  wordType);
+  }
+  this->Stream = stream;
+  this->Abort = abort;
+  vtkXMLDataParserFileLock.Unlock();
+  return result;
+}
+
+#if !defined(_WIN32)
+namespace
+{
+// The mappings made by MapAppendedData, by the address of their data.
+struct vtkXMLDataParserMapping
+{
+  void* Address;
+  size_t Length;
+};
+typedef std::map<void*, vtkXMLDataParserMapping> vtkXMLDataParserMappings;
+
+vtkSimpleCriticalSection vtkXMLDataParserMappingsLock;
+
+vtkXMLDataParserMappings& vtkXMLDataParserGetMappings()
+{
+  static vtkXMLDataParserMappings mappings;
+  return mappings;
+}
+}
+#endif
+
+//----------------------------------------------------------------------------
+void* vtkXMLDataParser::MapAppendedData(const char* fileName,
+                                        vtkTypeInt64 offset,
+                                        size_t numWords,
+                                        int wordType)
+{
+#if defined(_WIN32)
+  (void)fileName;
+  (void)offset;
+  (void)numWords;
+  (void)wordType;
+  return NULL;
+#else
+  // Only raw data in the native byte order can be used in place.
+#ifdef VTK_WORDS_BIGENDIAN
+  int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  if(!fileName || numWords == 0 || offset < 0 || this->Compressor ||
+     this->AppendedDataPosition <= 0 ||
+     vtkBase64InputStream::SafeDownCast(this->AppendedDataStream) ||
+     this->ByteOrder != nativeByteOrder)
+  {
+    return NULL;
+  }
+
+  // The data follow their header and must be aligned for their type.
+  size_t wordSize = this->GetWordTypeSize(wordType);
+#if defined(VTK_HAS_STD_UNIQUE_PTR)
+  std::unique_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#else
+  std::auto_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#endif
+  size_t const headerSize = uh->DataSize();
+  vtkTypeInt64 headerStart = this->AppendedDataPosition + offset;
+  vtkTypeInt64 dataStart = headerStart + headerSize;
+  vtkTypeUInt64 length = static_cast<vtkTypeUInt64>(numWords) * wordSize;
+  if(wordSize == 0 || dataStart % wordSize != 0)
+  {
+    return NULL;
+  }
+
+  // Map whole pages from the one holding the header, if the file holds
+  // all the data.
+  int fd = open(fileName, O_RDONLY);
+  if(fd < 0)
+  {
+    return NULL;
+  }
+  vtkTypeInt64 pageSize = sysconf(_SC_PAGESIZE);
+  vtkTypeInt64 mapStart = (headerStart / pageSize) * pageSize;
+  vtkTypeUInt64 mapLength = dataStart + length - mapStart;
+  void* address = MAP_FAILED;
+  struct stat st;
+  if(fstat(fd, &st) == 0 &&
+     static_cast<vtkTypeUInt64>(dataStart) + length <=
+     static_cast<vtkTypeUInt64>(st.st_size) &&
+     mapLength == static_cast<size_t>(mapLength))
+  {
+    address = mmap(NULL, static_cast<size_t>(mapLength),
+                   PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                   static_cast<off_t>(mapStart));
+  }
+  close(fd);
+  if(address == MAP_FAILED)
+  {
+    return NULL;
+  }
+
+  // Make sure the header gives enough data.
+  unsigned char* mapped = static_cast<unsigned char*>(address);
+  memcpy(uh->Data(), mapped + (headerStart - mapStart), headerSize);
+  if(uh->Get(0) < length)
+  {
+    munmap(address, static_cast<size_t>(mapLength));
+    return NULL;
+  }
+
+  void* data = mapped + (dataStart - mapStart);
+  vtkXMLDataParserMapping mapping = { address,
+                                      static_cast<size_t>(mapLength) };
+  vtkXMLDataParserMappingsLock.Lock();
+  vtkXMLDataParserGetMappings()[data] = mapping;
+  vtkXMLDataParserMappingsLock.Unlock();
+  return data;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkXMLDataParser::FreeMappedData(void* data)
+{
+#if defined(_WIN32)
+  (void)data;
+#else
+  vtkXMLDataParserMapping mapping = { NULL, 0 };
+  vtkXMLDataParserMappingsLock.Lock();
+  vtkXMLDataParserMappings& mappings = vtkXMLDataParserGetMappings();
+  vtkXMLDataParserMappings::iterator i = mappings.find(data);
+  if(i != mappings.end())
+  {
+    mapping = i->second;
+    mappings.erase(i);
+  }
+  vtkXMLDataParserMappingsLock.Unlock();
+  if(mapping.Address)
+  {
+    munmap(mapping.Address, mapping.Length);
+  }
+#endif
+}
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
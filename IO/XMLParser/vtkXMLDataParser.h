@@ -161,6 +161,36 @@ public:
     return this->AppendedDataPosition;
   }
 
+  /**
+   * Read the numWords words of the given type of the data array element
+   * da into buffer from fileName, the file that was parsed, opening the
+   * file again instead of using the current stream.  This lets arrays
+   * read their values after the reader that parsed the file is done with
+   * it.  Calls from several threads are serialized.  Returns the number
+   * of words read.
+   */
+  size_t ReadDataArrayFromFile(const char* fileName, vtkXMLDataElement* da,
+                               void* buffer, size_t numWords, int wordType);
+
+  /**
+   * Map the raw appended data at the given appended data offset into
+   * memory from fileName, the file being parsed, instead of reading it.
+   * Returns a pointer to the first of numWords words of the given type,
+   * or NULL if the data cannot be used in place: compressed, base64
+   * encoded, byte swapped or misaligned data, or a platform without
+   * mmap.  The pages are loaded when first accessed and are copied on
+   * write, leaving the file unchanged.  The file must not be truncated
+   * while the data is in use.  Release the data with FreeMappedData.
+   */
+  void* MapAppendedData(const char* fileName, vtkTypeInt64 offset,
+                        size_t numWords, int wordType);
+
+  /**
+   * Release data returned by MapAppendedData.  This is the free
+   * function of arrays that hold mapped data.
+   */
+  static void FreeMappedData(void* data);
+
 protected:
   vtkXMLDataParser();
   ~vtkXMLDataParser() VTK_OVERRIDE;
@@ -189,6 +219,19 @@ protected:
   size_t FindBlockSize(vtkTypeUInt64 block);
   int ReadBlock(vtkTypeUInt64 block, unsigned char* buffer);
   unsigned char* ReadBlock(vtkTypeUInt64 block);
+
+  // Read the compression header of the data at the current position,
+  // unless it is that of the last data read.
+  int ReadCachedCompressionHeader();
+
+  // Uncompress a block, unless it is the last one uncompressed.  The
+  // returned buffer belongs to the parser.
+  unsigned char* ReadCachedBlock(vtkTypeUInt64 block);
+
+  // Read numBlocks complete blocks starting at firstBlock into buffer
+  // and byte swap them.  The blocks are uncompressed in parallel.
+  int ReadBlocks(vtkTypeUInt64 firstBlock, vtkTypeUInt64 numBlocks,
+                 unsigned char* buffer, size_t wordSize);
   size_t ReadUncompressedData(unsigned char* data,
                               vtkTypeUInt64 startWord,
                               size_t numWords,
@@ -247,6 +290,15 @@ protected:
   size_t* BlockCompressedSizes;
   vtkTypeInt64* BlockStartOffsets;
 
+  // The position of the compression header read last and of the data
+  // following it, and the last block uncompressed from these data.  The
+  // readers read the rows or slices of a sub-extent one at a time, so
+  // this saves reading the header and the blocks they share each time.
+  vtkTypeInt64 CompressionHeaderPosition;
+  vtkTypeInt64 CompressedDataPosition;
+  unsigned char* CachedBlock;
+  vtkTypeInt64 CachedBlockIndex;
+
   // Ascii data parsing.
   unsigned char* AsciiDataBuffer;
   size_t AsciiDataBufferLength;
@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestEuclideanDistanceFelzenszwalb.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the Felzenszwalb algorithm of vtkImageEuclideanDistance against
+// brute force distances, with anisotropic spacing, signed distances and
+// several threads.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageEuclideanDistance.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestCheck.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// The squared distance of each voxel to the nearest voxel that is zero, or
+// non-zero if inverse is set.
+std::vector<double> BruteForce(vtkImageData *image, bool inverse,
+                               bool anisotropic)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  if (anisotropic)
+  {
+    image->GetSpacing(spacing);
+  }
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkIdType numPoints = image->GetNumberOfPoints();
+  std::vector<double> distances(numPoints, VTK_INT_MAX);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    int x = i % dims[0];
+    int y = (i / dims[0]) % dims[1];
+    int z = i / (dims[0] * dims[1]);
+    for (vtkIdType j = 0; j < numPoints; ++j)
+    {
+      if ((scalars->GetComponent(j, 0) == 0) != inverse)
+      {
+        double dx = spacing[0] * (x - j % dims[0]);
+        double dy = spacing[1] * (y - (j / dims[0]) % dims[1]);
+        double dz = spacing[2] * (z - j / (dims[0] * dims[1]));
+        distances[i] = std::min(distances[i], dx * dx + dy * dy + dz * dz);
+      }
+    }
+  }
+  return distances;
+}
+
+int Compare(vtkImageEuclideanDistance *filter, vtkImageData *image,
+            bool anisotropic, bool isSigned)
+{
+  filter->SetConsiderAnisotropy(anisotropic);
+  filter->SetSignedDistance(isSigned);
+  filter->Update();
+  vtkDataArray *result = filter->GetOutput()->GetPointData()->GetScalars();
+  vtkTestCheckMacro(result->GetDataType() == VTK_DOUBLE);
+  vtkTestCheckMacro(result->GetNumberOfComponents() == 1);
+
+  std::vector<double> inside = BruteForce(image, false, anisotropic);
+  std::vector<double> outside = BruteForce(image, true, anisotropic);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double expected = inside[i];
+    if (isSigned && scalars->GetComponent(i, 0) == 0)
+    {
+      expected = -outside[i];
+    }
+    vtkTestCheckMacro(fabs(result->GetComponent(i, 0) - expected) < 1e-9);
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestEuclideanDistanceFelzenszwalb(int, char *[])
+{
+  // Random blobs in a small anisotropic volume.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(21, 17, 9);
+  image->SetSpacing(0.7, 1.0, 2.5);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkMath::RandomSeed(5);
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    scalars->SetComponent(i, 0, vtkMath::Random() < 0.97 ? 1 : 0);
+  }
+
+  vtkNew<vtkImageEuclideanDistance> filter;
+  filter->SetInputData(image.GetPointer());
+  filter->SetAlgorithmToFelzenszwalb();
+  vtkTestCheckMacro(filter->GetAlgorithm() == VTK_EDT_FELZENSZWALB);
+
+  for (int threads = 1; threads <= 4; threads += 3)
+  {
+    int result = 0;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(threads), [&]()
+    {
+      result = Compare(filter.GetPointer(), image.GetPointer(), true, false) ||
+        Compare(filter.GetPointer(), image.GetPointer(), false, false) ||
+        Compare(filter.GetPointer(), image.GetPointer(), true, true) ||
+        Compare(filter.GetPointer(), image.GetPointer(), false, true);
+    });
+    vtkTestCheckMacro(result == 0);
+  }
+
+  // The Saito algorithm gives the same unsigned distances.
+  vtkNew<vtkImageEuclideanDistance> saito;
+  saito->SetInputData(image.GetPointer());
+  saito->SetAlgorithmToSaito();
+  saito->Update();
+  filter->SetSignedDistance(0);
+  filter->SetConsiderAnisotropy(1);
+  filter->Update();
+  vtkDataArray *expected = saito->GetOutput()->GetPointData()->GetScalars();
+  vtkDataArray *result = filter->GetOutput()->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    vtkTestCheckMacro(fabs(result->GetComponent(i, 0) -
+      expected->GetComponent(i, 0)) < 1e-9);
+  }
+
+  // Distances are not computed further than the maximum.
+  filter->SetMaximumDistance(3.0);
+  filter->Update();
+  result = filter->GetOutput()->GetPointData()->GetScalars();
+  double range[2];
+  result->GetRange(range);
+  vtkTestCheckMacro(range[0] == 0.0 && range[1] <= 3.0);
+
+  return 0;
+}
@@ -0,0 +1,278 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFFTPlan.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the planned fast Fourier transforms against discrete Fourier
+// transforms, alone, in vtkImageFFT and vtkImageRFFT, and in vtkTableFFT.
+
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageFFTPlan.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTable.h"
+#include "vtkTableFFT.h"
+#include "vtkTestCheck.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+// The discrete Fourier transform of n values taken every stride values.
+void DFT(const double *real, const double *imag, int n, int stride,
+         int direction, double *outReal, double *outImag)
+{
+  for (int k = 0; k < n; ++k)
+  {
+    double sumReal = 0.0;
+    double sumImag = 0.0;
+    for (int j = 0; j < n; ++j)
+    {
+      double angle = -direction * 2.0 * vtkMath::Pi() *
+        ((static_cast<long>(j) * k) % n) / n;
+      double c = cos(angle);
+      double s = sin(angle);
+      sumReal += real[j * stride] * c - imag[j * stride] * s;
+      sumImag += real[j * stride] * s + imag[j * stride] * c;
+    }
+    double scale = (direction == -1 ? 1.0 / n : 1.0);
+    outReal[k * stride] = sumReal * scale;
+    outImag[k * stride] = sumImag * scale;
+  }
+}
+
+int TestPlan(int n)
+{
+  const int count = 5;
+  std::vector<double> real(n * count), imag(n * count);
+  std::vector<double> expectedReal(n * count), expectedImag(n * count);
+  std::vector<double> workReal(n * count), workImag(n * count);
+  vtkImageFFTPlan plan;
+  plan.Initialize(n);
+  vtkTestCheckMacro(plan.GetSize() == n);
+  vtkTestCheckMacro(plan.GetBatchSize() >= 2 && plan.GetBatchSize() % 2 == 0);
+  const double tolerance = 1e-12 * n * n;
+
+  for (int direction = -1; direction <= 1; direction += 2)
+  {
+    for (int i = 0; i < n * count; ++i)
+    {
+      real[i] = vtkMath::Random(-1.0, 1.0);
+      imag[i] = vtkMath::Random(-1.0, 1.0);
+    }
+    for (int b = 0; b < count; ++b)
+    {
+      DFT(&real[b], &imag[b], n, count, direction, &expectedReal[b],
+          &expectedImag[b]);
+    }
+    plan.Execute(&real[0], &imag[0], &workReal[0], &workImag[0], count,
+                 direction);
+    for (int i = 0; i < n * count; ++i)
+    {
+      vtkTestCheckMacro(fabs(real[i] - expectedReal[i]) < tolerance);
+      vtkTestCheckMacro(fabs(imag[i] - expectedImag[i]) < tolerance);
+    }
+  }
+
+  // Six real sequences as three complex ones.
+  const int pairs = 3;
+  std::vector<double> lines(n * 2 * pairs), zeros(n * 2 * pairs, 0.0);
+  std::vector<double> outReal(n * 2 * pairs), outImag(n * 2 * pairs);
+  expectedReal.resize(n * 2 * pairs);
+  expectedImag.resize(n * 2 * pairs);
+  for (int i = 0; i < n * 2 * pairs; ++i)
+  {
+    lines[i] = vtkMath::Random(-1.0, 1.0);
+  }
+  for (int b = 0; b < 2 * pairs; ++b)
+  {
+    DFT(&lines[b], &zeros[b], n, 2 * pairs, 1, &expectedReal[b],
+        &expectedImag[b]);
+  }
+  for (int k = 0; k < n; ++k)
+  {
+    for (int b = 0; b < pairs; ++b)
+    {
+      real[k * pairs + b] = lines[k * 2 * pairs + 2 * b];
+      imag[k * pairs + b] = lines[k * 2 * pairs + 2 * b + 1];
+    }
+  }
+  plan.ExecuteReal(&real[0], &imag[0], &workReal[0], &workImag[0], pairs, 1,
+                   &outReal[0], &outImag[0]);
+  for (int i = 0; i < n * 2 * pairs; ++i)
+  {
+    vtkTestCheckMacro(fabs(outReal[i] - expectedReal[i]) < tolerance);
+    vtkTestCheckMacro(fabs(outImag[i] - expectedImag[i]) < tolerance);
+  }
+  return 0;
+}
+
+// Compare the 3D transform of the image to separable DFTs, and transform
+// it back.
+int TestImage(vtkImageData *image)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  vtkIdType numPoints = image->GetNumberOfPoints();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  std::vector<double> real(numPoints), imag(numPoints, 0.0);
+  std::vector<double> tmpReal(numPoints), tmpImag(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    real[i] = scalars->GetComponent(i, 0);
+    if (scalars->GetNumberOfComponents() > 1)
+    {
+      imag[i] = scalars->GetComponent(i, 1);
+    }
+  }
+  const int strides[3] = { 1, dims[0], dims[0] * dims[1] };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+      if ((i / strides[axis]) % dims[axis] == 0)
+      {
+        DFT(&real[i], &imag[i], dims[axis], strides[axis], 1, &tmpReal[i],
+            &tmpImag[i]);
+      }
+    }
+    real.swap(tmpReal);
+    imag.swap(tmpImag);
+  }
+
+  vtkNew<vtkImageFFT> fft;
+  fft->SetInputData(image);
+  fft->Update();
+  vtkDataArray *spectrum = fft->GetOutput()->GetPointData()->GetScalars();
+  vtkTestCheckMacro(spectrum->GetDataType() == VTK_DOUBLE);
+  vtkTestCheckMacro(spectrum->GetNumberOfComponents() == 2);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    vtkTestCheckMacro(fabs(spectrum->GetComponent(i, 0) - real[i]) < 1e-6);
+    vtkTestCheckMacro(fabs(spectrum->GetComponent(i, 1) - imag[i]) < 1e-6);
+  }
+
+  vtkNew<vtkImageRFFT> rfft;
+  rfft->SetInputConnection(fft->GetOutputPort());
+  rfft->Update();
+  vtkDataArray *values = rfft->GetOutput()->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    vtkTestCheckMacro(fabs(values->GetComponent(i, 0) -
+      scalars->GetComponent(i, 0)) < 1e-9);
+    if (scalars->GetNumberOfComponents() > 1)
+    {
+      vtkTestCheckMacro(fabs(values->GetComponent(i, 1) -
+        scalars->GetComponent(i, 1)) < 1e-9);
+    }
+    else
+    {
+      vtkTestCheckMacro(fabs(values->GetComponent(i, 1)) < 1e-9);
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestImageFFTPlan(int, char *[])
+{
+  vtkMath::RandomSeed(7);
+
+  // Powers of two and four, small primes, a large prime and mixes.
+  const int sizes[] =
+    { 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 30, 49, 64, 97, 100, 120, 243, 1024 };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+  {
+    if (TestPlan(sizes[i]))
+    {
+      cerr << "For " << sizes[i] << " values" << endl;
+      return 1;
+    }
+  }
+
+  // Real and complex images, with odd numbers of lines along each axis.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(24, 15, 7);
+  image->AllocateScalars(VTK_SHORT, 1);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    scalars->SetComponent(i, 0, static_cast<int>(vtkMath::Random(-100, 100)));
+  }
+  vtkTestCheckMacro(TestImage(image.GetPointer()) == 0);
+
+  vtkNew<vtkImageData> complexImage;
+  complexImage->SetDimensions(9, 16, 5);
+  complexImage->AllocateScalars(VTK_FLOAT, 2);
+  scalars = complexImage->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < complexImage->GetNumberOfPoints(); ++i)
+  {
+    scalars->SetComponent(i, 0, vtkMath::Random(-1.0, 1.0));
+    scalars->SetComponent(i, 1, vtkMath::Random(-1.0, 1.0));
+  }
+  vtkTestCheckMacro(TestImage(complexImage.GetPointer()) == 0);
+
+  // Columns of a table.
+  vtkNew<vtkTable> table;
+  const int numRows = 60;
+  for (int c = 0; c < 3; ++c)
+  {
+    vtkNew<vtkFloatArray> column;
+    column->SetName(c == 0 ? "A" : (c == 1 ? "B" : "C"));
+    column->SetNumberOfTuples(numRows);
+    for (int i = 0; i < numRows; ++i)
+    {
+      column->SetValue(i, static_cast<float>(vtkMath::Random(-1.0, 1.0)));
+    }
+    table->AddColumn(column.GetPointer());
+  }
+  vtkNew<vtkTableFFT> tableFFT;
+  tableFFT->SetInputData(table.GetPointer());
+  tableFFT->Update();
+  vtkTable *output = tableFFT->GetOutput();
+  vtkTestCheckMacro(output->GetNumberOfColumns() == 3);
+  std::vector<double> real(numRows), imag(numRows, 0.0);
+  std::vector<double> expectedReal(numRows), expectedImag(numRows);
+  for (int c = 0; c < 3; ++c)
+  {
+    vtkDataArray *column =
+      vtkArrayDownCast<vtkDataArray>(table->GetColumn(c));
+    vtkDataArray *result =
+      vtkArrayDownCast<vtkDataArray>(output->GetColumn(c));
+    vtkTestCheckMacro(result && result->GetNumberOfComponents() == 2);
+    vtkTestCheckMacro(strcmp(result->GetName(), column->GetName()) == 0);
+    for (int i = 0; i < numRows; ++i)
+    {
+      real[i] = column->GetComponent(i, 0);
+    }
+    DFT(&real[0], &imag[0], numRows, 1, 1, &expectedReal[0],
+        &expectedImag[0]);
+    for (int i = 0; i < numRows; ++i)
+    {
+      vtkTestCheckMacro(
+        fabs(result->GetComponent(i, 0) - expectedReal[i]) < 1e-9);
+      vtkTestCheckMacro(
+        fabs(result->GetComponent(i, 1) - expectedImag[i]) < 1e-9);
+    }
+  }
+
+  return 0;
+}
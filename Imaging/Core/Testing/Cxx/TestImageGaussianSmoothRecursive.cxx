@@ -0,0 +1,212 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageGaussianSmoothRecursive.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the recursive algorithm of vtkImageGaussianSmooth against the FIR
+// algorithm, its boundary conditions against a padded image, and that it
+// gives the same values with several threads and for sub extents.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageGaussianSmooth.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+// Fill an image with random values, except within a border of the given
+// width where it is zero.
+void FillImage(vtkImageData *image, int border, double maxValue)
+{
+  int extent[6];
+  image->GetExtent(extent);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkIdType i = 0;
+  for (int z = extent[4]; z <= extent[5]; ++z)
+  {
+    for (int y = extent[2]; y <= extent[3]; ++y)
+    {
+      for (int x = extent[0]; x <= extent[1]; ++x, ++i)
+      {
+        bool inside =
+          (x - extent[0] >= border && extent[1] - x >= border &&
+           y - extent[2] >= border && extent[3] - y >= border &&
+           (extent[4] == extent[5] ||
+            (z - extent[4] >= border && extent[5] - z >= border)));
+        for (int c = 0; c < scalars->GetNumberOfComponents(); ++c)
+        {
+          scalars->SetComponent(i, c, inside ?
+            std::floor(vtkMath::Random(0.0, maxValue)) : 0.0);
+        }
+      }
+    }
+  }
+}
+
+double MaximumDifference(vtkDataArray *a, vtkDataArray *b)
+{
+  double difference = 0.0;
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      difference = std::max(difference,
+        fabs(a->GetComponent(i, c) - b->GetComponent(i, c)));
+    }
+  }
+  return difference;
+}
+
+} // end anon namespace
+
+int TestImageGaussianSmoothRecursive(int, char *[])
+{
+  vtkMath::RandomSeed(7);
+
+  vtkNew<vtkImageGaussianSmooth> filter;
+  vtkTestCheckMacro(filter->GetAlgorithm() == VTK_GAUSSIAN_SMOOTH_FIR);
+  filter->SetAlgorithmToRecursive();
+  vtkTestCheckMacro(filter->GetAlgorithm() == VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  vtkTestCheckMacro(strcmp(filter->GetAlgorithmAsString(), "Recursive") == 0);
+
+  // Random values away from the edges, so that the FIR kernel is not
+  // clipped where the smoothed image is not zero, and the recursive
+  // filter approximates the same gaussian.
+  vtkNew<vtkImageData> image;
+  image->SetExtent(-3, 36, 2, 33, 5, 34);
+  image->AllocateScalars(VTK_DOUBLE, 2);
+  FillImage(image.GetPointer(), 10, 100.0);
+
+  const double stds[3][3] = { { 1.0, 1.0, 1.0 }, { 2.0, 3.5, 1.5 },
+                              { 2.5, 2.5, 2.5 } };
+  // The recursive filter is least accurate for random values and small
+  // standard deviations.
+  const double tolerances[3] = { 8.0, 4.0, 3.0 };
+  for (int s = 0; s < 3; ++s)
+  {
+    vtkNew<vtkImageGaussianSmooth> fir;
+    fir->SetInputData(image.GetPointer());
+    fir->SetStandardDeviations(stds[s][0], stds[s][1], stds[s][2]);
+    fir->SetRadiusFactor(7.0);
+    fir->Update();
+    vtkDataArray *expected = fir->GetOutput()->GetPointData()->GetScalars();
+
+    filter->SetInputData(image.GetPointer());
+    filter->SetStandardDeviations(stds[s][0], stds[s][1], stds[s][2]);
+    vtkDataArray *result = 0;
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(threads), [&]()
+      {
+        filter->Modified();
+        filter->Update();
+      });
+      vtkDataArray *scalars =
+        filter->GetOutput()->GetPointData()->GetScalars();
+      vtkTestCheckMacro(scalars->GetDataType() == VTK_DOUBLE);
+      vtkTestCheckMacro(scalars->GetNumberOfComponents() == 2);
+      if (result)
+      {
+        // The lines are filtered the same way with any number of threads.
+        vtkTestCheckMacro(MaximumDifference(scalars, result) == 0.0);
+        result->Delete();
+      }
+      result = scalars->NewInstance();
+      result->DeepCopy(scalars);
+    }
+    double difference = MaximumDifference(result, expected);
+    result->Delete();
+    if (difference > tolerances[s])
+    {
+      cerr << "Difference with FIR " << difference << " for stds " << s
+           << endl;
+      return 1;
+    }
+  }
+
+  // A sub extent of the output has the values of the whole output.
+  filter->SetStandardDeviations(2.0, 1.5, 3.0);
+  filter->Update();
+  vtkNew<vtkImageData> whole;
+  whole->DeepCopy(filter->GetOutput());
+  int subExtent[6] = { 0, 20, 7, 9, 30, 34 };
+  vtkTestCheckMacro(filter->UpdateExtent(subExtent));
+  vtkImageData *output = filter->GetOutput();
+  for (int z = subExtent[4]; z <= subExtent[5]; ++z)
+  {
+    for (int y = subExtent[2]; y <= subExtent[3]; ++y)
+    {
+      for (int x = subExtent[0]; x <= subExtent[1]; ++x)
+      {
+        for (int c = 0; c < 2; ++c)
+        {
+          vtkTestCheckMacro(output->GetScalarComponentAsDouble(x, y, z, c) ==
+            whole->GetScalarComponentAsDouble(x, y, z, c));
+        }
+      }
+    }
+  }
+
+  // The edges behave as if the image went on with its edge values, also
+  // for short lines and for a large standard deviation.
+  const int sizes[3] = { 2, 9, 41 };
+  for (int k = 0; k < 3; ++k)
+  {
+    int n = sizes[k];
+    int pad = 3000;
+    vtkNew<vtkImageData> line;
+    line->SetDimensions(n, 3, 1);
+    line->AllocateScalars(VTK_DOUBLE, 1);
+    FillImage(line.GetPointer(), 0, 50.0);
+    vtkNew<vtkImageData> padded;
+    padded->SetExtent(-pad, n - 1 + pad, 0, 2, 0, 0);
+    padded->AllocateScalars(VTK_DOUBLE, 1);
+    for (int y = 0; y < 3; ++y)
+    {
+      for (int x = -pad; x < n + pad; ++x)
+      {
+        padded->SetScalarComponentFromDouble(x, y, 0, 0,
+          line->GetScalarComponentAsDouble(std::min(std::max(x, 0), n - 1),
+                                           y, 0, 0));
+      }
+    }
+    for (int s = 0; s < 2; ++s)
+    {
+      double std = (s == 0 ? 0.8 : 60.0);
+      vtkNew<vtkImageGaussianSmooth> recursive;
+      recursive->SetAlgorithmToRecursive();
+      recursive->SetDimensionality(1);
+      recursive->SetStandardDeviation(std);
+      recursive->SetInputData(line.GetPointer());
+      recursive->Update();
+      vtkNew<vtkImageData> smoothed;
+      smoothed->DeepCopy(recursive->GetOutput());
+      recursive->SetInputData(padded.GetPointer());
+      int lineExtent[6] = { 0, n - 1, 0, 2, 0, 0 };
+      vtkTestCheckMacro(recursive->UpdateExtent(lineExtent));
+      vtkTestCheckMacro(
+        MaximumDifference(smoothed->GetPointData()->GetScalars(),
+        recursive->GetOutput()->GetPointData()->GetScalars()) < 1e-6);
+    }
+  }
+
+  return 0;
+}
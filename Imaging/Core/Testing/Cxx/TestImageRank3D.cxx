@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageRank3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the operations of vtkImageRank3D against sorted neighborhoods and
+// against vtkImageMedian3D, for 8 and 16 bit scalars and several threads.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageMedian3D.h"
+#include "vtkImageRank3D.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// The value of the operation over the sorted values of a neighborhood.
+double Rank(std::vector<double> &values, int operation, double percentile)
+{
+  std::sort(values.begin(), values.end());
+  int n = static_cast<int>(values.size());
+  switch (operation)
+  {
+    case VTK_IMAGE_RANK_MIN:
+      return values[0];
+    case VTK_IMAGE_RANK_MAX:
+      return values[n - 1];
+    case VTK_IMAGE_RANK_PERCENTILE:
+      return values[static_cast<int>(percentile * (n - 1) / 100.0 + 0.5)];
+    default:
+      if (n % 2 == 0)
+      {
+        return values[n / 2 - 1] +
+          std::floor((values[n / 2] - values[n / 2 - 1]) / 2);
+      }
+      return values[n / 2];
+  }
+}
+
+int Compare(vtkImageData *image, const int kernelSize[3], int operation,
+            double percentile, int threads)
+{
+  vtkNew<vtkImageRank3D> filter;
+  filter->SetInputData(image);
+  filter->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  filter->SetOperation(operation);
+  filter->SetPercentile(percentile);
+  filter->SetNumberOfThreads(threads);
+  filter->Update();
+  vtkImageData *output = filter->GetOutput();
+  vtkTestCheckMacro(output->GetScalarType() == image->GetScalarType());
+  vtkDataArray *result = output->GetPointData()->GetScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  int numComp = scalars->GetNumberOfComponents();
+  vtkTestCheckMacro(result->GetNumberOfComponents() == numComp);
+
+  int dims[3];
+  image->GetDimensions(dims);
+  std::vector<double> values;
+  for (int z = 0; z < dims[2]; ++z)
+  {
+    for (int y = 0; y < dims[1]; ++y)
+    {
+      for (int x = 0; x < dims[0]; ++x)
+      {
+        int idx[3] = { x, y, z };
+        int hoodMin[3], hoodMax[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          hoodMin[axis] = std::max(idx[axis] - kernelSize[axis] / 2, 0);
+          hoodMax[axis] = std::min(idx[axis] - kernelSize[axis] / 2 +
+                                   kernelSize[axis] - 1, dims[axis] - 1);
+        }
+        for (int c = 0; c < numComp; ++c)
+        {
+          values.clear();
+          for (int k = hoodMin[2]; k <= hoodMax[2]; ++k)
+          {
+            for (int j = hoodMin[1]; j <= hoodMax[1]; ++j)
+            {
+              for (int i = hoodMin[0]; i <= hoodMax[0]; ++i)
+              {
+                values.push_back(scalars->GetComponent(
+                  (k * dims[1] + j) * dims[0] + i, c));
+              }
+            }
+          }
+          double expected = Rank(values, operation, percentile);
+          double value =
+            result->GetComponent((z * dims[1] + y) * dims[0] + x, c);
+          vtkTestCheckMacro(value == expected);
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestImageRank3D(int, char *[])
+{
+  vtkMath::RandomSeed(3);
+
+  // 16 bit values spread over several coarse bins, and 8 bit values with
+  // two components.
+  const int types[4] =
+    { VTK_SHORT, VTK_UNSIGNED_SHORT, VTK_UNSIGNED_CHAR, VTK_SIGNED_CHAR };
+  const double ranges[4][2] =
+    { { -1500, 1500 }, { 0, 65535 }, { 0, 255 }, { -128, 127 } };
+  for (int t = 0; t < 4; ++t)
+  {
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(17, 13, 8);
+    int numComp = (t < 2 ? 1 : 2);
+    image->AllocateScalars(types[t], numComp);
+    vtkDataArray *scalars = image->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+      for (int c = 0; c < numComp; ++c)
+      {
+        scalars->SetComponent(i, c, std::floor(
+          vtkMath::Random(ranges[t][0], ranges[t][1] + 1)));
+      }
+    }
+
+    const int kernelSizes[3][3] = { { 3, 3, 3 }, { 6, 1, 4 }, { 9, 7, 5 } };
+    for (int k = 0; k < 3; ++k)
+    {
+      for (int operation = VTK_IMAGE_RANK_MEDIAN;
+           operation <= VTK_IMAGE_RANK_MAX; ++operation)
+      {
+        for (int threads = 1; threads <= 3; threads += 2)
+        {
+          if (Compare(image.GetPointer(), kernelSizes[k], operation, 30.0,
+                      threads))
+          {
+            cerr << "For type " << types[t] << ", kernel " << k
+                 << ", operation " << operation << " and " << threads
+                 << " threads" << endl;
+            return 1;
+          }
+        }
+      }
+    }
+
+    // The median is the one of vtkImageMedian3D.
+    vtkNew<vtkImageRank3D> rank;
+    rank->SetInputData(image.GetPointer());
+    rank->SetKernelSize(5, 4, 3);
+    rank->Update();
+    vtkNew<vtkImageMedian3D> median;
+    median->SetInputData(image.GetPointer());
+    median->SetKernelSize(5, 4, 3);
+    median->Update();
+    vtkTestCheckMacro(rank->GetNumberOfElements() == 60);
+    vtkDataArray *expected = median->GetOutput()->GetPointData()->GetScalars();
+    vtkDataArray *result = rank->GetOutput()->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+      for (int c = 0; c < numComp; ++c)
+      {
+        vtkTestCheckMacro(result->GetComponent(i, c) ==
+          expected->GetComponent(i, c));
+      }
+    }
+  }
+
+  return 0;
+}
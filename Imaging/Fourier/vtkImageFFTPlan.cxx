@@ -0,0 +1,398 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageFFTPlan.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkImageFFTPlan.h"
+
+#include "vtkMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------
+vtkImageFFTPlan::vtkImageFFTPlan()
+{
+  this->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+// Split n into factors, fours first, then twos, threes and the other
+// primes, and compute the twiddle factors of each butterfly stage.
+void vtkImageFFTPlan::Initialize(int n)
+{
+  if (n == this->Size)
+  {
+    return;
+  }
+  this->Size = n;
+  this->Stages.clear();
+  this->TwiddleReal.clear();
+  this->TwiddleImag.clear();
+
+  int rest = n;
+  int stride = 1;
+  int radix = 4;
+  while (rest > 1)
+  {
+    while (rest % radix != 0)
+    {
+      radix = (radix == 4 ? 2 : (radix == 2 ? 3 : radix + 2));
+      if (radix * radix > rest)
+      {
+        // rest is prime.
+        radix = rest;
+      }
+    }
+
+    Stage stage;
+    stage.Radix = radix;
+    stage.Length = rest;
+    stage.Stride = stride;
+    stage.Twiddles = this->TwiddleReal.size();
+    this->Stages.push_back(stage);
+
+    // The twiddle factor of output u of butterfly j is w^(j*u), w being
+    // the rest-th root of unity.  Generic butterflies also need the
+    // radix-th roots of unity.
+    int m = rest / radix;
+    double angle = -2.0 * vtkMath::Pi() / rest;
+    for (int j = 0; j < m; ++j)
+    {
+      for (int u = 1; u < radix; ++u)
+      {
+        int e = (j * u) % rest;
+        this->TwiddleReal.push_back(cos(angle * e));
+        this->TwiddleImag.push_back(sin(angle * e));
+      }
+    }
+    if (radix > 4)
+    {
+      for (int t = 0; t < radix; ++t)
+      {
+        this->TwiddleReal.push_back(cos(angle * m * t));
+        this->TwiddleImag.push_back(sin(angle * m * t));
+      }
+    }
+
+    rest = m;
+    stride *= radix;
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFFTPlan::GetBatchSize() const
+{
+  // Keep a batch of values and its scratch space within about 512 kB.
+  int batch = 16384 / std::max(this->Size, 1);
+  batch = std::min(std::max(batch, 2), 32);
+  return batch & ~1;
+}
+
+//----------------------------------------------------------------------------
+// In each stage, the butterflies read x as p sub-sequences of length
+// m = Length/p and write y as m sub-sequences of length p, each value
+// being Stride*count contiguous doubles.
+void vtkImageFFTPlan::Butterfly2(const Stage &stage, int count,
+                                 const double *xr, const double *xi,
+                                 double *yr, double *yi) const
+{
+  const int m = stage.Length / 2;
+  const size_t len = static_cast<size_t>(stage.Stride) * count;
+  const double *twr = &this->TwiddleReal[stage.Twiddles];
+  const double *twi = &this->TwiddleImag[stage.Twiddles];
+  for (int j = 0; j < m; ++j)
+  {
+    const double *ar = xr + j * len;
+    const double *ai = xi + j * len;
+    const double *br = xr + (j + m) * len;
+    const double *bi = xi + (j + m) * len;
+    double *y0r = yr + 2 * j * len;
+    double *y0i = yi + 2 * j * len;
+    double *y1r = y0r + len;
+    double *y1i = y0i + len;
+    const double wr = twr[j];
+    const double wi = twi[j];
+    for (size_t i = 0; i < len; ++i)
+    {
+      double dr = ar[i] - br[i];
+      double di = ai[i] - bi[i];
+      y0r[i] = ar[i] + br[i];
+      y0i[i] = ai[i] + bi[i];
+      y1r[i] = dr * wr - di * wi;
+      y1i[i] = dr * wi + di * wr;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFFTPlan::Butterfly3(const Stage &stage, int count,
+                                 const double *xr, const double *xi,
+                                 double *yr, double *yi) const
+{
+  const int m = stage.Length / 3;
+  const size_t len = static_cast<size_t>(stage.Stride) * count;
+  const double *twr = &this->TwiddleReal[stage.Twiddles];
+  const double *twi = &this->TwiddleImag[stage.Twiddles];
+  // sin(2*pi/3)
+  const double s = 0.86602540378443864676;
+  for (int j = 0; j < m; ++j)
+  {
+    const double *ar = xr + j * len;
+    const double *ai = xi + j * len;
+    const double *br = xr + (j + m) * len;
+    const double *bi = xi + (j + m) * len;
+    const double *cr = xr + (j + 2 * m) * len;
+    const double *ci = xi + (j + 2 * m) * len;
+    double *y0r = yr + 3 * j * len;
+    double *y0i = yi + 3 * j * len;
+    double *y1r = y0r + len;
+    double *y1i = y0i + len;
+    double *y2r = y1r + len;
+    double *y2i = y1i + len;
+    const double w1r = twr[2 * j];
+    const double w1i = twi[2 * j];
+    const double w2r = twr[2 * j + 1];
+    const double w2i = twi[2 * j + 1];
+    for (size_t i = 0; i < len; ++i)
+    {
+      double tr = br[i] + cr[i];
+      double ti = bi[i] + ci[i];
+      double dr = s * (br[i] - cr[i]);
+      double di = s * (bi[i] - ci[i]);
+      double hr = ar[i] - 0.5 * tr;
+      double hi = ai[i] - 0.5 * ti;
+      // h - i*d and h + i*d.
+      double z1r = hr + di;
+      double z1i = hi - dr;
+      double z2r = hr - di;
+      double z2i = hi + dr;
+      y0r[i] = ar[i] + tr;
+      y0i[i] = ai[i] + ti;
+      y1r[i] = z1r * w1r - z1i * w1i;
+      y1i[i] = z1r * w1i + z1i * w1r;
+      y2r[i] = z2r * w2r - z2i * w2i;
+      y2i[i] = z2r * w2i + z2i * w2r;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFFTPlan::Butterfly4(const Stage &stage, int count,
+                                 const double *xr, const double *xi,
+                                 double *yr, double *yi) const
+{
+  const int m = stage.Length / 4;
+  const size_t len = static_cast<size_t>(stage.Stride) * count;
+  const double *twr = &this->TwiddleReal[stage.Twiddles];
+  const double *twi = &this->TwiddleImag[stage.Twiddles];
+  for (int j = 0; j < m; ++j)
+  {
+    const double *ar = xr + j * len;
+    const double *ai = xi + j * len;
+    const double *br = xr + (j + m) * len;
+    const double *bi = xi + (j + m) * len;
+    const double *cr = xr + (j + 2 * m) * len;
+    const double *ci = xi + (j + 2 * m) * len;
+    const double *dr = xr + (j + 3 * m) * len;
+    const double *di = xi + (j + 3 * m) * len;
+    double *y0r = yr + 4 * j * len;
+    double *y0i = yi + 4 * j * len;
+    double *y1r = y0r + len;
+    double *y1i = y0i + len;
+    double *y2r = y1r + len;
+    double *y2i = y1i + len;
+    double *y3r = y2r + len;
+    double *y3i = y2i + len;
+    const double w1r = twr[3 * j];
+    const double w1i = twi[3 * j];
+    const double w2r = twr[3 * j + 1];
+    const double w2i = twi[3 * j + 1];
+    const double w3r = twr[3 * j + 2];
+    const double w3i = twi[3 * j + 2];
+    for (size_t i = 0; i < len; ++i)
+    {
+      double t0r = ar[i] + cr[i];
+      double t0i = ai[i] + ci[i];
+      double t1r = ar[i] - cr[i];
+      double t1i = ai[i] - ci[i];
+      double t2r = br[i] + dr[i];
+      double t2i = bi[i] + di[i];
+      // -i * (b - d)
+      double t3r = bi[i] - di[i];
+      double t3i = dr[i] - br[i];
+      double z1r = t1r + t3r;
+      double z1i = t1i + t3i;
+      double z2r = t0r - t2r;
+      double z2i = t0i - t2i;
+      double z3r = t1r - t3r;
+      double z3i = t1i - t3i;
+      y0r[i] = t0r + t2r;
+      y0i[i] = t0i + t2i;
+      y1r[i] = z1r * w1r - z1i * w1i;
+      y1i[i] = z1r * w1i + z1i * w1r;
+      y2r[i] = z2r * w2r - z2i * w2i;
+      y2i[i] = z2r * w2i + z2i * w2r;
+      y3r[i] = z3r * w3r - z3i * w3i;
+      y3i[i] = z3r * w3i + z3i * w3r;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFFTPlan::ButterflyN(const Stage &stage, int count,
+                                 const double *xr, const double *xi,
+                                 double *yr, double *yi) const
+{
+  const int p = stage.Radix;
+  const int m = stage.Length / p;
+  const size_t len = static_cast<size_t>(stage.Stride) * count;
+  const double *twr = &this->TwiddleReal[stage.Twiddles];
+  const double *twi = &this->TwiddleImag[stage.Twiddles];
+  const double *rootr = twr + m * (p - 1);
+  const double *rooti = twi + m * (p - 1);
+  for (int j = 0; j < m; ++j)
+  {
+    for (int u = 0; u < p; ++u)
+    {
+      double *zr = yr + (p * j + u) * len;
+      double *zi = yi + (p * j + u) * len;
+      std::copy(xr + j * len, xr + (j + 1) * len, zr);
+      std::copy(xi + j * len, xi + (j + 1) * len, zi);
+      for (int r = 1; r < p; ++r)
+      {
+        const double *ar = xr + (j + r * m) * len;
+        const double *ai = xi + (j + r * m) * len;
+        const double vr = rootr[(r * u) % p];
+        const double vi = rooti[(r * u) % p];
+        for (size_t i = 0; i < len; ++i)
+        {
+          zr[i] += ar[i] * vr - ai[i] * vi;
+          zi[i] += ar[i] * vi + ai[i] * vr;
+        }
+      }
+      if (u > 0)
+      {
+        const double wr = twr[j * (p - 1) + u - 1];
+        const double wi = twi[j * (p - 1) + u - 1];
+        for (size_t i = 0; i < len; ++i)
+        {
+          double tr = zr[i];
+          zr[i] = tr * wr - zi[i] * wi;
+          zi[i] = tr * wi + zi[i] * wr;
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFFTPlan::Transform(double *real, double *imag, double *workReal,
+                               double *workImag, int count) const
+{
+  double *xr = real;
+  double *xi = imag;
+  double *yr = workReal;
+  double *yi = workImag;
+  for (size_t s = 0; s < this->Stages.size(); ++s)
+  {
+    const Stage &stage = this->Stages[s];
+    switch (stage.Radix)
+    {
+      case 2:
+        this->Butterfly2(stage, count, xr, xi, yr, yi);
+        break;
+      case 3:
+        this->Butterfly3(stage, count, xr, xi, yr, yi);
+        break;
+      case 4:
+        this->Butterfly4(stage, count, xr, xi, yr, yi);
+        break;
+      default:
+        this->ButterflyN(stage, count, xr, xi, yr, yi);
+        break;
+    }
+    std::swap(xr, yr);
+    std::swap(xi, yi);
+  }
+  return xr != real;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFFTPlan::Execute(double *real, double *imag, double *workReal,
+                              double *workImag, int count,
+                              int direction) const
+{
+  const size_t numValues = static_cast<size_t>(this->Size) * count;
+
+  // The backward transform is the conjugate of the forward transform of
+  // the conjugate.
+  if (direction == -1)
+  {
+    for (size_t i = 0; i < numValues; ++i)
+    {
+      imag[i] = -imag[i];
+    }
+  }
+
+  const double *resultReal = real;
+  const double *resultImag = imag;
+  if (this->Transform(real, imag, workReal, workImag, count))
+  {
+    resultReal = workReal;
+    resultImag = workImag;
+  }
+
+  if (direction == -1)
+  {
+    const double scale = 1.0 / this->Size;
+    for (size_t i = 0; i < numValues; ++i)
+    {
+      real[i] = resultReal[i] * scale;
+      imag[i] = -resultImag[i] * scale;
+    }
+  }
+  else if (resultReal != real)
+  {
+    std::copy(resultReal, resultReal + numValues, real);
+    std::copy(resultImag, resultImag + numValues, imag);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFFTPlan::ExecuteReal(double *real, double *imag,
+                                  double *workReal, double *workImag,
+                                  int count, int direction,
+                                  double *outReal, double *outImag) const
+{
+  this->Execute(real, imag, workReal, workImag, count, direction);
+
+  // With z = x + i*y for real x and y, the transforms are
+  // X[k] = (Z[k] + conj(Z[n-k]))/2 and Y[k] = (Z[k] - conj(Z[n-k]))/2i.
+  const int n = this->Size;
+  for (int k = 0; k < n; ++k)
+  {
+    const double *zr = real + static_cast<size_t>(k) * count;
+    const double *zi = imag + static_cast<size_t>(k) * count;
+    const double *nr = real + static_cast<size_t>((n - k) % n) * count;
+    const double *ni = imag + static_cast<size_t>((n - k) % n) * count;
+    double *xr = outReal + static_cast<size_t>(k) * 2 * count;
+    double *xi = outImag + static_cast<size_t>(k) * 2 * count;
+    for (int b = 0; b < count; ++b)
+    {
+      xr[2 * b] = 0.5 * (zr[b] + nr[b]);
+      xi[2 * b] = 0.5 * (zi[b] - ni[b]);
+      xr[2 * b + 1] = 0.5 * (zi[b] + ni[b]);
+      xi[2 * b + 1] = 0.5 * (nr[b] - zr[b]);
+    }
+  }
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageFFTPlan.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkImageFFTPlan
+ * @brief   Precomputed fast Fourier transforms of one length.
+ *
+ * vtkImageFFTPlan holds what the fast Fourier transforms of sequences of
+ * one length need: the factors of the length and the twiddle factors of
+ * each butterfly stage, so that they are computed once instead of for
+ * every sequence.  The transforms are self-sorting (Stockham) mixed radix
+ * transforms with radix 4, 2 and 3 butterflies, and generic butterflies
+ * for other prime factors.
+ *
+ * The transforms are done on batches of sequences that are stored
+ * interleaved, value k of sequence b at index k*count + b, so that the
+ * inner loops of the butterflies run over contiguous values of all the
+ * sequences of a batch.  A batch of real sequences can be transformed as
+ * half as many complex sequences.  Once initialized, a plan can be used by
+ * several threads at once.
+ *
+ * @sa
+ * vtkImageFFT vtkImageRFFT vtkTableFFT
+*/
+
+#ifndef vtkImageFFTPlan_h
+#define vtkImageFFTPlan_h
+
+#include "vtkImagingFourierModule.h" // For export macro
+#include "vtkSystemIncludes.h"
+
+#include <vector> // For the twiddle factors
+
+class VTKIMAGINGFOURIER_EXPORT vtkImageFFTPlan
+{
+public:
+  vtkImageFFTPlan();
+
+  /**
+   * Prepare the transforms of sequences of length n.  Does nothing if
+   * the plan is already for this length.
+   */
+  void Initialize(int n);
+
+  /**
+   * Get the length of the sequences the plan is for, 0 before
+   * Initialize().
+   */
+  int GetSize() const { return this->Size; }
+
+  /**
+   * Transform the count complex sequences with real and imaginary parts
+   * in real and imag, in place.  Value k of sequence b is at index
+   * k*count + b.  workReal and workImag are scratch space of the same
+   * size.  The transform is forward if direction is 1, and backward,
+   * scaled by 1/n, if direction is -1.
+   */
+  void Execute(double *real, double *imag, double *workReal,
+               double *workImag, int count, int direction) const;
+
+  /**
+   * Transform 2*count real sequences with count complex transforms.
+   * Sequence 2*b is stored in the real part, and sequence 2*b+1 in the
+   * imaginary part, of complex sequence b of real and imag, which are
+   * used as in Execute().  The 2*count complex results are written to
+   * outReal and outImag, value k of result b at index k*2*count + b.
+   */
+  void ExecuteReal(double *real, double *imag, double *workReal,
+                   double *workImag, int count, int direction,
+                   double *outReal, double *outImag) const;
+
+  /**
+   * Get a good number of sequences to transform at once, so that a batch
+   * stays in cache.  The number is even.
+   */
+  int GetBatchSize() const;
+
+protected:
+  // One butterfly stage: Radix is its factor, Length the length of the
+  // sub-sequences it splits and Stride the number of them.
+  struct Stage
+  {
+    int Radix;
+    int Length;
+    int Stride;
+    size_t Twiddles;
+  };
+
+  // Return 1 if the results ended up in the work arrays.
+  int Transform(double *real, double *imag, double *workReal,
+                double *workImag, int count) const;
+
+  void Butterfly2(const Stage &stage, int count, const double *xr,
+                  const double *xi, double *yr, double *yi) const;
+  void Butterfly3(const Stage &stage, int count, const double *xr,
+                  const double *xi, double *yr, double *yi) const;
+  void Butterfly4(const Stage &stage, int count, const double *xr,
+                  const double *xi, double *yr, double *yi) const;
+  void ButterflyN(const Stage &stage, int count, const double *xr,
+                  const double *xi, double *yr, double *yi) const;
+
+  int Size;
+  std::vector<Stage> Stages;
+  std::vector<double> TwiddleReal;
+  std::vector<double> TwiddleImag;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImageFFTPlan.h
@@ -14,8 +14,27 @@
 =========================================================================*/
 #include "vtkImageFourierFilter.h"
 
+#include "vtkImageData.h"
+#include "vtkImageFFTPlan.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
 #include "vtkMath.h"
+
+#include <algorithm>
 #include <cmath>
+#include <vector>
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::vtkImageFourierFilter()
+{
+  this->Plan = new vtkImageFFTPlan;
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::~vtkImageFourierFilter()
+{
+  delete this->Plan;
+}
 
 /*=========================================================================
         Vectors of complex numbers.
@@ -145,64 +164,33 @@ void vtkImageFourierFilter::ExecuteFftStepN(vtkImageComplex *p_in,
 //----------------------------------------------------------------------------
 // This function calculates the whole fft (or rfft) of an array.
 // The contents of the input array are changed.
-// It is engineered for no decimation so input and output cannot be equal.
 // (fb = 1) => fft, (fb = -1) => rfft;
 void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
                                                       vtkImageComplex *out,
                                                       int N, int fb)
 {
-  vtkImageComplex *p1, *p2, *p3;
-  int block_size = 1;
-  int rest_size = N;
-  int n = 2;
-  int idx;
-
-  // If this is a reverse transform (scale accordingly).
-  if(fb == -1)
+  // Use the plan of the current axis if it fits.
+  vtkImageFFTPlan plan;
+  const vtkImageFFTPlan *p = this->Plan;
+  if (p->GetSize() != N)
   {
-    p1 = in;
-    for(idx = 0; idx < N; ++idx)
-    {
-      p1->Real = p1->Real / N;
-      p1->Imag = p1->Imag / N;
-      ++p1;
-    }
+    plan.Initialize(N);
+    p = &plan;
   }
-  p1 = in;
-  p2 = out;
-  while(block_size < N && n <= N)
+
+  std::vector<double> buffer(4 * N);
+  double *real = &buffer[0];
+  double *imag = real + N;
+  for (int idx = 0; idx < N; ++idx)
   {
-    if((rest_size % n) == 0)
-    {
-      // n is a prime factor, perform one "butterfly" stage of the fft.
-      if(n == 2)
-      {
-        this->ExecuteFftStep2(p1, p2, N, block_size, fb);
-      }
-      else
-      {
-        this->ExecuteFftStepN(p1, p2, N, block_size, n, fb);
-      }
-      block_size = block_size * n;
-      rest_size = rest_size / n;
-      // switch input and output.
-      p3 = p1;
-      p1 = p2;
-      p2 = p3;
-    }
-    else
-    {
-      // n is not a prime factor. increment n to see if n+1 is.
-      ++n;
-    }
+    real[idx] = in[idx].Real;
+    imag[idx] = in[idx].Imag;
   }
-  // If the results ended up in the input, copy to output.
-  if(p1 != out)
+  p->Execute(real, imag, imag + N, imag + 2 * N, 1, fb);
+  for (int idx = 0; idx < N; ++idx)
   {
-    for(n = 0; n < N; ++n)
-    {
-      *out++ = *p1++;
-    }
+    out[idx].Real = real[idx];
+    out[idx].Imag = imag[idx];
   }
 }
 
@@ -228,11 +216,188 @@ void vtkImageFourierFilter::ExecuteRfft(vtkImageComplex *in,
   this->ExecuteFftForwardBackward(in, out, N, -1);
 }
 
+//----------------------------------------------------------------------------
+// This templated function transforms the lines of any type of input, in
+// batches of lines that are gathered next to each other so that the
+// butterflies run over contiguous values.  The output is always doubles.
+template <class T>
+void vtkImageFourierFilterExecute(vtkImageFourierFilter *self,
+                                  const vtkImageFFTPlan *plan,
+                                  vtkImageData *inData, int inExt[6],
+                                  T *inPtr, vtkImageData *outData,
+                                  int outExt[6], double *outPtr, int id,
+                                  int direction)
+{
+  int inMin0, inMax0;
+  vtkIdType inInc0, inInc1, inInc2;
+  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+  vtkIdType outInc0, outInc1, outInc2;
+
+  // Reorder axes (The outs here are just placeholdes
+  self->PermuteExtent(inExt, inMin0, inMax0, outMin1,outMax1,outMin2,outMax2);
+  self->PermuteExtent(outExt, outMin0,outMax0,outMin1,outMax1,outMin2,outMax2);
+  self->PermuteIncrements(inData->GetIncrements(), inInc0, inInc1, inInc2);
+  self->PermuteIncrements(outData->GetIncrements(), outInc0, outInc1, outInc2);
+
+  const int n = inMax0 - inMin0 + 1;
+  if (plan->GetSize() != n)
+  {
+    vtkGenericWarningMacro("The transforms are not planned for " << n
+                           << " values.");
+    return;
+  }
+
+  // Input has to have real components at least.
+  int numberOfComponents = inData->GetNumberOfScalarComponents();
+  if (numberOfComponents < 1)
+  {
+    vtkGenericWarningMacro("No real components");
+    return;
+  }
+  const bool isReal = (numberOfComponents == 1);
+
+  // The lines of a batch, the scratch space of the transforms, and the
+  // results of real lines.
+  const int batch = plan->GetBatchSize();
+  const size_t batchSize = static_cast<size_t>(n) * batch;
+  std::vector<double> buffer(6 * batchSize);
+  double *real = &buffer[0];
+  double *imag = real + batchSize;
+  double *workReal = imag + batchSize;
+  double *workImag = workReal + batchSize;
+  double *pairReal = workImag + batchSize;
+  double *pairImag = pairReal + batchSize;
+
+  double startProgress =
+    self->GetIteration()/static_cast<double>(self->GetNumberOfIterations());
+  unsigned long count = 0;
+  unsigned long target = static_cast<unsigned long>(
+    (outMax2-outMin2+1)*(outMax1-outMin1+1)
+    * self->GetNumberOfIterations() / 50.0);
+  target++;
+  unsigned long nextUpdate = 0;
+
+  // loop over other axes
+  T *inPtr2 = inPtr;
+  double *outPtr2 = outPtr;
+  for (int idx2 = outMin2; idx2 <= outMax2; ++idx2)
+  {
+    T *inPtr1 = inPtr2;
+    double *outPtr1 = outPtr2;
+    for (int idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += batch)
+    {
+      const int lines = std::min(batch, outMax1 - idx1 + 1);
+      if (!id)
+      {
+        if (count >= nextUpdate)
+        {
+          self->UpdateProgress(count/(50.0*target) + startProgress);
+          nextUpdate += target;
+        }
+        count += lines;
+      }
+
+      // Gather the lines, real lines in pairs.
+      const int stride = isReal ? (lines + 1) / 2 : lines;
+      T *inPtr0 = inPtr1;
+      for (int k = 0; k < n; ++k)
+      {
+        double *pReal = real + static_cast<size_t>(k) * stride;
+        double *pImag = imag + static_cast<size_t>(k) * stride;
+        T *inPtrB = inPtr0;
+        if (isReal)
+        {
+          pImag[stride - 1] = 0.0;
+          for (int b = 0; b < lines; ++b)
+          {
+            double *p = (b & 1) ? pImag : pReal;
+            p[b / 2] = static_cast<double>(*inPtrB);
+            inPtrB += inInc1;
+          }
+        }
+        else
+        {
+          for (int b = 0; b < lines; ++b)
+          {
+            pReal[b] = static_cast<double>(inPtrB[0]);
+            pImag[b] = static_cast<double>(inPtrB[1]);
+            inPtrB += inInc1;
+          }
+        }
+        inPtr0 += inInc0;
+      }
+
+      // Call the method that performs the transforms
+      const double *resultReal = real;
+      const double *resultImag = imag;
+      int resultStride = stride;
+      if (isReal)
+      {
+        plan->ExecuteReal(real, imag, workReal, workImag, stride, direction,
+                          pairReal, pairImag);
+        resultReal = pairReal;
+        resultImag = pairImag;
+        resultStride = 2 * stride;
+      }
+      else
+      {
+        plan->Execute(real, imag, workReal, workImag, stride, direction);
+      }
+
+      // copy into output
+      double *outPtr0 = outPtr1;
+      for (int k = outMin0 - inMin0; k <= outMax0 - inMin0; ++k)
+      {
+        const double *pReal =
+          resultReal + static_cast<size_t>(k) * resultStride;
+        const double *pImag =
+          resultImag + static_cast<size_t>(k) * resultStride;
+        double *outPtrB = outPtr0;
+        for (int b = 0; b < lines; ++b)
+        {
+          outPtrB[0] = pReal[b];
+          outPtrB[1] = pImag[b];
+          outPtrB += outInc1;
+        }
+        outPtr0 += outInc0;
+      }
+      inPtr1 += lines * inInc1;
+      outPtr1 += lines * outInc1;
+    }
+    inPtr2 += inInc2;
+    outPtr2 += outInc2;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteLines(vtkImageData *inData, int inExt[6],
+                                         vtkImageData *outData,
+                                         int outExt[6], int threadId,
+                                         int direction)
+{
+  void *inPtr = inData->GetScalarPointerForExtent(inExt);
+  double *outPtr =
+    static_cast<double *>(outData->GetScalarPointerForExtent(outExt));
+
+  // choose which templated function to call.
+  switch (inData->GetScalarType())
+  {
+    vtkTemplateMacro(
+      vtkImageFourierFilterExecute(this, this->Plan, inData, inExt,
+                                   static_cast<VTK_TT *>(inPtr), outData,
+                                   outExt, outPtr, threadId, direction));
+    default:
+      vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      return;
+  }
+}
+
 //----------------------------------------------------------------------------
 // Called each axis over which the filter is executed.
-int vtkImageFourierFilter::RequestData(vtkInformation* request,
-                                       vtkInformationVector** inputVector,
-                                       vtkInformationVector* outputVector)
+int vtkImageFourierFilter::IterativeRequestData(
+  vtkInformation* request, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
 {
   // ensure that iteration axis is not split during threaded execution
   this->SplitPathLength = 0;
@@ -244,7 +409,17 @@ int vtkImageFourierFilter::RequestData(vtkInformation* request,
     }
   }
 
-  return this->Superclass::RequestData(request, inputVector, outputVector);
-}
-
+  // The whole input is needed along the axis, so all the lines of the
+  // axis have the same length.
+  vtkImageData *input = vtkImageData::GetData(inputVector[0]);
+  if (input)
+  {
+    int *extent = input->GetExtent();
+    int axis = this->Iteration;
+    this->Plan->Initialize(
+      std::max(extent[2*axis + 1] - extent[2*axis] + 1, 1));
+  }
 
+  return this->Superclass::IterativeRequestData(request, inputVector,
+                                                outputVector);
+}
@@ -85,6 +85,8 @@ typedef struct{
 
 /******************* End of COMPLEX number stuff ********************/
 
+class vtkImageFFTPlan;
+
 class VTKIMAGINGFOURIER_EXPORT vtkImageFourierFilter : public vtkImageDecomposeFilter
 {
 public:
@@ -109,8 +111,8 @@ public:
   void ExecuteRfft(vtkImageComplex *in, vtkImageComplex *out, int N);
 
 protected:
-  vtkImageFourierFilter() {}
-  ~vtkImageFourierFilter()VTK_OVERRIDE {}
+  vtkImageFourierFilter();
+  ~vtkImageFourierFilter() VTK_OVERRIDE;
 
   void ExecuteFftStep2(vtkImageComplex *p_in, vtkImageComplex *p_out,
                        int N, int bsize, int fb);
@@ -120,11 +122,24 @@ protected:
                                  int N, int fb);
 
   /**
-   * Override to change extent splitting rules.
+   * Transform the lines of inData along the current axis, in batches, and
+   * write them to outData.  The transforms are forward if direction is 1,
+   * and backward if it is -1.  Real input lines are transformed in pairs.
    */
-  int RequestData(vtkInformation* request,
-                  vtkInformationVector** inputVector,
-                  vtkInformationVector* outputVector) VTK_OVERRIDE;
+  void ExecuteLines(vtkImageData *inData, int inExt[6],
+                    vtkImageData *outData, int outExt[6],
+                    int threadId, int direction);
+
+  /**
+   * Override to change extent splitting rules, and to plan the
+   * transforms of the current axis.
+   */
+  int IterativeRequestData(vtkInformation* request,
+                           vtkInformationVector** inputVector,
+                           vtkInformationVector* outputVector) VTK_OVERRIDE;
+
+  // The transforms of the lines along the current axis.
+  vtkImageFFTPlan *Plan;
 
 private:
   vtkImageFourierFilter(const vtkImageFourierFilter&) VTK_DELETE_FUNCTION;
@@ -23,10 +23,9 @@
 #include "vtkTableFFT.h"
 
 #include "vtkDataArray.h"
-#include "vtkImageData.h"
-#include "vtkImageFFT.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageFFTPlan.h"
 #include "vtkObjectFactory.h"
-#include "vtkPointData.h"
 #include "vtkTable.h"
 
 #include "vtkSmartPointer.h"
@@ -34,6 +33,7 @@
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include <cstring>
+#include <vector>
 
 #include <vtksys/SystemTools.hxx>
 using namespace vtksys;
@@ -44,10 +44,12 @@ vtkStandardNewMacro(vtkTableFFT);
 //-----------------------------------------------------------------------------
 vtkTableFFT::vtkTableFFT()
 {
+  this->Plan = new vtkImageFFTPlan;
 }
 
 vtkTableFFT::~vtkTableFFT()
 {
+  delete this->Plan;
 }
 
 void vtkTableFFT::PrintSelf(ostream &os, vtkIndent indent)
@@ -99,17 +101,32 @@ int vtkTableFFT::RequestData(vtkInformation *vtkNotUsed(request),
 //-----------------------------------------------------------------------------
 vtkSmartPointer<vtkDataArray> vtkTableFFT::DoFFT(vtkDataArray *input)
 {
-  // Build an image data containing the input data.
-  VTK_CREATE(vtkImageData, imgInput);
-  imgInput->SetDimensions(input->GetNumberOfTuples(), 1, 1);
-  imgInput->SetScalarType(input->GetDataType(), input->GetInformation());
-  imgInput->GetPointData()->SetScalars(input);
-
-  // Compute the FFT
-  VTK_CREATE(vtkImageFFT, fft);
-  fft->SetInputData(imgInput);
-  fft->Update();
-
-  // Return the result
-  return vtkSmartPointer<vtkDataArray>(fft->GetOutput()->GetPointData()->GetScalars());
+  vtkIdType numTuples = input->GetNumberOfTuples();
+  VTK_CREATE(vtkDoubleArray, output);
+  output->SetNumberOfComponents(2);
+  output->SetNumberOfTuples(numTuples);
+  if (numTuples == 0)
+  {
+    return output;
+  }
+
+  // The plan is kept from one column to the next.
+  int n = static_cast<int>(numTuples);
+  this->Plan->Initialize(n);
+  std::vector<double> buffer(4 * n, 0.0);
+  double *real = &buffer[0];
+  double *imag = real + n;
+  for (int i = 0; i < n; ++i)
+  {
+    real[i] = input->GetComponent(i, 0);
+  }
+  this->Plan->Execute(real, imag, imag + n, imag + 2 * n, 1, 1);
+
+  double *values = output->GetPointer(0);
+  for (int i = 0; i < n; ++i)
+  {
+    values[2 * i] = real[i];
+    values[2 * i + 1] = imag[i];
+  }
+  return output;
 }
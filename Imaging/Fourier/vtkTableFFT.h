@@ -27,12 +27,13 @@
  *
  *
  * vtkTableFFT performs the Fast Fourier Transform on the columns of a table.
- * Internally, it shoves each column into an image data and then uses
- * vtkImageFFT to perform the actual FFT.
+ * The columns have the same length, so they are all transformed with the
+ * same vtkImageFFTPlan, the one vtkImageFFT uses.  The results are complex
+ * doubles, as the output of vtkImageFFT.
  *
  *
  * @sa
- * vtkImageFFT
+ * vtkImageFFT vtkImageFFTPlan
  *
 */
 
@@ -43,6 +44,8 @@
 #include "vtkImagingFourierModule.h" // For export macro
 #include "vtkSmartPointer.h"    // For internal method.
 
+class vtkImageFFTPlan;
+
 class VTKIMAGINGFOURIER_EXPORT vtkTableFFT : public vtkTableAlgorithm
 {
 public:
@@ -63,6 +66,9 @@ protected:
    */
   virtual vtkSmartPointer<vtkDataArray> DoFFT(vtkDataArray *input);
 
+  // The transforms of the columns.
+  vtkImageFFTPlan *Plan;
+
 private:
   vtkTableFFT(const vtkTableFFT &) VTK_DELETE_FUNCTION;
   void operator=(const vtkTableFFT &) VTK_DELETE_FUNCTION;
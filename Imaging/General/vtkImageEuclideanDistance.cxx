@@ -18,9 +18,11 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageEuclideanDistance);
 
@@ -32,6 +34,14 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
   this->Initialize = 1;
   this->ConsiderAnisotropy = 1;
   this->Algorithm = VTK_EDT_SAITO;
+  this->SignedDistance = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageEuclideanDistance::ComputeSignedDistance()
+{
+  return this->SignedDistance && this->Initialize &&
+    this->Algorithm == VTK_EDT_FELZENSZWALB;
 }
 
 //----------------------------------------------------------------------------
@@ -39,7 +49,16 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
 int vtkImageEuclideanDistance::IterativeRequestInformation(
   vtkInformation* vtkNotUsed(input), vtkInformation* output)
 {
-  vtkDataObject::SetPointDataActiveScalarInfo(output, VTK_DOUBLE, 1);
+  // Signed distances keep the distances to the zero voxels and to the
+  // non-zero voxels apart until the last iteration.
+  int numComponents = 1;
+  if (this->ComputeSignedDistance() &&
+      this->Iteration < this->NumberOfIterations - 1)
+  {
+    numComponents = 2;
+  }
+  vtkDataObject::SetPointDataActiveScalarInfo(output, VTK_DOUBLE,
+                                              numComponents);
   return 1;
 }
 
@@ -554,12 +573,194 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
   free(temp);
   free(sq);
 }
+//----------------------------------------------------------------------------
+// Execute the algorithm of Felzenszwalb and Huttenlocher on the lines along
+// the current axis, in parallel.
+//
+// P.F. Felzenszwalb and D.P. Huttenlocher. Distance Transforms of Sampled
+// Functions. Theory of Computing, 8(19). pp. 415--428, 2012.
+//
+// Each line is read from the input, the image itself in the first
+// iteration and the previous squared distances after, and its squared
+// distances are written to the output.  For signed distances, the two
+// components hold the squared distances to the zero voxels and to the
+// non-zero voxels until the last iteration, which subtracts them.
+template <class T>
+class vtkImageEuclideanDistanceFelzenszwalbLines
+{
+public:
+  vtkImageEuclideanDistanceFelzenszwalbLines(
+    vtkImageEuclideanDistance *self, vtkImageData *inData, T *inPtr,
+    vtkImageData *outData, int outExt[6], double *outPtr, int initialize,
+    int isSigned)
+    : InPtr(inPtr), OutPtr(outPtr), Initialize(initialize)
+  {
+    int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+    self->PermuteExtent(outExt, outMin0, outMax0, outMin1, outMax1,
+                        outMin2, outMax2);
+    self->PermuteIncrements(inData->GetIncrements(), this->InInc0,
+                            this->InInc1, this->InInc2);
+    self->PermuteIncrements(outData->GetIncrements(), this->OutInc0,
+                            this->OutInc1, this->OutInc2);
+    this->Size0 = outMax0 - outMin0 + 1;
+    this->Size1 = outMax1 - outMin1 + 1;
+    this->NumberOfLines = static_cast<vtkIdType>(this->Size1) *
+      (outMax2 - outMin2 + 1);
+    this->OutComponents = outData->GetNumberOfScalarComponents();
+    this->NumberOfChannels = isSigned ? 2 : 1;
+    this->MaximumDistance = self->GetMaximumDistance();
+    this->Weight = 1.0;
+    if (self->GetConsiderAnisotropy())
+    {
+      double spacing = outData->GetSpacing()[self->GetIteration()];
+      this->Weight = spacing * spacing;
+    }
+  }
+
+  vtkIdType GetNumberOfLines() const { return this->NumberOfLines; }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const int n = this->Size0;
+    std::vector<double> f(n);
+    std::vector<double> d(this->NumberOfChannels * n);
+    std::vector<int> v(n);
+    std::vector<double> z(n + 1);
+
+    for (vtkIdType line = begin; line < end; ++line)
+    {
+      vtkIdType idx1 = line % this->Size1;
+      vtkIdType idx2 = line / this->Size1;
+      const T *inPtr0 = this->InPtr + idx1 * this->InInc1 +
+        idx2 * this->InInc2;
+      double *outPtr0 = this->OutPtr + idx1 * this->OutInc1 +
+        idx2 * this->OutInc2;
+
+      for (int c = 0; c < this->NumberOfChannels; ++c)
+      {
+        // Sample the line.
+        const T *inPtr = inPtr0;
+        for (int i = 0; i < n; ++i, inPtr += this->InInc0)
+        {
+          if (!this->Initialize)
+          {
+            f[i] = static_cast<double>(inPtr[c]);
+          }
+          else if ((*inPtr == 0) == (c == 0))
+          {
+            f[i] = 0.0;
+          }
+          else
+          {
+            f[i] = this->MaximumDistance;
+          }
+        }
+        this->LowerEnvelope(&f[0], &d[c * n], &v[0], &z[0]);
+      }
+
+      double *outPtr = outPtr0;
+      if (this->NumberOfChannels == 2 && this->OutComponents == 1)
+      {
+        for (int i = 0; i < n; ++i, outPtr += this->OutInc0)
+        {
+          *outPtr = d[i] - d[n + i];
+        }
+      }
+      else
+      {
+        for (int i = 0; i < n; ++i, outPtr += this->OutInc0)
+        {
+          for (int c = 0; c < this->NumberOfChannels; ++c)
+          {
+            outPtr[c] = d[c * n + i];
+          }
+        }
+      }
+    }
+  }
+
+protected:
+  // Compute d[p] = min over q of Weight*(p - q)^2 + f[q] by finding the
+  // lower envelope of the parabolas rooted at each q, whose locations are
+  // kept in v and the boundaries between them in z.
+  void LowerEnvelope(const double *f, double *d, int *v, double *z) const
+  {
+    const int n = this->Size0;
+    const double w = this->Weight;
+    int k = 0;
+    v[0] = 0;
+    z[0] = -VTK_DOUBLE_MAX;
+    z[1] = VTK_DOUBLE_MAX;
+    for (int q = 1; q < n; ++q)
+    {
+      double s;
+      for (;;)
+      {
+        int r = v[k];
+        s = ((f[q] + w * q * q) - (f[r] + w * r * r)) / (2.0 * w * (q - r));
+        if (s > z[k])
+        {
+          break;
+        }
+        --k;
+      }
+      ++k;
+      v[k] = q;
+      z[k] = s;
+      z[k + 1] = VTK_DOUBLE_MAX;
+    }
+
+    k = 0;
+    for (int p = 0; p < n; ++p)
+    {
+      while (z[k + 1] < p)
+      {
+        ++k;
+      }
+      double dp = p - v[k];
+      d[p] = w * dp * dp + f[v[k]];
+    }
+  }
+
+  const T *InPtr;
+  double *OutPtr;
+  vtkIdType InInc0, InInc1, InInc2;
+  vtkIdType OutInc0, OutInc1, OutInc2;
+  int Size0;
+  int Size1;
+  vtkIdType NumberOfLines;
+  int OutComponents;
+  int NumberOfChannels;
+  int Initialize;
+  double MaximumDistance;
+  double Weight;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageEuclideanDistanceExecuteFelzenszwalb(
+  vtkImageEuclideanDistance *self, vtkImageData *inData, T *inPtr,
+  vtkImageData *outData, int outExt[6], double *outPtr, int isSigned)
+{
+  // Only the first iteration initializes the distances from the input.
+  int initialize = (self->GetIteration() == 0 && self->GetInitialize());
+  vtkImageEuclideanDistanceFelzenszwalbLines<T> lines(
+    self, inData, inPtr, outData, outExt, outPtr, initialize, isSigned);
+  vtkSMPTools::For(0, lines.GetNumberOfLines(), lines);
+}
+
 //----------------------------------------------------------------------------
 void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData,
                                                       int outExt[6],
                                                       vtkInformation* outInfo)
 {
   outData->SetExtent(outExt);
+  // The data of intermediate iterations gets no spacing from the pipeline,
+  // and the anisotropic distances need it.
+  if (outInfo->Has(vtkDataObject::SPACING()))
+  {
+    outData->SetSpacing(outInfo->Get(vtkDataObject::SPACING()));
+  }
   outData->AllocateScalars(outInfo);
 }
 
@@ -615,13 +816,37 @@ int vtkImageEuclideanDistance::IterativeRequestData(
     return 1;
   }
 
-  // this filter expects input to have 1 components
-  if (outData->GetNumberOfScalarComponents() != 1 )
+  // this filter expects output to have 1 components, or 2 for the
+  // intermediate signed distances
+  if (outData->GetNumberOfScalarComponents() != 1 &&
+      !(this->ComputeSignedDistance() &&
+        outData->GetNumberOfScalarComponents() == 2))
   {
     vtkErrorMacro(<< "Execute: Cannot handle more than 1 components");
     return 1;
   }
 
+  // The Felzenszwalb algorithm reads the input itself.
+  if ( this->GetAlgorithm() == VTK_EDT_FELZENSZWALB )
+  {
+    int isSigned = this->ComputeSignedDistance();
+    switch (inData->GetScalarType())
+    {
+      vtkTemplateMacro(
+        vtkImageEuclideanDistanceExecuteFelzenszwalb(this,
+                                                     inData,
+                                                     static_cast<VTK_TT *>(inPtr),
+                                                     outData, outExt,
+                                                     static_cast<double *>(outPtr),
+                                                     isSigned ));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return 1;
+    }
+    this->UpdateProgress((this->GetIteration()+1.0)/3.0);
+    return 1;
+  }
+
   if ( this->GetIteration() == 0 )
   {
     switch (inData->GetScalarType())
@@ -690,8 +915,15 @@ void vtkImageEuclideanDistance::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << "Saito\n";
   }
+  else if ( this->Algorithm == VTK_EDT_FELZENSZWALB )
+  {
+    os << "Felzenszwalb\n";
+  }
   else
   {
     os << "Saito Cached\n";
   }
+
+  os << indent << "Signed Distance: "
+     << (this->SignedDistance ? "On\n" : "Off\n");
 }
@@ -31,6 +31,12 @@
  * slow it very significantly. In that case, one should use
  * ::SetAlgorithmToSaitoCached() instead for better performance.
  *
+ * ::SetAlgorithmToFelzenszwalb() selects the algorithm of Felzenszwalb and
+ * Huttenlocher instead, which computes the lower envelope of the parabolas
+ * of each line, and is linear in the number of voxels whatever the
+ * distances.  The lines of each axis are processed in parallel.  This
+ * algorithm can also compute signed distances, see SignedDistance.
+ *
  * References:
  *
  * T. Saito and J.I. Toriwaki. New algorithms for Euclidean distance
@@ -40,6 +46,9 @@
  * O. Cuisenaire. Distance Transformation: fast algorithms and applications
  * to medical image processing. PhD Thesis, Universite catholique de Louvain,
  * October 1999. http://ltswww.epfl.ch/~cuisenai/papers/oc_thesis.pdf
+ *
+ * P.F. Felzenszwalb and D.P. Huttenlocher. Distance Transforms of Sampled
+ * Functions. Theory of Computing, 8(19). pp. 415--428, 2012.
 */
 
 #ifndef vtkImageEuclideanDistance_h
@@ -50,6 +59,7 @@
 
 #define VTK_EDT_SAITO_CACHED 0
 #define VTK_EDT_SAITO 1
+#define VTK_EDT_FELZENSZWALB 2
 
 class VTKIMAGINGGENERAL_EXPORT vtkImageEuclideanDistance : public vtkImageDecomposeFilter
 {
@@ -94,7 +104,7 @@ public:
    * Selects a Euclidean DT algorithm.
    * 1. Saito
    * 2. Saito-cached
-   * More algorithms will be added later on.
+   * 3. Felzenszwalb
    */
   vtkSetMacro(Algorithm, int);
   vtkGetMacro(Algorithm, int);
@@ -102,6 +112,21 @@ public:
     { this->SetAlgorithm(VTK_EDT_SAITO); }
   void SetAlgorithmToSaitoCached ()
     { this->SetAlgorithm(VTK_EDT_SAITO_CACHED); }
+  void SetAlgorithmToFelzenszwalb ()
+    { this->SetAlgorithm(VTK_EDT_FELZENSZWALB); }
+  //@}
+
+  //@{
+  /**
+   * Used to compute signed distances with the Felzenszwalb algorithm and
+   * Initialize on.  The non-zero voxels then get the square of their
+   * distance to the nearest zero voxel, as usual, and the zero voxels get
+   * the square of their distance to the nearest non-zero voxel, negated.
+   * Off by default.
+   */
+  vtkSetMacro(SignedDistance, int);
+  vtkGetMacro(SignedDistance, int);
+  vtkBooleanMacro(SignedDistance, int);
   //@}
 
   int IterativeRequestData(vtkInformation*,
@@ -116,6 +141,11 @@ protected:
   int Initialize;
   int ConsiderAnisotropy;
   int Algorithm;
+  int SignedDistance;
+
+  // Whether the distances to the zero voxels and to the non-zero voxels
+  // are both computed.
+  int ComputeSignedDistance();
 
   // Replaces "EnlargeOutputUpdateExtent"
   virtual void AllocateOutputScalars(vtkImageData *outData,
@@ -18,9 +18,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageGaussianSmooth);
 
@@ -34,6 +37,7 @@ vtkImageGaussianSmooth::vtkImageGaussianSmooth()
   this->RadiusFactors[0] = 1.5;
   this->RadiusFactors[1] = 1.5;
   this->RadiusFactors[2] = 1.5;
+  this->Algorithm = VTK_GAUSSIAN_SMOOTH_FIR;
 }
 
 //----------------------------------------------------------------------------
@@ -61,6 +65,21 @@ void vtkImageGaussianSmooth::PrintSelf(ostream& os, vtkIndent indent)
      << this->StandardDeviations[0] << ", "
      << this->StandardDeviations[1] << ", "
      << this->StandardDeviations[2] << " )\n";
+
+  os << indent << "Algorithm: " << this->GetAlgorithmAsString() << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char *vtkImageGaussianSmooth::GetAlgorithmAsString()
+{
+  switch (this->Algorithm)
+  {
+    case VTK_GAUSSIAN_SMOOTH_FIR:
+      return "FIR";
+    case VTK_GAUSSIAN_SMOOTH_RECURSIVE:
+      return "Recursive";
+  }
+  return "Unknown";
 }
 
 //----------------------------------------------------------------------------
@@ -125,6 +144,14 @@ void vtkImageGaussianSmooth::InternalRequestUpdateExtent(int *inExt,
   // Expand filtered axes
   for (idx = 0; idx < this->Dimensionality; ++idx)
   {
+    // the impulse response of the recursive filter is infinite
+    if (this->Algorithm == VTK_GAUSSIAN_SMOOTH_RECURSIVE)
+    {
+      inExt[idx*2] = wholeExtent[idx*2];
+      inExt[idx*2+1] = wholeExtent[idx*2+1];
+      continue;
+    }
+
     radius = static_cast<int>(this->StandardDeviations[idx]
                               * this->RadiusFactors[idx]);
     inExt[idx*2] -= radius;
@@ -462,3 +489,381 @@ void vtkImageGaussianSmooth::ThreadedRequestData(
       break;
   }
 }
+
+//----------------------------------------------------------------------------
+// Compute the coefficients of the recursive filter of Young and van Vliet
+// for the given standard deviation,
+//   w[k] = b*x[k] + a[0]*w[k-1] + a[1]*w[k-2] + a[2]*w[k-3],
+// which is run forward and then backward along each line.  Also compute the
+// matrix m of Triggs and Sdika, which gives the three values that follow
+// the end of the line in the backward pass from the deviations of the last
+// three values of the forward pass from the last value of the line, as if
+// the line went on with its last value.  Rather than using the closed form
+// of the matrix, the filter is run on each of the three deviations until
+// its response dies out, which only has to be done once per axis.
+static void vtkImageGaussianSmoothRecursiveCoefficients(double std,
+                                                        double *b,
+                                                        double a[3],
+                                                        double m[9])
+{
+  double q;
+  if (std >= 2.5)
+  {
+    q = 0.98711*std - 0.96330;
+  }
+  else
+  {
+    std = std::max(std, 0.5);
+    q = 3.97156 - 4.14554*sqrt(1.0 - 0.26891*std);
+  }
+  double q2 = q*q;
+  double q3 = q2*q;
+  double b0 = 1.57825 + 2.44413*q + 1.4281*q2 + 0.422205*q3;
+  a[0] = (2.44413*q + 2.85619*q2 + 1.26661*q3)/b0;
+  a[1] = -(1.4281*q2 + 1.26661*q3)/b0;
+  a[2] = 0.422205*q3/b0;
+  *b = 1.0 - a[0] - a[1] - a[2];
+
+  // find how many samples it takes for the impulse response to die out
+  std::vector<double> w(3, 0.0);
+  w[2] = 1.0;
+  double peak = 1.0;
+  for (size_t k = 3; k < 6 || fabs(w[k-1]) + fabs(w[k-2]) + fabs(w[k-3]) >
+       1e-17*peak; ++k)
+  {
+    w.push_back(a[0]*w[k-1] + a[1]*w[k-2] + a[2]*w[k-3]);
+    peak = std::max(peak, fabs(w[k]));
+  }
+  int n = static_cast<int>(w.size()) - 3;
+
+  for (int j = 0; j < 3; ++j)
+  {
+    // forward pass beyond the end of the line
+    double w1 = (j == 0), w2 = (j == 1), w3 = (j == 2);
+    for (int k = 0; k < n; ++k)
+    {
+      w[k] = a[0]*w1 + a[1]*w2 + a[2]*w3;
+      w3 = w2; w2 = w1; w1 = w[k];
+    }
+    // backward pass back to the end of the line
+    double y1 = 0.0, y2 = 0.0, y3 = 0.0;
+    for (int k = n - 1; k >= 0; --k)
+    {
+      double y = (*b)*w[k] + a[0]*y1 + a[1]*y2 + a[2]*y3;
+      y3 = y2; y2 = y1; y1 = y;
+      if (k < 3)
+      {
+        m[3*k + j] = y;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// This functor runs the recursive filter along all the lines of one axis of
+// a double image with interleaved components.  The lines are filtered in
+// batches of neighbors, whose samples are interleaved in a buffer so that
+// the inner loops go across the batch.
+class vtkImageGaussianSmoothRecursiveLines
+{
+public:
+  enum { BatchSize = 8 };
+
+  vtkImageGaussianSmoothRecursiveLines(double *data, int numComp,
+                                       const int dims[3], int axis,
+                                       double std)
+  {
+    vtkImageGaussianSmoothRecursiveCoefficients(std, &this->B, this->A,
+                                                this->M);
+    vtkIdType incs[3];
+    incs[0] = numComp;
+    incs[1] = incs[0]*dims[0];
+    incs[2] = incs[1]*dims[1];
+
+    this->Data = data;
+    this->Size = dims[axis];
+    this->Increment = incs[axis];
+    // the lines are ordered by component and then by the other axes
+    this->LineCounts[0] = numComp;
+    this->LineIncs[0] = 1;
+    int j = 1;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (i != axis)
+      {
+        this->LineCounts[j] = dims[i];
+        this->LineIncs[j] = incs[i];
+        ++j;
+      }
+    }
+    this->NumberOfLines = static_cast<vtkIdType>(this->LineCounts[0])*
+      this->LineCounts[1]*this->LineCounts[2];
+  }
+
+  vtkIdType GetNumberOfBatches() const
+  {
+    return (this->NumberOfLines + BatchSize - 1)/BatchSize;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const int n = this->Size;
+    std::vector<double> buffer(static_cast<size_t>(n)*BatchSize);
+    double *starts[BatchSize];
+
+    for (vtkIdType batch = begin; batch < end; ++batch)
+    {
+      vtkIdType firstLine = batch*BatchSize;
+      int count = static_cast<int>(
+        std::min<vtkIdType>(BatchSize, this->NumberOfLines - firstLine));
+      for (int b = 0; b < count; ++b)
+      {
+        vtkIdType line = firstLine + b;
+        vtkIdType idx0 = line % this->LineCounts[0];
+        line /= this->LineCounts[0];
+        vtkIdType idx1 = line % this->LineCounts[1];
+        vtkIdType idx2 = line / this->LineCounts[1];
+        starts[b] = this->Data + idx0*this->LineIncs[0] +
+          idx1*this->LineIncs[1] + idx2*this->LineIncs[2];
+      }
+
+      // gather the lines, and fill the unused lanes with zero
+      double *ptr = &buffer[0];
+      vtkIdType offset = 0;
+      for (int k = 0; k < n; ++k)
+      {
+        int b = 0;
+        for (; b < count; ++b)
+        {
+          ptr[b] = starts[b][offset];
+        }
+        for (; b < BatchSize; ++b)
+        {
+          ptr[b] = 0.0;
+        }
+        ptr += BatchSize;
+        offset += this->Increment;
+      }
+
+      this->Filter(&buffer[0]);
+
+      // scatter the results
+      ptr = &buffer[0];
+      offset = 0;
+      for (int k = 0; k < n; ++k)
+      {
+        for (int b = 0; b < count; ++b)
+        {
+          starts[b][offset] = ptr[b];
+        }
+        ptr += BatchSize;
+        offset += this->Increment;
+      }
+    }
+  }
+
+protected:
+  // Filter the interleaved lines in place, forward and then backward.
+  void Filter(double *buffer) const
+  {
+    const int n = this->Size;
+    const double b0 = this->B;
+    const double a1 = this->A[0];
+    const double a2 = this->A[1];
+    const double a3 = this->A[2];
+    double first[BatchSize], last[BatchSize];
+    double w1[BatchSize], w2[BatchSize], w3[BatchSize];
+
+    // the forward pass starts from the steady state of the first value
+    double *ptr = buffer;
+    double *lastPtr = buffer + static_cast<size_t>(n - 1)*BatchSize;
+    for (int b = 0; b < BatchSize; ++b)
+    {
+      first[b] = ptr[b];
+      last[b] = lastPtr[b];
+      w1[b] = first[b];
+      w2[b] = first[b];
+      w3[b] = first[b];
+    }
+    for (int k = 0; k < n; ++k)
+    {
+      for (int b = 0; b < BatchSize; ++b)
+      {
+        double w = b0*ptr[b] + a1*w1[b] + a2*w2[b] + a3*w3[b];
+        w3[b] = w2[b];
+        w2[b] = w1[b];
+        w1[b] = w;
+        ptr[b] = w;
+      }
+      ptr += BatchSize;
+    }
+
+    // the backward pass starts from the values that it would have if the
+    // line went on with its last value, where values before the start of
+    // short lines are the steady state of the first value
+    for (int b = 0; b < BatchSize; ++b)
+    {
+      double d[3];
+      for (int j = 0; j < 3; ++j)
+      {
+        int k = n - 1 - j;
+        d[j] = (k >= 0 ? buffer[static_cast<size_t>(k)*BatchSize + b] :
+                first[b]) - last[b];
+      }
+      const double *m = this->M;
+      w1[b] = m[0]*d[0] + m[1]*d[1] + m[2]*d[2] + last[b];
+      w2[b] = m[3]*d[0] + m[4]*d[1] + m[5]*d[2] + last[b];
+      w3[b] = m[6]*d[0] + m[7]*d[1] + m[8]*d[2] + last[b];
+    }
+    for (int k = n - 1; k >= 0; --k)
+    {
+      ptr -= BatchSize;
+      for (int b = 0; b < BatchSize; ++b)
+      {
+        double y = b0*ptr[b] + a1*w1[b] + a2*w2[b] + a3*w3[b];
+        w3[b] = w2[b];
+        w2[b] = w1[b];
+        w1[b] = y;
+        ptr[b] = y;
+      }
+    }
+  }
+
+  double *Data;
+  int Size;
+  vtkIdType Increment;
+  int LineCounts[3];
+  vtkIdType LineIncs[3];
+  vtkIdType NumberOfLines;
+  double B;
+  double A[3];
+  double M[9];
+};
+
+//----------------------------------------------------------------------------
+// Copy the input into a double image, run the recursive filter along each
+// axis, and copy the requested extent into the output.
+template <class T>
+void vtkImageGaussianSmoothRecursiveExecute(vtkImageGaussianSmooth *self,
+                                            vtkImageData *inData,
+                                            int workExt[6],
+                                            vtkImageData *outData,
+                                            int outExt[6], T *)
+{
+  int numComp = inData->GetNumberOfScalarComponents();
+  int dims[3];
+  dims[0] = workExt[1] - workExt[0] + 1;
+  dims[1] = workExt[3] - workExt[2] + 1;
+  dims[2] = workExt[5] - workExt[4] + 1;
+  vtkIdType rowSize = static_cast<vtkIdType>(dims[0])*numComp;
+  std::vector<double> work(rowSize*dims[1]*dims[2]);
+
+  T *inPtr = static_cast<T *>(inData->GetScalarPointerForExtent(workExt));
+  vtkIdType inIncX, inIncY, inIncZ;
+  inData->GetContinuousIncrements(workExt, inIncX, inIncY, inIncZ);
+  double *workPtr = &work[0];
+  for (int idxZ = 0; idxZ < dims[2]; ++idxZ)
+  {
+    for (int idxY = 0; idxY < dims[1]; ++idxY)
+    {
+      for (vtkIdType idxR = 0; idxR < rowSize; ++idxR)
+      {
+        *workPtr++ = static_cast<double>(*inPtr++);
+      }
+      inPtr += inIncY;
+    }
+    inPtr += inIncZ;
+  }
+
+  int dimensionality = std::min(self->GetDimensionality(), 3);
+  const double *stds = self->GetStandardDeviations();
+  for (int axis = 0; axis < dimensionality && !self->AbortExecute; ++axis)
+  {
+    if (stds[axis] > 0.0)
+    {
+      vtkImageGaussianSmoothRecursiveLines lines(&work[0], numComp, dims,
+                                                 axis, stds[axis]);
+      vtkSMPTools::For(0, lines.GetNumberOfBatches(), lines);
+    }
+    self->UpdateProgress(static_cast<double>(axis + 1)/dimensionality);
+  }
+
+  T *outPtr = static_cast<T *>(outData->GetScalarPointerForExtent(outExt));
+  vtkIdType outIncX, outIncY, outIncZ;
+  outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
+  vtkIdType outRowSize =
+    static_cast<vtkIdType>(outExt[1] - outExt[0] + 1)*numComp;
+  for (int idxZ = outExt[4]; idxZ <= outExt[5]; ++idxZ)
+  {
+    for (int idxY = outExt[2]; idxY <= outExt[3]; ++idxY)
+    {
+      workPtr = &work[0] +
+        ((idxZ - workExt[4])*static_cast<vtkIdType>(dims[1]) +
+         (idxY - workExt[2]))*rowSize + (outExt[0] - workExt[0])*numComp;
+      for (vtkIdType idxR = 0; idxR < outRowSize; ++idxR)
+      {
+        *outPtr++ = static_cast<T>(*workPtr++);
+      }
+      outPtr += outIncY;
+    }
+    outPtr += outIncZ;
+  }
+}
+
+//----------------------------------------------------------------------------
+// The FIR algorithm is threaded over pieces of the output by the
+// superclass, while the recursive algorithm needs whole lines along the
+// filtered axes and is threaded over the lines instead.
+int vtkImageGaussianSmooth::RequestData(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  if (this->Algorithm != VTK_GAUSSIAN_SMOOTH_RECURSIVE)
+  {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+  }
+
+  vtkImageData *inData = 0;
+  vtkImageData **inDataPtr = &inData;
+  vtkImageData *outData = 0;
+  this->PrepareImageData(inputVector, outputVector, &inDataPtr, &outData);
+  if (!inData || !outData)
+  {
+    return 1;
+  }
+
+  // this filter expects that input is the same type as output.
+  if (inData->GetScalarType() != outData->GetScalarType())
+  {
+    vtkErrorMacro("Execute: input ScalarType, "
+                  << inData->GetScalarType()
+                  << ", must match out ScalarType "
+                  << outData->GetScalarType());
+    return 1;
+  }
+
+  int outExt[6], workExt[6], wholeExt[6];
+  outData->GetExtent(outExt);
+  if (outExt[0] > outExt[1] || outExt[2] > outExt[3] || outExt[4] > outExt[5])
+  {
+    return 1;
+  }
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+  std::copy(outExt, outExt + 6, workExt);
+  this->InternalRequestUpdateExtent(workExt, wholeExt);
+
+  switch (inData->GetScalarType())
+  {
+    vtkTemplateMacro(
+      vtkImageGaussianSmoothRecursiveExecute(this, inData, workExt,
+                                             outData, outExt,
+                                             static_cast<VTK_TT *>(0)));
+    default:
+      vtkErrorMacro("Unknown scalar type");
+      return 1;
+  }
+
+  return 1;
+}
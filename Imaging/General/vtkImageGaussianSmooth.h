@@ -18,6 +18,31 @@
  *
  * vtkImageGaussianSmooth implements a convolution of the input image
  * with a gaussian. Supports from one to three dimensional convolutions.
+ *
+ * By default the gaussian is sampled out to the radius set by the
+ * RadiusFactors, so the cost of each pixel grows with the standard
+ * deviation.  SetAlgorithmToRecursive() instead approximates the gaussian
+ * with the third order recursive (IIR) filter of Young and van Vliet, run
+ * forward and then backward along each line, whose cost does not depend
+ * on the standard deviation.  The approximation is less accurate,
+ * especially for standard deviations below 1 pixel, and standard
+ * deviations below 0.5 pixels are raised to 0.5.  The recursive filter
+ * extends the image by repeating its edge values, using the initial
+ * conditions of Triggs and Sdika at the end of the lines, instead of
+ * renormalizing the kernel where it is clipped, and it needs the whole
+ * extent of the input along the filtered axes.  It is threaded across
+ * batches of neighboring lines that are filtered together, which lets the
+ * compiler vectorize the recursions, and it works on a double precision
+ * copy of the image.
+ *
+ * References:
+ *
+ * I.T. Young and L.J. van Vliet. Recursive implementation of the Gaussian
+ * filter. Signal Processing, 44(2), pp. 139--151, 1995.
+ *
+ * B. Triggs and M. Sdika. Boundary conditions for Young-van Vliet
+ * recursive filtering. IEEE Transactions on Signal Processing, 54(6),
+ * pp. 2365--2367, 2006.
 */
 
 #ifndef vtkImageGaussianSmooth_h
@@ -27,6 +52,9 @@
 #include "vtkImagingGeneralModule.h" // For export macro
 #include "vtkThreadedImageAlgorithm.h"
 
+#define VTK_GAUSSIAN_SMOOTH_FIR 0
+#define VTK_GAUSSIAN_SMOOTH_RECURSIVE 1
+
 class VTKIMAGINGGENERAL_EXPORT vtkImageGaussianSmooth : public vtkThreadedImageAlgorithm
 {
 public:
@@ -84,6 +112,23 @@ public:
   vtkGetMacro(Dimensionality, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get the algorithm used for the convolution.  "FIR" convolves with
+   * the gaussian kernel clamped at the radius, and "Recursive" uses the
+   * recursive approximation of the gaussian, which ignores the
+   * RadiusFactors.  The default is "FIR".
+   */
+  vtkSetClampMacro(Algorithm, int, VTK_GAUSSIAN_SMOOTH_FIR,
+                   VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  void SetAlgorithmToFIR() {
+    this->SetAlgorithm(VTK_GAUSSIAN_SMOOTH_FIR); };
+  void SetAlgorithmToRecursive() {
+    this->SetAlgorithm(VTK_GAUSSIAN_SMOOTH_RECURSIVE); };
+  vtkGetMacro(Algorithm, int);
+  const char *GetAlgorithmAsString();
+  //@}
+
 protected:
   vtkImageGaussianSmooth();
   ~vtkImageGaussianSmooth() VTK_OVERRIDE;
@@ -91,6 +136,7 @@ protected:
   int Dimensionality;
   double StandardDeviations[3];
   double RadiusFactors[3];
+  int Algorithm;
 
   void ComputeKernel(double *kernel, int min, int max, double std);
   int RequestUpdateExtent (vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
@@ -104,6 +150,9 @@ protected:
                            vtkInformationVector *outputVector,
                            vtkImageData ***inData, vtkImageData **outData,
                            int outExt[6], int id) VTK_OVERRIDE;
+  int RequestData(vtkInformation *request,
+                  vtkInformationVector **inputVector,
+                  vtkInformationVector *outputVector) VTK_OVERRIDE;
 
 private:
   vtkImageGaussianSmooth(const vtkImageGaussianSmooth&) VTK_DELETE_FUNCTION;
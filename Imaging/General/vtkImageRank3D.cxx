@@ -0,0 +1,512 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageRank3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkImageRank3D.h"
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkTypeTraits.h"
+
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkImageRank3D);
+
+//-----------------------------------------------------------------------------
+// Construct an instance of vtkImageRank3D filter.
+vtkImageRank3D::vtkImageRank3D()
+{
+  this->NumberOfElements = 0;
+  this->SetKernelSize(1,1,1);
+  this->HandleBoundaries = 1;
+  this->Operation = VTK_IMAGE_RANK_MEDIAN;
+  this->Percentile = 50.0;
+}
+
+//-----------------------------------------------------------------------------
+vtkImageRank3D::~vtkImageRank3D()
+{
+}
+
+//-----------------------------------------------------------------------------
+void vtkImageRank3D::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfElements: " << this->NumberOfElements << endl;
+  os << indent << "Operation: " << this->GetOperationAsString() << "\n";
+  os << indent << "Percentile: " << this->Percentile << "\n";
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkImageRank3D::GetOperationAsString()
+{
+  switch (this->Operation)
+  {
+    case VTK_IMAGE_RANK_MEDIAN:
+      return "Median";
+    case VTK_IMAGE_RANK_PERCENTILE:
+      return "Percentile";
+    case VTK_IMAGE_RANK_MIN:
+      return "Min";
+    case VTK_IMAGE_RANK_MAX:
+      return "Max";
+    default:
+      return "";
+  }
+}
+
+//-----------------------------------------------------------------------------
+// This method sets the size of the neighborhood.  It also sets the
+// default middle of the neighborhood
+void vtkImageRank3D::SetKernelSize(int size0, int size1, int size2)
+{
+  if (this->KernelSize[0] == size0 && this->KernelSize[1] == size1 &&
+      this->KernelSize[2] == size2)
+  {
+    return;
+  }
+
+  this->KernelSize[0] = size0;
+  this->KernelMiddle[0] = size0 / 2;
+  this->KernelSize[1] = size1;
+  this->KernelMiddle[1] = size1 / 2;
+  this->KernelSize[2] = size2;
+  this->KernelMiddle[2] = size2 / 2;
+  this->NumberOfElements = size0 * size1 * size2;
+  this->Modified();
+}
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// The histogram of the values of a neighborhood.  Each bin of its coarse
+// level counts the values of Width consecutive bins, so that the bin of a
+// rank can be found in a few steps.  The bin of the last rank found is
+// kept, along with the number of values below it, since the next rank is
+// usually close.
+template <class T>
+class vtkImageRankHistogram
+{
+public:
+  enum
+  {
+    Bits = 8 * sizeof(T),
+    NumberOfBins = 1 << Bits,
+    Shift = Bits / 2,
+    Width = 1 << Shift
+  };
+
+  vtkImageRankHistogram()
+    : Counts(NumberOfBins, 0), CoarseCounts(NumberOfBins >> Shift, 0),
+      NumberOfValues(0), Bin(0), Below(0)
+  {
+  }
+
+  static int GetBin(T value)
+  {
+    return static_cast<int>(value) -
+      static_cast<int>(vtkTypeTraits<T>::Min());
+  }
+
+  static T GetValue(int bin)
+  {
+    return static_cast<T>(bin + static_cast<int>(vtkTypeTraits<T>::Min()));
+  }
+
+  void Add(int bin)
+  {
+    ++this->Counts[bin];
+    ++this->CoarseCounts[bin >> Shift];
+    ++this->NumberOfValues;
+    this->Below += (bin < this->Bin);
+  }
+
+  void Remove(int bin)
+  {
+    --this->Counts[bin];
+    --this->CoarseCounts[bin >> Shift];
+    --this->NumberOfValues;
+    this->Below -= (bin < this->Bin);
+  }
+
+  int GetNumberOfValues() const { return this->NumberOfValues; }
+
+  // Return the bin of the value of rank r, 0 being the smallest value.
+  int FindRank(int r)
+  {
+    while (this->Below > r)
+    {
+      int coarse = (this->Bin >> Shift) - 1;
+      if ((this->Bin & (Width - 1)) == 0 &&
+          this->Below - this->CoarseCounts[coarse] > r)
+      {
+        this->Below -= this->CoarseCounts[coarse];
+        this->Bin -= Width;
+      }
+      else
+      {
+        --this->Bin;
+        this->Below -= this->Counts[this->Bin];
+      }
+    }
+    while (this->Below + this->Counts[this->Bin] <= r)
+    {
+      int coarse = this->Bin >> Shift;
+      if ((this->Bin & (Width - 1)) == 0 &&
+          this->Below + this->CoarseCounts[coarse] <= r)
+      {
+        this->Below += this->CoarseCounts[coarse];
+        this->Bin += Width;
+      }
+      else
+      {
+        this->Below += this->Counts[this->Bin];
+        ++this->Bin;
+      }
+    }
+    return this->Bin;
+  }
+
+  // Return the bin of the value of rank r - 1, right after FindRank(r).
+  int FindPreviousRank(int r) const
+  {
+    if (this->Below < r)
+    {
+      return this->Bin;
+    }
+    int bin = this->Bin - 1;
+    while (this->Counts[bin] == 0)
+    {
+      if (((bin + 1) & (Width - 1)) == 0 &&
+          this->CoarseCounts[bin >> Shift] == 0)
+      {
+        bin -= Width;
+      }
+      else
+      {
+        --bin;
+      }
+    }
+    return bin;
+  }
+
+protected:
+  std::vector<int> Counts;
+  std::vector<int> CoarseCounts;
+  int NumberOfValues;
+  int Bin;
+  int Below;
+};
+
+//-----------------------------------------------------------------------------
+// The neighborhood of a pixel, clipped by the input extent, and the
+// histogram of one component of its values.  Moving the neighborhood adds
+// the values of the slices it enters and removes the ones it leaves.
+template <class T>
+class vtkImageRankNeighborhood
+{
+public:
+  vtkImageRankNeighborhood(const T *inPtr, const vtkIdType inInc[3],
+                           const int inExt[6], const int kernelSize[3],
+                           const int kernelMiddle[3])
+    : InPtr(inPtr), Empty(1)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->InInc[axis] = inInc[axis];
+      this->InMin[axis] = inExt[2 * axis];
+      this->InMax[axis] = inExt[2 * axis + 1];
+      this->KernelSize[axis] = kernelSize[axis];
+      this->KernelMiddle[axis] = kernelMiddle[axis];
+      this->Min[axis] = 0;
+      this->Max[axis] = -1;
+    }
+  }
+
+  // Move the neighborhood to the pixel idx.
+  void MoveTo(const int idx[3])
+  {
+    int hoodMin[3], hoodMax[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      hoodMin[axis] = idx[axis] - this->KernelMiddle[axis];
+      hoodMax[axis] = hoodMin[axis] + this->KernelSize[axis] - 1;
+      hoodMin[axis] = std::max(hoodMin[axis], this->InMin[axis]);
+      hoodMax[axis] = std::min(hoodMax[axis], this->InMax[axis]);
+    }
+    if (this->Empty)
+    {
+      // Start from an empty neighborhood that only has to grow along x.
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        this->Min[axis] = hoodMin[axis];
+        this->Max[axis] = (axis == 0 ? hoodMin[axis] - 1 : hoodMax[axis]);
+      }
+      this->Empty = 0;
+    }
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->Move(axis, hoodMin[axis], hoodMax[axis]);
+    }
+  }
+
+  vtkImageRankHistogram<T> Histogram;
+
+protected:
+  void Move(int axis, int hoodMin, int hoodMax)
+  {
+    while (this->Max[axis] < hoodMax)
+    {
+      ++this->Max[axis];
+      this->UpdateSlice(axis, this->Max[axis], true);
+    }
+    while (this->Min[axis] > hoodMin)
+    {
+      --this->Min[axis];
+      this->UpdateSlice(axis, this->Min[axis], true);
+    }
+    while (this->Min[axis] < hoodMin)
+    {
+      this->UpdateSlice(axis, this->Min[axis], false);
+      ++this->Min[axis];
+    }
+    while (this->Max[axis] > hoodMax)
+    {
+      this->UpdateSlice(axis, this->Max[axis], false);
+      --this->Max[axis];
+    }
+  }
+
+  // Add or remove the values of the slice of the neighborhood at idx
+  // along axis.
+  void UpdateSlice(int axis, int idx, bool add)
+  {
+    int min[3] = { this->Min[0], this->Min[1], this->Min[2] };
+    int max[3] = { this->Max[0], this->Max[1], this->Max[2] };
+    min[axis] = idx;
+    max[axis] = idx;
+    const T *inPtr2 = this->InPtr;
+    for (int i = 0; i < 3; ++i)
+    {
+      inPtr2 += (min[i] - this->InMin[i]) * this->InInc[i];
+    }
+    int n0 = max[0] - min[0] + 1;
+    for (int idx2 = min[2]; idx2 <= max[2]; ++idx2)
+    {
+      const T *inPtr1 = inPtr2;
+      for (int idx1 = min[1]; idx1 <= max[1]; ++idx1)
+      {
+        const T *inPtr0 = inPtr1;
+        if (add)
+        {
+          for (int idx0 = 0; idx0 < n0; ++idx0)
+          {
+            this->Histogram.Add(vtkImageRankHistogram<T>::GetBin(*inPtr0));
+            inPtr0 += this->InInc[0];
+          }
+        }
+        else
+        {
+          for (int idx0 = 0; idx0 < n0; ++idx0)
+          {
+            this->Histogram.Remove(
+              vtkImageRankHistogram<T>::GetBin(*inPtr0));
+            inPtr0 += this->InInc[0];
+          }
+        }
+        inPtr1 += this->InInc[1];
+      }
+      inPtr2 += this->InInc[2];
+    }
+  }
+
+  const T *InPtr;
+  vtkIdType InInc[3];
+  int InMin[3];
+  int InMax[3];
+  int KernelSize[3];
+  int KernelMiddle[3];
+  int Min[3];
+  int Max[3];
+  int Empty;
+};
+
+} // end anonymous namespace
+
+//-----------------------------------------------------------------------------
+// The neighborhood of each component snakes through the output extent,
+// back and forth along x and y, so that it only ever moves by one pixel.
+template <class T>
+void vtkImageRank3DExecute(vtkImageRank3D *self,
+                           vtkImageData *inData, T *inPtr,
+                           vtkImageData *outData, T *outPtr,
+                           int outExt[6], int id,
+                           vtkDataArray *inArray)
+{
+  vtkIdType inInc[3];
+  vtkIdType outInc[3];
+  inData->GetIncrements(inInc);
+  outData->GetIncrements(outInc);
+  int *inExt = inData->GetExtent();
+  int numComp = inArray->GetNumberOfComponents();
+  int operation = self->GetOperation();
+  double percentile = self->GetPercentile();
+
+  unsigned long count = 0;
+  unsigned long target = static_cast<unsigned long>(
+    numComp*(outExt[5] - outExt[4] + 1)*(outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  for (int c = 0; c < numComp; ++c)
+  {
+    vtkImageRankNeighborhood<T> hood(inPtr + c, inInc, inExt,
+                                     self->GetKernelSize(),
+                                     self->GetKernelMiddle());
+    vtkImageRankHistogram<T> &histogram = hood.Histogram;
+    bool forward0 = true;
+    bool forward1 = true;
+    int idx[3];
+    for (idx[2] = outExt[4]; idx[2] <= outExt[5]; ++idx[2])
+    {
+      for (int i1 = outExt[2];
+           !self->AbortExecute && i1 <= outExt[3]; ++i1)
+      {
+        if (!id)
+        {
+          if (!(count%target))
+          {
+            self->UpdateProgress(count/(50.0*target));
+          }
+          count++;
+        }
+        idx[1] = (forward1 ? i1 : outExt[2] + outExt[3] - i1);
+        T *outPtr1 = outPtr + c + (idx[1] - outExt[2])*outInc[1] +
+          (idx[2] - outExt[4])*outInc[2];
+        for (int i0 = outExt[0]; i0 <= outExt[1]; ++i0)
+        {
+          idx[0] = (forward0 ? i0 : outExt[0] + outExt[1] - i0);
+          hood.MoveTo(idx);
+
+          int n = histogram.GetNumberOfValues();
+          T value;
+          if (operation == VTK_IMAGE_RANK_MIN)
+          {
+            value = histogram.GetValue(histogram.FindRank(0));
+          }
+          else if (operation == VTK_IMAGE_RANK_MAX)
+          {
+            value = histogram.GetValue(histogram.FindRank(n - 1));
+          }
+          else if (operation == VTK_IMAGE_RANK_PERCENTILE)
+          {
+            int r = static_cast<int>(percentile*(n - 1)/100.0 + 0.5);
+            value = histogram.GetValue(histogram.FindRank(r));
+          }
+          else
+          {
+            // if even size, compute the average of the two middle values
+            value = histogram.GetValue(histogram.FindRank(n/2));
+            if (n % 2 == 0)
+            {
+              T low = histogram.GetValue(histogram.FindPreviousRank(n/2));
+              value = static_cast<T>(low + (value - low)/2);
+            }
+          }
+          outPtr1[(idx[0] - outExt[0])*outInc[0]] = value;
+        }
+        forward0 = !forward0;
+      }
+      forward1 = !forward1;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// This method contains the first switch statement that calls the correct
+// templated function for the input and output region types.
+void vtkImageRank3D::ThreadedRequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *vtkNotUsed(outputVector),
+  vtkImageData ***inData,
+  vtkImageData **outData,
+  int outExt[6], int id)
+{
+  void *inPtr;
+  void *outPtr = outData[0]->GetScalarPointerForExtent(outExt);
+
+  vtkDataArray *inArray = this->GetInputArrayToProcess(0,inputVector);
+  if (!inArray)
+  {
+    return;
+  }
+  if (id == 0)
+  {
+    outData[0]->GetPointData()->GetScalars()->SetName(inArray->GetName());
+  }
+
+  inPtr = inArray->GetVoidPointer(0);
+
+  // this filter expects that input is the same type as output.
+  if (inArray->GetDataType() != outData[0]->GetScalarType())
+  {
+    vtkErrorMacro(<< "Execute: input data type, " << inArray->GetDataType()
+                << ", must match out ScalarType "
+                  << outData[0]->GetScalarType());
+    return;
+  }
+
+  // the histograms are only practical for 8 and 16 bit integers
+  switch (inArray->GetDataType())
+  {
+    case VTK_CHAR:
+      vtkImageRank3DExecute(this, inData[0][0], static_cast<char *>(inPtr),
+                            outData[0], static_cast<char *>(outPtr),
+                            outExt, id, inArray);
+      break;
+    case VTK_SIGNED_CHAR:
+      vtkImageRank3DExecute(this, inData[0][0],
+                            static_cast<signed char *>(inPtr),
+                            outData[0], static_cast<signed char *>(outPtr),
+                            outExt, id, inArray);
+      break;
+    case VTK_UNSIGNED_CHAR:
+      vtkImageRank3DExecute(this, inData[0][0],
+                            static_cast<unsigned char *>(inPtr),
+                            outData[0], static_cast<unsigned char *>(outPtr),
+                            outExt, id, inArray);
+      break;
+    case VTK_SHORT:
+      vtkImageRank3DExecute(this, inData[0][0], static_cast<short *>(inPtr),
+                            outData[0], static_cast<short *>(outPtr),
+                            outExt, id, inArray);
+      break;
+    case VTK_UNSIGNED_SHORT:
+      vtkImageRank3DExecute(this, inData[0][0],
+                            static_cast<unsigned short *>(inPtr),
+                            outData[0], static_cast<unsigned short *>(outPtr),
+                            outExt, id, inArray);
+      break;
+    default:
+      vtkErrorMacro(<< "Execute: ScalarType " << inArray->GetDataType()
+                    << " is not an 8 or 16 bit integer type, use"
+                    << " vtkImageMedian3D instead");
+      return;
+  }
+}
@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageRank3D.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkImageRank3D
+ * @brief   Median, percentile, minimum or maximum of a neighborhood.
+ *
+ * vtkImageRank3D replaces each pixel with the median, a percentile, the
+ * minimum or the maximum of the values of a rectangular neighborhood
+ * around that pixel.  Neighborhoods can be no more than 3 dimensional.
+ * The median is the same as the one of vtkImageMedian3D.
+ *
+ * Instead of sorting the values of each neighborhood, the filter keeps a
+ * histogram of the neighborhood that it updates as the neighborhood moves
+ * from one pixel to the next, in the manner of Huang, so that the cost of
+ * each pixel grows with the area of the faces of the neighborhood instead
+ * of its volume.  The neighborhood snakes through the rows and slices of
+ * the piece of the output that each thread computes, and a coarse level of
+ * the histogram is used to move to the wanted rank quickly.  This makes
+ * large neighborhoods practical, but only for 8 and 16 bit integer scalars,
+ * whose histograms are small enough.
+ *
+ * References:
+ *
+ * T.S. Huang, G.J. Yang and G.Y. Tang. A fast two-dimensional median
+ * filtering algorithm. IEEE Transactions on Acoustics, Speech and Signal
+ * Processing, 27(1), pp. 13--18, 1979.
+ *
+ * S. Perreault and P. Hebert. Median Filtering in Constant Time. IEEE
+ * Transactions on Image Processing, 16(9), pp. 2389--2394, 2007.
+ *
+ * @sa
+ * vtkImageMedian3D
+*/
+
+#ifndef vtkImageRank3D_h
+#define vtkImageRank3D_h
+
+
+#include "vtkImagingGeneralModule.h" // For export macro
+#include "vtkImageSpatialAlgorithm.h"
+
+#define VTK_IMAGE_RANK_MEDIAN 0
+#define VTK_IMAGE_RANK_PERCENTILE 1
+#define VTK_IMAGE_RANK_MIN 2
+#define VTK_IMAGE_RANK_MAX 3
+
+class VTKIMAGINGGENERAL_EXPORT vtkImageRank3D : public vtkImageSpatialAlgorithm
+{
+public:
+  static vtkImageRank3D *New();
+  vtkTypeMacro(vtkImageRank3D,vtkImageSpatialAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * This method sets the size of the neighborhood.  It also sets the
+   * default middle of the neighborhood
+   */
+  void SetKernelSize(int size0, int size1, int size2);
+
+  //@{
+  /**
+   * Set the value each pixel is replaced with: "Median", "Percentile",
+   * "Min" or "Max" of its neighborhood.  The default is "Median".
+   */
+  vtkSetClampMacro(Operation, int, VTK_IMAGE_RANK_MEDIAN, VTK_IMAGE_RANK_MAX);
+  void SetOperationToMedian() {
+    this->SetOperation(VTK_IMAGE_RANK_MEDIAN); };
+  void SetOperationToPercentile() {
+    this->SetOperation(VTK_IMAGE_RANK_PERCENTILE); };
+  void SetOperationToMin() {
+    this->SetOperation(VTK_IMAGE_RANK_MIN); };
+  void SetOperationToMax() {
+    this->SetOperation(VTK_IMAGE_RANK_MAX); };
+  vtkGetMacro(Operation, int);
+  const char *GetOperationAsString();
+  //@}
+
+  //@{
+  /**
+   * Set the percentile, between 0 and 100, used by the "Percentile"
+   * operation.  Of the n values of a neighborhood sorted in increasing
+   * order, the one of index Percentile*(n-1)/100, rounded to the nearest
+   * integer, is used.  The default is 50.
+   */
+  vtkSetClampMacro(Percentile, double, 0.0, 100.0);
+  vtkGetMacro(Percentile, double);
+  //@}
+
+  //@{
+  /**
+   * Return the number of elements in the neighborhood.
+   */
+  vtkGetMacro(NumberOfElements,int);
+  //@}
+
+protected:
+  vtkImageRank3D();
+  ~vtkImageRank3D() VTK_OVERRIDE;
+
+  int NumberOfElements;
+  int Operation;
+  double Percentile;
+
+  void ThreadedRequestData(vtkInformation *request,
+                           vtkInformationVector **inputVector,
+                           vtkInformationVector *outputVector,
+                           vtkImageData ***inData, vtkImageData **outData,
+                           int extent[6], int id) VTK_OVERRIDE;
+
+private:
+  vtkImageRank3D(const vtkImageRank3D&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkImageRank3D&) VTK_DELETE_FUNCTION;
+};
+
+#endif
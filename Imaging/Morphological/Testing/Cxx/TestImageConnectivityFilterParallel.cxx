@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageConnectivityFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the ParallelLabeling of vtkImageConnectivityFilter gives the
+// same output and region arrays as the flood fill, for the different modes,
+// with many regions, and with several threads.
+
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageConnectivityFilter.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestCheck.h"
+#include "vtkUnsignedCharArray.h"
+
+namespace
+{
+
+enum { AllDefaults, IntLabels, SizeRank, Largest, SizeRange, Extents,
+       Seeds, SubExtent, NumberOfCases };
+
+void Configure(vtkImageConnectivityFilter *filter, vtkImageData *image,
+               vtkPolyData *seeds, int which)
+{
+  filter->SetInputData(image);
+  filter->SetScalarRange(1, 255);
+  switch (which)
+  {
+    case IntLabels:
+      filter->SetLabelScalarTypeToInt();
+      break;
+    case SizeRank:
+      filter->SetLabelScalarTypeToUnsignedShort();
+      filter->SetLabelModeToSizeRank();
+      filter->GenerateRegionExtentsOn();
+      break;
+    case Largest:
+      filter->SetExtractionModeToLargestRegion();
+      break;
+    case SizeRange:
+      filter->SetLabelScalarTypeToShort();
+      filter->SetSizeRange(3, 50);
+      break;
+    case Extents:
+      filter->SetLabelScalarTypeToInt();
+      filter->GenerateRegionExtentsOn();
+      break;
+    case Seeds:
+      filter->SetSeedData(seeds);
+      filter->SetExtractionModeToAllRegions();
+      filter->GenerateRegionExtentsOn();
+      break;
+    case SubExtent:
+      filter->SetLabelScalarTypeToInt();
+      filter->GenerateRegionExtentsOn();
+      break;
+  }
+}
+
+int CompareArrays(vtkDataArray *a, vtkDataArray *b)
+{
+  vtkTestCheckMacro(a->GetNumberOfTuples() == b->GetNumberOfTuples());
+  vtkTestCheckMacro(a->GetNumberOfComponents() == b->GetNumberOfComponents());
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      vtkTestCheckMacro(a->GetComponent(i, c) == b->GetComponent(i, c));
+    }
+  }
+  return 0;
+}
+
+int Compare(vtkImageData *image, vtkPolyData *seeds, int which)
+{
+  vtkNew<vtkImageConnectivityFilter> serial;
+  vtkNew<vtkImageConnectivityFilter> parallel;
+  Configure(serial.GetPointer(), image, seeds, which);
+  Configure(parallel.GetPointer(), image, seeds, which);
+  parallel->ParallelLabelingOn();
+  vtkTestCheckMacro(parallel->GetParallelLabeling() == 1);
+  if (which == SubExtent)
+  {
+    int extent[6];
+    image->GetExtent(extent);
+    extent[0] += 3;
+    extent[3] -= 5;
+    extent[5] = (extent[4] + extent[5]) / 2;
+    vtkTestCheckMacro(serial->UpdateExtent(extent));
+    vtkTestCheckMacro(parallel->UpdateExtent(extent));
+  }
+  else
+  {
+    serial->Update();
+    parallel->Update();
+  }
+
+  vtkTestCheckMacro(serial->GetNumberOfExtractedRegions() > 0);
+  vtkTestCheckMacro(
+    CompareArrays(parallel->GetOutput()->GetPointData()->GetScalars(),
+    serial->GetOutput()->GetPointData()->GetScalars()) == 0);
+  vtkTestCheckMacro(CompareArrays(parallel->GetExtractedRegionLabels(),
+    serial->GetExtractedRegionLabels()) == 0);
+  vtkTestCheckMacro(CompareArrays(parallel->GetExtractedRegionSizes(),
+    serial->GetExtractedRegionSizes()) == 0);
+  vtkTestCheckMacro(CompareArrays(parallel->GetExtractedRegionSeedIds(),
+    serial->GetExtractedRegionSeedIds()) == 0);
+  vtkTestCheckMacro(CompareArrays(parallel->GetExtractedRegionExtents(),
+    serial->GetExtractedRegionExtents()) == 0);
+  return 0;
+}
+
+} // end anon namespace
+
+int TestImageConnectivityFilterParallel(int, char *[])
+{
+  vtkMath::RandomSeed(11);
+
+  // Random voxels near the percolation threshold give regions of all
+  // sizes, with too many of them for unsigned char labels.  The volume is
+  // big enough to be split in several blocks, and so is the 2D image.
+  vtkNew<vtkImageData> volume;
+  volume->SetExtent(-2, 61, 1, 48, 0, 49);
+  vtkNew<vtkImageData> slice;
+  slice->SetDimensions(301, 397, 1);
+  vtkImageData *images[2] = { volume.GetPointer(), slice.GetPointer() };
+  const double fractions[2] = { 0.3, 0.55 };
+  for (int k = 0; k < 2; ++k)
+  {
+    images[k]->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    vtkDataArray *scalars = images[k]->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < images[k]->GetNumberOfPoints(); ++i)
+    {
+      scalars->SetComponent(i, 0, vtkMath::Random() < fractions[k] ? 7 : 0);
+    }
+  }
+
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(10, 10, 10);
+  points->InsertNextPoint(30, 20, 40);
+  points->InsertNextPoint(5, 40, 3);
+  vtkNew<vtkUnsignedCharArray> seedScalars;
+  seedScalars->InsertNextValue(2);
+  seedScalars->InsertNextValue(5);
+  seedScalars->InsertNextValue(9);
+  vtkNew<vtkPolyData> seeds;
+  seeds->SetPoints(points.GetPointer());
+  seeds->GetPointData()->SetScalars(seedScalars.GetPointer());
+
+  for (int threads = 1; threads <= 4; threads += 3)
+  {
+    for (int k = 0; k < 2; ++k)
+    {
+      for (int which = 0; which < NumberOfCases; ++which)
+      {
+        int result = 0;
+        vtkSMPTools::LocalScope(vtkSMPTools::Config(threads), [&]()
+        {
+          result = Compare(images[k], seeds.GetPointer(), which);
+        });
+        if (result)
+        {
+          cerr << "For image " << k << ", case " << which << " and "
+               << threads << " threads" << endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
@@ -55,6 +55,7 @@
 #include "vtkImageIterator.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIntArray.h"
 #include "vtkImageStencilData.h"
@@ -69,6 +70,8 @@
 #include <vector>
 #include <stack>
 #include <algorithm>
+#include <atomic>
+#include <unordered_map>
 
 vtkStandardNewMacro(vtkImageConnectivityFilter);
 
@@ -93,6 +96,8 @@ vtkImageConnectivityFilter::vtkImageConnectivityFilter()
 
   this->GenerateRegionExtents = 0;
 
+  this->ParallelLabeling = 0;
+
   this->ExtractedRegionLabels = vtkIdTypeArray::New();
   this->ExtractedRegionSizes = vtkIdTypeArray::New();
   this->ExtractedRegionSeedIds = vtkIdTypeArray::New();
@@ -346,6 +351,23 @@ protected:
     OT *outPtr, unsigned char *maskPtr, int extent[6],
     vtkICF::RegionVector& regionInfo);
 
+  // Execute method for when no seeds are provided, which labels all the
+  // regions at once with union-find, in parallel.
+  template <class OT>
+  static void ParallelSeedlessExecute(
+    vtkImageConnectivityFilter *self,
+    vtkImageData *outData, vtkImageStencilData *stencil,
+    OT *outPtr, unsigned char *maskPtr, int extent[6],
+    vtkICF::RegionVector& regionInfo);
+
+  // The above, for IdT large enough to index all the voxels.
+  template <class OT, class IdT>
+  static void UnionFindExecute(
+    vtkImageConnectivityFilter *self,
+    vtkImageData *outData, vtkImageStencilData *stencil,
+    OT *outPtr, unsigned char *maskPtr, int extent[6],
+    vtkICF::RegionVector& regionInfo);
+
 public:
   // Create a bit mask from the input
   template<class IT>
@@ -465,6 +487,520 @@ public:
 
 };
 
+//----------------------------------------------------------------------------
+// Union-find labeling of the voxels whose bits are not set in the bitmask.
+// The rows of voxels are split into blocks that are labeled in parallel,
+// then the blocks are merged pairwise, in parallel too, since the merges of
+// each level only touch their own group of blocks and need no locks.  Each
+// set is rooted at its voxel with the smallest index, which is where the
+// flood fill of SeedlessExecute would start, so that numbering the roots
+// in index order gives the regions in the order SeedlessExecute finds them.
+template <class IdT>
+class vtkICFUnionFind
+{
+public:
+  vtkICFUnionFind(unsigned char *maskPtr, const int maxIdx[3]);
+
+  // Label the voxels and compute the regions.  The id of each region is
+  // set to -2 minus its index, its extent to the extent of its voxels or,
+  // if generateExtents is false, to its first voxel.
+  void Execute(bool generateExtents, std::vector<vtkICF::Region> &regions);
+
+  // Set the output of the voxels of each region to its label.
+  template <class OT>
+  void Paint(OT *outPtr, const vtkIdType outInc[3], const int *outLimits,
+             const std::vector<OT> &labels);
+
+protected:
+  enum PhaseEnum { Label, Merge, Flatten, NumberRoots, Number };
+
+  // Run one phase for each block, or each pair of groups of blocks.
+  class PhaseFunctor
+  {
+  public:
+    PhaseFunctor(vtkICFUnionFind *self, PhaseEnum phase, vtkIdType width)
+      : Self(self), Phase(phase), Width(width) {}
+
+    void operator()(vtkIdType begin, vtkIdType end) const;
+
+  protected:
+    vtkICFUnionFind *Self;
+    PhaseEnum Phase;
+    vtkIdType Width;
+  };
+
+  template <class OT>
+  class PaintFunctor
+  {
+  public:
+    PaintFunctor(vtkICFUnionFind *self, OT *outPtr,
+                 const vtkIdType outInc[3], const int *outLimits,
+                 const std::vector<OT> &labels)
+      : Self(self), OutPtr(outPtr), OutInc(outInc), OutLimits(outLimits),
+        Labels(labels) {}
+
+    void operator()(vtkIdType begin, vtkIdType end) const;
+
+  protected:
+    vtkICFUnionFind *Self;
+    OT *OutPtr;
+    const vtkIdType *OutInc;
+    const int *OutLimits;
+    const std::vector<OT> &Labels;
+  };
+
+  bool IsSet(vtkIdType i) const
+  {
+    return ((this->MaskPtr[i >> 3] >> (i & 0x7)) & 1) != 0;
+  }
+
+  IdT Get(IdT i) const
+  {
+    return this->Parent[i].load(std::memory_order_relaxed);
+  }
+
+  void Set(IdT i, IdT v)
+  {
+    this->Parent[i].store(v, std::memory_order_relaxed);
+  }
+
+  IdT Find(IdT i)
+  {
+    // path halving
+    IdT p;
+    while ((p = this->Get(i)) != i)
+    {
+      IdT g = this->Get(p);
+      this->Set(i, g);
+      i = g;
+    }
+    return i;
+  }
+
+  void Union(IdT i, IdT j)
+  {
+    i = this->Find(i);
+    j = this->Find(j);
+    if (i < j)
+    {
+      this->Set(j, i);
+    }
+    else if (j < i)
+    {
+      this->Set(i, j);
+    }
+  }
+
+  // Give voxel i the region index of its root, and return it.
+  IdT NumberVoxel(IdT i)
+  {
+    IdT v = this->Get(i);
+    if (v >= 0)
+    {
+      v = this->Get(v);
+      this->Set(i, v);
+    }
+    return v;
+  }
+
+  // Join the voxels of the rows [firstRow, lastRow) to their neighbors in
+  // the rows [minRow, firstRow).
+  void JoinRows(vtkIdType firstRow, vtkIdType lastRow, vtkIdType minRow);
+
+  void LabelBlock(vtkIdType block);
+  void MergeBlocks(vtkIdType width, vtkIdType pair);
+  void FlattenBlock(vtkIdType block);
+  void NumberBlockRoots(vtkIdType block);
+  void NumberBlock(vtkIdType block);
+
+  unsigned char *MaskPtr;
+  int Size[3];
+  vtkIdType NumberOfRows;
+  std::vector<vtkIdType> BlockRows;
+  std::vector<std::atomic<IdT> > Parent;
+  std::vector<IdT> BlockRoots;
+  std::vector<IdT> RootIndices;
+  std::vector<std::vector<vtkICF::Region> > BlockRegions;
+};
+
+//----------------------------------------------------------------------------
+template <class IdT>
+vtkICFUnionFind<IdT>::vtkICFUnionFind(
+  unsigned char *maskPtr, const int maxIdx[3])
+  : MaskPtr(maskPtr)
+{
+  this->Size[0] = maxIdx[0] + 1;
+  this->Size[1] = maxIdx[1] + 1;
+  this->Size[2] = maxIdx[2] + 1;
+  this->NumberOfRows = static_cast<vtkIdType>(this->Size[1])*this->Size[2];
+
+  // blocks of at least 32768 voxels, of whole slices if the image is 3D,
+  // and no more than 256 of them to keep the merges cheap
+  vtkIdType numVoxels = this->NumberOfRows*this->Size[0];
+  vtkIdType numBlocks = (numVoxels + 32767)/32768;
+  numBlocks = (numBlocks < 256 ? numBlocks : 256);
+  vtkIdType blockRows = (this->NumberOfRows + numBlocks - 1)/numBlocks;
+  if (this->Size[2] > 1)
+  {
+    blockRows = (blockRows + this->Size[1] - 1)/this->Size[1]*this->Size[1];
+  }
+  for (vtkIdType row = 0; row < this->NumberOfRows; row += blockRows)
+  {
+    this->BlockRows.push_back(row);
+  }
+  this->BlockRows.push_back(this->NumberOfRows);
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::PhaseFunctor::operator()(
+  vtkIdType begin, vtkIdType end) const
+{
+  for (vtkIdType i = begin; i < end; i++)
+  {
+    switch (this->Phase)
+    {
+      case Label:
+        this->Self->LabelBlock(i);
+        break;
+      case Merge:
+        this->Self->MergeBlocks(this->Width, i);
+        break;
+      case Flatten:
+        this->Self->FlattenBlock(i);
+        break;
+      case NumberRoots:
+        this->Self->NumberBlockRoots(i);
+        break;
+      case Number:
+        this->Self->NumberBlock(i);
+        break;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::JoinRows(
+  vtkIdType firstRow, vtkIdType lastRow, vtkIdType minRow)
+{
+  vtkIdType rowSize = this->Size[0];
+  vtkIdType sliceRows = this->Size[1];
+  for (vtkIdType row = firstRow; row < lastRow; row++)
+  {
+    bool joinY = (row % sliceRows != 0 && row - 1 >= minRow &&
+                  row - 1 < firstRow);
+    bool joinZ = (row - sliceRows >= minRow && row - sliceRows < firstRow);
+    if (!joinY && !joinZ)
+    {
+      continue;
+    }
+    IdT i = static_cast<IdT>(row*rowSize);
+    for (vtkIdType x = 0; x < rowSize; x++, i++)
+    {
+      if (!this->IsSet(i))
+      {
+        if (joinY && !this->IsSet(i - rowSize))
+        {
+          this->Union(static_cast<IdT>(i - rowSize), i);
+        }
+        if (joinZ && !this->IsSet(i - sliceRows*rowSize))
+        {
+          this->Union(static_cast<IdT>(i - sliceRows*rowSize), i);
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::LabelBlock(vtkIdType block)
+{
+  vtkIdType rowSize = this->Size[0];
+  vtkIdType firstRow = this->BlockRows[block];
+  vtkIdType lastRow = this->BlockRows[block + 1];
+  for (vtkIdType row = firstRow; row < lastRow; row++)
+  {
+    // join the voxels along the row
+    IdT i = static_cast<IdT>(row*rowSize);
+    for (vtkIdType x = 0; x < rowSize; x++, i++)
+    {
+      if (this->IsSet(i))
+      {
+        this->Set(i, 0);
+      }
+      else if (x > 0 && !this->IsSet(i - 1))
+      {
+        this->Set(i, this->Get(i - 1));
+      }
+      else
+      {
+        this->Set(i, i);
+      }
+    }
+
+    // join them to the previous rows of the block
+    this->JoinRows(row, row + 1, firstRow);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::MergeBlocks(vtkIdType width, vtkIdType pair)
+{
+  // merge the group of blocks [b, b + width) with [b + width, b + 2*width)
+  vtkIdType numBlocks = static_cast<vtkIdType>(this->BlockRows.size()) - 1;
+  vtkIdType b = 2*width*pair;
+  vtkIdType lastBlock = b + 2*width;
+  lastBlock = (lastBlock < numBlocks ? lastBlock : numBlocks);
+  vtkIdType minRow = this->BlockRows[b];
+  vtkIdType firstRow = this->BlockRows[b + width];
+  vtkIdType lastRow = this->BlockRows[lastBlock];
+
+  // only the first slice of the second group can touch the first group
+  if (lastRow - firstRow > this->Size[1])
+  {
+    lastRow = firstRow + this->Size[1];
+  }
+  this->JoinRows(firstRow, lastRow, minRow);
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::FlattenBlock(vtkIdType block)
+{
+  vtkIdType rowSize = this->Size[0];
+  IdT i = static_cast<IdT>(this->BlockRows[block]*rowSize);
+  IdT end = static_cast<IdT>(this->BlockRows[block + 1]*rowSize);
+  IdT numRoots = 0;
+  for (; i < end; i++)
+  {
+    if (!this->IsSet(i))
+    {
+      IdT r = this->Get(i);
+      IdT p;
+      while ((p = this->Get(r)) != r)
+      {
+        r = p;
+      }
+      this->Set(i, r);
+      numRoots += (r == i);
+    }
+  }
+  this->BlockRoots[block] = numRoots;
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::NumberBlockRoots(vtkIdType block)
+{
+  // roots get their region index, encoded as -1 minus the index
+  vtkIdType rowSize = this->Size[0];
+  IdT i = static_cast<IdT>(this->BlockRows[block]*rowSize);
+  IdT end = static_cast<IdT>(this->BlockRows[block + 1]*rowSize);
+  IdT region = this->BlockRoots[block];
+  for (; i < end; i++)
+  {
+    if (!this->IsSet(i) && this->Get(i) == i)
+    {
+      this->RootIndices[region] = i;
+      this->Set(i, -1 - region);
+      region++;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::NumberBlock(vtkIdType block)
+{
+  // give the other voxels the region index of their root, and compute
+  // the size and extent of the regions, one run of voxels at a time
+  std::vector<vtkICF::Region> &regions = this->BlockRegions[block];
+  std::unordered_map<IdT, size_t> regionMap;
+  vtkIdType rowSize = this->Size[0];
+  vtkIdType firstRow = this->BlockRows[block];
+  vtkIdType lastRow = this->BlockRows[block + 1];
+  for (vtkIdType row = firstRow; row < lastRow; row++)
+  {
+    int y = static_cast<int>(row % this->Size[1]);
+    int z = static_cast<int>(row / this->Size[1]);
+    IdT i = static_cast<IdT>(row*rowSize);
+    int x = 0;
+    while (x < rowSize)
+    {
+      if (this->IsSet(i))
+      {
+        x++;
+        i++;
+        continue;
+      }
+      IdT region = this->NumberVoxel(i);
+      int runStart = x;
+      do
+      {
+        x++;
+        i++;
+      }
+      while (x < rowSize && !this->IsSet(i) &&
+             this->NumberVoxel(i) == region);
+
+      int runExtent[6] = { runStart, x - 1, y, y, z, z };
+      std::pair<typename std::unordered_map<IdT, size_t>::iterator, bool>
+        entry = regionMap.insert(std::make_pair(region, regions.size()));
+      if (entry.second)
+      {
+        regions.push_back(vtkICF::Region(x - runStart, -1 - region,
+                                         runExtent));
+      }
+      else
+      {
+        vtkICF::Region &r = regions[entry.first->second];
+        r.size += x - runStart;
+        r.extent[0] = std::min(r.extent[0], runExtent[0]);
+        r.extent[1] = std::max(r.extent[1], runExtent[1]);
+        r.extent[2] = std::min(r.extent[2], y);
+        r.extent[3] = std::max(r.extent[3], y);
+        r.extent[4] = std::min(r.extent[4], z);
+        r.extent[5] = std::max(r.extent[5], z);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+void vtkICFUnionFind<IdT>::Execute(
+  bool generateExtents, std::vector<vtkICF::Region> &regions)
+{
+  vtkIdType numBlocks = static_cast<vtkIdType>(this->BlockRows.size()) - 1;
+  std::vector<std::atomic<IdT> > parent(
+    static_cast<size_t>(this->NumberOfRows*this->Size[0]));
+  this->Parent.swap(parent);
+  this->BlockRoots.resize(numBlocks + 1);
+  this->BlockRegions.resize(numBlocks);
+
+  vtkSMPTools::For(0, numBlocks, 1, PhaseFunctor(this, Label, 0));
+  for (vtkIdType width = 1; width < numBlocks; width *= 2)
+  {
+    vtkIdType numPairs = (numBlocks + width - 1)/(2*width);
+    vtkSMPTools::For(0, numPairs, 1, PhaseFunctor(this, Merge, width));
+  }
+  vtkSMPTools::For(0, numBlocks, 1, PhaseFunctor(this, Flatten, 0));
+
+  // the regions of each block follow the ones of the previous blocks
+  IdT numRegions = 0;
+  for (vtkIdType b = 0; b < numBlocks; b++)
+  {
+    IdT n = this->BlockRoots[b];
+    this->BlockRoots[b] = numRegions;
+    numRegions += n;
+  }
+  this->RootIndices.resize(numRegions);
+  vtkSMPTools::For(0, numBlocks, 1, PhaseFunctor(this, NumberRoots, 0));
+  vtkSMPTools::For(0, numBlocks, 1, PhaseFunctor(this, Number, 0));
+
+  // gather the regions of all the blocks
+  regions.assign(numRegions, vtkICF::Region());
+  std::vector<bool> found(numRegions, false);
+  for (vtkIdType b = 0; b < numBlocks; b++)
+  {
+    std::vector<vtkICF::Region> &blockRegions = this->BlockRegions[b];
+    for (size_t j = 0; j < blockRegions.size(); j++)
+    {
+      const vtkICF::Region &r = blockRegions[j];
+      IdT region = static_cast<IdT>(r.id);
+      vtkICF::Region &s = regions[region];
+      if (!found[region])
+      {
+        s = r;
+        s.id = -2 - static_cast<vtkIdType>(region);
+        found[region] = true;
+        continue;
+      }
+      s.size += r.size;
+      for (int k = 0; k < 6; k += 2)
+      {
+        s.extent[k] = std::min(s.extent[k], r.extent[k]);
+        s.extent[k + 1] = std::max(s.extent[k + 1], r.extent[k + 1]);
+      }
+    }
+    std::vector<vtkICF::Region>().swap(blockRegions);
+  }
+
+  if (!generateExtents)
+  {
+    // the extent of the first voxel, like SeedlessExecute
+    vtkIdType rowSize = this->Size[0];
+    for (IdT region = 0; region < numRegions; region++)
+    {
+      vtkIdType i = this->RootIndices[region];
+      int *extent = regions[region].extent;
+      extent[0] = extent[1] = static_cast<int>(i % rowSize);
+      extent[2] = extent[3] = static_cast<int>((i / rowSize) % this->Size[1]);
+      extent[4] = extent[5] = static_cast<int>(i / rowSize / this->Size[1]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+template <class OT>
+void vtkICFUnionFind<IdT>::PaintFunctor<OT>::operator()(
+  vtkIdType begin, vtkIdType end) const
+{
+  const int *limits = this->OutLimits;
+  const vtkIdType *outInc = this->OutInc;
+  int minX = (limits ? limits[0] : 0);
+  int maxX = (limits ? limits[1] : this->Self->Size[0] - 1);
+  for (vtkIdType block = begin; block < end; block++)
+  {
+    for (vtkIdType row = this->Self->BlockRows[block];
+         row < this->Self->BlockRows[block + 1]; row++)
+    {
+      int y = static_cast<int>(row % this->Self->Size[1]);
+      int z = static_cast<int>(row / this->Self->Size[1]);
+      if (limits && (y < limits[2] || y > limits[3] ||
+                     z < limits[4] || z > limits[5]))
+      {
+        continue;
+      }
+      OT *outPtr = this->OutPtr;
+      if (limits)
+      {
+        outPtr += (y - limits[2])*outInc[1] + (z - limits[4])*outInc[2];
+      }
+      else
+      {
+        outPtr += y*outInc[1] + z*outInc[2];
+      }
+      IdT i = static_cast<IdT>(row*this->Self->Size[0] + minX);
+      for (int x = minX; x <= maxX; x++, i++)
+      {
+        IdT v = this->Self->Get(i);
+        if (v < 0)
+        {
+          *outPtr = this->Labels[-1 - v];
+        }
+        outPtr += outInc[0];
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class IdT>
+template <class OT>
+void vtkICFUnionFind<IdT>::Paint(
+  OT *outPtr, const vtkIdType outInc[3], const int *outLimits,
+  const std::vector<OT> &labels)
+{
+  vtkIdType numBlocks = static_cast<vtkIdType>(this->BlockRows.size()) - 1;
+  vtkSMPTools::For(0, numBlocks, 1,
+    PaintFunctor<OT>(this, outPtr, outInc, outLimits, labels));
+}
+
 //----------------------------------------------------------------------------
 bool vtkICF::IntersectExtents(
   const int extent1[6], const int extent2[6], int output[6])
@@ -1350,6 +1886,87 @@ void vtkICF::SeedlessExecute(
   }
 }
 
+//----------------------------------------------------------------------------
+template <class OT, class IdT>
+void vtkICF::UnionFindExecute(
+  vtkImageConnectivityFilter *self,
+  vtkImageData *outData, vtkImageStencilData *stencil,
+  OT *outPtr, unsigned char *maskPtr, int extent[6],
+  vtkICF::RegionVector& regionInfo)
+{
+  // Get execution parameters
+  int extractionMode = self->GetExtractionMode();
+  vtkIdType sizeRange[2];
+  self->GetSizeRange(sizeRange);
+
+  vtkIdType outInc[3];
+  outData->GetIncrements(outInc);
+
+  int outExt[6];
+  outData->GetExtent(outExt);
+
+  int maxIdx[3];
+  int *outLimits = vtkICF::ZeroBaseExtent(extent, outExt, maxIdx);
+
+  // find all the regions, in the order SeedlessExecute finds them
+  std::vector<vtkICF::Region> regions;
+  vtkICFUnionFind<IdT> unionFind(maskPtr, maxIdx);
+  unionFind.Execute(self->GetGenerateRegionExtents() != 0, regions);
+
+  // add them like SeedlessExecute does, with the region index encoded in
+  // the id so that its label can be found after any pruning
+  for (size_t i = 0; i < regions.size(); i++)
+  {
+    vtkIdType voxelCount = regions[i].size;
+    if (voxelCount == 1 &&
+        static_cast<OT>(regionInfo.size()) == vtkTypeTraits<OT>::Max())
+    {
+      // smallest region is definitely the one we would add
+      continue;
+    }
+    vtkICF::AddRegion(
+      outData, outPtr, stencil, extent, sizeRange, regionInfo,
+      voxelCount, regions[i].id, regions[i].extent, extractionMode);
+  }
+
+  std::vector<OT> labels(regions.size(), 0);
+  for (size_t j = 1; j < regionInfo.size(); j++)
+  {
+    vtkIdType id = regionInfo[j].id;
+    if (id <= -2)
+    {
+      labels[-2 - id] = static_cast<OT>(j);
+      regionInfo[j].id = -1;
+    }
+  }
+
+  unionFind.Paint(outPtr, outInc, outLimits, labels);
+}
+
+//----------------------------------------------------------------------------
+template <class OT>
+void vtkICF::ParallelSeedlessExecute(
+  vtkImageConnectivityFilter *self,
+  vtkImageData *outData, vtkImageStencilData *stencil,
+  OT *outPtr, unsigned char *maskPtr, int extent[6],
+  vtkICF::RegionVector& regionInfo)
+{
+  // the smallest type that can index all the voxels
+  vtkIdType size = (extent[1] - extent[0] + 1);
+  size *= (extent[3] - extent[2] + 1);
+  size *= (extent[5] - extent[4] + 1);
+  if (size <= VTK_INT_MAX)
+  {
+    vtkICF::UnionFindExecute<OT, int>(
+      self, outData, stencil, outPtr, maskPtr, extent, regionInfo);
+  }
+  else
+  {
+    vtkICF::UnionFindExecute<OT, vtkIdType>(
+      self, outData, stencil, outPtr, maskPtr, extent, regionInfo);
+  }
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 template <class OT>
@@ -1377,9 +1994,18 @@ void vtkICF::ExecuteOutput(
   if (!seedData ||
       extractionMode == vtkImageConnectivityFilter::AllRegions)
   {
-    vtkICF::SeedlessExecute(
-      self, outData, stencil, outPtr, maskPtr, extent,
-      regionInfo);
+    if (self->GetParallelLabeling())
+    {
+      vtkICF::ParallelSeedlessExecute(
+        self, outData, stencil, outPtr, maskPtr, extent,
+        regionInfo);
+    }
+    else
+    {
+      vtkICF::SeedlessExecute(
+        self, outData, stencil, outPtr, maskPtr, extent,
+        regionInfo);
+    }
   }
 
   // do final relabelling and other bookkeeping
@@ -1591,6 +2217,9 @@ void vtkImageConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "GenerateRegionExtents: "
      << (this->GenerateRegionExtents ? "On\n" : "Off\n");
 
+  os << indent << "ParallelLabeling: "
+     << (this->ParallelLabeling ? "On\n" : "Off\n");
+
   os << indent << "SeedConnection: "
      << this->GetSeedConnection() << "\n";
 
@@ -0,0 +1,42 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestCheck.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file   vtkTestCheck.h
+ * @brief  Condition check for regression tests.
+ *
+ * vtkTestCheckMacro(cond) prints the failed condition with its file and
+ * line to cerr and returns EXIT_FAILURE from the calling function, which
+ * must return an int that is 0 on success.
+*/
+
+#ifndef vtkTestCheck_h
+#define vtkTestCheck_h
+
+#include "vtkSystemIncludes.h"
+
+#include <cstdlib> // Needed for EXIT_FAILURE
+
+#define vtkTestCheckMacro(cond) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      cerr << "Failed " << #cond << " at " << __FILE__ << ":" << __LINE__ \
+           << endl; \
+      return EXIT_FAILURE; \
+    } \
+  } while (0)
+
+#endif